@@ -210,6 +210,12 @@ namespace CASM {
       return bset_dir(bset) / (project + "_Clexulator.so");
     }
 
+    /// \brief Returns path to global clexulator basis function tables, used by
+    ///        the 'table' clexulator backend
+    fs::path clexulator_table(std::string project, std::string bset) const {
+      return bset_dir(bset) / (project + "_Clexulator_table.json");
+    }
+
     /// \brief Returns path to eci.in, in bset directory
     fs::path eci_in(std::string bset) const {
       return bset_dir(bset) / "eci.in";
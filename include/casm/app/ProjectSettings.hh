@@ -174,6 +174,9 @@ namespace CASM {
     /// \brief Get current command used by 'casm view'
     std::string view_command() const;
 
+    /// \brief Get Clexulator backend, "compiled" or "table"
+    std::string clexulator_backend() const;
+
     /// \brief Get current project crystallography tolerance
     double crystallography_tol() const;
 
@@ -303,6 +306,9 @@ namespace CASM {
     /// \brief Set command used by 'casm view'
     bool set_view_command(std::string opt);
 
+    /// \brief Set Clexulator backend, "compiled" or "table"
+    bool set_clexulator_backend(std::string opt);
+
     /// \brief Set crystallography tolerance
     bool set_crystallography_tol(double _tol);
 
@@ -378,6 +384,9 @@ namespace CASM {
     // Command executed by 'casm view'
     std::string m_view_command;
 
+    // Clexulator backend: "compiled" or "table"
+    std::string m_clexulator_backend;
+
     // Crystallography tolerance
     double m_crystallography_tol;
 
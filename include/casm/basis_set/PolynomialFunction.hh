@@ -40,6 +40,11 @@ namespace CASM {
       return m_coeffs;
     };
 
+    /// \brief The argument whose exponent is at position 'linear_ind' of each poly_coeffs() key
+    Function const *poly_argument(Index linear_ind) const {
+      return _argument(linear_ind);
+    }
+
     std::string type_name()const {
       return "PolynomialFunction";
     };
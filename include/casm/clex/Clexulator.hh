@@ -1,9 +1,12 @@
 #ifndef CLEXULATOR_HH
 #define CLEXULATOR_HH
 #include <cstddef>
+#include <algorithm>
+#include <vector>
 
 #include "casm/external/boost.hh"
 #include "casm/system/RuntimeLibrary.hh"
+#include "casm/system/RuntimeLibraryCache.hh"
 #include "casm/crystallography/UnitCellCoord.hh"
 #include "casm/clex/NeighborList.hh"
 #include "casm/casm_io/Log.hh"
@@ -12,6 +15,19 @@ namespace CASM {
 
   namespace Clexulator_impl {
 
+    /// \brief Version of the Clexulator_impl::Base interface
+    ///
+    /// - Each Clexulator library exports 'int abi_version_X_Clexulator()', which
+    ///   returns the version it was compiled with, and Clexulator checks it when
+    ///   the library is loaded
+    /// - Increment whenever the virtual members of Base change
+    ///
+    /// Versions:
+    /// - 1: Added has_delta_point_energy and calc_delta_point_energy
+    /// - 2: Added calc_global_corr_sum, with the pair-swap kernels
+    ///      (Clexulator::calc_delta_swap_corr) that use the same libraries
+    const int abi_version = 2;
+
     /// \brief Abstract base class for cluster expansion correlation calculations
     class Base {
 
@@ -194,6 +210,68 @@ namespace CASM {
                                                     size_type const *ind_list_begin,
                                                     size_type const *ind_list_end) const = 0;
 
+      /// \brief Returns true if calc_delta_point_energy was generated for this Clexulator
+      virtual bool has_delta_point_energy() const {
+        return false;
+      }
+
+      /// \brief Calculate the change in energy, sum_i eci_i*dCorr_i, due to changing an occupant
+      ///
+      /// \brief b_index Basis site index about which to calculate correlations
+      /// \brief occ_i,occ_f Initial and final occupant variable
+      /// \brief eci Pointer to beginning of ECI values for all correlations, zero if not included
+      ///
+      /// - Only the basis functions of clusters that include sublattice 'b_index' and
+      ///   have non-zero ECI are evaluated, and no correlations are written
+      ///
+      /// Call using:
+      /// \code
+      /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+      /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta energy
+      /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
+      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
+      /// double dE = myclexulator.calc_delta_point_energy(b, occ_i, occ_f, eci_array.data());
+      /// \endcode
+      ///
+      virtual double calc_delta_point_energy(int b_index, int occ_i, int occ_f, double const *eci) const {
+        throw std::runtime_error(
+          "Error in Clexulator: calc_delta_point_energy was not generated. Try 'casm bset -uf'.");
+      }
+
+      /// \brief Calculate the sum of contributions to global correlations from several unit cells
+      ///
+      /// \param nlist_ptrs Pointers to the beginning of the neighbor list of each unit cell
+      /// \param n_cells Number of unit cells
+      /// \param corr_begin Pointer to beginning of data structure where the summed correlations are written
+      ///
+      /// - The default evaluates calc_global_corr_contribution one unit cell at a
+      ///   time. Implementations may instead evaluate each basis function for
+      ///   many unit cells at once.
+      /// - Leaves the Clexulator pointing at an unspecified neighbor list
+      ///
+      /// Call using:
+      /// \code
+      /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+      /// std::vector<const long int*> nlist_ptrs;
+      /// for(int v=0; v<my_supercell.volume(); ++v) {
+      ///   nlist_ptrs.push_back(my_supercell.nlist().sites(v).data());
+      /// }
+      /// myclexulator.calc_global_corr_sum(nlist_ptrs.data(), nlist_ptrs.size(), correlation_array.begin());
+      /// \endcode
+      ///
+      virtual void calc_global_corr_sum(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin) {
+        std::fill(corr_begin, corr_begin + corr_size(), 0.0);
+        std::vector<double> tcorr(corr_size());
+        for(size_type c = 0; c < n_cells; c++) {
+          set_nlist(nlist_ptrs[c]);
+          calc_global_corr_contribution(tcorr.data());
+          for(size_type i = 0; i < corr_size(); i++) {
+            *(corr_begin + i) += tcorr[i];
+          }
+        }
+      }
+
 
     private:
 
@@ -229,12 +307,31 @@ namespace CASM {
     };
   }
 
+  /// \brief One site of a pair swap, for Clexulator::calc_delta_swap_corr
+  ///
+  /// - l: Linear index of the site in the Configuration
+  /// - b: Basis site index of the site
+  /// - occ_i, occ_f: Initial and final occupant variable
+  /// - nlist_begin, nlist_end: Neighbor list of the unit cell containing the site
+  ///
+  struct ClexSwapSite {
+    long int l;
+    int b;
+    int occ_i;
+    int occ_f;
+    const long int *nlist_begin;
+    const long int *nlist_end;
+  };
+
   /// \brief Evaluates correlations
   ///
   /// CASM generates code for very efficient calculation of basis functions via
   /// the print_clexulator function. This source code may be compiled, linked,
   /// and used at runtime via Clexulator.
   ///
+  /// Alternatively, the same basis functions may be evaluated from tables
+  /// without a c++ compiler, see make_table_clexulator.
+  ///
   /// \ingroup ClexClex
   ///
   class Clexulator {
@@ -259,7 +356,9 @@ namespace CASM {
     ///
     /// If 'name' is 'X_Clexulator', and 'dirpath' is '/path/to':
     /// - Looks for '/path/to/X_Clexulator.so' and tries to load it.
-    /// - If not found, looks for 'path/to/X_Clexulator.cc' and tries to compile and load it.
+    /// - If not found, looks for 'path/to/X_Clexulator.cc' and tries to load it
+    ///   from the RuntimeLibraryCache, compiling it into the cache if necessary.
+    ///   If the cache is disabled or not usable, compiles it in 'dirpath'.
     /// - If unsuccesful, will throw std::runtime_error.
     ///
     /// The Clexulator has shared ownership of the loaded library,
@@ -281,13 +380,31 @@ namespace CASM {
                   (dirpath / name).string(),
                   compile_options,
                   so_options,
-                  "compile time depends on how many basis functions are included");
+                  "compile time depends on how many basis functions are included",
+                  RuntimeLibraryCache());
       }
       catch(std::exception &e) {
         logging.log() << "Clexulator construction failed: could not construct runtime library." << std::endl;
         throw;
       }
 
+      // Check the library was compiled against this version of Clexulator_impl::Base
+      int version = 0;
+      try {
+        version = m_lib->get_function<int (void)>("abi_version_" + name)();
+      }
+      catch(std::runtime_error &e) {
+        // compiled before the version was exported
+      }
+      if(version != Clexulator_impl::abi_version) {
+        logging.log() << "Clexulator construction failed: incompatible library." << std::endl;
+        throw std::runtime_error(
+          "Error constructing Clexulator '" + name + "': the library was compiled "
+          "for Clexulator version " + std::to_string(version) + ", but version " +
+          std::to_string(Clexulator_impl::abi_version) + " is required. "
+          "Regenerate it with 'casm bset -uf'.");
+      }
+
       // Get the Clexulator factory function
       std::function<Clexulator_impl::Base* (void)> factory;
       factory = m_lib->get_function<Clexulator_impl::Base* (void)>("make_" + name);
@@ -295,21 +412,25 @@ namespace CASM {
       // Use the factory to construct the clexulator and store it in m_clex
       m_clex.reset(factory());
 
-      // Check nlist has the right weight_matrix
-      if(nlist.weight_matrix() != m_clex->weight_matrix()) {
-        std::cerr << "Error in Clexulator constructor: weight matrix of neighbor "
-                  "list does not match the weight matrix used to print the "
-                  "clexulator." << std::endl;
-        std::cerr << "nlist weight matrix: \n" << nlist.weight_matrix() << std::endl;
-        std::cerr << "clexulator weight matrix: \n" << m_clex->weight_matrix() << std::endl;
-        throw std::runtime_error(
-          "Error in Clexulator constructor: weight matrix of neighbor list does "
-          "not match the weight matrix used to print the clexulator. Try 'casm bset -uf'.");
-      }
+      _init_nlist(nlist);
 
-      // Expand the given neighbor list as necessary
-      nlist.expand(neighborhood().begin(), neighborhood().end());
+    }
 
+    /// \brief Construct a Clexulator that takes ownership of 'clex', which does
+    ///        not require a runtime library
+    ///
+    /// \param name Class name for the Clexulator, typically 'X_Clexulator'
+    /// \param clex The Clexulator implementation
+    /// \param nlist, A PrimNeighborList to be updated to include the neighborhood
+    ///        of this Clexulator
+    ///
+    Clexulator(std::string name,
+               std::unique_ptr<Clexulator_impl::Base> clex,
+               PrimNeighborList &nlist) :
+      m_name(name),
+      m_clex(std::move(clex)) {
+
+      _init_nlist(nlist);
     }
 
 
@@ -351,9 +472,9 @@ namespace CASM {
       swap(first.m_lib, second.m_lib);
     }
 
-    /// \brief Is runtime library loaded?
+    /// \brief Is a Clexulator implementation loaded?
     bool initialized() const {
-      return m_lib.get() != nullptr;
+      return m_clex.get() != nullptr;
     }
 
     /// \brief Name
@@ -535,13 +656,284 @@ namespace CASM {
       m_clex->calc_restricted_delta_point_corr(b_index, occ_i, occ_f, corr_begin, ind_list_begin, ind_list_end);
     }
 
+    /// \brief Returns true if calc_delta_point_energy was generated for this Clexulator
+    bool has_delta_point_energy() const {
+      return m_clex->has_delta_point_energy();
+    }
+
+    /// \brief Calculate the change in energy, sum_i eci_i*dCorr_i, due to changing an occupant
+    ///
+    /// \brief b_index Basis site index about which to calculate correlations
+    /// \brief occ_i,occ_f Initial and final occupant variable
+    /// \brief eci Pointer to beginning of ECI values for all correlations, zero if not included
+    ///
+    /// Call using:
+    /// \code
+    /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+    /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta energy
+    /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
+    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
+    /// double dE = myclexulator.calc_delta_point_energy(b, occ_i, occ_f, eci_array.data());
+    /// \endcode
+    ///
+    double calc_delta_point_energy(int b_index, int occ_i, int occ_f, double const *eci) const {
+      return m_clex->calc_delta_point_energy(b_index, occ_i, occ_f, eci);
+    }
+
+    /// \brief Calculate the sum of contributions to global correlations from several unit cells
+    ///
+    /// \param nlist_ptrs Pointers to the beginning of the neighbor list of each unit cell
+    /// \param n_cells Number of unit cells
+    /// \param corr_begin Pointer to beginning of data structure where the summed correlations are written
+    ///
+    /// - Table-based Clexulators evaluate each basis function for many unit
+    ///   cells at once; compiled Clexulators evaluate one unit cell at a time
+    /// - May use workspace owned by this Clexulator, so each thread requires its own copy
+    /// - Leaves the Clexulator pointing at an unspecified neighbor list
+    ///
+    /// Call using:
+    /// \code
+    /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+    /// std::vector<const long int*> nlist_ptrs;
+    /// for(int v=0; v<my_supercell.volume(); ++v) {
+    ///   nlist_ptrs.push_back(my_supercell.nlist().sites(v).data());
+    /// }
+    /// myclexulator.calc_global_corr_sum(nlist_ptrs.data(), nlist_ptrs.size(), correlation_array.begin());
+    /// \endcode
+    ///
+    void calc_global_corr_sum(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin) {
+      m_clex->calc_global_corr_sum(nlist_ptrs, n_cells, corr_begin);
+    }
+
+    /// \brief Calculate the change in correlations due to swapping the occupants of two sites
+    ///
+    /// \param occ_ptr Pointer to beginning of occupation variables, not modified
+    /// \param a,b The two sites, with initial and final occupants
+    /// \param use_deltas If true, use calc_delta_point_corr; else difference
+    ///        calc_point_corr before and after, which is required if a site
+    ///        interacts with its own periodic images
+    /// \param corr_begin Pointer to beginning of data structure where difference in
+    ///        (extensive) correlations is written
+    ///
+    /// - Overlapping neighborhoods are handled by evaluating site 'b' on a local copy
+    ///   of its neighborhood occupation, with site 'a' already changed
+    /// - Does not allocate after the first call, but uses workspace owned by this
+    ///   Clexulator, so each thread requires its own copy
+    /// - Leaves the Clexulator pointing at 'occ_ptr' and the neighbor list of 'b'
+    ///
+    /// Call using:
+    /// \code
+    /// ClexSwapSite a {l_a, b_a, occ_a, occ_b, nlist_a.data(), nlist_a.data() + nlist_a.size()};
+    /// ClexSwapSite b {l_b, b_b, occ_b, occ_a, nlist_b.data(), nlist_b.data() + nlist_b.size()};
+    /// myclexulator.calc_delta_swap_corr(my_configdof.occupation().begin(), a, b, true, correlation_array.begin());
+    /// \endcode
+    ///
+    void calc_delta_swap_corr(const int *occ_ptr,
+                              const ClexSwapSite &a,
+                              const ClexSwapSite &b,
+                              bool use_deltas,
+                              double *corr_begin) {
+      _calc_delta_swap_corr(occ_ptr, a, b, use_deltas, corr_begin, nullptr, nullptr);
+    }
+
+    /// \brief Calculate the change in select correlations due to swapping the occupants of two sites
+    ///
+    /// \param ind_list_begin,ind_list_end Pointers to range indicating which correlations should be calculated
+    ///
+    /// - Only correlations in the index list are written
+    /// - See calc_delta_swap_corr for other parameters
+    ///
+    void calc_restricted_delta_swap_corr(const int *occ_ptr,
+                                         const ClexSwapSite &a,
+                                         const ClexSwapSite &b,
+                                         bool use_deltas,
+                                         double *corr_begin,
+                                         size_type const *ind_list_begin,
+                                         size_type const *ind_list_end) {
+      _calc_delta_swap_corr(occ_ptr, a, b, use_deltas, corr_begin, ind_list_begin, ind_list_end);
+    }
+
+    /// \brief Calculate the change in energy, sum_i eci_i*dCorr_i, due to swapping the occupants of two sites
+    ///
+    /// \param occ_ptr Pointer to beginning of occupation variables, not modified
+    /// \param a,b The two sites, with initial and final occupants
+    /// \param eci Pointer to beginning of ECI values for all correlations, zero if not included
+    ///
+    /// - Requires has_delta_point_energy(), and that no site interacts with its
+    ///   own periodic images (as for calc_delta_swap_corr with use_deltas == true)
+    ///
+    double calc_delta_swap_energy(const int *occ_ptr,
+                                  const ClexSwapSite &a,
+                                  const ClexSwapSite &b,
+                                  double const *eci) {
+
+      m_clex->set_config_occ(occ_ptr);
+      m_clex->set_nlist(a.nlist_begin);
+      double dE = m_clex->calc_delta_point_energy(a.b, a.occ_i, a.occ_f, eci);
+
+      if(std::find(b.nlist_begin, b.nlist_end, a.l) == b.nlist_end) {
+        m_clex->set_nlist(b.nlist_begin);
+        return dE + m_clex->calc_delta_point_energy(b.b, b.occ_i, b.occ_f, eci);
+      }
+
+      _set_swap_occ(occ_ptr, b, a.l, a.occ_f, -1, 0);
+      dE += m_clex->calc_delta_point_energy(b.b, b.occ_i, b.occ_f, eci);
+
+      m_clex->set_config_occ(occ_ptr);
+      m_clex->set_nlist(b.nlist_begin);
+      return dE;
+    }
+
 
   private:
 
+    /// \brief Check that 'nlist' has the weight matrix used to print the
+    ///        clexulator, and expand it to include the neighborhood
+    void _init_nlist(PrimNeighborList &nlist) const {
+
+      // Check nlist has the right weight_matrix
+      if(nlist.weight_matrix() != m_clex->weight_matrix()) {
+        std::cerr << "Error in Clexulator constructor: weight matrix of neighbor "
+                  "list does not match the weight matrix used to print the "
+                  "clexulator." << std::endl;
+        std::cerr << "nlist weight matrix: \n" << nlist.weight_matrix() << std::endl;
+        std::cerr << "clexulator weight matrix: \n" << m_clex->weight_matrix() << std::endl;
+        throw std::runtime_error(
+          "Error in Clexulator constructor: weight matrix of neighbor list does "
+          "not match the weight matrix used to print the clexulator. Try 'casm bset -uf'.");
+      }
+
+      // Expand the given neighbor list as necessary
+      nlist.expand(neighborhood().begin(), neighborhood().end());
+    }
+
+    /// \brief Point m_clex at a copy of the neighborhood occupation of 'site',
+    ///        with site 'l1' (and 'l2', if not -1) given a different occupant
+    void _set_swap_occ(const int *occ_ptr, const ClexSwapSite &site, long int l1, int occ1, long int l2, int occ2) {
+
+      size_type N = site.nlist_end - site.nlist_begin;
+      if(m_swap_occ.size() < N) {
+        m_swap_occ.resize(N);
+        m_swap_nlist.resize(N);
+      }
+
+      for(size_type k = 0; k < N; ++k) {
+        long int l = *(site.nlist_begin + k);
+        m_swap_occ[k] = (l == l1) ? occ1 : ((l == l2) ? occ2 : *(occ_ptr + l));
+        m_swap_nlist[k] = k;
+      }
+
+      m_clex->set_config_occ(m_swap_occ.data());
+      m_clex->set_nlist(m_swap_nlist.data());
+    }
+
+    /// \brief Point correlations about 'b_index', all if 'ind_list_begin' is nullptr
+    void _point_corr(int b_index, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const {
+      if(ind_list_begin == nullptr) {
+        m_clex->calc_point_corr(b_index, corr_begin);
+      }
+      else {
+        m_clex->calc_restricted_point_corr(b_index, corr_begin, ind_list_begin, ind_list_end);
+      }
+    }
+
+    /// \brief Delta point correlations about 'b_index', all if 'ind_list_begin' is nullptr
+    void _delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const {
+      if(ind_list_begin == nullptr) {
+        m_clex->calc_delta_point_corr(b_index, occ_i, occ_f, corr_begin);
+      }
+      else {
+        m_clex->calc_restricted_delta_point_corr(b_index, occ_i, occ_f, corr_begin, ind_list_begin, ind_list_end);
+      }
+    }
+
+    /// \brief Apply 'f(i)' to each correlation index, all if 'ind_list_begin' is nullptr
+    template<typename F>
+    void _for_each_corr(size_type const *ind_list_begin, size_type const *ind_list_end, F f) const {
+      if(ind_list_begin == nullptr) {
+        for(size_type i = 0; i < corr_size(); ++i) {
+          f(i);
+        }
+      }
+      else {
+        for(; ind_list_begin != ind_list_end; ++ind_list_begin) {
+          f(*ind_list_begin);
+        }
+      }
+    }
+
+    void _calc_delta_swap_corr(const int *occ_ptr,
+                               const ClexSwapSite &a,
+                               const ClexSwapSite &b,
+                               bool use_deltas,
+                               double *corr_begin,
+                               size_type const *ind_list_begin,
+                               size_type const *ind_list_end) {
+
+      if(m_swap_corr.size() < corr_size()) {
+        m_swap_corr.resize(corr_size());
+        m_swap_corr_f.resize(corr_size());
+      }
+      double *tmp = m_swap_corr.data();
+      double *tmp_f = m_swap_corr_f.data();
+
+      if(use_deltas) {
+
+        // site 'a', unaffected by site 'b'
+        m_clex->set_config_occ(occ_ptr);
+        m_clex->set_nlist(a.nlist_begin);
+        _delta_point_corr(a.b, a.occ_i, a.occ_f, corr_begin, ind_list_begin, ind_list_end);
+
+        // site 'b', after site 'a' has changed
+        if(std::find(b.nlist_begin, b.nlist_end, a.l) == b.nlist_end) {
+          m_clex->set_nlist(b.nlist_begin);
+        }
+        else {
+          _set_swap_occ(occ_ptr, b, a.l, a.occ_f, -1, 0);
+        }
+        _delta_point_corr(b.b, b.occ_i, b.occ_f, tmp, ind_list_begin, ind_list_end);
+        _for_each_corr(ind_list_begin, ind_list_end, [&](size_type i) {
+          corr_begin[i] += tmp[i];
+        });
+      }
+      else {
+
+        // site 'a': before, and after only site 'a' changes
+        m_clex->set_config_occ(occ_ptr);
+        m_clex->set_nlist(a.nlist_begin);
+        _point_corr(a.b, tmp, ind_list_begin, ind_list_end);
+        _set_swap_occ(occ_ptr, a, a.l, a.occ_f, -1, 0);
+        _point_corr(a.b, tmp_f, ind_list_begin, ind_list_end);
+        _for_each_corr(ind_list_begin, ind_list_end, [&](size_type i) {
+          corr_begin[i] = tmp_f[i] - tmp[i];
+        });
+
+        // site 'b': after site 'a' changes, and after both change
+        _set_swap_occ(occ_ptr, b, a.l, a.occ_f, -1, 0);
+        _point_corr(b.b, tmp, ind_list_begin, ind_list_end);
+        _set_swap_occ(occ_ptr, b, a.l, a.occ_f, b.l, b.occ_f);
+        _point_corr(b.b, tmp_f, ind_list_begin, ind_list_end);
+        _for_each_corr(ind_list_begin, ind_list_end, [&](size_type i) {
+          corr_begin[i] += tmp_f[i] - tmp[i];
+        });
+      }
+
+      m_clex->set_config_occ(occ_ptr);
+      m_clex->set_nlist(b.nlist_begin);
+    }
+
+
     std::string m_name;
     std::unique_ptr<Clexulator_impl::Base> m_clex;
     std::shared_ptr<RuntimeLibrary> m_lib;
 
+    /// Workspace for calc_delta_swap_corr, not copied
+    std::vector<int> m_swap_occ;
+    std::vector<long int> m_swap_nlist;
+    std::vector<double> m_swap_corr;
+    std::vector<double> m_swap_corr_f;
+
   };
 
 }
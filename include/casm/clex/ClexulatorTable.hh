@@ -0,0 +1,195 @@
+#ifndef CASM_ClexulatorTable_HH
+#define CASM_ClexulatorTable_HH
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "casm/clex/Clexulator.hh"
+
+namespace CASM {
+
+  class jsonParser;
+  class Structure;
+  class SiteCluster;
+  template<typename ClustType> class GenericOrbitree;
+  typedef GenericOrbitree<SiteCluster> SiteOrbitree;
+
+  /// \brief Sums of products of occupation functions, stored in flat arrays
+  ///
+  /// - Function 'i' is the sum of terms [term_begin[i], term_begin[i+1])
+  /// - Term 't' is coeff[t] times the product of factors [factor_begin[t], factor_begin[t+1])
+  /// - Factor 'k' is occ_func[func[k] + occ], where 'occ' is the occupant of
+  ///   the site at neighbor list index nlist[k]
+  /// - Factors [factor_begin[t], site_end[t]) are on the site whose occupant
+  ///   changes in a delta point correlation calculation
+  ///
+  /// \ingroup ClexClex
+  ///
+  struct ClexTermTable {
+
+    typedef Clexulator_impl::Base::size_type size_type;
+
+    /// \brief Number of functions
+    size_type size() const {
+      return term_begin.empty() ? 0 : term_begin.size() - 1;
+    }
+
+    std::vector<size_type> term_begin;
+    std::vector<double> coeff;
+    std::vector<size_type> factor_begin;
+    std::vector<size_type> site_end;
+    std::vector<size_type> nlist;
+    std::vector<size_type> func;
+  };
+
+  jsonParser &to_json(const ClexTermTable &table, jsonParser &json);
+
+  void from_json(ClexTermTable &table, const jsonParser &json);
+
+
+  /// \brief The basis functions of a Clexulator, as tables that can be evaluated
+  ///        without compiling
+  ///
+  /// - Written by 'casm bset -u' along with the Clexulator source code
+  /// - Only occupation basis functions are supported
+  ///
+  /// \ingroup ClexClex
+  ///
+  struct ClexulatorTable {
+
+    typedef Clexulator_impl::Base::size_type size_type;
+
+    size_type nlist_size;
+    size_type corr_size;
+
+    /// \brief Maximum number of occupants on any site
+    ///
+    /// - Each occupation function takes max_occ entries of occ_func, padded
+    ///   with zeros for sites with fewer occupants
+    size_type max_occ;
+
+    /// \brief The weight matrix used for ordering the neighbor list
+    PrimNeighborList::Matrix3Type weight_matrix;
+
+    /// \brief The UnitCellCoord involved in calculating the basis functions
+    std::set<UnitCellCoord> neighborhood;
+
+    /// \brief The UnitCellCoord involved in calculating each basis function
+    std::vector<std::set<UnitCellCoord> > orbit_neighborhood;
+
+    /// \brief Occupation function values, all sites and functions, by occupant
+    ///
+    /// - occ_func[f + occ], for 'f' the start of the occupation function and
+    ///   'occ' < max_occ
+    std::vector<double> occ_func;
+
+    /// \brief Contribution to global correlations from one unit cell
+    ClexTermTable orbit;
+
+    /// \brief Point correlations about each basis site, flower[b]
+    std::vector<ClexTermTable> flower;
+  };
+
+  jsonParser &to_json(const ClexulatorTable &table, jsonParser &json);
+
+  void from_json(ClexulatorTable &table, const jsonParser &json);
+
+  /// \brief Make the basis function tables equivalent to print_clexulator
+  ClexulatorTable make_clexulator_table(const Structure &prim,
+                                        SiteOrbitree &tree,
+                                        const PrimNeighborList &nlist,
+                                        double xtal_tol);
+
+
+  namespace Clexulator_impl {
+
+    /// \brief Evaluates basis functions from a ClexulatorTable
+    ///
+    /// - Copies share the table
+    /// - calc_global_corr_sum evaluates each basis function for a batch of unit
+    ///   cells at once, from occupation function values gathered into one
+    ///   contiguous array per (neighbor, occupation function) pair, so that the
+    ///   loops over unit cells may be vectorized
+    ///
+    class TableClexulator : public Base {
+
+    public:
+
+      explicit TableClexulator(ClexulatorTable table);
+
+      /// \brief Calculate contribution to global correlations from one unit cell
+      void calc_global_corr_contribution(double *corr_begin) const override;
+
+      /// \brief Calculate contribution to select global correlations from one unit cell
+      void calc_restricted_global_corr_contribution(double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const override;
+
+      /// \brief Calculate point correlations about basis site 'b_index'
+      void calc_point_corr(int b_index, double *corr_begin) const override;
+
+      /// \brief Calculate select point correlations about basis site 'b_index'
+      void calc_restricted_point_corr(int b_index, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const override;
+
+      /// \brief Calculate the change in point correlations due to changing an occupant
+      void calc_delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin) const override;
+
+      /// \brief Calculate the change in select point correlations due to changing an occupant
+      void calc_restricted_delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const override;
+
+      /// \brief Returns true, calc_delta_point_energy is implemented
+      bool has_delta_point_energy() const override {
+        return true;
+      }
+
+      /// \brief Calculate the change in energy due to changing an occupant
+      double calc_delta_point_energy(int b_index, int occ_i, int occ_f, double const *eci) const override;
+
+      /// \brief Calculate the sum of contributions to global correlations from several unit cells
+      void calc_global_corr_sum(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin) override;
+
+    private:
+
+      /// \brief Clone the TableClexulator
+      Base *_clone() const override {
+        return new TableClexulator(*this);
+      }
+
+      /// \brief Evaluate function 'i' of 'table'
+      double _eval(const ClexTermTable &table, size_type i) const;
+
+      /// \brief Evaluate the change in function 'i' of 'table' when the
+      ///        occupant of the central site changes from 'occ_i' to 'occ_f'
+      double _eval_delta(const ClexTermTable &table, size_type i, int occ_i, int occ_f) const;
+
+      /// \brief Distinct (neighbor, occupation function) pairs of the orbit table
+      struct GatherTable {
+        std::vector<size_type> pair_nlist;
+        std::vector<size_type> pair_func;
+
+        /// \brief Index of the pair for each factor of the orbit table
+        std::vector<size_type> factor_pair;
+      };
+
+      std::shared_ptr<const ClexulatorTable> m_table;
+
+      std::shared_ptr<const GatherTable> m_gather;
+
+      /// \brief m_table->occ_func.data()
+      double const *m_occ_func;
+
+      /// \brief Workspace for calc_global_corr_sum, gathered occupation
+      /// function values by pair, then by unit cell
+      std::vector<double> m_phi;
+    };
+
+  }
+
+  /// \brief Construct a Clexulator that evaluates the basis function tables
+  ///        written at 'table_path'
+  Clexulator make_table_clexulator(std::string name,
+                                   const boost::filesystem::path &table_path,
+                                   PrimNeighborList &nlist);
+
+}
+
+#endif
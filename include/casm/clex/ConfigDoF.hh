@@ -184,10 +184,10 @@ namespace CASM {
   void swap(ConfigDoF &A, ConfigDoF &B);
 
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
-  Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator);
+  Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator, Index n_threads = 1);
 
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
-  Eigen::VectorXd correlations_vec(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator);
+  Eigen::VectorXd correlations_vec(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator, Index n_threads = 1);
 
   /// \brief Returns num_each_molecule[ molecule_type], where 'molecule_type' is ordered as Structure::get_struc_molecule()
   ReturnArray<int> get_num_each_molecule(const ConfigDoF &configdof, const Supercell &scel);
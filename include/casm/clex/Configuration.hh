@@ -672,7 +672,7 @@ namespace CASM {
   Configuration make_configuration(PrimClex &primclex, std::string name);
 
   /// \brief Returns correlations using 'clexulator'.
-  Correlation correlations(const Configuration &config, Clexulator &clexulator);
+  Correlation correlations(const Configuration &config, Clexulator &clexulator, Index n_threads = 1);
 
   /// Returns parametric composition, as calculated using PrimClex::param_comp
   Eigen::VectorXd comp(const Configuration &config);
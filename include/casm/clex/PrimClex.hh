@@ -351,13 +351,18 @@ namespace CASM {
   /// \brief Make orbitree. For now specifically global.
   SiteOrbitree make_orbitree(Structure &prim, const jsonParser &json, double _tol);
 
+  /// \brief Set the neighbor list indices of each cluster in 'tree'
+  void set_nlist_ind(const Structure &prim, SiteOrbitree &tree, const PrimNeighborList &nlist, double xtal_tol);
+
   /// \brief Print clexulator
   void print_clexulator(const Structure &prim,
                         SiteOrbitree &tree,
                         const PrimNeighborList &nlist,
                         std::string class_name,
                         std::ostream &stream,
-                        double xtal_tol);
+                        double xtal_tol,
+                        bool delta_point_energy = true,
+                        Index shard_size = 1 << 18);
 
 }
 #endif
@@ -0,0 +1,70 @@
+#ifndef CASM_parallel
+#define CASM_parallel
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief Number of threads to use, with 0 meaning the number of hardware threads
+  inline Index resolve_threads(Index n_threads) {
+    if(n_threads == 0) {
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+    return n_threads;
+  }
+
+  /// \brief Call 'f(Index thread, Index i)' for each i in [0, n), using up to 'n_threads' threads
+  ///
+  /// - The range is divided into contiguous chunks, one per thread, in order,
+  ///   so results stored by 'i' and reduced in order do not depend on timing
+  /// - The calling thread evaluates the first chunk
+  /// - If any call to 'f' throws, that thread stops, and the first exception
+  ///   (by thread) is rethrown after all threads have finished
+  template<typename F>
+  void parallel_for(Index n, Index n_threads, F f) {
+
+    Index T = std::max(Index(1), std::min(n_threads, n));
+    if(T == 1) {
+      for(Index i = 0; i < n; ++i) {
+        f(0, i);
+      }
+      return;
+    }
+
+    std::vector<std::exception_ptr> exception(T);
+
+    auto work = [&](Index t) {
+      try {
+        Index end = ((t + 1) * n) / T;
+        for(Index i = (t * n) / T; i < end; ++i) {
+          f(t, i);
+        }
+      }
+      catch(...) {
+        exception[t] = std::current_exception();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for(Index t = 1; t < T; ++t) {
+      threads.emplace_back(work, t);
+    }
+    work(0);
+    for(auto &thread : threads) {
+      thread.join();
+    }
+
+    for(auto &e : exception) {
+      if(e) {
+        std::rethrow_exception(e);
+      }
+    }
+  }
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef CASM_Monte_BiasPotential_HH
+#define CASM_Monte_BiasPotential_HH
+
+#include <utility>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  class jsonParser;
+  template<typename T> struct jsonConstructor;
+
+  namespace Monte {
+
+    /// \brief A bias potential for umbrella sampling, u(q), of an order parameter
+    ///        q that is a linear combination of correlations
+    ///
+    /// - q = sum_i w_i * corr_i, using correlations normalized per unit cell
+    /// - The bias energy of the supercell is U = N * u(q), where N is the
+    ///   supercell volume, and is added to the change in potential energy when
+    ///   deciding whether to accept an event
+    /// - Because q is linear in the correlations, its change is calculated from
+    ///   the change in correlations of an event, using only the correlations
+    ///   with non-zero weight
+    /// - Sublattice compositions may be used as order parameters via point
+    ///   cluster correlations, which are linear in sublattice composition
+    ///
+    /// Potentials:
+    /// - HARMONIC: u(q) = 0.5 * spring * (q - center)^2
+    /// - LINEAR: u(q) = slope * q
+    /// - TABLE: linear interpolation of (q, u) points, constant beyond the ends
+    ///
+    /// \seealso reweighting_weights, reweighted_mean
+    ///
+    class BiasPotential {
+
+    public:
+
+      enum class TYPE {
+        HARMONIC, LINEAR, TABLE
+      };
+
+      /// \brief Construct an inactive BiasPotential
+      BiasPotential() :
+        m_is_active(false) {}
+
+      /// \brief Construct a harmonic or linear bias potential
+      ///
+      /// \param weights pair(correlation index, weight) for the order parameter
+      /// \param type HARMONIC or LINEAR
+      /// \param a spring constant (HARMONIC) or slope (LINEAR)
+      /// \param b center (HARMONIC), not used for LINEAR
+      BiasPotential(const std::vector<std::pair<Index, double> > &weights, TYPE type, double a, double b = 0.0);
+
+      /// \brief Construct a tabulated bias potential
+      BiasPotential(const std::vector<std::pair<Index, double> > &weights,
+                    const std::vector<double> &table_q,
+                    const std::vector<double> &table_u);
+
+      /// \brief Return true if a bias potential is in use
+      bool is_active() const {
+        return m_is_active;
+      }
+
+      /// \brief pair(correlation index, weight) for the order parameter
+      const std::vector<std::pair<Index, double> > &weights() const {
+        return m_weights;
+      }
+
+      /// \brief Order parameter, given correlations normalized per unit cell
+      double order_parameter(const Eigen::VectorXd &corr) const {
+        double q = 0.0;
+        for(const auto &w : m_weights) {
+          q += w.second * corr(w.first);
+        }
+        return q;
+      }
+
+      /// \brief Change in order parameter, given the change in (extensive)
+      ///        correlations of an event and the supercell volume
+      double delta_order_parameter(const Eigen::VectorXd &dCorr, double volume) const {
+        return order_parameter(dCorr) / volume;
+      }
+
+      /// \brief Bias potential, per unit cell
+      double value(double q) const;
+
+      /// \brief Change in the bias energy of the supercell, N*(u(q + dq) - u(q))
+      double delta(double q, double dq, double volume) const {
+        return volume * (value(q + dq) - value(q));
+      }
+
+    private:
+
+      bool m_is_active;
+
+      std::vector<std::pair<Index, double> > m_weights;
+
+      TYPE m_type;
+
+      double m_a;
+
+      double m_b;
+
+      std::vector<double> m_table_q;
+
+      std::vector<double> m_table_u;
+    };
+
+    /// \brief Weights that recover unbiased averages from biased samples
+    Eigen::VectorXd reweighting_weights(const Eigen::VectorXd &bias_energy, double beta, double volume);
+
+    /// \brief Unbiased mean of biased samples
+    double reweighted_mean(const Eigen::VectorXd &observations,
+                           const Eigen::VectorXd &bias_energy,
+                           double beta,
+                           double volume);
+
+  }
+
+  /// \brief Read BiasPotential
+  ///
+  /// Expects:
+  /// \code
+  /// {
+  ///   "order_parameter": {"corr": {"1": 1.0, "2": -1.0, ...}},
+  ///   "potential": {"type": "harmonic", "center": number, "spring": number}
+  ///     or {"type": "linear", "slope": number}
+  ///     or {"type": "table", "order_parameter": [...], "value": [...]}
+  /// }
+  /// \endcode
+  ///
+  /// - Correlation indices must be less than 'corr_size'
+  template<>
+  struct jsonConstructor<Monte::BiasPotential> {
+    static Monte::BiasPotential from_json(const jsonParser &json, Index corr_size);
+  };
+
+}
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef CASM_Monte_Checkerboard_HH
+#define CASM_Monte_Checkerboard_HH
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "casm/clex/Clexulator.hh"
+#include "casm/monte_carlo/OccLocation.hh"
+
+namespace CASM {
+
+  class SuperNeighborList;
+
+  namespace Monte {
+
+    /// \brief Partition of the variable sites of a supercell into groups of
+    ///        non-interacting sites, for parallel sweeps
+    ///
+    /// - Unit cells are colored so that no unit cell is in the neighborhood of
+    ///   another unit cell of the same color. Each group consists of the sites on
+    ///   one sublattice in the unit cells of one color, so changing the occupation
+    ///   of one site in a group does not change the energy of any other change in
+    ///   the same group.
+    /// - Requires that periodic images of the neighborhood do not overlap
+    ///   (!SuperNeighborList::overlaps())
+    ///
+    /// A sweep visits every group once, in random order. The sites of a group are
+    /// divided among threads, each with its own MTRand, and all threads must finish a
+    /// group before any begins the next. The MTRand of each thread is seeded from the
+    /// MTRand given to 'sweep', so sweeps are determined by that MTRand alone. Because the changes within a group are
+    /// independent and the order of groups is random, each sweep satisfies detailed
+    /// balance if each single change does.
+    ///
+    /// The threads used in sweeps are started by the first sweep and wait for the
+    /// next one until the Checkerboard is destroyed.
+    ///
+    class Checkerboard {
+
+    public:
+
+      /// \brief Constructor
+      ///
+      /// \param nlist SuperNeighborList of the supercell
+      /// \param volume Number of unit cells in the supercell
+      /// \param variable_sites Linear indices of sites to include in groups
+      /// \param n_threads Number of threads to use in sweeps
+      /// \param mtrand Used to seed one MTRand per thread
+      ///
+      Checkerboard(const SuperNeighborList &nlist,
+                   Index volume,
+                   const std::vector<Index> &variable_sites,
+                   Index n_threads,
+                   MTRand &mtrand);
+
+      Checkerboard(const Checkerboard &) = delete;
+      Checkerboard &operator=(const Checkerboard &) = delete;
+
+      /// \brief Stops and joins the sweep threads
+      ~Checkerboard();
+
+      /// \brief Number of groups
+      Index size() const {
+        return m_group.size();
+      }
+
+      /// \brief Linear indices of the sites in a group
+      const std::vector<Index> &group(Index i) const {
+        return m_group[i];
+      }
+
+      /// \brief Number of unit cell colors
+      Index n_colors() const {
+        return m_n_colors;
+      }
+
+      /// \brief Number of threads used in sweeps
+      Index n_threads() const {
+        return m_mtrand.size();
+      }
+
+      /// \brief MTRand to be used by a particular thread
+      MTRand &mtrand(Index thread) {
+        return m_mtrand[thread];
+      }
+
+      /// \brief Write the state of the MTRand of each thread
+      void write_checkpoint(std::ostream &sout) const;
+
+      /// \brief Restore data written by write_checkpoint
+      void read_checkpoint(std::istream &sin);
+
+      /// \brief Visit all groups once, in random order, using all threads
+      ///
+      /// \param mtrand Used to choose the order of groups
+      /// \param f Called as 'f(Index thread, const std::vector<Index> &sites)' for
+      ///          each thread and group, with the sites in the group assigned to
+      ///          the thread
+      ///
+      /// - The assignment of sites to threads is randomly rotated every sweep
+      /// - The MTRand of each thread is seeded from 'mtrand' every sweep
+      /// - Exceptions thrown by 'f' are rethrown after the sweep is finished
+      template<typename F>
+      void sweep(MTRand &mtrand, F f);
+
+    private:
+
+      /// \brief Run 'work(t)' for every thread, with thread 0 being the caller
+      void _run(const std::function<void (Index)> &work);
+
+      /// \brief Loop run by sweep thread 't', for t > 0
+      void _worker(Index t);
+
+      /// \brief Wait for all threads to finish the current group
+      void _wait();
+
+      /// Sites in each group
+      std::vector<std::vector<Index> > m_group;
+
+      /// Number of unit cell colors
+      Index m_n_colors;
+
+      /// One MTRand per thread
+      std::vector<MTRand> m_mtrand;
+
+      /// Order of groups in the current sweep
+      std::vector<Index> m_order;
+
+      /// Rotation of sites in each group (in order) in the current sweep
+      std::vector<Index> m_offset;
+
+      /// Sites assigned to each thread
+      std::vector<std::vector<Index> > m_chunk;
+
+      /// Exceptions thrown by each thread
+      std::vector<std::exception_ptr> m_exception;
+
+      // ---- barrier ----
+
+      std::mutex m_mutex;
+
+      std::condition_variable m_cv;
+
+      Index m_waiting;
+
+      Index m_generation;
+
+      // ---- sweep threads ----
+
+      /// Threads 1, ..., n_threads()-1, started by the first sweep
+      std::vector<std::thread> m_thread;
+
+      /// Work of the current sweep, called as 'm_work(t)' by each thread
+      const std::function<void (Index)> *m_work;
+
+      /// Number of sweeps started
+      Index m_sweep;
+
+      /// Number of sweep threads that have finished the current sweep
+      Index m_finished;
+
+      /// Set to stop the sweep threads
+      bool m_stop;
+
+      std::condition_variable m_start_cv;
+
+      std::condition_variable m_finish_cv;
+    };
+
+
+    /// \brief Per thread data for parallel sweeps
+    ///
+    /// - Holds a Clexulator clone, workspace, and the accumulated change in
+    ///   properties due to the changes accepted by one thread during a sweep
+    struct SweepData {
+
+      SweepData(const Clexulator &_clexulator, Index Ncorr, Index Nspecies) :
+        clexulator(_clexulator),
+        dCorr(Eigen::VectorXd::Zero(Ncorr)),
+        dCorr_tmp(Eigen::VectorXd::Zero(Ncorr)),
+        dN(Eigen::VectorXl::Zero(Nspecies)),
+        dEf(0.0),
+        dEpot(0.0) {}
+
+      /// \brief Set accumulated changes to zero
+      void reset() {
+        dCorr.setZero();
+        dN.setZero();
+        dEf = 0.0;
+        dEpot = 0.0;
+        accepted.clear();
+      }
+
+      Clexulator clexulator;
+
+      /// Accumulated change in correlations (extensive)
+      Eigen::VectorXd dCorr;
+
+      /// Workspace
+      Eigen::VectorXd dCorr_tmp;
+
+      /// Accumulated change in number of each species
+      Eigen::VectorXl dN;
+
+      /// Accumulated change in formation energy (extensive)
+      double dEf;
+
+      /// Accumulated change in potential energy (extensive)
+      double dEpot;
+
+      /// Accepted events, if they must be applied after the sweep
+      std::vector<OccEvent> accepted;
+    };
+
+
+    template<typename F>
+    void Checkerboard::sweep(MTRand &mtrand, F f) {
+
+      Index N = m_group.size();
+      Index T = n_threads();
+
+      // random order of groups, and random rotation of the sites in each group
+      m_order.resize(N);
+      m_offset.resize(N);
+      for(Index i = 0; i < N; ++i) {
+        m_order[i] = i;
+      }
+      for(Index i = N - 1; i > 0; --i) {
+        std::swap(m_order[i], m_order[mtrand.randInt(i)]);
+      }
+      for(Index i = 0; i < N; ++i) {
+        m_offset[i] = mtrand.randInt(m_group[m_order[i]].size() - 1);
+      }
+      for(auto &thread_mtrand : m_mtrand) {
+        thread_mtrand.seed(mtrand.randInt());
+      }
+
+      for(auto &e : m_exception) {
+        e = nullptr;
+      }
+
+      std::function<void (Index)> work = [&](Index t) {
+        std::vector<Index> &chunk = m_chunk[t];
+        for(Index i = 0; i < N; ++i) {
+          const std::vector<Index> &group = m_group[m_order[i]];
+          Index n = group.size();
+          Index begin = (t * n) / T;
+          Index end = ((t + 1) * n) / T;
+          chunk.clear();
+          for(Index j = begin; j < end; ++j) {
+            chunk.push_back(group[(j + m_offset[i]) % n]);
+          }
+          if(!m_exception[t]) {
+            try {
+              f(t, chunk);
+            }
+            catch(...) {
+              m_exception[t] = std::current_exception();
+            }
+          }
+          _wait();
+        }
+      };
+
+      _run(work);
+
+      for(auto &e : m_exception) {
+        if(e) {
+          std::rethrow_exception(e);
+        }
+      }
+    }
+
+  }
+}
+
+#endif
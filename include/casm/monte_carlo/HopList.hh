@@ -0,0 +1,69 @@
+#ifndef CASM_Monte_HopList_HH
+#define CASM_Monte_HopList_HH
+
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  class Supercell;
+
+  namespace Monte {
+
+    class Conversions;
+
+    /// \brief A hop between two sites with variable occupation
+    struct Hop {
+      Index l_a;               ///< Linear index of first site
+      Index l_b;               ///< Linear index of second site
+      Eigen::Vector3d dr;      ///< Cartesian displacement from l_a to l_b
+    };
+
+    /// \brief List of all hops between pairs of sites with variable occupation
+    ///        within a cutoff distance in a supercell, for kinetic Monte Carlo
+    ///
+    /// - Each pair of sites is included once, as a Hop in either direction
+    /// - Requires that the supercell is large enough that no pair of sites is
+    ///   within the cutoff distance by more than one periodic image
+    ///
+    class HopList {
+
+    public:
+
+      /// \brief Construct the list of hops in a supercell
+      HopList(const Supercell &scel, const Conversions &convert, double cutoff);
+
+      /// \brief Number of hops
+      Index size() const {
+        return m_hop.size();
+      }
+
+      /// \brief Access a hop
+      const Hop &operator[](Index i) const {
+        return m_hop[i];
+      }
+
+      /// \brief Indices of all hops with site 'l' as an endpoint
+      const std::vector<Index> &site_hops(Index l) const {
+        return m_site_hops[l];
+      }
+
+      /// \brief Maximum hop distance
+      double cutoff() const {
+        return m_cutoff;
+      }
+
+    private:
+
+      std::vector<Hop> m_hop;
+
+      std::vector<std::vector<Index> > m_site_hops;
+
+      double m_cutoff;
+
+    };
+
+  }
+}
+
+#endif
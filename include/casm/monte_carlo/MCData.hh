@@ -1,48 +1,121 @@
 #ifndef MCData_HH
 #define MCData_HH
 
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 #include "casm/CASM_global_definitions.hh"
 
 namespace CASM {
 
-  /// \brief MCData stores observations of properties
-  class MCData {
+  /// \brief MCDataStore stores observations of several properties, taken at the same times
+  ///
+  /// - Observations are stored by sample, one column of cols() values per
+  ///   sample, so that adding an observation of every property writes
+  ///   contiguous memory
+  /// - Space for the observations is reserved up front, and only re-sized (by
+  ///   doubling) if it is exceeded
+  /// - The blocking statistics grow with the observations: a block level is
+  ///   added when its first block is complete, and each level grows by one
+  ///   entry per complete block
+  /// - Also maintains blocking statistics as observations are added, so that
+  ///   the mean, and the variance of the mean, of the observations in any range
+  ///   [start, size()) can be estimated in O(log(size())) (see MCDataConvergence)
+  /// - Block level k consists of the blocks of 2^k consecutive observations
+  ///   beginning at 0, 2^k, 2*2^k, ...
+  class MCDataStore {
 
   public:
 
     typedef unsigned long int size_type;
 
-    /// \brief Default constructor
-    MCData() :
-      MCData(1) {}
+    typedef Eigen::Block<const Eigen::MatrixXd, 1, Eigen::Dynamic, false> RowType;
 
-    /// \brief Constructor with initial buffer size 'count'
-    MCData(size_type count) :
-      m_observation(Eigen::VectorXd::Zero(count)),
-      m_size(0) {}
+    typedef const Eigen::Transpose<const RowType> ObservationsType;
+
+    /// \brief Constructor with 'cols' properties and initial buffer size 'count'
+    MCDataStore(Index cols, size_type count) :
+      m_observation(Eigen::MatrixXd::Zero(cols, std::max<size_type>(count, 1))),
+      m_size(0),
+      m_block_sum(1),
+      m_block_sqsum(1) {
+      clear();
+    }
 
     /// \brief Forget all the observed values (does not resize reserved space)
     void clear() {
       m_size = 0;
+      m_levels = 1;
+      m_shift = Eigen::VectorXd::Zero(cols());
+      m_block_sum[0].assign(cols(), 0.0);
+      m_block_sqsum[0].assign(cols(), 0.0);
     }
 
-    /// \brief Add an observation
-    void push_back(double value) {
+    /// \brief Add an observation of every property
+    ///
+    /// \param sample Pointer to cols() values, in column order
+    void push_back(const double *sample) {
 
-      m_observation(m_size) = value;
+      Index n_col = cols();
+      std::copy(sample, sample + n_col, m_observation.col(m_size).data());
       ++m_size;
 
+      // update blocking statistics
+      if(m_size == 1) {
+        for(Index c = 0; c < n_col; ++c) {
+          m_shift(c) = sample[c];
+        }
+      }
+      m_block_sum[0].resize((m_size + 1) * n_col);
+      m_block_sqsum[0].resize((m_size + 1) * n_col);
+      double *sum0 = m_block_sum[0].data();
+      double *sqsum0 = m_block_sqsum[0].data();
+      size_type prev = (m_size - 1) * n_col;
+      size_type curr = m_size * n_col;
+      for(Index c = 0; c < n_col; ++c) {
+        double x = sample[c] - m_shift(c);
+        sum0[curr + c] = sum0[prev + c] + x;
+        sqsum0[curr + c] = sqsum0[prev + c] + x * x;
+      }
+
+      size_type block_size = 2;
+      for(Index k = 1; m_size % block_size == 0; ++k, block_size *= 2) {
+        if(k == m_levels) {
+          ++m_levels;
+          if(k == m_block_sum.size()) {
+            m_block_sum.emplace_back();
+            m_block_sqsum.emplace_back();
+          }
+          m_block_sum[k].assign(n_col, 0.0);
+          m_block_sqsum[k].assign(n_col, 0.0);
+        }
+        size_type j = m_size / block_size;
+        m_block_sum[k].resize((j + 1) * n_col);
+        m_block_sqsum[k].resize((j + 1) * n_col);
+        double *sum = m_block_sum[k].data();
+        double *sqsum = m_block_sqsum[k].data();
+        size_type last = (j - 1) * n_col;
+        size_type next = j * n_col;
+        size_type end0 = m_size * n_col;
+        size_type begin0 = (m_size - block_size) * n_col;
+        for(Index c = 0; c < n_col; ++c) {
+          double block_mean = (sum0[end0 + c] - sum0[begin0 + c]) / block_size;
+          sum[next + c] = sum[last + c] + block_mean;
+          sqsum[next + c] = sqsum[last + c] + block_mean * block_mean;
+        }
+      }
+
       // re-size as necessary by doubling reserved space
-      if(m_size == m_observation.size()) {
-        Eigen::VectorXd tmp = Eigen::VectorXd::Zero(m_observation.size() * 2);
-        tmp.head(m_observation.size()) = m_observation;
-        m_observation = tmp;
+      if(m_size == capacity()) {
+        m_observation.conservativeResize(Eigen::NoChange, 2 * capacity());
       }
     }
 
-    /// \brief Return all observations
-    Eigen::VectorBlock<const Eigen::VectorXd> observations() const {
-      return m_observation.head(m_size);
+    /// \brief Number of properties
+    Index cols() const {
+      return m_observation.rows();
     }
 
     /// \brief Number of observations
@@ -50,15 +123,200 @@ namespace CASM {
       return m_size;
     }
 
+    /// \brief Number of observations that can be stored without re-sizing
+    size_type capacity() const {
+      return m_observation.cols();
+    }
+
+    /// \brief Return all observations of property 'col'
+    ObservationsType observations(Index col) const {
+      return ObservationsType(RowType(m_observation, col, 0, 1, m_size));
+    }
+
+    /// \brief Return observation 'i' of every property, in column order
+    const double *sample(size_type i) const {
+      return m_observation.col(i).data();
+    }
+
+    /// \brief Number of block levels with at least one complete block
+    Index block_levels() const {
+      return m_levels;
+    }
+
+    /// \brief Value subtracted from all observations of property 'col' in the blocking statistics
+    ///
+    /// - The first observation, to limit round-off
+    double shift(Index col) const {
+      return m_shift(col);
+    }
+
+    /// \brief Sum of (block mean - shift(col)), for blocks [0, j) at level k
+    double block_sum(Index k, size_type j, Index col) const {
+      return m_block_sum[k][j * cols() + col];
+    }
+
+    /// \brief Sum of (block mean - shift(col))^2, for blocks [0, j) at level k
+    double block_sqsum(Index k, size_type j, Index col) const {
+      return m_block_sqsum[k][j * cols() + col];
+    }
 
   private:
 
-    /// \brief vector of all observations (includes m_size observations, and the rest is reserved space)
-    Eigen::VectorXd m_observation;
+    /// \brief All observations (m_size columns of observations, and the rest is reserved space)
+    Eigen::MatrixXd m_observation;
 
     /// \brief The number of observations
     size_type m_size;
 
+    /// \brief The number of block levels with at least one complete block
+    Index m_levels;
+
+    /// \brief Value subtracted from all observations in the blocking statistics
+    Eigen::VectorXd m_shift;
+
+    /// \brief m_block_sum[k][j*cols() + c]: sum of (block mean - m_shift(c)), for blocks [0, j) at level k
+    ///
+    /// - Only the first m_levels levels are in use; levels beyond are kept, after
+    ///   clear(), to reuse their space
+    std::vector<std::vector<double> > m_block_sum;
+
+    /// \brief m_block_sqsum[k][j*cols() + c]: sum of (block mean - m_shift(c))^2, for blocks [0, j) at level k
+    std::vector<std::vector<double> > m_block_sqsum;
+
+  };
+
+  /// \brief MCData stores observations of a property
+  ///
+  /// - Either owns a single column MCDataStore, or is a view of one column of
+  ///   an MCDataStore owned elsewhere, that stores several properties that are
+  ///   observed together
+  /// - The owner of a viewed MCDataStore must outlive the view
+  /// - Copies always own their observations: copying a view copies the
+  ///   observations of its column into a new single column MCDataStore
+  class MCData {
+
+  public:
+
+    typedef MCDataStore::size_type size_type;
+
+    /// \brief Default constructor
+    MCData() :
+      MCData(1) {}
+
+    /// \brief Constructor with initial buffer size 'count'
+    MCData(size_type count) :
+      m_owned(new MCDataStore(1, count)),
+      m_store(m_owned.get()),
+      m_col(0) {}
+
+    /// \brief View column 'col' of 'store'
+    MCData(MCDataStore &store, Index col) :
+      m_store(&store),
+      m_col(col) {}
+
+    /// \brief Copy the observations
+    MCData(const MCData &other) :
+      m_col(0) {
+      if(other.m_owned) {
+        m_owned.reset(new MCDataStore(*other.m_owned));
+      }
+      else {
+        m_owned.reset(new MCDataStore(1, other.m_store->capacity()));
+        auto obs = other.observations();
+        for(size_type i = 0; i < other.size(); ++i) {
+          double value = obs(i);
+          m_owned->push_back(&value);
+        }
+      }
+      m_store = m_owned.get();
+    }
+
+    /// \brief Move the observations, or the view
+    ///
+    /// - 'other' is left empty, and may only be assigned to or destroyed
+    MCData(MCData &&other) noexcept :
+      m_owned(std::move(other.m_owned)),
+      m_store(other.m_store),
+      m_col(other.m_col) {
+      other.m_store = nullptr;
+    }
+
+    MCData &operator=(const MCData &other) {
+      return *this = MCData(other);
+    }
+
+    MCData &operator=(MCData &&other) noexcept {
+      if(this == &other) {
+        return *this;
+      }
+      m_owned = std::move(other.m_owned);
+      m_store = other.m_store;
+      m_col = other.m_col;
+      other.m_store = nullptr;
+      return *this;
+    }
+
+    /// \brief Forget all the observed values (does not resize reserved space)
+    ///
+    /// - Forgets the observations of all properties in the MCDataStore
+    void clear() {
+      m_store->clear();
+    }
+
+    /// \brief Add an observation
+    ///
+    /// - Only allowed if the MCDataStore holds a single property. Otherwise,
+    ///   add observations with MCDataStore::push_back.
+    void push_back(double value) {
+      if(m_store->cols() != 1) {
+        throw std::runtime_error(
+          "Error in MCData::push_back: observations of shared MCDataStore must be added together");
+      }
+      m_store->push_back(&value);
+    }
+
+    /// \brief Return all observations
+    MCDataStore::ObservationsType observations() const {
+      return m_store->observations(m_col);
+    }
+
+    /// \brief Number of observations
+    size_type size() const {
+      return m_store->size();
+    }
+
+    /// \brief Number of block levels with at least one complete block
+    Index block_levels() const {
+      return m_store->block_levels();
+    }
+
+    /// \brief Value subtracted from all observations in the blocking statistics
+    double shift() const {
+      return m_store->shift(m_col);
+    }
+
+    /// \brief Sum of (block mean - shift()), for blocks [0, j) at level k
+    double block_sum(Index k, size_type j) const {
+      return m_store->block_sum(k, j, m_col);
+    }
+
+    /// \brief Sum of (block mean - shift())^2, for blocks [0, j) at level k
+    double block_sqsum(Index k, size_type j) const {
+      return m_store->block_sqsum(k, j, m_col);
+    }
+
+
+  private:
+
+    /// \brief Holds the observations, if not a view
+    std::unique_ptr<MCDataStore> m_owned;
+
+    /// \brief Holds the observations: either m_owned, or the viewed MCDataStore
+    MCDataStore *m_store;
+
+    /// \brief Column of m_store with the observations of this property
+    Index m_col;
+
   };
 
   /// \brief Checks if a range of observations have equilibrated
@@ -104,8 +362,8 @@ namespace CASM {
     /// \brief Default constructor
     MCDataConvergence() {}
 
-    /// \brief Construct a MCDataConvergence object
-    MCDataConvergence(const Eigen::VectorXd &observations, double conf);
+    /// \brief Check convergence of the observations in range [start, data.size())
+    MCDataConvergence(const MCData &data, size_type start, double conf);
 
     /// \brief Returns true if converged to the requested level
     ///
@@ -113,7 +371,7 @@ namespace CASM {
     ///
     /// \returns true if Var(<X>) <= pow(prec/(sqrt(2.0)*inv_erf(1.0-conf)), 2.0)
     ///
-    /// \seealso MCDataConvergence(const Eigen::VectorXd& observations, double conf)
+    /// \seealso MCDataConvergence(const MCData &data, size_type start, double conf)
     ///
     bool is_converged(double prec) const {
       return m_calculated_prec <= prec;
@@ -142,9 +400,6 @@ namespace CASM {
 
   private:
 
-    /// \brief Try to find rho = pow(2.0, -1.0/i), using min i such that CoVar[i]/CoVar[0] <= 0.5
-    std::tuple<bool, double, double> _calc_rho(const Eigen::VectorXd &observations);
-
     bool m_is_converged;
     double m_mean;
     double m_squared_norm;
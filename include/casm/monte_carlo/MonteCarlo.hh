@@ -1,6 +1,7 @@
 #ifndef CASM_MonteCarlo_HH
 #define CASM_MonteCarlo_HH
 
+#include <iosfwd>
 #include <vector>
 #include "casm/misc/cloneable_ptr.hh"
 #include "casm/external/MersenneTwister/MersenneTwister.h"
@@ -11,6 +12,8 @@
 #include "casm/monte_carlo/MonteSettings.hh"
 #include "casm/monte_carlo/MonteSampler.hh"
 #include "casm/monte_carlo/MonteCounter.hh"
+#include "casm/monte_carlo/MonteTrajectory.hh"
+#include "casm/monte_carlo/SiteEnergyCache.hh"
 
 namespace CASM {
 
@@ -56,6 +59,11 @@ namespace CASM {
     /// \brief a vector of std::pair(pass, step) indicating when samples were taken
     typedef std::vector<std::pair<MonteCounter::size_type, MonteCounter::size_type> > SampleTimes;
 
+    /// \brief Not copyable or movable: the samplers store their observations in
+    ///        m_sample_store, and m_other_samples points to the samplers
+    MonteCarlo(const MonteCarlo &) = delete;
+    MonteCarlo &operator=(const MonteCarlo &) = delete;
+
 
     // ---- Accessors -----------------------------
 
@@ -97,10 +105,16 @@ namespace CASM {
 
     // ---- Accessors -----------------------------
 
+    /// \brief Seed the random number generator
+    void seed(MTRand::uint32 _seed) {
+      m_twister.seed(_seed);
+    }
+
     /// \brief Set current microstate and clear samplers
     void reset(const ConfigDoF &dof) {
       _configdof() = dof;
       clear_samples();
+      m_site_energy_cache.clear();
     }
 
 
@@ -135,6 +149,13 @@ namespace CASM {
     /// \brief Clear all data from all samplers
     void clear_samples();
 
+    /// \brief Begin writing snapshots for conditions 'cond_index' to a binary
+    ///        trajectory file, if requested
+    void begin_trajectory(Index cond_index);
+
+    /// \brief Finish writing any binary trajectory file
+    void end_trajectory();
+
     /// \brief Return true if convergence is requested
     bool must_converge() const {
       return m_must_converge;
@@ -172,6 +193,42 @@ namespace CASM {
       return m_debug;
     }
 
+    /// \brief Number of threads to use to calculate correlations over all unit cells
+    Index corr_threads() const {
+      return m_corr_threads;
+    }
+
+    /// \brief const Access the cache of single site energy changes, for analysis
+    ///
+    /// - Disabled unless requested and supported by the Monte Carlo method
+    const Monte::SiteEnergyCache &site_energy_cache() const {
+      return m_site_energy_cache;
+    }
+
+
+    // ---- Checkpoint ----------------
+
+    /// \brief Write sampled data, properties, and random number generator state
+    void write_checkpoint(std::ostream &sout) const;
+
+    /// \brief Restore data written by write_checkpoint
+    void read_checkpoint(std::istream &sin);
+
+
+    // ---- Optional methods ----------
+    //
+    // Derived classes that implement these hide the base class versions
+
+    /// \brief Returns true if steps are performed using 'rejection_free_step'
+    bool is_rejection_free() const {
+      return false;
+    }
+
+    /// \brief Perform up to 'max_steps' steps at once, rejection-free
+    Index rejection_free_step(Index max_steps, bool &accepted) {
+      throw std::runtime_error("Error: rejection-free steps are not implemented for this Monte Carlo method");
+    }
+
 
   protected:
 
@@ -209,6 +266,17 @@ namespace CASM {
       return m_log;
     }
 
+    /// \brief Access the cache of single site energy changes
+    ///
+    /// - This can be used by a const member, because it only stores values
+    ///   that could be recalculated from the current microstate
+    Monte::SiteEnergyCache &_site_energy_cache() const {
+      return m_site_energy_cache;
+    }
+
+    /// \brief Write cache hits, misses, and memory to _log(), if the cache is enabled
+    void _log_site_energy_cache() const;
+
     MTRand &_mtrand() {
       return m_twister;
     }
@@ -270,13 +338,24 @@ namespace CASM {
     /// \brief Random number generator
     MTRand m_twister;
 
+    /// \brief Cache of single site energy changes
+    ///
+    /// - 'mutable' so that const functions, such as the low temperature
+    ///   expansion, may use the cache
+    mutable Monte::SiteEnergyCache m_site_energy_cache;
+
 
     /// \brief Save trajectory?
     bool m_write_trajectory = false;
 
     /// \brief Snapshots of the Monte Carlo simulation, taken by sample_data() if m_write_trajectory is true
+    ///
+    /// - Not used while a binary trajectory is being written (see begin_trajectory)
     std::vector<ConfigDoF> m_trajectory;
 
+    /// \brief Writes snapshots as they are taken, between begin_trajectory and end_trajectory
+    std::unique_ptr<MonteTrajectoryWriter> m_trajectory_writer;
+
     /// \brief True if any Sampler must converge
     bool m_must_converge;
 
@@ -286,6 +365,21 @@ namespace CASM {
     /// \brief Set the next time convergence is due to be checked
     void _set_check_convergence_time() const;
 
+    /// \brief Attach all samplers to columns of m_sample_store, and group them
+    ///        by the MonteCarlo property they sample
+    void _init_sample_store(size_type data_initsize);
+
+    /// \brief Samplers that sample elements of one MonteCarlo property
+    struct PropertySamples {
+
+      std::string property;
+
+      bool is_vector;
+
+      /// \brief pair(element index, m_sample_store column) for each sampler
+      std::vector<std::pair<Index, Index> > element_col;
+    };
+
     /// \brief a map of pair<keyname, index> to MonteSampler
     ///
     /// - scalar example: m_sampler[std::make_pair("formation_energy", 0)]
@@ -296,6 +390,20 @@ namespace CASM {
     /// \brief a vector of std::pair(pass, step) indicating when samples were taken
     SampleTimes m_sample_time;
 
+    /// \brief Observations of all samplers, one column per sampler, in m_sampler order
+    std::unique_ptr<MCDataStore> m_sample_store;
+
+    /// \brief The values sampled by sample_data, in m_sample_store column order
+    Eigen::VectorXd m_sample_row;
+
+    /// \brief Samplers copied directly from MonteCarlo properties, grouped by property
+    std::vector<PropertySamples> m_property_samples;
+
+    /// \brief Samplers that must be evaluated individually, and their m_sample_store column
+    ///
+    /// - Points to samplers owned by m_sampler
+    std::vector<std::pair<MonteSampler *, Index> > m_other_samples;
+
 
     // Members to remember results of is_equilibrated and is_converged
 
@@ -311,6 +419,9 @@ namespace CASM {
     // in debug mode, allow printing or checking extra things
     bool m_debug;
 
+    // number of threads to use to calculate correlations over all unit cells
+    Index m_corr_threads;
+
   };
 
   /// \brief Construct with a starting ConfigDoF as specified the given MonteSettings and prepare data samplers
@@ -323,9 +434,11 @@ namespace CASM {
     m_configdof(m_config.configdof()),
     m_write_trajectory(settings.write_trajectory()),
     m_log(_log),
-    m_debug(m_settings.debug()) {
+    m_debug(m_settings.debug()),
+    m_corr_threads(m_settings.corr_threads()) {
 
     settings.samplers(primclex, std::inserter(m_sampler, m_sampler.begin()));
+    _init_sample_store(settings.max_data_length());
 
     m_must_converge = false;
     for(auto it = m_sampler.cbegin(); it != m_sampler.cend(); ++it) {
@@ -0,0 +1,169 @@
+#ifndef CASM_MonteCheckpoint_HH
+#define CASM_MonteCheckpoint_HH
+
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+#include "casm/container/Array.hh"
+#include "casm/monte_carlo/SumTree.hh"
+
+namespace CASM {
+
+  /// \brief Binary read/write of Monte Carlo checkpoint data
+  ///
+  /// - Checkpoints are only for restarting a calculation on the same kind of
+  ///   machine, so values are written in native byte order and size
+  /// - Every read checks the stream, so a truncated checkpoint raises an exception
+  ///
+  namespace checkpoint {
+
+    /// \brief Write an arithmetic value
+    template<typename T>
+    void write(std::ostream &sout, const T &value) {
+      static_assert(std::is_arithmetic<T>::value, "checkpoint::write requires an arithmetic type");
+      sout.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    /// \brief Read an arithmetic value
+    template<typename T>
+    void read(std::istream &sin, T &value) {
+      static_assert(std::is_arithmetic<T>::value, "checkpoint::read requires an arithmetic type");
+      sin.read(reinterpret_cast<char *>(&value), sizeof(T));
+      if(!sin) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: unexpected end of file");
+      }
+    }
+
+    /// \brief Write a string, preceded by its length
+    inline void write(std::ostream &sout, const std::string &value) {
+      write(sout, Index(value.size()));
+      sout.write(value.data(), value.size());
+    }
+
+    /// \brief Read a string, preceded by its length
+    inline void read(std::istream &sin, std::string &value) {
+      Index size;
+      read(sin, size);
+      value.resize(size);
+      sin.read(&value[0], size);
+      if(!sin) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: unexpected end of file");
+      }
+    }
+
+    /// \brief Write a std::vector of arithmetic values, preceded by its size
+    template<typename T>
+    void write(std::ostream &sout, const std::vector<T> &value) {
+      write(sout, Index(value.size()));
+      for(const auto &v : value) {
+        write(sout, v);
+      }
+    }
+
+    /// \brief Read a std::vector of arithmetic values, preceded by its size
+    template<typename T>
+    void read(std::istream &sin, std::vector<T> &value) {
+      Index size;
+      read(sin, size);
+      value.resize(size);
+      for(auto &v : value) {
+        read(sin, v);
+      }
+    }
+
+    /// \brief Write an Array of arithmetic values, preceded by its size
+    template<typename T>
+    void write(std::ostream &sout, const Array<T> &value) {
+      write(sout, Index(value.size()));
+      for(Index i = 0; i < value.size(); ++i) {
+        write(sout, value[i]);
+      }
+    }
+
+    /// \brief Read an Array of arithmetic values, preceded by its size
+    template<typename T>
+    void read(std::istream &sin, Array<T> &value) {
+      Index size;
+      read(sin, size);
+      value.resize(size);
+      for(Index i = 0; i < value.size(); ++i) {
+        read(sin, value[i]);
+      }
+    }
+
+    /// \brief Write an Eigen matrix of doubles, preceded by its dimensions
+    inline void write(std::ostream &sout, const Eigen::MatrixXd &value) {
+      write(sout, Index(value.rows()));
+      write(sout, Index(value.cols()));
+      sout.write(reinterpret_cast<const char *>(value.data()), sizeof(double) * value.size());
+    }
+
+    /// \brief Read an Eigen matrix of doubles, preceded by its dimensions
+    inline void read(std::istream &sin, Eigen::MatrixXd &value) {
+      Index rows, cols;
+      read(sin, rows);
+      read(sin, cols);
+      value.resize(rows, cols);
+      sin.read(reinterpret_cast<char *>(value.data()), sizeof(double) * value.size());
+      if(!sin) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: unexpected end of file");
+      }
+    }
+
+    /// \brief Write an Eigen vector of doubles, preceded by its size
+    inline void write(std::ostream &sout, const Eigen::VectorXd &value) {
+      write(sout, Eigen::MatrixXd(value));
+    }
+
+    /// \brief Read an Eigen vector of doubles, preceded by its size
+    inline void read(std::istream &sin, Eigen::VectorXd &value) {
+      Eigen::MatrixXd tmp;
+      read(sin, tmp);
+      if(tmp.cols() != 1) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: expected a vector");
+      }
+      value = tmp.col(0);
+    }
+
+    /// \brief Write a Monte::SumTree, as its values
+    inline void write(std::ostream &sout, const Monte::SumTree &value) {
+      write(sout, value.size());
+      for(Index i = 0; i < value.size(); ++i) {
+        write(sout, value.value(i));
+      }
+    }
+
+    /// \brief Read a Monte::SumTree, written as its values
+    ///
+    /// - Partial sums are recalculated from the values, which reproduces them
+    ///   exactly, as every SumTree::set does
+    inline void read(std::istream &sin, Monte::SumTree &value) {
+      Index size;
+      read(sin, size);
+      value.resize(size);
+      double v;
+      for(Index i = 0; i < size; ++i) {
+        read(sin, v);
+        value.set(i, v);
+      }
+    }
+
+    /// \brief Read a value and check that it equals 'expected'
+    template<typename T>
+    void check(std::istream &sin, const T &expected, const std::string &what) {
+      T value;
+      read(sin, value);
+      if(value != expected) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: " + what + " does not match");
+      }
+    }
+
+  }
+
+}
+
+#endif
@@ -65,6 +65,15 @@ namespace CASM {
     /// \brief Postfix increment step and updates pass
     MonteCounter operator++(int);
 
+    /// \brief Increment by a full pass, for methods that attempt every step of a pass at once
+    MonteCounter &increment_pass();
+
+    /// \brief Maximum number of steps that may be taken at once using 'increment'
+    size_type max_increment() const;
+
+    /// \brief Increment by 'n' steps, for methods that perform many steps at once
+    MonteCounter &increment(size_type n);
+
 
     /// \brief Check if requested number of pass, step, or samples has been met
     bool is_complete() const;
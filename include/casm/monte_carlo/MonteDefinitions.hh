@@ -10,7 +10,8 @@ namespace CASM {
     /// \brief Monte Carlo ensemble type
     enum class ENSEMBLE {
       GrandCanonical,
-      Canonical
+      Canonical,
+      ChargeNeutralGrandCanonical
     };
 
     ENUM_IO(CASM::Monte::ENSEMBLE)
@@ -18,7 +19,7 @@ namespace CASM {
 
     /// \brief Monte Carlo method type
     enum class METHOD {
-      Metropolis, LTE1
+      Metropolis, LTE1, ReplicaExchange, KMC, WangLandau
     };
 
     ENUM_IO(CASM::Monte::METHOD)
@@ -34,7 +35,7 @@ namespace CASM {
 
     ///How to change conditions
     enum class DRIVE_MODE {
-      INCREMENTAL, CUSTOM
+      INCREMENTAL, CUSTOM, ADAPTIVE
     };
 
     ENUM_IO(CASM::Monte::DRIVE_MODE)
@@ -1,10 +1,19 @@
 #ifndef CASM_MonteDriver_HH
 #define CASM_MonteDriver_HH
 
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include "casm/external/boost.hh"
 
-#include "casm/monte_carlo/MonteIO.hh"
+#include "casm/casm_io/SafeOfstream.hh"
+#include "casm/monte_carlo/MonteIO_impl.hh"
+#include "casm/monte_carlo/MonteCheckpoint.hh"
 #include "casm/monte_carlo/MonteCarlo.hh"
 #include "casm/monte_carlo/MonteCarloEnum_impl.hh"
 #include "casm/monte_carlo/MonteSettings.hh"
@@ -20,6 +29,21 @@ namespace CASM {
    * The different kinds of drive modes the user can specify are:
    * INCREMENTAL:   Given a delta in condition values, increment the conditions by the delta after each point
    * CUSTOM:        Calculate for a list of condition values
+   * ADAPTIVE:      As INCREMENTAL, but if results change too much between adjacent conditions,
+   *                calculate conditions half way between them, down to a minimum step
+   *
+   * If runs are not dependent, and "driver"/"threads" > 1, conditions are calculated
+   * at the same time by a pool of threads, each with its own specialized MonteCarlo
+   * object (including its random number generator) and log. The results summary is
+   * written in order of conditions, as soon as all preceding conditions are finished.
+   *
+   * If "driver"/"seed" is given, the random number generator is seeded with
+   * "seed" + i before calculating conditions i, so that results are the same
+   * whether conditions are calculated one at a time or concurrently.
+   *
+   * If "data"/"storage"/"checkpoint_period" > 0, a checkpoint of each run is written
+   * periodically to "conditions.i/checkpoint.bin", and a restarted calculation
+   * continues from the checkpoint as if it had not stopped.
    */
 
   template<typename RunType>
@@ -45,12 +69,45 @@ namespace CASM {
     ///Return the appropriate std::vector of conditions to visit based from settings. Use for construction.
     std::vector<CondType> make_conditions_list(const PrimClex &primclex, const SettingsType &settings);
 
-    ///Converge the MonteCarlo for conditions 'cond_index'
-    void single_run(Index cond_index);
+    ///Converge the MonteCarlo 'mc' for conditions 'cond_index', and write the final state
+    void single_run(RunType &mc, Log &log, Index cond_index);
+
+    ///Set the initial state for the first conditions, and perform any first run equilibration passes
+    void _first_run_state();
+
+    ///Run conditions chosen by the adaptive drive mode, starting with 'start_i'
+    void _run_adaptive(Index start_i);
+
+    ///Conditions at 'param' increments from the initial conditions
+    CondType _adaptive_conditions(double param) const;
+
+    ///Choose the next conditions for the adaptive drive mode
+    bool _adaptive_next(double &param, Index &prev) const;
+
+    ///Results summary properties used to decide where to refine
+    std::map<std::string, double> _adaptive_values(const RunType &mc) const;
+
+    ///Read "adaptive.json", and construct the list of conditions already chosen
+    void _adaptive_read();
+
+    ///Write "adaptive.json"
+    void _adaptive_write() const;
+
+    ///Run all conditions, starting with 'start_i', using a pool of threads
+    void _run_concurrent(PrimClex &primclex, Index start_i);
+
+    ///Seed the random number generator of 'mc' for conditions 'cond_index', if "driver"/"seed" is given
+    void _seed(RunType &mc, Index cond_index) const;
 
     ///Check for existing calculations to find starting conditions
     Index _find_starting_conditions() const;
 
+    ///Write a checkpoint of the run of 'mc' for conditions 'cond_index'
+    void _write_checkpoint(const RunType &mc, const MonteCounter &counter, Index cond_index, Log &log) const;
+
+    ///Restore 'mc', 'counter', and the enumeration hall of fame from a checkpoint
+    void _read_checkpoint(RunType &mc, MonteCounter &counter, Index cond_index, Log &log);
+
 
     /// target for log messages
     Log &m_log;
@@ -67,24 +124,49 @@ namespace CASM {
     ///Specifies how to build the conditions list from the settings
     const Monte::DRIVE_MODE m_drive_mode;
 
+    /// PrimClex, for constructing additional MonteCarlo objects
+    PrimClex &m_primclex;
+
     ///Specialized Monte Carlo object to use throughout
     RunType m_mc;
 
     ///List of specialized conditions to visit in sequential order. Does not include initial conditions.
-    const std::vector<CondType> m_conditions_list;
+    ///For the adaptive drive mode, conditions are added as they are chosen.
+    std::vector<CondType> m_conditions_list;
 
     /// run in debug mode?
     bool m_debug;
 
     /// Enumerated configurations encountered during Monte Carlo calculations
     notstd::cloneable_ptr<MonteCarloEnum> m_enum;
+
+    /// Setting the state is done one thread at a time, because it may use PrimClex
+    std::mutex m_set_state_mutex;
+
+    /// Adaptive drive mode: number of increments from the initial conditions, for each conditions.i
+    std::vector<double> m_adaptive_param;
+
+    /// Adaptive drive mode: results summary properties, for each conditions.i
+    std::vector<std::map<std::string, double> > m_adaptive_value;
   };
 
 
+  /// Construct the list of conditions to visit, as specified by the settings
+  template<typename RunType>
+  std::vector<typename RunType::CondType> make_conditions_list(
+    const PrimClex &primclex,
+    const typename RunType::SettingsType &settings,
+    const MonteCarloDirectoryStructure &dir,
+    Log &err_log);
+
   /// Perform a single monte carlo step, return true if accepted
   template<typename RunType>
   bool monte_carlo_step(RunType &monte_run);
 
+  /// Perform a single monte carlo step, parallel sweep, or rejection-free steps, and increment the counter
+  template<typename RunType>
+  bool monte_carlo_step(RunType &monte_run, MonteCounter &counter);
+
 
   template<typename RunType>
   MonteDriver<RunType>::MonteDriver(PrimClex &primclex, const SettingsType &settings, Log &_log, Log &_err_log):
@@ -93,10 +175,15 @@ namespace CASM {
     m_settings(settings),
     m_dir(m_settings.output_directory()),
     m_drive_mode(m_settings.drive_mode()),
+    m_primclex(primclex),
     m_mc(primclex, m_settings, _log),
     m_conditions_list(make_conditions_list(primclex, m_settings)),
     m_debug(m_settings.debug()),
     m_enum(m_settings.is_enumeration() ? new MonteCarloEnum(primclex, settings, _log, m_mc) : nullptr) {
+
+    if(m_drive_mode == Monte::DRIVE_MODE::ADAPTIVE) {
+      _adaptive_read();
+    }
   }
 
   /// \brief Run calculations for all conditions, outputting data as you finish each one
@@ -106,6 +193,8 @@ namespace CASM {
   ///   and that no other results are written to the results summary.
   /// - If there are existing results, uses "output_dir/conditions.i/final_state.json" as
   ///   the initial state for the next run
+  /// - For dependent runs, if the next run has a checkpoint, it is resumed from the
+  ///   checkpoint without setting the initial state or equilibrating first
   template<typename RunType>
   void MonteDriver<RunType>::run() {
 
@@ -129,7 +218,7 @@ namespace CASM {
       }
     }
 
-    if(start_i == m_conditions_list.size()) {
+    if(start_i == m_conditions_list.size() && m_drive_mode != Monte::DRIVE_MODE::ADAPTIVE) {
       m_log << "calculations already complete." << std::endl;
       return;
     }
@@ -151,35 +240,34 @@ namespace CASM {
     }
     m_log << std::endl;
 
-    if(m_settings.dependent_runs()) {
-
-      // if starting from initial condition
-      if(start_i == 0) {
-
-        // set intial state
-        m_mc.set_state(m_conditions_list[0], m_settings);
-
-        // perform any requested explicit equilibration passes
-        if(m_settings.dependent_runs() && m_settings.is_equilibration_passes_first_run()) {
-
-          auto equil_passes = m_settings.equilibration_passes_first_run();
+    if(m_drive_mode == Monte::DRIVE_MODE::ADAPTIVE) {
+      if(!m_settings.dependent_runs() && m_settings.threads() > 1) {
+        m_log << "adaptive drive mode, conditions will be calculated one at a time\n" << std::endl;
+      }
+      _run_adaptive(start_i);
+      return;
+    }
 
-          m_log.write("DoF");
-          m_log << "write: " << m_dir.initial_state_firstruneq_json(0) << "\n" << std::endl;
+    if(!m_settings.dependent_runs() && m_settings.threads() > 1) {
+      if(m_enum) {
+        m_log << "enumeration is requested, conditions will be calculated one at a time\n" << std::endl;
+      }
+      else {
+        _run_concurrent(m_primclex, start_i);
+        return;
+      }
+    }
 
-          jsonParser json;
-          fs::create_directories(m_dir.conditions_dir(0));
-          to_json(m_mc.configdof(), json).write(m_dir.initial_state_firstruneq_json(0));
+    if(m_settings.dependent_runs()) {
 
-          m_log.begin("Equilibration passes");
-          m_log << equil_passes << " equilibration passes\n" << std::endl;
+      _seed(m_mc, start_i);
 
-          MonteCounter equil_counter(m_settings, m_mc.steps_per_pass());
-          while(equil_counter.pass() != equil_passes) {
-            monte_carlo_step(m_mc);
-            equil_counter++;
-          }
-        }
+      if(fs::exists(m_dir.checkpoint_bin(start_i))) {
+        // the state is restored from the checkpoint by single_run
+      }
+      // if starting from initial condition
+      else if(start_i == 0) {
+        _first_run_state();
       }
       else {
 
@@ -197,17 +285,28 @@ namespace CASM {
     // Run for all conditions, outputting data as you finish each one
     for(Index i = start_i; i < m_conditions_list.size(); i++) {
       if(!m_settings.dependent_runs()) {
+        _seed(m_mc, i);
         m_mc.set_state(m_conditions_list[i], m_settings);
       }
       else if(i != start_i) {
 
+        _seed(m_mc, i);
         m_mc.set_conditions(m_conditions_list[i]);
 
         m_log.custom("Continue with existing DoF");
         m_log << std::endl;
       }
 
-      single_run(i);
+      single_run(m_mc, m_log, i);
+
+      m_log.write("Output files");
+      m_mc.write_results(i);
+      m_log << std::endl;
+
+      if(m_enum) {
+        m_enum->save_configs();
+      }
+      fs::remove(m_dir.checkpoint_bin(i));
 
       m_log << std::endl;
     }
@@ -215,6 +314,403 @@ namespace CASM {
     return;
   }
 
+  /// \brief Run all conditions, starting with 'start_i', using a pool of threads
+  ///
+  /// - Each thread has its own RunType, constructed here, and its own log, which is
+  ///   copied to the driver log after each condition is finished
+  /// - Setting the state is done one thread at a time, because it may use PrimClex
+  /// - Output for "conditions.i" is written by RunType::write_conditions_results as
+  ///   each condition is finished, and the results summary is appended in order of
+  ///   conditions, so that a stopped calculation can be restarted by
+  ///   '_find_starting_conditions'
+  /// - A checkpoint is kept until the results summary for its conditions is written
+  template<typename RunType>
+  void MonteDriver<RunType>::_run_concurrent(PrimClex &primclex, Index start_i) {
+
+    Index n_threads = std::min<Index>(m_settings.threads(), m_conditions_list.size() - start_i);
+
+    m_log.custom("Concurrent calculations");
+    m_log << "threads: " << n_threads << "\n" << std::endl;
+
+    std::vector<std::unique_ptr<OStringStreamLog> > log;
+    std::vector<std::unique_ptr<RunType> > mc;
+    for(Index t = 0; t < n_threads; ++t) {
+      log.emplace_back(new OStringStreamLog(m_log.verbosity()));
+      mc.emplace_back(new RunType(primclex, m_settings, *log.back()));
+    }
+
+    // protects everything shared below, and the driver log
+    std::mutex mutex;
+    Index next_i = start_i;
+    Index next_results = start_i;
+    std::map<Index, MonteResultsSummary> pending;
+    bool failed = false;
+    std::vector<std::exception_ptr> error(n_threads);
+
+    auto flush_log = [&](Index t) {
+      m_log.require<Log::none>() << log[t]->ss().str() << std::flush;
+      log[t]->ss().str("");
+    };
+
+    auto worker = [&](Index t) {
+
+      try {
+
+        while(true) {
+
+          Index i;
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(failed || next_i == m_conditions_list.size()) {
+              return;
+            }
+            i = next_i++;
+            std::lock_guard<std::mutex> state_lock(m_set_state_mutex);
+            _seed(*mc[t], i);
+            mc[t]->set_state(m_conditions_list[i], m_settings);
+          }
+
+          single_run(*mc[t], *log[t], i);
+
+          log[t]->write("Output files");
+          mc[t]->write_conditions_results(i);
+          MonteResultsSummary summary = make_results_summary(m_settings, *mc[t]);
+
+          std::lock_guard<std::mutex> lock(mutex);
+          pending[i] = summary;
+          while(pending.size() && pending.begin()->first == next_results) {
+            write_results(m_settings, pending.begin()->second, *log[t]);
+            fs::remove(m_dir.checkpoint_bin(pending.begin()->first));
+            pending.erase(pending.begin());
+            ++next_results;
+          }
+          *log[t] << std::endl;
+          flush_log(t);
+        }
+      }
+      catch(...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error[t] = std::current_exception();
+        failed = true;
+        flush_log(t);
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for(Index t = 0; t < n_threads; ++t) {
+      threads.emplace_back(worker, t);
+    }
+    for(auto &thread : threads) {
+      thread.join();
+    }
+
+    for(Index t = 0; t < n_threads; ++t) {
+      if(error[t]) {
+        std::rethrow_exception(error[t]);
+      }
+    }
+
+    return;
+  }
+
+  /// \brief Set the initial state for the first conditions, and perform any first run equilibration passes
+  template<typename RunType>
+  void MonteDriver<RunType>::_first_run_state() {
+
+    // set intial state
+    m_mc.set_state(m_conditions_list[0], m_settings);
+
+    // perform any requested explicit equilibration passes
+    if(m_settings.dependent_runs() && m_settings.is_equilibration_passes_first_run()) {
+
+      auto equil_passes = m_settings.equilibration_passes_first_run();
+
+      m_log.write("DoF");
+      m_log << "write: " << m_dir.initial_state_firstruneq_json(0) << "\n" << std::endl;
+
+      jsonParser json;
+      fs::create_directories(m_dir.conditions_dir(0));
+      to_json(m_mc.configdof(), json).write(m_dir.initial_state_firstruneq_json(0));
+
+      m_log.begin("Equilibration passes");
+      m_log << equil_passes << " equilibration passes\n" << std::endl;
+
+      MonteCounter equil_counter(m_settings, m_mc.steps_per_pass());
+      while(equil_counter.pass() != equil_passes) {
+        monte_carlo_step(m_mc, equil_counter);
+      }
+    }
+  }
+
+  /// \brief Run conditions chosen by the adaptive drive mode, starting with 'start_i'
+  ///
+  /// - Conditions are numbered in the order they are calculated, so
+  ///   "conditions.i" and the results summary are appended to as for other
+  ///   drive modes, but results are not necessarily in order of conditions
+  /// - The increments from the initial conditions, and the properties used to
+  ///   choose the next conditions, are written to "adaptive.json" after each
+  ///   conditions are finished, so a restarted calculation makes the same choices
+  /// - For dependent runs, each calculation begins with the final state of the
+  ///   adjacent conditions that come before it
+  template<typename RunType>
+  void MonteDriver<RunType>::_run_adaptive(Index start_i) {
+
+    // forget conditions that must be re-calculated
+    m_conditions_list.resize(start_i);
+    m_adaptive_param.resize(start_i);
+    m_adaptive_value.resize(start_i);
+    _adaptive_write();
+
+    jsonParser max_jump = jsonParser::object();
+    for(const auto &jump : m_settings.adaptive_max_jump()) {
+      max_jump[jump.first] = jump.second;
+    }
+    m_log.custom("Adaptive conditions");
+    m_log << "max_refinement: " << m_settings.adaptive_max_refinement() << "\n";
+    m_log << "max_jump: " << max_jump << "\n" << std::endl;
+
+    // index of the conditions whose final state m_mc holds, if any
+    Index curr = -1;
+    double param;
+    Index prev;
+    while(_adaptive_next(param, prev)) {
+
+      Index i = m_conditions_list.size();
+      m_conditions_list.push_back(_adaptive_conditions(param));
+
+      m_log.custom("Adaptive conditions");
+      m_log << "conditions: " << i << "\n";
+      m_log << "increments from initial_conditions: " << param << "\n";
+      if(prev != -1) {
+        m_log << "previous conditions: " << prev << "\n";
+      }
+      m_log << std::endl;
+
+      _seed(m_mc, i);
+      if(!m_settings.dependent_runs()) {
+        m_mc.set_state(m_conditions_list[i], m_settings);
+      }
+      else if(fs::exists(m_dir.checkpoint_bin(i))) {
+        // the state is restored from the checkpoint by single_run
+      }
+      else if(prev == -1) {
+        _first_run_state();
+      }
+      else if(prev == curr) {
+        m_mc.set_conditions(m_conditions_list[i]);
+
+        m_log.custom("Continue with existing DoF");
+        m_log << std::endl;
+      }
+      else {
+
+        // read end state of previous condition
+        ConfigDoF configdof = m_mc.configdof();
+        from_json(configdof, jsonParser(m_dir.final_state_json(prev)));
+
+        m_mc.set_state(
+          m_conditions_list[i],
+          configdof,
+          std::string("Using: ") + m_dir.final_state_json(prev).string());
+      }
+
+      single_run(m_mc, m_log, i);
+
+      m_log.write("Output files");
+      m_mc.write_results(i);
+
+      if(m_enum) {
+        m_enum->save_configs();
+      }
+      fs::remove(m_dir.checkpoint_bin(i));
+
+      m_adaptive_param.push_back(param);
+      m_adaptive_value.push_back(_adaptive_values(m_mc));
+      m_log << "write: " << m_dir.adaptive_json() << "\n" << std::endl;
+      _adaptive_write();
+      curr = i;
+
+      m_log << std::endl;
+    }
+
+    m_log << "calculations complete." << std::endl;
+  }
+
+  /// \brief Conditions at 'param' increments from the initial conditions
+  template<typename RunType>
+  typename MonteDriver<RunType>::CondType MonteDriver<RunType>::_adaptive_conditions(double param) const {
+    return m_settings.initial_conditions() + m_settings.incremental_conditions() * param;
+  }
+
+  /// \brief Choose the next conditions for the adaptive drive mode
+  ///
+  /// \param param Set to the number of increments from the initial conditions
+  /// \param prev Set to the index of the calculated conditions that come before
+  ///        the next conditions, or -1 for the initial conditions
+  ///
+  /// \returns false if there are no more conditions to calculate
+  ///
+  /// - If the change in any "max_jump" property between adjacent calculated
+  ///   conditions is too large, and they are at least twice the minimum step
+  ///   apart, chooses the conditions half way between them
+  /// - Else, chooses the next incremental conditions after the last calculated
+  ///   conditions, until the final conditions are calculated
+  /// - Only depends on the conditions already calculated, so a restarted
+  ///   calculation continues the same way
+  template<typename RunType>
+  bool MonteDriver<RunType>::_adaptive_next(double &param, Index &prev) const {
+
+    if(m_adaptive_param.empty()) {
+      param = 0.0;
+      prev = -1;
+      return true;
+    }
+
+    // calculated conditions, in order of increments
+    std::vector<Index> order(m_adaptive_param.size());
+    for(Index i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](Index a, Index b) {
+      return m_adaptive_param[a] < m_adaptive_param[b];
+    });
+
+    double min_step = std::ldexp(1.0, -int(m_settings.adaptive_max_refinement()));
+    auto max_jump = m_settings.adaptive_max_jump();
+
+    for(Index k = 0; k + 1 < order.size(); ++k) {
+      Index a = order[k];
+      Index b = order[k + 1];
+      if(m_adaptive_param[b] - m_adaptive_param[a] < 2.0 * min_step - 1e-8) {
+        continue;
+      }
+      for(const auto &jump : max_jump) {
+        double diff = std::abs(m_adaptive_value[b].at(jump.first) - m_adaptive_value[a].at(jump.first));
+        if(diff > jump.second) {
+          param = 0.5 * (m_adaptive_param[a] + m_adaptive_param[b]);
+          prev = a;
+          return true;
+        }
+      }
+    }
+
+    CondType init_cond(m_settings.initial_conditions());
+    CondType final_cond(m_settings.final_conditions());
+    CondType cond_increment(m_settings.incremental_conditions());
+    int num_increments = (final_cond - init_cond) / cond_increment;
+
+    prev = order.back();
+    param = std::floor(m_adaptive_param[prev] + 1e-8) + 1.0;
+    return param < num_increments + 0.5;
+  }
+
+  /// \brief Results summary properties used to decide where to refine
+  ///
+  /// - Properties that could not be evaluated, such as "heat_capacity" before
+  ///   equilibration, are NaN and never compare as too large a change
+  template<typename RunType>
+  std::map<std::string, double> MonteDriver<RunType>::_adaptive_values(const RunType &mc) const {
+
+    jsonParser json = jsonParser::object();
+    make_results_formatter(mc).to_json_arrays(&mc, json);
+
+    std::map<std::string, double> value;
+    for(const auto &jump : m_settings.adaptive_max_jump()) {
+      if(!json.contains(jump.first)) {
+        throw std::runtime_error(
+          std::string("Error in adaptive drive mode: \"max_jump\" property \"") + jump.first +
+          "\" is not in the results summary.");
+      }
+      const jsonParser &col = json[jump.first];
+      value[jump.first] = (col.size() && col[0].is_number()) ?
+                          col[0].get<double>() : std::numeric_limits<double>::quiet_NaN();
+    }
+    return value;
+  }
+
+  /// \brief Read "adaptive.json", and construct the list of conditions already chosen
+  ///
+  /// - Checks that the conditions of any existing calculations agree, and
+  ///   throws if not
+  template<typename RunType>
+  void MonteDriver<RunType>::_adaptive_read() {
+
+    if(!fs::exists(m_dir.adaptive_json())) {
+      return;
+    }
+
+    jsonParser json(m_dir.adaptive_json());
+    const jsonParser &param = json["param"];
+    const jsonParser &value = json["value"];
+    for(Index i = 0; i < param.size(); ++i) {
+
+      m_adaptive_param.push_back(param[i].get<double>());
+      std::map<std::string, double> v;
+      for(const auto &jump : m_settings.adaptive_max_jump()) {
+        v[jump.first] = value.contains(jump.first) && value[jump.first][i].is_number() ?
+                        value[jump.first][i].template get<double>() : std::numeric_limits<double>::quiet_NaN();
+      }
+      m_adaptive_value.push_back(v);
+      m_conditions_list.push_back(_adaptive_conditions(m_adaptive_param.back()));
+
+      if(fs::exists(m_dir.conditions_json(i))) {
+        CondType existing;
+        jsonParser cond_json(m_dir.conditions_json(i));
+        from_json(existing, m_primclex, cond_json);
+        if(existing != m_conditions_list[i]) {
+          m_err_log.error("Conditions mismatch");
+          m_err_log << "existing conditions: " << m_dir.conditions_json(i) << "\n";
+          m_err_log << existing << "\n";
+          m_err_log << "adaptive conditions " << i << ":\n";
+          m_err_log << m_conditions_list[i] << "\n" << std::endl;
+          throw std::runtime_error("ERROR: initial_conditions or incremental_conditions has changed.");
+        }
+      }
+    }
+  }
+
+  /// \brief Write "adaptive.json"
+  ///
+  /// Format:
+  /// \code
+  /// {
+  ///   "param": [<increments from initial_conditions>, ...],
+  ///   "value": {"<property>": [<value>, ...], ...}
+  /// }
+  /// \endcode
+  /// with one element per "conditions.i". Values that could not be evaluated
+  /// are null.
+  template<typename RunType>
+  void MonteDriver<RunType>::_adaptive_write() const {
+
+    jsonParser json = jsonParser::object();
+    json["param"] = m_adaptive_param;
+    jsonParser &value = json["value"].put_obj();
+    for(const auto &jump : m_settings.adaptive_max_jump()) {
+      jsonParser &col = value[jump.first].put_array();
+      for(const auto &v : m_adaptive_value) {
+        double x = v.at(jump.first);
+        if(std::isnan(x)) {
+          col.push_back(jsonParser::null());
+        }
+        else {
+          col.push_back(x);
+        }
+      }
+    }
+
+    fs::create_directories(m_dir.output_dir());
+    json.write(m_dir.adaptive_json());
+  }
+
+  /// \brief Seed the random number generator of 'mc' for conditions 'cond_index', if "driver"/"seed" is given
+  template<typename RunType>
+  void MonteDriver<RunType>::_seed(RunType &mc, Index cond_index) const {
+    if(m_settings.is_seed()) {
+      mc.seed(m_settings.seed() + cond_index);
+    }
+  }
+
   /// \brief Checks existing files to determine where to restart a path
   ///
   /// - Will overwrite or cause to overwrite files in cases where the
@@ -240,7 +736,7 @@ namespace CASM {
       json_results.read(m_dir.results_json());
 
       // can start with i+1 if results[i] and final_state.json (i) exist
-      while(json_results.begin()->size() > start_json && fs::exists(m_dir.final_state_json(start_i)) && start_i < start_max) {
+      while(json_results.begin()->size() > start_json && fs::exists(m_dir.final_state_json(start_json)) && start_json < start_max) {
         ++start_json;
       }
 
@@ -257,7 +753,7 @@ namespace CASM {
       ss << str << "\n";
 
       // can start with i+1 if results[i] and final_state.json (i) exist
-      while(!csv_results.eof() && fs::exists(m_dir.final_state_json(start_csv)) && start_i < start_max) {
+      while(!csv_results.eof() && fs::exists(m_dir.final_state_json(start_csv)) && start_csv < start_max) {
         ++start_csv;
         std::getline(csv_results, str);
         ss << str << "\n";
@@ -299,58 +795,181 @@ namespace CASM {
     return start_i;
   }
 
+  /// \brief Write a checkpoint of the run of 'mc' for conditions 'cond_index'
+  ///
+  /// Writes "conditions.cond_index/checkpoint.bin", atomically, containing:
+  /// - the MonteCounter pass, step, and number of samples
+  /// - the current occupation
+  /// - MonteCarlo data written by RunType::write_checkpoint (sampled data,
+  ///   sample times, random number generator state, and the state of the
+  ///   method, such as the order of occupants used to propose events and any
+  ///   preselected rejection-free or kinetic Monte Carlo event)
+  /// - the supercell and occupation of each hall of fame configuration
+  ///
+  /// Checkpoints are written in native byte order, and are only meant to
+  /// restart a calculation on the same kind of machine.
+  template<typename RunType>
+  void MonteDriver<RunType>::_write_checkpoint(const RunType &mc, const MonteCounter &counter, Index cond_index, Log &log) const {
+
+    fs::path path = m_dir.checkpoint_bin(cond_index);
+
+    log.custom<Log::verbose>("Checkpoint");
+    log << "pass: " << counter.pass() << "  "
+        << "step: " << counter.step() << "  "
+        << "samples: " << counter.samples() << "\n"
+        << "write: " << path << "\n" << std::endl;
+
+    // remove any partial checkpoint left by a run that stopped while writing
+    fs::remove(fs::path(path.string() + ".tmp"));
+
+    SafeOfstream file;
+    file.open(path);
+    std::ostream &sout = file.ofstream();
+
+    checkpoint::write(sout, std::string("CASMCHK2"));
+    checkpoint::write(sout, cond_index);
+    checkpoint::write(sout, counter.pass());
+    checkpoint::write(sout, counter.step());
+    checkpoint::write(sout, counter.samples());
+    checkpoint::write(sout, mc.configdof().occupation());
+
+    mc.write_checkpoint(sout);
+
+    if(!m_enum) {
+      checkpoint::write(sout, Index(0));
+    }
+    else {
+      checkpoint::write(sout, Index(m_enum->halloffame().size()));
+      for(const auto &score_config : m_enum->halloffame()) {
+        const Configuration &config = score_config.second;
+        checkpoint::write(sout, Eigen::MatrixXd(config.get_supercell().get_real_super_lattice().lat_column_mat()));
+        checkpoint::write(sout, config.occupation());
+      }
+    }
+
+    file.close();
+  }
+
+  /// \brief Restore 'mc', 'counter', and the enumeration hall of fame from a checkpoint
+  ///
+  /// - Sets the state of 'mc' to the checkpointed ConfigDoF, at conditions
+  ///   'cond_index', then restores data with RunType::read_checkpoint
+  /// - Hall of fame configurations are re-inserted, so m_enum->reset() should be
+  ///   called first
+  template<typename RunType>
+  void MonteDriver<RunType>::_read_checkpoint(RunType &mc, MonteCounter &counter, Index cond_index, Log &log) {
+
+    fs::path path = m_dir.checkpoint_bin(cond_index);
+    fs::ifstream sin(path, std::ios::in | std::ios::binary);
+    if(!sin) {
+      throw std::runtime_error("Error: could not open " + path.string());
+    }
+
+    checkpoint::check(sin, std::string("CASMCHK2"), path.string() + " file type");
+    checkpoint::check(sin, cond_index, "conditions index");
+
+    MonteCounter::size_type pass, step, samples;
+    checkpoint::read(sin, pass);
+    checkpoint::read(sin, step);
+    checkpoint::read(sin, samples);
+
+    ConfigDoF configdof = mc.configdof();
+    Array<int> occupation;
+    checkpoint::read(sin, occupation);
+    configdof.set_occupation(occupation);
+    {
+      std::lock_guard<std::mutex> state_lock(m_set_state_mutex);
+      mc.set_state(m_conditions_list[cond_index], configdof, std::string("Resume from checkpoint: ") + path.string());
+    }
+
+    mc.read_checkpoint(sin);
+    counter.set(pass, step, samples);
+
+    Index n_halloffame;
+    checkpoint::read(sin, n_halloffame);
+    if(n_halloffame && !m_enum) {
+      throw std::runtime_error("Error: " + path.string() + " includes enumerated configurations, but enumeration is not requested");
+    }
+    Eigen::MatrixXd lat_column_mat;
+    for(Index i = 0; i < n_halloffame; ++i) {
+      checkpoint::read(sin, lat_column_mat);
+      checkpoint::read(sin, occupation);
+      Supercell &scel = m_primclex.get_supercell(Lattice(Eigen::Matrix3d(lat_column_mat)));
+      m_enum->insert(Configuration(scel, jsonParser(), ConfigDoF(occupation)));
+    }
+
+    log.custom("Resume from checkpoint");
+    log << "read: " << path << "\n"
+        << "pass: " << pass << "  "
+        << "step: " << step << "  "
+        << "samples: " << samples << "\n" << std::endl;
+  }
+
+  /// \brief Converge the MonteCarlo 'mc' for conditions 'cond_index', and write the final state
+  ///
+  /// - If "conditions.cond_index/checkpoint.bin" exists, the run continues from
+  ///   the checkpoint, skipping equilibration passes and the initial state
+  /// - If checkpoints are requested, a checkpoint is written after the first
+  ///   sample taken at least 'checkpoint_period' passes after the previous one
   template<typename RunType>
-  void MonteDriver<RunType>::single_run(Index cond_index) {
+  void MonteDriver<RunType>::single_run(RunType &mc, Log &log, Index cond_index) {
 
     fs::create_directories(m_dir.conditions_dir(cond_index));
+    bool resume = fs::exists(m_dir.checkpoint_bin(cond_index));
+    MonteCounter::size_type checkpoint_period = m_settings.checkpoint_period();
+    jsonParser json;
 
     // perform any requested explicit equilibration passes
-    if(m_settings.is_equilibration_passes_each_run()) {
+    if(!resume && m_settings.is_equilibration_passes_each_run()) {
 
-      m_log.write("DoF");
-      m_log << "write: " << m_dir.initial_state_runeq_json(cond_index) << "\n" << std::endl;
+      log.write("DoF");
+      log << "write: " << m_dir.initial_state_runeq_json(cond_index) << "\n" << std::endl;
 
-      jsonParser json;
-      to_json(m_mc.configdof(), json).write(m_dir.initial_state_runeq_json(cond_index));
+      to_json(mc.configdof(), json).write(m_dir.initial_state_runeq_json(cond_index));
       auto equil_passes = m_settings.equilibration_passes_each_run();
 
-      m_log.begin("Equilibration passes");
-      m_log << equil_passes << " equilibration passes\n" << std::endl;
+      log.begin("Equilibration passes");
+      log << equil_passes << " equilibration passes\n" << std::endl;
 
-      MonteCounter equil_counter(m_settings, m_mc.steps_per_pass());
+      MonteCounter equil_counter(m_settings, mc.steps_per_pass());
       while(equil_counter.pass() != equil_passes) {
-        monte_carlo_step(m_mc);
-        equil_counter++;
+        monte_carlo_step(mc, equil_counter);
       }
     }
 
     // initial state (after any equilibriation passes)
-    m_log.write("DoF");
-    m_log << "write: " << m_dir.initial_state_json(cond_index) << "\n" << std::endl;
-    jsonParser json;
-    to_json(m_mc.configdof(), json).write(m_dir.initial_state_json(cond_index));
+    if(!resume) {
+      log.write("DoF");
+      log << "write: " << m_dir.initial_state_json(cond_index) << "\n" << std::endl;
+      to_json(mc.configdof(), json).write(m_dir.initial_state_json(cond_index));
+      mc.begin_trajectory(cond_index);
+    }
 
     std::stringstream ss;
     ss << "Conditions " << cond_index;
-    m_log.begin(ss.str());
-    m_log << std::endl;
-    m_log.begin_lap();
+    log.begin(ss.str());
+    log << std::endl;
+    log.begin_lap();
 
-    MonteCounter run_counter(m_settings, m_mc.steps_per_pass());
+    MonteCounter run_counter(m_settings, mc.steps_per_pass());
     if(m_enum) {
       m_enum->reset();
     };
+    if(resume) {
+      _read_checkpoint(mc, run_counter, cond_index, log);
+    }
+    MonteCounter::size_type next_checkpoint = run_counter.pass() + checkpoint_period;
 
     while(true) {
 
       if(debug()) {
-        m_log.custom<Log::debug>("Counter info");
-        m_log << "pass: " << run_counter.pass() << "  "
+        log.custom<Log::debug>("Counter info");
+        log << "pass: " << run_counter.pass() << "  "
               << "step: " << run_counter.step() << "  "
               << "samples: " << run_counter.samples() << "\n" << std::endl;
       }
 
-      if(m_mc.must_converge()) {
+      if(mc.must_converge()) {
 
         if(!run_counter.minimums_met()) {
 
@@ -364,14 +983,14 @@ namespace CASM {
         }
         else {
 
-          if(m_mc.check_convergence_time()) {
+          if(mc.check_convergence_time()) {
 
-            m_log.require<Log::verbose>() << "\n";
-            m_log.custom<Log::verbose>("Begin convergence checks");
-            m_log << "samples: " << m_mc.sample_times().size() << std::endl;
-            m_log << std::endl;
+            log.require<Log::verbose>() << "\n";
+            log.custom<Log::verbose>("Begin convergence checks");
+            log << "samples: " << mc.sample_times().size() << std::endl;
+            log << std::endl;
 
-            if(m_mc.is_converged()) {
+            if(mc.is_converged()) {
               break;
             }
           }
@@ -386,48 +1005,44 @@ namespace CASM {
         break;
       }
 
-      bool res = monte_carlo_step(m_mc);
+      bool res = monte_carlo_step(mc, run_counter);
 
       if(res && m_enum && m_enum->on_accept()) {
-        m_enum->insert(m_mc.config());
+        m_enum->insert(mc.config());
       }
 
-      run_counter++;
-
       if(run_counter.sample_time()) {
         if(debug()) {
-          m_log.custom<Log::debug>("Sample data");
-          m_log << "pass: " << run_counter.pass() << "  "
+          log.custom<Log::debug>("Sample data");
+          log << "pass: " << run_counter.pass() << "  "
                 << "step: " << run_counter.step() << "  "
-                << "take sample " << m_mc.sample_times().size() << "\n" << std::endl;
+                << "take sample " << mc.sample_times().size() << "\n" << std::endl;
         }
 
-        m_mc.sample_data(run_counter);
+        mc.sample_data(run_counter);
         run_counter.increment_samples();
         if(m_enum && m_enum->on_sample()) {
-          m_enum->insert(m_mc.config());
+          m_enum->insert(mc.config());
+        }
+
+        if(checkpoint_period > 0 && run_counter.pass() >= next_checkpoint) {
+          _write_checkpoint(mc, run_counter, cond_index, log);
+          next_checkpoint = run_counter.pass() + checkpoint_period;
         }
       }
     }
-    m_log << std::endl;
+    log << std::endl;
+    mc.end_trajectory();
 
 
     // timing info:
-    double s = m_log.lap_time();
-    m_log.end(ss.str());
-    m_log << "run time: " << s << " (s),  " << s / run_counter.pass() << " (s/pass),  " << s / (run_counter.pass()*run_counter.steps_per_pass() + run_counter.step()) << "(s/step)\n" << std::endl;
-
-    m_log.write("DoF");
-    m_log << "write: " << m_dir.final_state_json(cond_index) << "\n" << std::endl;
-    to_json(m_mc.configdof(), json).write(m_dir.final_state_json(cond_index));
+    double s = log.lap_time();
+    log.end(ss.str());
+    log << "run time: " << s << " (s),  " << s / run_counter.pass() << " (s/pass),  " << s / (run_counter.pass()*run_counter.steps_per_pass() + run_counter.step()) << "(s/step)\n" << std::endl;
 
-    m_log.write("Output files");
-    m_mc.write_results(cond_index);
-    m_log << std::endl;
-
-    if(m_enum) {
-      m_enum->save_configs();
-    }
+    log.write("DoF");
+    log << "write: " << m_dir.final_state_json(cond_index) << "\n" << std::endl;
+    to_json(mc.configdof(), json).write(m_dir.final_state_json(cond_index));
 
     return;
   }
@@ -447,26 +1062,45 @@ namespace CASM {
   std::vector<typename MonteDriver<RunType>::CondType>
   MonteDriver<RunType>::make_conditions_list(const PrimClex &primclex, const SettingsType &settings) {
 
+    // adaptive conditions are read by _adaptive_read, and chosen as they are calculated
+    if(settings.drive_mode() == Monte::DRIVE_MODE::ADAPTIVE) {
+      return std::vector<CondType>();
+    }
+    return CASM::make_conditions_list<RunType>(primclex, settings, m_dir, m_err_log);
+  }
+
+  /// \brief Construct the list of conditions to visit, as specified by the settings
+  ///
+  /// - Checks that the conditions of any existing calculations in 'dir' agree
+  ///   with the conditions specified by the settings, and throws if not
+  template<typename RunType>
+  std::vector<typename RunType::CondType> make_conditions_list(
+    const PrimClex &primclex,
+    const typename RunType::SettingsType &settings,
+    const MonteCarloDirectoryStructure &dir,
+    Log &err_log) {
+
+    typedef typename RunType::CondType CondType;
     std::vector<CondType> conditions_list;
 
-    switch(m_drive_mode) {
+    switch(settings.drive_mode()) {
 
     case Monte::DRIVE_MODE::CUSTOM: {
 
       // read existing conditions, and check for agreement
       std::vector<CondType> custom_cond(settings.custom_conditions());
       int i = 0;
-      while(fs::exists(m_dir.conditions_json(i))) {
+      while(fs::exists(dir.conditions_json(i))) {
 
         CondType existing;
-        jsonParser json(m_dir.conditions_json(i));
+        jsonParser json(dir.conditions_json(i));
         from_json(existing, primclex, json);
         if(existing != custom_cond[i]) {
-          m_err_log.error("Conditions mismatch");
-          m_err_log << "existing conditions: " << m_dir.conditions_json(i) << "\n";
-          m_err_log << existing << "\n\n";
-          m_err_log << "specified custom conditions " << i << ":\n";
-          m_err_log << custom_cond[i] << "\n" << std::endl;
+          err_log.error("Conditions mismatch");
+          err_log << "existing conditions: " << dir.conditions_json(i) << "\n";
+          err_log << existing << "\n\n";
+          err_log << "specified custom conditions " << i << ":\n";
+          err_log << custom_cond[i] << "\n" << std::endl;
           throw std::runtime_error("ERROR: custom_conditions list has changed.");
         }
         ++i;
@@ -491,17 +1125,17 @@ namespace CASM {
       }
 
       int i = 0;
-      while(fs::exists(m_dir.conditions_json(i)) && i < conditions_list.size()) {
+      while(fs::exists(dir.conditions_json(i)) && i < conditions_list.size()) {
 
         CondType existing;
-        jsonParser json(m_dir.conditions_json(i));
+        jsonParser json(dir.conditions_json(i));
         from_json(existing, primclex, json);
         if(existing != conditions_list[i]) {
-          m_err_log.error("Conditions mismatch");
-          m_err_log << "existing conditions: " << m_dir.conditions_json(i) << "\n";
-          m_err_log << existing << "\n";
-          m_err_log << "incremental conditions " << i << ":\n";
-          m_err_log << conditions_list[i] << "\n" << std::endl;
+          err_log.error("Conditions mismatch");
+          err_log << "existing conditions: " << dir.conditions_json(i) << "\n";
+          err_log << existing << "\n";
+          err_log << "incremental conditions " << i << ":\n";
+          err_log << conditions_list[i] << "\n" << std::endl;
           throw std::runtime_error("ERROR: initial_conditions or incremental_conditions has changed.");
         }
         ++i;
@@ -511,6 +1145,10 @@ namespace CASM {
       return conditions_list;
     }
 
+    case Monte::DRIVE_MODE::ADAPTIVE: {
+      throw std::runtime_error("ERROR: The \"adaptive\" drive mode is only supported by the \"metropolis\" method.");
+    }
+
     default: {
       throw std::runtime_error("ERROR: An invalid drive mode was given.");
     }
@@ -536,6 +1174,35 @@ namespace CASM {
 
   }
 
+  /// Perform a single monte carlo step, parallel sweep, or rejection-free steps, and increment the counter
+  ///
+  /// - If monte_run.is_parallel_sweep(), performs a parallel sweep and
+  ///   increments the counter by one pass, returning true
+  /// - If monte_run.is_rejection_free(), performs up to counter.max_increment()
+  ///   steps at once and increments the counter by the number performed,
+  ///   returning true if the last was accepted
+  /// - Else, performs a single monte carlo step and increments the counter by
+  ///   one step, returning true if accepted
+  template<typename RunType>
+  bool monte_carlo_step(RunType &monte_run, MonteCounter &counter) {
+
+    if(monte_run.is_parallel_sweep()) {
+      monte_run.parallel_sweep();
+      counter.increment_pass();
+      return true;
+    }
+
+    if(monte_run.is_rejection_free()) {
+      bool accepted = false;
+      counter.increment(monte_run.rejection_free_step(counter.max_increment(), accepted));
+      return accepted;
+    }
+
+    bool res = monte_carlo_step(monte_run);
+    counter++;
+    return res;
+  }
+
 }
 
 #endif
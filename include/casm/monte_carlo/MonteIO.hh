@@ -3,6 +3,7 @@
 
 #include <string>
 #include "casm/CASM_global_definitions.hh"
+#include "casm/casm_io/jsonParser.hh"
 #include "casm/monte_carlo/MonteSampler.hh"
 #include "casm/monte_carlo/MonteCounter.hh"
 
@@ -30,6 +31,26 @@ namespace CASM {
       return m_output_dir / "results.json";
     }
 
+    /// \brief Wang-Landau density of states: "output_dir/dos.json"
+    fs::path dos_json() const {
+      return m_output_dir / "dos.json";
+    }
+
+    /// \brief Adaptive drive mode record: "output_dir/adaptive.json"
+    fs::path adaptive_json() const {
+      return m_output_dir / "adaptive.json";
+    }
+
+    /// \brief Integrated free energy: "output_dir/free_energy.csv"
+    fs::path free_energy_csv() const {
+      return m_output_dir / "free_energy.csv";
+    }
+
+    /// \brief Integrated free energy: "output_dir/free_energy.json"
+    fs::path free_energy_json() const {
+      return m_output_dir / "free_energy.json";
+    }
+
 
     /// \brief "output_dir/conditions.cond_index/"
     fs::path conditions_dir(int cond_index) const {
@@ -62,6 +83,16 @@ namespace CASM {
       return conditions_dir(cond_index) / "trajectory.json";
     }
 
+    /// \brief "output_dir/conditions.cond_index/trajectory.bin"
+    fs::path trajectory_bin(int cond_index) const {
+      return conditions_dir(cond_index) / "trajectory.bin";
+    }
+
+    /// \brief "output_dir/conditions.cond_index/checkpoint.bin"
+    fs::path checkpoint_bin(int cond_index) const {
+      return conditions_dir(cond_index) / "checkpoint.bin";
+    }
+
     /// \brief "output_dir/conditions.cond_index/trajectory"
     fs::path trajectory_dir(int cond_index) const {
       return conditions_dir(cond_index) / "trajectory";
@@ -190,6 +221,10 @@ namespace CASM {
   template<typename MonteType>
   GenericDatumFormatter<double, ConstMonteCarloPtr> MonteCarloHeatCapacityFormatter();
 
+  /// \brief Print mean property values, reweighted to remove the bias potential: unbiased(<prop_name>)
+  template<typename MonteType>
+  GenericDatumFormatter<double, ConstMonteCarloPtr> MonteCarloUnbiasedMeanFormatter(std::string prop_name);
+
   /// \brief Print parametric susceptibility, 'susc_x(a,b)'
   template<typename MonteType>
   GenericDatumFormatter<double, ConstMonteCarloPtr>
@@ -234,10 +269,33 @@ namespace CASM {
   /// \brief Make a trajectory formatter
   DataFormatter<std::pair<ConstMonteCarloPtr, Index> > make_trajectory_formatter(const MonteCarlo &mc);
 
+  /// \brief Results summary of a single run
+  ///
+  /// - Allows the results summary of a run to be appended to the results files
+  ///   after the MonteCarlo object has moved on to other conditions
+  struct MonteResultsSummary {
+
+    /// CSV header line(s), used if the results file does not yet exist
+    std::string csv_header;
+
+    /// CSV line for this run
+    std::string csv;
+
+    /// JSON object of single element arrays for this run
+    jsonParser json;
+  };
+
+  /// \brief Make the results summary of the latest run
+  template<typename MonteType>
+  MonteResultsSummary make_results_summary(const MonteSettings &settings, const MonteType &mc);
+
   /// \brief Will create new file or append to existing file results of the latest run
   template<typename MonteType>
   void write_results(const MonteSettings &settings, const MonteType &mc, Log &_log);
 
+  /// \brief Will create new file or append to existing file a results summary
+  void write_results(const MonteSettings &settings, const MonteResultsSummary &summary, Log &_log);
+
   /// \brief Write conditions to conditions.cond_index directory
   template<typename MonteType>
   void write_conditions_json(const MonteSettings &settings, const MonteType &mc, Index cond_index, Log &_log);
@@ -2,6 +2,7 @@
 #define CASM_MonteIO_impl_HH
 
 #include "casm/monte_carlo/MonteIO.hh"
+#include "casm/monte_carlo/BiasPotential.hh"
 
 namespace CASM {
 
@@ -123,6 +124,40 @@ namespace CASM {
     return GenericDatumFormatter<double, ConstMonteCarloPtr>(header, header, evaluator, validator);
   }
 
+  /// \brief Print mean property values, reweighted to remove the bias potential: unbiased(<prop_name>)
+  ///
+  /// - Uses the "bias_energy" samples, which are required when using a bias potential
+  /// - unbiased(<X>) = sum_i X_i*exp(beta*N*u_i) / sum_i exp(beta*N*u_i)
+  template<typename MonteType>
+  GenericDatumFormatter<double, ConstMonteCarloPtr> MonteCarloUnbiasedMeanFormatter(std::string prop_name) {
+
+    auto evaluator = [ = ](const ConstMonteCarloPtr & mc) {
+      auto equil = mc->is_equilibrated();
+
+      const MonteSampler &sampler = *(mc->samplers().find(prop_name)->second);
+      const Eigen::VectorXd &obs = sampler.data().observations();
+
+      const MonteSampler &bias_sampler = *(mc->samplers().find("bias_energy")->second);
+      const Eigen::VectorXd &bias = bias_sampler.data().observations();
+      Index N = obs.size() - equil.second;
+
+      ConstMonteCarloPtr ptr = mc;
+      auto beta = static_cast<const MonteType *>(ptr)->conditions().beta();
+      return Monte::reweighted_mean(obs.segment(equil.second, N),
+                                    bias.segment(equil.second, N),
+                                    beta,
+                                    mc->supercell().volume());
+    };
+
+    auto validator = [ = ](const ConstMonteCarloPtr & mc) {
+      return mc->is_equilibrated().first;
+    };
+
+    std::string header = std::string("unbiased(<") + prop_name + ">)";
+
+    return GenericDatumFormatter<double, ConstMonteCarloPtr>(header, header, evaluator, validator);
+  }
+
   /// \brief Print parametric susceptibility, 'susc_x(a,b)'
   ///
   /// \arg comp_var_i: First parametric composition variable "a", "b", "c", ...
@@ -233,56 +268,34 @@ namespace CASM {
     return GenericDatumFormatter<double, ConstMonteCarloPtr>(header, header, evaluator, validator);
   }
 
-  /// \brief Will create new file or append to existing results file the results of the latest run
+  /// \brief Make the results summary of the latest run
   template<typename MonteType>
-  void write_results(const MonteSettings &settings, const MonteType &mc, Log &_log) {
-    try {
-
-      fs::create_directories(settings.output_directory());
-      MonteCarloDirectoryStructure dir(settings.output_directory());
-      auto formatter = make_results_formatter(mc);
-
-      // write csv path results
-      if(settings.write_csv()) {
-        _log << "write: " << dir.results_csv() << "\n";
-        fs::path file = dir.results_csv();
-        fs::ofstream sout;
-
-        if(!fs::exists(file)) {
-          sout.open(file);
-          formatter.print_header(&mc, sout);
-        }
-        else {
-          sout.open(file, std::ios::app);
-        }
-
-        formatter.print(&mc, sout);
-
-        sout.close();
-      }
-
-      // write json path results
-      if(settings.write_json()) {
-        _log << "write: " << dir.results_json() << "\n";
-        fs::path file = dir.results_json();
-
-        jsonParser results;
-        if(fs::exists(file)) {
-          results.read(file);
-        }
-        else {
-          results = jsonParser::object();
-        }
-
-        formatter.to_json_arrays(&mc, results);
-        results.write(file);
-      }
+  MonteResultsSummary make_results_summary(const MonteSettings &settings, const MonteType &mc) {
+
+    MonteResultsSummary summary;
+    auto formatter = make_results_formatter(mc);
+
+    if(settings.write_csv()) {
+      std::stringstream ss;
+      formatter.print_header(&mc, ss);
+      summary.csv_header = ss.str();
+      ss.str("");
+      formatter.print(&mc, ss);
+      summary.csv = ss.str();
     }
-    catch(...) {
-      std::cerr << "ERROR writing results" << std::endl;
-      throw;
+
+    if(settings.write_json()) {
+      summary.json = jsonParser::object();
+      formatter.to_json_arrays(&mc, summary.json);
     }
 
+    return summary;
+  }
+
+  /// \brief Will create new file or append to existing results file the results of the latest run
+  template<typename MonteType>
+  void write_results(const MonteSettings &settings, const MonteType &mc, Log &_log) {
+    write_results(settings, make_results_summary(settings, mc), _log);
   }
 
   /// \brief Write conditions to conditions.cond_index directory
@@ -1,6 +1,7 @@
 #ifndef CASM_MonteSampler_HH
 #define CASM_MonteSampler_HH
 
+#include <memory>
 #include "casm/CASM_global_definitions.hh"
 #include "casm/monte_carlo/MCData.hh"
 #include "casm/monte_carlo/MonteCounter.hh"
@@ -15,7 +16,13 @@ namespace CASM {
   /// \brief An abstract base class for sampling and storing data observations
   ///
   /// - Derived classes "know" how to sample a particular property via implementation
-  ///   of 'virtual void sample(const MonteCarlo &mc, const MonteCounter &counter) = 0;'
+  ///   of 'virtual double value(const MonteCarlo &mc, const MonteCounter &counter)'
+  /// - Derived classes that sample an element of a MonteCarlo scalar or vector
+  ///   property also implement 'property_element', so that MonteCarlo can copy
+  ///   the value directly
+  /// - By default, each MonteSampler stores its own observations. MonteCarlo
+  ///   instead attaches all its samplers to columns of one MCDataStore (see
+  ///   'attach') and adds the observations of all samplers together.
   /// - Optionally may require and check for convergence to some level of precision
   ///   given a particular confidence level
   ///
@@ -25,6 +32,16 @@ namespace CASM {
 
     typedef MCData::size_type size_type;
 
+    /// \brief Describes a sampled value that is an element of a MonteCarlo property
+    ///
+    /// - If 'is_vector', the value is mc.vector_property(property)(index)
+    /// - Else, the value is mc.scalar_property(property)
+    struct PropertyElement {
+      std::string property;
+      bool is_vector;
+      Index index;
+    };
+
     /// \brief Construct sampler that does not need to converge
     MonteSampler(const std::string &print_name,
                  double data_confidence,
@@ -39,13 +56,39 @@ namespace CASM {
     virtual ~MonteSampler() {}
 
 
-    virtual void sample(const MonteCarlo &mc, const MonteCounter &counter) {
+    /// \brief Sample data from a MonteCarlo calculation
+    ///
+    /// - Only allowed if not attached to a shared MCDataStore
+    void sample(const MonteCarlo &mc, const MonteCounter &counter) {
+      data().push_back(value(mc, counter));
+    }
+
+    /// \brief Evaluate the sampled property for a MonteCarlo calculation
+    virtual double value(const MonteCarlo &mc, const MonteCounter &counter) {
       throw std::runtime_error("Error: MonteSampler base class used to sample");
     }
 
+    /// \brief If the sampled property is an element of a MonteCarlo property,
+    ///        set 'element' and return true
+    virtual bool property_element(PropertyElement &element) const {
+      return false;
+    }
+
+    /// \brief Store observations in column 'col' of 'store'
+    ///
+    /// - Existing observations are discarded
+    /// - 'store' must outlive this sampler, or its next 'attach'
+    void attach(MCDataStore &store, Index col) {
+      m_data = MCData(store, col);
+      m_convergence_uptodate = false;
+      m_equilibration_uptodate = false;
+    }
+
     /// \brief Clear all data observations
     void clear() {
       m_data.clear();
+      m_convergence_uptodate = false;
+      m_equilibration_uptodate = false;
     }
 
     /// \brief Returns pair(true, equil_steps) if equilibration has occured to required precision
@@ -58,8 +101,9 @@ namespace CASM {
         return std::make_pair(false, m_data.size());
       }
 
-      if(!m_convergence_uptodate) {
+      if(!m_equilibration_uptodate || m_equilibration_size != m_data.size()) {
         m_equilibration = MCDataEquilibration(m_data.observations(), m_prec);
+        m_equilibration_size = m_data.size();
         m_equilibration_uptodate = true;
       }
 
@@ -86,7 +130,7 @@ namespace CASM {
       }
 
       // if not calculated, or calculated for a different range of data, re-calculate
-      if(!m_convergence_uptodate || m_convergence_start_sample != equil_samples) {
+      if(!_is_convergence_uptodate(equil_samples)) {
         _check_convergence(equil_samples);
       }
 
@@ -97,7 +141,7 @@ namespace CASM {
     double mean(size_type equil_samples) const {
 
       // if not calculated, or calculated for a different range of data, re-calculate
-      if(!m_convergence_uptodate || m_convergence_start_sample != equil_samples) {
+      if(!_is_convergence_uptodate(equil_samples)) {
         _check_convergence(equil_samples);
       }
 
@@ -108,7 +152,7 @@ namespace CASM {
     double squared_norm(size_type equil_samples) const {
 
       // if not calculated, or calculated for a different range of data, re-calculate
-      if(!m_convergence_uptodate || m_convergence_start_sample != equil_samples) {
+      if(!_is_convergence_uptodate(equil_samples)) {
         _check_convergence(equil_samples);
       }
 
@@ -119,7 +163,7 @@ namespace CASM {
     double calculated_precision(size_type equil_samples) const {
 
       // if not calculated, or calculated for a different range of data, re-calculate
-      if(!m_convergence_uptodate || m_convergence_start_sample != equil_samples) {
+      if(!_is_convergence_uptodate(equil_samples)) {
         _check_convergence(equil_samples);
       }
 
@@ -157,10 +201,19 @@ namespace CASM {
       return new MonteSampler(*this);
     }
 
+    /// \brief Observations may be added to a shared MCDataStore without
+    ///        notifying the sampler, so also check the number of observations
+    bool _is_convergence_uptodate(size_type equil_samples) const {
+      return m_convergence_uptodate &&
+             m_convergence_start_sample == equil_samples &&
+             m_convergence_size == m_data.size();
+    }
+
     void _check_convergence(size_type equil_samples) const {
 
       m_convergence_start_sample = equil_samples;
-      m_convergence = MCDataConvergence(m_data.observations().segment(equil_samples, m_data.observations().size() - equil_samples), m_conf);
+      m_convergence_size = m_data.size();
+      m_convergence = MCDataConvergence(m_data, equil_samples, m_conf);
       m_convergence_uptodate = true;
     }
 
@@ -182,9 +235,11 @@ namespace CASM {
     // enable storing equilibration and convergence info
 
     mutable bool m_equilibration_uptodate = false;
+    mutable size_type m_equilibration_size = 0;
     mutable MCDataEquilibration m_equilibration;
     mutable bool m_convergence_uptodate = false;
     mutable size_type m_convergence_start_sample = 0;
+    mutable size_type m_convergence_size = 0;
     mutable MCDataConvergence m_convergence;
   };
 
@@ -209,8 +264,11 @@ namespace CASM {
                        size_type data_initsize);
 
 
-    /// \brief Sample data from a MonteCarlo calculation
-    void sample(const MonteCarlo &mc, const MonteCounter &counter);
+    /// \brief Evaluate the sampled property for a MonteCarlo calculation
+    double value(const MonteCarlo &mc, const MonteCounter &counter) override;
+
+    /// \brief Sampled property is mc.scalar_property(property_name)
+    bool property_element(PropertyElement &element) const override;
 
     /// \brief Clone this object
     std::unique_ptr<ScalarMonteSampler> clone() const {
@@ -251,8 +309,11 @@ namespace CASM {
                        size_type data_initsize);
 
 
-    /// \brief Sample data from a MonteCarlo calculation
-    void sample(const MonteCarlo &mc, const MonteCounter &counter);
+    /// \brief Evaluate the sampled property for a MonteCarlo calculation
+    double value(const MonteCarlo &mc, const MonteCounter &counter) override;
+
+    /// \brief Sampled property is mc.vector_property(property_name)(index)
+    bool property_element(PropertyElement &element) const override;
 
     /// \brief Clone this object
     std::unique_ptr<VectorMonteSampler> clone() const {
@@ -324,8 +385,8 @@ namespace CASM {
                       size_type data_initsize);
 
 
-    /// \brief Sample data from a MonteCarlo calculation
-    void sample(const MonteCarlo &mc, const MonteCounter &counter);
+    /// \brief Evaluate the sampled property for a MonteCarlo calculation
+    double value(const MonteCarlo &mc, const MonteCounter &counter) override;
 
     /// \brief Clone this object
     std::unique_ptr<QueryMonteSampler> clone() const {
@@ -368,8 +429,8 @@ namespace CASM {
                      size_type data_initsize);
 
 
-    /// \brief Sample data from a MonteCarlo calculation
-    void sample(const MonteCarlo &mc, const MonteCounter &counter);
+    /// \brief Evaluate the sampled property for a MonteCarlo calculation
+    double value(const MonteCarlo &mc, const MonteCounter &counter) override;
 
     /// \brief Clone this object
     std::unique_ptr<CompMonteSampler> clone() const {
@@ -415,8 +476,8 @@ namespace CASM {
                          size_type data_initsize);
 
 
-    /// \brief Sample data from a MonteCarlo calculation
-    void sample(const MonteCarlo &mc, const MonteCounter &counter);
+    /// \brief Evaluate the sampled property for a MonteCarlo calculation
+    double value(const MonteCarlo &mc, const MonteCounter &counter) override;
 
     /// \brief Clone this object
     std::unique_ptr<SiteFracMonteSampler> clone() const {
@@ -462,8 +523,8 @@ namespace CASM {
                          size_type data_initsize);
 
 
-    /// \brief Sample data from a MonteCarlo calculation
-    void sample(const MonteCarlo &mc, const MonteCounter &counter);
+    /// \brief Evaluate the sampled property for a MonteCarlo calculation
+    double value(const MonteCarlo &mc, const MonteCounter &counter) override;
 
     /// \brief Clone this object
     std::unique_ptr<AtomFracMonteSampler> clone() const {
@@ -1,6 +1,7 @@
 #ifndef CASM_MonteSettings_HH
 #define CASM_MonteSettings_HH
 
+#include <map>
 #include <string>
 #include "casm/CASM_global_definitions.hh"
 #include "casm/misc/cloneable_ptr.hh"
@@ -9,6 +10,8 @@
 #include "casm/clex/PrimClex.hh"
 #include "casm/monte_carlo/MonteDefinitions.hh"
 #include "casm/monte_carlo/MonteSampler.hh"
+#include "casm/monte_carlo/BiasPotential.hh"
+#include "casm/monte_carlo/WangLandau.hh"
 
 namespace CASM {
 
@@ -114,6 +117,86 @@ namespace CASM {
     ///        of the previous calculation. Default true.
     bool dependent_runs() const;
 
+    /// \brief Number of passes between replica exchange attempts. Default 1.
+    size_type swap_period() const;
+
+    /// \brief Number of conditions to calculate at once if not dependent runs, or
+    ///        replicas to run at once for replica exchange. Default 1.
+    size_type threads() const;
+
+    /// \brief Returns true if a random number generator seed is given
+    bool is_seed() const;
+
+    /// \brief Random number generator seed for the first conditions
+    unsigned long seed() const;
+
+    /// \brief Maximum change in each results summary property between adjacent
+    ///        conditions, for the adaptive drive mode
+    std::map<std::string, double> adaptive_max_jump() const;
+
+    /// \brief Maximum number of times an increment may be halved in the adaptive drive mode. Default 3.
+    size_type adaptive_max_refinement() const;
+
+    /// \brief Lower edge of the Wang-Landau energy range, per unit cell
+    double wang_landau_energy_min() const;
+
+    /// \brief Upper edge of the Wang-Landau energy range, per unit cell
+    double wang_landau_energy_max() const;
+
+    /// \brief Width of Wang-Landau energy bins, per unit cell
+    double wang_landau_bin_width() const;
+
+    /// \brief Number of Wang-Landau energy windows. Default 1.
+    size_type wang_landau_windows() const;
+
+    /// \brief Fraction of each Wang-Landau window that overlaps the next. Default 0.5.
+    double wang_landau_overlap() const;
+
+    /// \brief Number of passes between Wang-Landau histogram flatness checks. Default 10.
+    size_type wang_landau_check_period() const;
+
+    /// \brief Parameters controlling the Wang-Landau convergence
+    Monte::WangLandauParams wang_landau_params() const;
+
+    /// \brief Returns true if checkerboard parallel sweeps are requested
+    bool is_parallel_sweep() const;
+
+    /// \brief Number of threads to use for checkerboard parallel sweeps
+    size_type parallel_sweep() const;
+
+    /// \brief Number of threads to use to calculate correlations over all unit cells. Default 1.
+    size_type corr_threads() const;
+
+    /// \brief If true, use the rejection-free (n-fold way) method. Default false.
+    bool is_rejection_free() const;
+
+    /// \brief If true, cache single site energy changes. Default false.
+    bool is_site_energy_cache() const;
+
+    /// \brief Number of threads to use for the low temperature expansion. Default 1.
+    size_type lte_threads() const;
+
+    /// \brief Order of the low temperature expansion, 1 or 2. Default 1.
+    size_type lte_order() const;
+
+    /// \brief Returns true if the free energy should be integrated along the path of conditions
+    bool is_free_energy() const;
+
+    /// \brief Reference for free energy integration: "lte", "high_temperature", or "value"
+    std::string free_energy_anchor() const;
+
+    /// \brief Free energy, per unit cell, at the first conditions, if the anchor is "value"
+    double free_energy_anchor_value() const;
+
+
+    // --- Bias potential -------------
+
+    /// \brief Returns true if a bias potential is given
+    bool is_bias() const;
+
+    /// \brief Bias potential for umbrella sampling
+    Monte::BiasPotential bias_potential(Index corr_size) const;
+
 
     // --- Sampling -------------------
 
@@ -127,6 +210,15 @@ namespace CASM {
     /// \brief Returns true if snapshots are requested
     bool write_trajectory() const;
 
+    /// \brief Returns true if snapshots should be written with MonteTrajectoryWriter
+    bool write_binary_trajectory() const;
+
+    /// \brief Number of samples between keyframes of a binary trajectory. Default 100.
+    Index trajectory_keyframe_period() const;
+
+    /// \brief Number of passes between checkpoints. Default 0, no checkpoints.
+    MonteCounter::size_type checkpoint_period() const;
+
     /// \brief Returns true if POSCARs of snapshots are requsted. Requires write_trajectory.
     bool write_POSCAR_snapshots() const;
 
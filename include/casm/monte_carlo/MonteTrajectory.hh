@@ -0,0 +1,178 @@
+#ifndef CASM_MonteTrajectory_HH
+#define CASM_MonteTrajectory_HH
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+#include "casm/container/Array.hh"
+
+namespace CASM {
+
+  /// \brief Writes a Monte Carlo occupation trajectory in a compact binary format
+  ///
+  /// The file is written as samples are taken, so memory use does not grow with
+  /// the number of samples:
+  /// - Header: "CASMTRJ1", uint64 number of sites, uint32 keyframe period
+  /// - Then one record per sample: uint8 record type, uint64 pass, uint64 step,
+  ///   uint32 payload size (bytes), and the payload:
+  ///   - Keyframe (type 0): one uint8 occupant index per site
+  ///   - Delta (type 1): varint number of changed sites, then for each changed
+  ///     site, in increasing order, varint (site index - previous changed site
+  ///     index) and uint8 occupant index
+  /// - Every 'keyframe_period' samples is a keyframe, so that any sample can be
+  ///   read by applying at most 'keyframe_period'-1 deltas to a keyframe
+  /// - Integers are written little-endian; varints are unsigned LEB128
+  /// - The output is flushed after every keyframe
+  ///
+  /// \seealso MonteTrajectoryReader
+  ///
+  class MonteTrajectoryWriter {
+
+  public:
+
+    typedef Index size_type;
+
+    /// \brief Create (or overwrite) the trajectory file 'filepath'
+    MonteTrajectoryWriter(const fs::path &filepath, Index n_sites, Index keyframe_period = 100);
+
+    /// \brief Resume writing a trajectory file, from data written by write_checkpoint
+    explicit MonteTrajectoryWriter(std::istream &sin);
+
+    /// \brief Write the occupation of a sample taken at 'pass' and 'step'
+    void write(size_type pass, size_type step, const Array<int> &occupation);
+
+    /// \brief Number of samples written
+    Index size() const {
+      return m_size;
+    }
+
+    /// \brief Flush output to the file
+    void flush() {
+      m_file.flush();
+    }
+
+    /// \brief Flush output, and write the data needed to resume writing
+    void write_checkpoint(std::ostream &sout);
+
+  private:
+
+    fs::path m_filepath;
+
+    fs::ofstream m_file;
+
+    Index m_n_sites;
+
+    Index m_keyframe_period;
+
+    Index m_size;
+
+    /// Occupation of the previous sample
+    std::vector<std::uint8_t> m_prev;
+
+    /// Payload of the record being written
+    std::vector<char> m_payload;
+
+  };
+
+  /// \brief Reads a Monte Carlo occupation trajectory written by MonteTrajectoryWriter
+  ///
+  /// - On construction, the record headers are scanned to find when each sample
+  ///   was taken and where each keyframe begins
+  /// - seek(i) reads sample i, starting from the nearest preceding keyframe,
+  ///   and next() reads the sample after the current one
+  ///
+  /// Example:
+  /// \code
+  /// MonteTrajectoryReader traj(dir.trajectory_bin(cond_index));
+  /// for(Index i = 0; i < traj.size(); ++i) {
+  ///   traj.seek(i);
+  ///   ConfigDoF configdof(traj.occupation());
+  ///   ...
+  /// }
+  /// \endcode
+  ///
+  class MonteTrajectoryReader {
+
+  public:
+
+    typedef Index size_type;
+
+    /// \brief Open the trajectory file 'filepath'
+    explicit MonteTrajectoryReader(const fs::path &filepath);
+
+    /// \brief Number of samples
+    Index size() const {
+      return m_pass.size();
+    }
+
+    /// \brief Number of sites
+    Index n_sites() const {
+      return m_n_sites;
+    }
+
+    /// \brief Number of samples between keyframes
+    Index keyframe_period() const {
+      return m_keyframe_period;
+    }
+
+    /// \brief Pass at which sample 'i' was taken
+    size_type pass(Index i) const {
+      return m_pass[i];
+    }
+
+    /// \brief Step at which sample 'i' was taken
+    size_type step(Index i) const {
+      return m_step[i];
+    }
+
+    /// \brief Read sample 'i'
+    void seek(Index i);
+
+    /// \brief Read the sample after the current sample, or the first sample if
+    ///        none has been read yet
+    ///
+    /// \returns false if there are no more samples
+    bool next();
+
+    /// \brief Index of the current sample, or size() if none has been read yet
+    Index sample() const {
+      return m_sample;
+    }
+
+    /// \brief Occupation of the current sample
+    const Array<int> &occupation() const {
+      return m_occupation;
+    }
+
+  private:
+
+    /// \brief Read the record at the current file position into m_occupation
+    void _read_record();
+
+    fs::path m_filepath;
+
+    fs::ifstream m_file;
+
+    Index m_n_sites;
+
+    Index m_keyframe_period;
+
+    /// Pass and step of each sample
+    std::vector<size_type> m_pass;
+    std::vector<size_type> m_step;
+
+    /// File position of each record
+    std::vector<std::streamoff> m_offset;
+
+    Index m_sample;
+
+    Array<int> m_occupation;
+
+    std::vector<char> m_payload;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef CASM_Monte_OccEventSpec_HH
+#define CASM_Monte_OccEventSpec_HH
+
+#include <string>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+
+class MTRand;
+
+namespace CASM {
+
+  class jsonParser;
+  template<typename T> struct jsonConstructor;
+
+  namespace Monte {
+
+    class Conversions;
+    class OccCandidateList;
+    class OccLocation;
+    struct OccEvent;
+
+    /// \brief One site of an OccEventSpec: a site on any of the asymmetric units
+    ///        'asym', occupied by 'from_species', changes to 'to_species'
+    struct OccFlipSpec {
+
+      OccFlipSpec(const std::vector<Index> &_asym, Index _from_species, Index _to_species) :
+        asym(_asym),
+        from_species(_from_species),
+        to_species(_to_species) {}
+
+      std::vector<Index> asym;
+      Index from_species;
+      Index to_species;
+    };
+
+    /// \brief Occupation changes on several distinct sites that must occur together
+    ///
+    /// - For example, charge neutral reduction of CeO2:
+    ///   {Ce4 -> Ce3, Ce4 -> Ce3, O -> Va}
+    struct OccEventSpec {
+
+      OccEventSpec() {}
+
+      OccEventSpec(std::string _name, const std::vector<OccFlipSpec> &_flip) :
+        name(_name),
+        flip(_flip) {}
+
+      std::string name;
+      std::vector<OccFlipSpec> flip;
+
+      /// \brief The event that undoes this event
+      OccEventSpec reverse() const;
+    };
+
+    jsonParser &to_json(const OccEventSpec &spec, const Conversions &convert, jsonParser &json);
+
+  }
+
+  /// \brief Read OccEventSpec
+  ///
+  /// Expects:
+  /// \code
+  /// {
+  ///   "name": "reduction",
+  ///   "sites": [
+  ///     {"sublats": [0], "from": "Ce4", "to": "Ce3"},
+  ///     {"sublats": [0], "from": "Ce4", "to": "Ce3"},
+  ///     {"sublats": [1], "from": "O", "to": "Va"}
+  ///   ]
+  /// }
+  /// \endcode
+  ///
+  /// - "sublats" must be a union of complete asymmetric units
+  template<>
+  struct jsonConstructor<Monte::OccEventSpec> {
+    static Monte::OccEventSpec from_json(const jsonParser &json, const Monte::Conversions &convert);
+  };
+
+  namespace Monte {
+
+    /// \brief Proposes events from a list of OccEventSpec, using OccLocation
+    ///
+    /// - The reverse of every OccEventSpec is included, and the type of event is
+    ///   chosen uniformly, so the choice of type is the same for an event and its
+    ///   reverse
+    /// - The sites are then chosen uniformly, in order, from the sites that match
+    ///   each OccFlipSpec, without choosing any site twice
+    /// - propose returns the ratio of reverse to forward proposal probabilities,
+    ///   for use in the acceptance probability
+    /// - Sites matching two OccFlipSpec in one event must be all or none of each:
+    ///   flips with the same 'from_species' (or 'to_species') must have the same
+    ///   or non-overlapping 'asym'
+    ///
+    class OccEventProposer {
+
+    public:
+
+      OccEventProposer(const Conversions &convert,
+                       const OccCandidateList &cand,
+                       const std::vector<OccEventSpec> &spec);
+
+      /// \brief Number of event types, including reverse events
+      Index size() const {
+        return m_spec.size();
+      }
+
+      /// \brief Event type, including reverse events
+      const OccEventSpec &spec(Index i) const {
+        return m_spec[i];
+      }
+
+      /// \brief Propose an event
+      ///
+      /// \returns P(reverse event) / P(event), or 0.0 if the randomly chosen
+      ///          type of event is not possible, in which case 'e' has no
+      ///          occ_transform
+      double propose(OccEvent &e, const OccLocation &occ_loc, MTRand &mtrand) const;
+
+    private:
+
+      /// Data used to choose sites for one OccFlipSpec
+      struct Flip {
+
+        /// Candidate index of each (asym, from_species)
+        std::vector<Index> from_cand;
+
+        /// Candidate index of each (asym, to_species)
+        std::vector<Index> to_cand;
+
+        /// Earlier flips in the same event with the same from_cand
+        std::vector<Index> prev_from;
+
+        /// Number of earlier flips in the same event with the same to_cand
+        Index n_prev_to;
+      };
+
+      /// \brief Number of sites of any of the candidates
+      Index _count(const std::vector<Index> &cand, const OccLocation &occ_loc) const;
+
+      const Conversions *m_convert;
+
+      const OccCandidateList *m_cand;
+
+      /// Event types, including reverse events
+      std::vector<OccEventSpec> m_spec;
+
+      /// Data used to choose sites for each flip of each event type
+      std::vector<std::vector<Flip> > m_flip;
+
+      // ---- workspace for propose ----
+
+      /// Position in the list of matching sites of each site chosen so far
+      mutable std::vector<Index> m_chosen;
+
+      /// Change in candidate sizes due to the proposed event
+      mutable std::vector<long> m_dsize;
+    };
+
+  }
+}
+
+#endif
@@ -1,9 +1,11 @@
 #ifndef CASM_Monte_OccLocation_HH
 #define CASM_Monte_OccLocation_HH
 
+#include <iosfwd>
 #include <vector>
 #include "casm/CASM_global_definitions.hh"
 #include "casm/crystallography/UnitCellCoord.hh"
+#include "casm/monte_carlo/SumTree.hh"
 
 class MTRand;
 
@@ -25,6 +27,7 @@ namespace CASM {
       Index id;                    ///< Location in OccLocation.m_species
       UnitCellCoord bijk_begin;    ///< Saves initial position
       Index mol_comp_begin;          ///< Saves initial Mol.component index
+      Eigen::Vector3d displacement;  ///< Total Cartesian displacement since initialization
     };
 
     /// \brief Represents the occupant on a site
@@ -71,7 +74,7 @@ namespace CASM {
 
       typedef Index size_type;
 
-      OccLocation(const Conversions &_convert, const OccCandidateList &_cand);
+      OccLocation(const Conversions &_convert, const OccCandidateList &_cand, bool _kmc = false);
 
       /// Fill tables with occupation info
       void initialize(const Configuration &config);
@@ -83,6 +86,13 @@ namespace CASM {
 
       const Mol &mol(Index mol_id) const;
 
+      /// Total number of Species, if tracking Species locations
+      size_type species_size() const;
+
+      Species &species(Index species_id);
+
+      const Species &species(Index species_id) const;
+
       /// Total number of mutating sites, of OccCandidate type, specified by index
       size_type cand_size(Index cand_index) const;
 
@@ -107,6 +117,12 @@ namespace CASM {
       /// Update configdof and this to reflect that event 'e' occurred
       void apply(const OccEvent &e, ConfigDoF &configdof);
 
+      /// Write the order of Mol and Species, for restarting a calculation
+      void write_checkpoint(std::ostream &sout) const;
+
+      /// Restore data written by write_checkpoint
+      void read_checkpoint(std::istream &sin);
+
     private:
 
       /// Canonical propose
@@ -115,6 +131,9 @@ namespace CASM {
       /// Canonical propose
       OccEvent &_propose(OccEvent &e, const OccSwap &swap, MTRand &mtrand) const;
 
+      /// Update m_canonical_swap_weight for swaps involving a candidate
+      void _update_canonical_swap_weight(Index cand_index);
+
       const Conversions &m_convert;
 
       const OccCandidateList &m_cand;
@@ -138,8 +157,15 @@ namespace CASM {
       /// Data structure used store temporaries during apply
       std::vector<Mol> m_tmol;
 
-      /// Data used by propose_canonical
+      /// Data used by propose_canonical, if not proposing from m_cand.canonical_swap()
       mutable std::vector<double> m_tsum;
+
+      /// Number of possible events for each swap in m_cand.canonical_swap():
+      ///   cand_size(cand_a)*cand_size(cand_b)
+      SumTree m_canonical_swap_weight;
+
+      /// Indices of the swaps in m_cand.canonical_swap() involving each candidate
+      std::vector<std::vector<Index> > m_cand_to_canonical_swap;
     };
   }
 }
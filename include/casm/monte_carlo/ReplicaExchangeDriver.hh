@@ -0,0 +1,596 @@
+#ifndef CASM_ReplicaExchangeDriver_HH
+#define CASM_ReplicaExchangeDriver_HH
+
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <string>
+#include "casm/external/boost.hh"
+
+#include "casm/misc/parallel.hh"
+#include "casm/monte_carlo/MonteIO.hh"
+#include "casm/monte_carlo/MonteCarlo.hh"
+#include "casm/monte_carlo/MonteDriver.hh"
+#include "casm/monte_carlo/MonteSettings.hh"
+
+namespace CASM {
+
+  /**
+   * ReplicaExchangeDriver runs one specialized MonteCarlo object (a 'replica') for
+   * each of the conditions in the list at the same time, and periodically attempts to
+   * exchange the states of replicas at neighboring conditions (parallel tempering).
+   *
+   * - The conditions list is constructed as for MonteDriver (INCREMENTAL or CUSTOM).
+   * - Replicas run for "driver"/"swap_period" passes, up to "driver"/"threads"
+   *   replicas at a time, then exchanges are attempted between neighboring pairs
+   *   (0-1, 2-3, ... and 1-2, 3-4, ... on alternating attempts).
+   * - An exchange between replicas i and j is accepted with probability
+   *   min(1, exp(-D)), where
+   *     D = beta_i*(Omega_i(x_j) - Omega_i(x_i)) + beta_j*(Omega_j(x_i) - Omega_j(x_j)),
+   *   and Omega_i(x) is the potential energy of the supercell in state x at the
+   *   conditions of replica i. If the conditions of replicas i and j differ only in
+   *   temperature, Omega_i == Omega_j, and D = (beta_i - beta_j)*(Omega(x_j) - Omega(x_i))
+   *   is evaluated from the current potential energy of each replica. Otherwise,
+   *   Omega_i(x_j) and Omega_j(x_i) are calculated from the correlations.
+   * - Samples stay with the conditions, so each replica converges (or completes) as it
+   *   would with MonteDriver. A replica that is finished stops running and no longer
+   *   takes part in exchanges.
+   * - Output is written as by MonteDriver, using MonteCarloDirectoryStructure and
+   *   RunType::write_results, in order of the conditions list.
+   * - If "driver"/"seed" is given, replica i is seeded with "seed" + i.
+   *
+   * RunType must provide, in addition to the MonteDriver requirements:
+   * - void exchange_configdof(const ConfigDoF &configdof), which sets the ConfigDoF
+   *   without clearing previously collected data
+   */
+
+  /// \brief Probability of accepting an exchange of states between replicas i and j
+  ///
+  /// \param beta_i, beta_j Inverse temperature of replicas i and j
+  /// \param omega_ii, omega_ij Potential energy at the conditions of replica i,
+  ///        in the state of replica i and j, respectively
+  /// \param omega_ji, omega_jj Potential energy at the conditions of replica j,
+  ///        in the state of replica i and j, respectively
+  ///
+  /// \returns min(1, exp(-D)), where
+  ///   D = beta_i*(omega_ij - omega_ii) + beta_j*(omega_ji - omega_jj)
+  ///
+  inline double replica_exchange_probability(double beta_i,
+                                             double beta_j,
+                                             double omega_ii,
+                                             double omega_ij,
+                                             double omega_ji,
+                                             double omega_jj) {
+    double delta = beta_i * (omega_ij - omega_ii) + beta_j * (omega_ji - omega_jj);
+    return (delta <= 0.0) ? 1.0 : std::exp(-delta);
+  }
+
+  template<typename RunType>
+  class ReplicaExchangeDriver {
+
+  public:
+    typedef typename RunType::CondType CondType;
+    typedef typename RunType::SettingsType SettingsType;
+
+    /// \brief Constructor via MonteSettings
+    ReplicaExchangeDriver(PrimClex &primclex, const SettingsType &settings, Log &_log, Log &_err_log);
+
+    /// \brief Run everything requested by the MonteSettings
+    void run();
+
+    /// \brief Number of exchanges attempted between replica i and i+1
+    const std::vector<Index> &exchanges_attempted() const {
+      return m_n_attempt;
+    }
+
+    /// \brief Number of exchanges accepted between replica i and i+1
+    const std::vector<Index> &exchanges_accepted() const {
+      return m_n_accept;
+    }
+
+  private:
+
+    /// Data for a single replica
+    struct Replica {
+
+      Replica(PrimClex &primclex, const SettingsType &settings, int verbosity) :
+        log(new OStringStreamLog(verbosity)),
+        mc(new RunType(primclex, settings, *log)),
+        counter(settings, mc->steps_per_pass()),
+        complete(false) {}
+
+      /// Replica log, flushed to the driver log between blocks of passes
+      std::unique_ptr<OStringStreamLog> log;
+
+      std::unique_ptr<RunType> mc;
+
+      MonteCounter counter;
+
+      bool complete;
+    };
+
+    /// run in debug mode?
+    bool debug() const {
+      return m_debug;
+    }
+
+    /// \brief Run replica 'i' for up to 'passes' passes, or until complete
+    void _run_passes(Index i, MonteCounter::size_type passes);
+
+    /// \brief Return true if replica 'i' has finished, as in MonteDriver::single_run
+    bool _is_complete(Index i);
+
+    /// \brief Attempt exchanges between neighboring replicas, starting with pair (parity, parity+1)
+    void _attempt_exchanges(Index parity);
+
+    /// \brief Potential energy of the supercell for replica 'i' in the state of replica 'j'
+    double _potential_energy(Index i, Index j) const;
+
+    /// \brief Copy replica log messages to the driver log, in order
+    void _flush_logs();
+
+    /// \brief Return true if all conditions have existing results
+    bool _is_finished() const;
+
+
+    /// target for log messages
+    Log &m_log;
+
+    /// target for error messages
+    Log &m_err_log;
+
+    ///Copy of initial settings given at construction
+    SettingsType m_settings;
+
+    /// describes where to write output
+    MonteCarloDirectoryStructure m_dir;
+
+    ///List of specialized conditions, one per replica, in the order that exchanges are attempted
+    const std::vector<CondType> m_conditions_list;
+
+    /// Number of passes between exchange attempts
+    MonteCounter::size_type m_swap_period;
+
+    /// Number of replicas to run at once
+    Index m_threads;
+
+    /// True if the conditions of replica i and i+1 differ only in temperature
+    std::vector<bool> m_same_potential;
+
+    /// run in debug mode?
+    bool m_debug;
+
+    /// One replica per conditions
+    std::vector<Replica> m_replica;
+
+    /// Number of exchanges attempted between replica i and i+1
+    std::vector<Index> m_n_attempt;
+
+    /// Number of exchanges accepted between replica i and i+1
+    std::vector<Index> m_n_accept;
+
+    /// Random number generator for exchanges
+    MTRand m_twister;
+  };
+
+
+  template<typename RunType>
+  ReplicaExchangeDriver<RunType>::ReplicaExchangeDriver(PrimClex &primclex, const SettingsType &settings, Log &_log, Log &_err_log):
+    m_log(_log),
+    m_err_log(_err_log),
+    m_settings(settings),
+    m_dir(m_settings.output_directory()),
+    m_conditions_list(make_conditions_list<RunType>(primclex, m_settings, m_dir, m_err_log)),
+    m_swap_period(m_settings.swap_period()),
+    m_threads(m_settings.threads()),
+    m_debug(m_settings.debug()) {
+
+    if(m_settings.is_enumeration()) {
+      throw std::runtime_error(
+        "Error in ReplicaExchangeDriver: \"data\"/\"enumeration\" is not supported.");
+    }
+    if(m_swap_period < 1) {
+      throw std::runtime_error(
+        "Error in ReplicaExchangeDriver: \"driver\"/\"swap_period\" must be >= 1.");
+    }
+
+    // replicas are constructed serially, so that any lazily constructed PrimClex
+    // data (Clexulator, ECI, neighbor lists) exists before running in parallel
+    m_replica.reserve(m_conditions_list.size());
+    for(Index i = 0; i < m_conditions_list.size(); ++i) {
+      m_replica.emplace_back(primclex, m_settings, m_log.verbosity());
+    }
+    _flush_logs();
+
+    m_n_attempt = std::vector<Index>(m_conditions_list.size(), 0);
+    m_n_accept = std::vector<Index>(m_conditions_list.size(), 0);
+
+    m_same_potential = std::vector<bool>(m_conditions_list.size(), false);
+    for(Index i = 0; i + 1 < m_conditions_list.size(); ++i) {
+      CondType cond = m_conditions_list[i + 1];
+      cond.set_temperature(m_conditions_list[i].temperature());
+      m_same_potential[i] = (cond == m_conditions_list[i]);
+    }
+  }
+
+  /// \brief Run calculations for all conditions at once, exchanging states between
+  ///        neighboring conditions
+  ///
+  /// - If results exist for all conditions, the calculations are not repeated. Otherwise,
+  ///   all conditions are recalculated, because replicas depend on each other.
+  /// - Every replica begins with the DoF specified for the "motif", "dependent_runs" is
+  ///   not used.
+  template<typename RunType>
+  void ReplicaExchangeDriver<RunType>::run() {
+
+    m_log.check("For existing calculations");
+
+    if(!m_settings.write_json() && !m_settings.write_csv()) {
+      throw std::runtime_error(
+        std::string("No valid monte carlo output format.\n") +
+        "  Expected [\"data\"][\"storage\"][\"output_format\"] to contain a string or array of strings.\n" +
+        "  Valid options are 'csv' or 'json'.");
+    }
+
+    if(_is_finished()) {
+      m_log << "calculations already complete." << std::endl;
+      return;
+    }
+
+    // results summary files are appended to, so remove partial results
+    bool existing = false;
+    if(fs::exists(m_dir.results_csv())) {
+      m_log << "remove: " << m_dir.results_csv() << "\n";
+      fs::remove(m_dir.results_csv());
+      existing = true;
+    }
+    if(fs::exists(m_dir.results_json())) {
+      m_log << "remove: " << m_dir.results_json() << "\n";
+      fs::remove(m_dir.results_json());
+      existing = true;
+    }
+    for(Index i = 0; i < m_conditions_list.size(); ++i) {
+      if(fs::exists(m_dir.conditions_dir(i))) {
+        existing = true;
+      }
+    }
+    if(existing) {
+      m_log << "found incomplete calculations, will overwrite existing results\n";
+    }
+    else {
+      m_log << "did not find existing calculations\n";
+    }
+    m_log << std::endl;
+
+    if(m_conditions_list.size() < 2) {
+      m_log << "only one condition, no replica exchanges will be attempted\n" << std::endl;
+    }
+
+    // seed replica i with "seed" + i, and exchanges with "seed" + (number of replicas)
+    if(m_settings.is_seed()) {
+      for(Index i = 0; i < m_replica.size(); ++i) {
+        m_replica[i].mc->seed(m_settings.seed() + i);
+      }
+      m_twister.seed(m_settings.seed() + m_replica.size());
+    }
+
+    // set initial states
+    for(Index i = 0; i < m_replica.size(); ++i) {
+      m_replica[i].mc->set_state(m_conditions_list[i], m_settings);
+      m_replica[i].counter = MonteCounter(m_settings, m_replica[i].mc->steps_per_pass());
+      m_replica[i].complete = false;
+    }
+
+    if(RunType::ensemble == Monte::ENSEMBLE::Canonical) {
+      for(Index i = 1; i < m_replica.size(); ++i) {
+        if(!almost_equal(m_replica[i].mc->comp_n(), m_replica[0].mc->comp_n())) {
+          throw std::runtime_error(
+            "Error in ReplicaExchangeDriver: canonical replicas must have the same composition.");
+        }
+      }
+    }
+    _flush_logs();
+
+    // perform any requested explicit equilibration passes, in parallel
+    if(m_settings.is_equilibration_passes_each_run()) {
+
+      auto equil_passes = m_settings.equilibration_passes_each_run();
+
+      m_log.write("DoF");
+      for(Index i = 0; i < m_replica.size(); ++i) {
+        fs::create_directories(m_dir.conditions_dir(i));
+        m_log << "write: " << m_dir.initial_state_runeq_json(i) << "\n";
+        jsonParser json;
+        to_json(m_replica[i].mc->configdof(), json).write(m_dir.initial_state_runeq_json(i));
+      }
+      m_log << std::endl;
+
+      m_log.begin("Equilibration passes");
+      m_log << equil_passes << " equilibration passes\n" << std::endl;
+
+      parallel_for(m_replica.size(), m_threads, [&](Index t, Index i) {
+        RunType &mc = *m_replica[i].mc;
+        MonteCounter equil_counter(m_settings, mc.steps_per_pass());
+        while(equil_counter.pass() != equil_passes) {
+          monte_carlo_step(mc, equil_counter);
+        }
+      });
+    }
+
+    // initial state (after any equilibriation passes)
+    m_log.write("DoF");
+    for(Index i = 0; i < m_replica.size(); ++i) {
+      fs::create_directories(m_dir.conditions_dir(i));
+      m_log << "write: " << m_dir.initial_state_json(i) << "\n";
+      jsonParser json;
+      to_json(m_replica[i].mc->configdof(), json).write(m_dir.initial_state_json(i));
+      m_replica[i].mc->begin_trajectory(i);
+    }
+    m_log << std::endl;
+
+    m_log.begin("Replica exchange");
+    m_log << m_replica.size() << " replicas\n";
+    m_log << "threads: " << std::min<Index>(m_threads, m_replica.size()) << "\n";
+    m_log << "swap period: " << m_swap_period << " (passes)\n" << std::endl;
+    m_log.begin_lap();
+
+    Index parity = 0;
+    std::vector<Index> running;
+    while(true) {
+
+      running.clear();
+      for(Index i = 0; i < m_replica.size(); ++i) {
+        if(!m_replica[i].complete) {
+          running.push_back(i);
+        }
+      }
+      if(!running.size()) {
+        break;
+      }
+
+      try {
+        parallel_for(running.size(), m_threads, [&](Index t, Index k) {
+          _run_passes(running[k], m_swap_period);
+        });
+      }
+      catch(...) {
+        _flush_logs();
+        throw;
+      }
+      _flush_logs();
+
+      _attempt_exchanges(parity);
+      parity = 1 - parity;
+    }
+
+    for(auto &r : m_replica) {
+      r.mc->end_trajectory();
+    }
+
+    // timing info:
+    double s = m_log.lap_time();
+    m_log.end("Replica exchange");
+    m_log << "run time: " << s << " (s)\n" << std::endl;
+
+    m_log.custom("Exchange acceptance");
+    m_log << std::setw(12) << "pair" << std::setw(16) << "attempted" << std::setw(16) << "accepted" << "\n";
+    for(Index i = 0; i + 1 < m_replica.size(); ++i) {
+      std::stringstream pair;
+      pair << i << "-" << i + 1;
+      m_log << std::setw(12) << pair.str()
+            << std::setw(16) << m_n_attempt[i]
+            << std::setw(16) << m_n_accept[i] << "\n";
+    }
+    m_log << std::endl;
+
+    // write output, in order of conditions
+    for(Index i = 0; i < m_replica.size(); ++i) {
+
+      std::stringstream ss;
+      ss << "Conditions " << i;
+      m_log.custom(ss.str());
+      m_log << "passes: " << m_replica[i].counter.pass() << "  "
+            << "samples: " << m_replica[i].counter.samples() << "\n" << std::endl;
+
+      m_log.write("DoF");
+      m_log << "write: " << m_dir.final_state_json(i) << "\n" << std::endl;
+      jsonParser json;
+      to_json(m_replica[i].mc->configdof(), json).write(m_dir.final_state_json(i));
+
+      m_replica[i].log->write("Output files");
+      m_replica[i].mc->write_results(i);
+      *m_replica[i].log << std::endl;
+      _flush_logs();
+    }
+
+    return;
+  }
+
+  /// \brief Run replica 'i' for up to 'passes' passes, or until complete
+  ///
+  /// - May run in a worker thread, so all messages go to the replica log
+  template<typename RunType>
+  void ReplicaExchangeDriver<RunType>::_run_passes(Index i, MonteCounter::size_type passes) {
+
+    Replica &r = m_replica[i];
+    RunType &mc = *r.mc;
+    MonteCounter &run_counter = r.counter;
+    Log &log = *r.log;
+    auto final_pass = run_counter.pass() + passes;
+
+    while(run_counter.pass() != final_pass) {
+
+      if(_is_complete(i)) {
+        r.complete = true;
+        break;
+      }
+
+      monte_carlo_step(mc, run_counter);
+
+      if(run_counter.sample_time()) {
+        if(debug()) {
+          log.custom<Log::debug>("Sample data");
+          log << "conditions: " << i << "  "
+              << "pass: " << run_counter.pass() << "  "
+              << "step: " << run_counter.step() << "  "
+              << "take sample " << mc.sample_times().size() << "\n" << std::endl;
+        }
+
+        mc.sample_data(run_counter);
+        run_counter.increment_samples();
+      }
+    }
+  }
+
+  /// \brief Return true if replica 'i' has finished, as in MonteDriver::single_run
+  template<typename RunType>
+  bool ReplicaExchangeDriver<RunType>::_is_complete(Index i) {
+
+    RunType &mc = *m_replica[i].mc;
+    const MonteCounter &run_counter = m_replica[i].counter;
+    Log &log = *m_replica[i].log;
+
+    if(mc.must_converge()) {
+
+      if(!run_counter.minimums_met()) {
+
+        // keep going, but check for conflicts with maximums
+        if(run_counter.maximums_met()) {
+          throw std::runtime_error(
+            std::string("Error in 'ReplicaExchangeDriver<RunType>::run()'\n") +
+            "  Conflicting input: Minimum number of passes, steps, or samples not met,\n" +
+            "  but maximum number of passes, steps, or samples are met.");
+        }
+        return false;
+      }
+
+      if(mc.check_convergence_time()) {
+
+        log.require<Log::verbose>() << "\n";
+        log.custom<Log::verbose>("Begin convergence checks");
+        log << "conditions: " << i << std::endl;
+        log << "samples: " << mc.sample_times().size() << std::endl;
+        log << std::endl;
+
+        if(mc.is_converged()) {
+          return true;
+        }
+      }
+
+      return run_counter.maximums_met();
+    }
+
+    return run_counter.is_complete();
+  }
+
+  /// \brief Attempt exchanges between neighboring replicas, starting with pair (parity, parity+1)
+  ///
+  /// - Pairs in which either replica has finished are skipped
+  /// - If the replicas differ only in temperature, uses the current potential
+  ///   energy of each replica, else calculates the potential energy of each
+  ///   state at the other conditions
+  template<typename RunType>
+  void ReplicaExchangeDriver<RunType>::_attempt_exchanges(Index parity) {
+
+    for(Index i = parity; i + 1 < m_replica.size(); i += 2) {
+
+      Index j = i + 1;
+      if(m_replica[i].complete || m_replica[j].complete) {
+        continue;
+      }
+
+      double beta_i = m_replica[i].mc->conditions().beta();
+      double beta_j = m_replica[j].mc->conditions().beta();
+      double omega_ii = _potential_energy(i, i);
+      double omega_jj = _potential_energy(j, j);
+      double omega_ij = m_same_potential[i] ? omega_jj : _potential_energy(i, j);
+      double omega_ji = m_same_potential[i] ? omega_ii : _potential_energy(j, i);
+      double prob = replica_exchange_probability(beta_i, beta_j, omega_ii, omega_ij, omega_ji, omega_jj);
+
+      ++m_n_attempt[i];
+
+      bool accept = (prob == 1.0) || (m_twister.rand53() < prob);
+
+      if(debug()) {
+        m_log.custom<Log::debug>("Check exchange");
+        m_log << "conditions: " << i << " " << j << "\n"
+              << "probability: " << prob << "  accept: " << std::boolalpha << accept << "\n" << std::endl;
+      }
+
+      if(accept) {
+        ConfigDoF tmp = m_replica[i].mc->configdof();
+        m_replica[i].mc->exchange_configdof(m_replica[j].mc->configdof());
+        m_replica[j].mc->exchange_configdof(tmp);
+        ++m_n_accept[i];
+      }
+    }
+  }
+
+  /// \brief Potential energy of the supercell for replica 'i' in the state of replica 'j'
+  template<typename RunType>
+  double ReplicaExchangeDriver<RunType>::_potential_energy(Index i, Index j) const {
+    const RunType &mc = *m_replica[i].mc;
+    double N = mc.supercell().volume();
+    if(i == j) {
+      return mc.potential_energy() * N;
+    }
+    return mc.potential_energy(m_replica[j].mc->config()) * N;
+  }
+
+  /// \brief Copy replica log messages to the driver log, in order
+  template<typename RunType>
+  void ReplicaExchangeDriver<RunType>::_flush_logs() {
+    for(auto &r : m_replica) {
+      std::string msg = r.log->ss().str();
+      if(!msg.empty()) {
+        m_log.require<Log::none>() << msg;
+        r.log->ss().str("");
+      }
+    }
+    m_log << std::flush;
+  }
+
+  /// \brief Return true if all conditions have existing results
+  template<typename RunType>
+  bool ReplicaExchangeDriver<RunType>::_is_finished() const {
+
+    for(Index i = 0; i < m_conditions_list.size(); ++i) {
+      if(!fs::exists(m_dir.final_state_json(i))) {
+        return false;
+      }
+    }
+
+    if(m_settings.write_json()) {
+      if(!fs::exists(m_dir.results_json())) {
+        return false;
+      }
+      jsonParser json_results(m_dir.results_json());
+      if(!json_results.size() || json_results.begin()->size() != m_conditions_list.size()) {
+        return false;
+      }
+    }
+
+    if(m_settings.write_csv()) {
+      if(!fs::exists(m_dir.results_csv())) {
+        return false;
+      }
+      fs::ifstream csv_results(m_dir.results_csv());
+      std::string str;
+      Index n_lines = 0;
+      while(std::getline(csv_results, str)) {
+        if(!str.empty()) {
+          ++n_lines;
+        }
+      }
+      // header + one line per conditions
+      if(n_lines != m_conditions_list.size() + 1) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+}
+
+#endif
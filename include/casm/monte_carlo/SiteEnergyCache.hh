@@ -0,0 +1,120 @@
+#ifndef CASM_Monte_SiteEnergyCache_HH
+#define CASM_Monte_SiteEnergyCache_HH
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  class Supercell;
+  class SuperNeighborList;
+  class Clexulator;
+
+  namespace Monte {
+
+    /// \brief Cache of the change in energy due to changing the occupant of a
+    ///        single site, by site and new occupant
+    ///
+    /// - When the occupant of a site changes, only the values for sites in unit
+    ///   cells whose Clexulator neighborhood includes the changed site are
+    ///   invalidated
+    /// - Values that depend on the conditions, such as dEpot, should only be
+    ///   stored if the cache is cleared when the conditions change
+    /// - Counts hits and misses, for reporting how useful the cache is
+    ///
+    class SiteEnergyCache {
+
+    public:
+
+      /// \brief Construct a disabled SiteEnergyCache
+      SiteEnergyCache() :
+        m_max_occ(0),
+        m_volume(0),
+        m_nlist(nullptr),
+        m_hits(0),
+        m_misses(0) {}
+
+      /// \brief Construct a SiteEnergyCache for all sites in a Supercell
+      SiteEnergyCache(const Supercell &scel, const Clexulator &clexulator, Index max_occ);
+
+      /// \brief Returns true if values are being cached
+      bool is_enabled() const {
+        return m_max_occ != 0;
+      }
+
+      /// \brief Get the value for changing site 'l' to occupant 'occ'
+      ///
+      /// \returns true, and sets 'value', if the value is cached
+      bool find(Index l, int occ, double &value) {
+        double cached = m_value[l * m_max_occ + occ];
+        if(std::isnan(cached)) {
+          ++m_misses;
+          return false;
+        }
+        ++m_hits;
+        value = cached;
+        return true;
+      }
+
+      /// \brief Store the value for changing site 'l' to occupant 'occ'
+      void insert(Index l, int occ, double value) {
+        m_value[l * m_max_occ + occ] = value;
+      }
+
+      /// \brief Invalidate values that depend on the occupant of site 'l'
+      void invalidate(Index l);
+
+      /// \brief Invalidate all values
+      void clear() {
+        std::fill(m_value.begin(), m_value.end(), std::numeric_limits<double>::quiet_NaN());
+      }
+
+      /// \brief Number of values found in the cache
+      Index hits() const {
+        return m_hits;
+      }
+
+      /// \brief Number of values not found in the cache
+      Index misses() const {
+        return m_misses;
+      }
+
+      /// \brief Fraction of values found in the cache
+      double hit_rate() const {
+        return (m_hits + m_misses) ? (1.0 * m_hits) / (m_hits + m_misses) : 0.0;
+      }
+
+      /// \brief Memory used for cached values and neighborhoods, in bytes
+      Index memory() const {
+        return m_value.capacity() * sizeof(double) + m_affected.capacity() * sizeof(Index);
+      }
+
+    private:
+
+      /// \brief Maximum number of occupants of any site
+      Index m_max_occ;
+
+      /// \brief Supercell volume, for site index -> unit cell, sublattice
+      Index m_volume;
+
+      /// \brief Indices into SuperNeighborList::unitcells(uc) of the unit cells
+      ///        with a neighborhood that includes 'uc'
+      std::vector<Index> m_affected;
+
+      const SuperNeighborList *m_nlist;
+
+      /// \brief Cached values, m_value[l*m_max_occ + occ], NaN if not cached
+      std::vector<double> m_value;
+
+      Index m_hits;
+
+      Index m_misses;
+    };
+
+  }
+}
+
+#endif
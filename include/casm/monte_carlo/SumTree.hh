@@ -0,0 +1,106 @@
+#ifndef CASM_Monte_SumTree_HH
+#define CASM_Monte_SumTree_HH
+
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+  namespace Monte {
+
+    /// \brief Binary tree of partial sums, for sampling from a set of
+    ///        non-negative weights that change one at a time
+    ///
+    /// - set(i, value) and find(target) are O(log(size())), sum() is O(1)
+    /// - Internal nodes are recalculated from their children on every set, so
+    ///   round-off does not accumulate as values are changed
+    ///
+    class SumTree {
+
+    public:
+
+      /// \brief Construct an empty SumTree
+      SumTree() :
+        m_size(0),
+        m_base(1),
+        m_tree(2, 0.0) {}
+
+      /// \brief Construct a SumTree with 'size' values, all zero
+      explicit SumTree(Index size) {
+        resize(size);
+      }
+
+      /// \brief Set the number of values, and set all values to zero
+      void resize(Index size) {
+        m_size = size;
+        m_base = 1;
+        while(m_base < m_size) {
+          m_base *= 2;
+        }
+        m_tree.assign(2 * m_base, 0.0);
+      }
+
+      /// \brief Number of values
+      Index size() const {
+        return m_size;
+      }
+
+      /// \brief Set value 'i'
+      void set(Index i, double value) {
+        Index node = m_base + i;
+        m_tree[node] = value;
+        node /= 2;
+        while(node) {
+          m_tree[node] = m_tree[2 * node] + m_tree[2 * node + 1];
+          node /= 2;
+        }
+      }
+
+      /// \brief Value 'i'
+      double value(Index i) const {
+        return m_tree[m_base + i];
+      }
+
+      /// \brief Sum of all values
+      double sum() const {
+        return m_tree[1];
+      }
+
+      /// \brief Find 'i' such that sum(value(0:i)) <= target < sum(value(0:i+1))
+      ///
+      /// - 'target' should be in the range [0, sum()). If, due to round-off,
+      ///   target >= sum(), returns the last 'i' with non-zero value.
+      /// - Never returns an 'i' with zero value, unless sum() == 0.0
+      ///
+      Index find(double target) const {
+        Index node = 1;
+        while(node < m_base) {
+          Index left = 2 * node;
+          if(target < m_tree[left] || m_tree[left + 1] == 0.0) {
+            node = left;
+          }
+          else {
+            target -= m_tree[left];
+            node = left + 1;
+          }
+        }
+        return node - m_base;
+      }
+
+    private:
+
+      /// Number of values
+      Index m_size;
+
+      /// Number of leaves, the smallest power of 2 >= m_size
+      Index m_base;
+
+      /// Tree stored as an array: root at 1, children of node n at 2n and 2n+1,
+      /// and value i at m_base + i
+      std::vector<double> m_tree;
+
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef CASM_Monte_ThermoIntegration_HH
+#define CASM_Monte_ThermoIntegration_HH
+
+#include "casm/external/Eigen/Dense"
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+  namespace Monte {
+
+    /// \brief Conditions and mean properties, per unit cell, at one point
+    ///        along a path of grand canonical conditions
+    struct ThermoIntegrationPoint {
+
+      ThermoIntegrationPoint() :
+        beta(0.0),
+        potential_energy(0.0) {}
+
+      ThermoIntegrationPoint(double _beta,
+                             const Eigen::VectorXd &_param_chem_pot,
+                             double _potential_energy,
+                             const Eigen::VectorXd &_comp) :
+        beta(_beta),
+        param_chem_pot(_param_chem_pot),
+        potential_energy(_potential_energy),
+        comp(_comp) {}
+
+      double beta;
+      Eigen::VectorXd param_chem_pot;
+
+      /// <potential_energy>
+      double potential_energy;
+
+      /// <comp(a)>, <comp(b)>, ...
+      Eigen::VectorXd comp;
+    };
+
+
+    /// \brief Change in beta*phi, per unit cell, between two points, using
+    ///        the trapezoid rule
+    ///
+    /// With Phi = beta*phi, where phi is the grand canonical free energy per unit
+    /// cell:
+    /// \code
+    /// dPhi = <potential_energy> dBeta - Beta*<comp(a)> dparam_chem_pot(a) - ...
+    /// \endcode
+    inline double integrate_beta_phi(const ThermoIntegrationPoint &a, const ThermoIntegrationPoint &b) {
+      return 0.5 * (a.potential_energy + b.potential_energy) * (b.beta - a.beta) -
+             0.5 * (a.beta * a.comp + b.beta * b.comp).dot(b.param_chem_pot - a.param_chem_pot);
+    }
+
+    /// \brief First order high temperature estimate of the grand canonical free
+    ///        energy, per unit cell
+    ///
+    /// \param point Conditions and mean properties
+    /// \param ln_omega Log of the number of possible configurations, per unit cell
+    ///
+    /// \code
+    /// phi ~= <potential_energy> - ln_omega/Beta
+    /// \endcode
+    ///
+    /// - Neglects terms of order Beta*var(potential_energy), so should only be
+    ///   used as a reference where the temperature is high compared to the
+    ///   range of potential energies
+    inline double high_temperature_phi(const ThermoIntegrationPoint &point, double ln_omega) {
+      return point.potential_energy - ln_omega / point.beta;
+    }
+
+
+    /// \brief Integrates the grand canonical free energy along a path of
+    ///        conditions, starting from a reference point where it is known
+    ///
+    /// - The reference may be a low temperature expansion, a high temperature
+    ///   estimate, or the last point of a previous integration, so an
+    ///   integration can be continued as more conditions are calculated
+    ///
+    class ThermoIntegration {
+
+    public:
+
+      /// \brief Construct an empty ThermoIntegration, anchor must be called first
+      ThermoIntegration() :
+        m_beta_phi(0.0),
+        m_size(0) {}
+
+      /// \brief Begin integrating at 'point', where the free energy is 'phi'
+      ///
+      /// \returns phi
+      double anchor(const ThermoIntegrationPoint &point, double phi) {
+        m_last = point;
+        m_beta_phi = point.beta * phi;
+        m_size = 1;
+        return phi;
+      }
+
+      /// \brief Integrate from the last point to 'point'
+      ///
+      /// \returns The grand canonical free energy, per unit cell, at 'point'
+      double add(const ThermoIntegrationPoint &point) {
+        m_beta_phi += integrate_beta_phi(m_last, point);
+        m_last = point;
+        ++m_size;
+        return phi();
+      }
+
+      /// \brief Number of points, including the anchor
+      Index size() const {
+        return m_size;
+      }
+
+      /// \brief True if anchor has not been called
+      bool empty() const {
+        return m_size == 0;
+      }
+
+      /// \brief Last point
+      const ThermoIntegrationPoint &last() const {
+        return m_last;
+      }
+
+      /// \brief Grand canonical free energy, per unit cell, at the last point
+      double phi() const {
+        return m_beta_phi / m_last.beta;
+      }
+
+    private:
+
+      ThermoIntegrationPoint m_last;
+
+      /// beta*phi at m_last
+      double m_beta_phi;
+
+      Index m_size;
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef CASM_Monte_WangLandau_HH
+#define CASM_Monte_WangLandau_HH
+
+#include <map>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+  namespace Monte {
+
+    /// \brief Parameters controlling a Wang-Landau calculation
+    struct WangLandauParams {
+
+      /// \brief Initial ln(f), the amount ln(g) of the current bin is increased each step
+      double ln_f_initial = 1.0;
+
+      /// \brief The calculation is converged once ln(f) <= ln_f_final
+      double ln_f_final = 1e-6;
+
+      /// \brief The histogram is flat if min(H) >= flatness * mean(H), over visited bins
+      double flatness = 0.8;
+
+      /// \brief If true, switch to ln(f) = 1/t once ln(f) would be less than 1/t
+      ///        (Belardinelli and Pereyra), where t is the number of steps per
+      ///        visited bin
+      bool one_over_t = true;
+    };
+
+    /// \brief Wang-Landau estimate of the density of states, g(E), in an energy window
+    ///
+    /// Energies are binned on a grid shared by all windows, with bin b covering
+    /// [origin + b*bin_width, origin + (b+1)*bin_width). A window covers bins
+    /// [bin_begin, bin_end), so that windows calculated separately can be combined
+    /// by 'stitch'.
+    ///
+    /// Each step:
+    /// - A proposed change from energy E to E' is accepted with probability
+    ///   min(1, g(E)/g(E')) by 'accept', or rejected if E' is outside the window.
+    ///   While E is outside the window, changes that do not move E further from
+    ///   the window are accepted, so that a calculation can start anywhere.
+    /// - 'update' is called with the energy after the step, increasing ln(g(E))
+    ///   by ln(f) and adding one to the histogram H(E).
+    ///
+    /// Periodically, 'check_flat' reduces ln(f) by half and resets H once H is
+    /// flat. With WangLandauParams::one_over_t, once ln(f) would be less than 1/t,
+    /// ln(f) = 1/t is used thereafter, which avoids saturation of the error. The
+    /// calculation is converged once ln(f) <= WangLandauParams::ln_f_final.
+    ///
+    class WangLandau {
+
+    public:
+
+      /// \brief Construct a window, covering bins [bin_begin, bin_end)
+      WangLandau(double origin,
+                 double bin_width,
+                 Index bin_begin,
+                 Index bin_end,
+                 const WangLandauParams &params = WangLandauParams());
+
+      /// \brief Bin containing 'energy', which may be outside the window
+      Index bin(double energy) const;
+
+      /// \brief Energy at the center of bin 'b'
+      double energy(Index b) const {
+        return m_origin + (b + 0.5) * m_bin_width;
+      }
+
+      /// \brief Return true if bin 'b' is in the window
+      bool contains(Index b) const {
+        return b >= m_bin_begin && b < m_bin_end;
+      }
+
+      /// \brief Decide whether to accept a change from 'energy' to 'new_energy',
+      ///        given a random number in [0, 1)
+      bool accept(double energy, double new_energy, double rand) const;
+
+      /// \brief Update ln(g) and the histogram with the energy after a step
+      void update(double energy);
+
+      /// \brief If the histogram is flat, reduce ln(f), reset the histogram and return true
+      bool check_flat();
+
+      /// \brief Return true once ln(f) <= WangLandauParams::ln_f_final
+      bool is_converged() const {
+        return m_ln_f <= m_params.ln_f_final;
+      }
+
+      /// \brief Current ln(f)
+      double ln_f() const {
+        return m_ln_f;
+      }
+
+      /// \brief Return true if using ln(f) = 1/t
+      bool is_one_over_t() const {
+        return m_is_one_over_t;
+      }
+
+      /// \brief Number of times ln(f) has been reduced by a flat histogram
+      Index iterations() const {
+        return m_iterations;
+      }
+
+      /// \brief Number of steps taken within the window
+      Index steps() const {
+        return m_steps;
+      }
+
+      /// \brief First bin in the window
+      Index bin_begin() const {
+        return m_bin_begin;
+      }
+
+      /// \brief One past the last bin in the window
+      Index bin_end() const {
+        return m_bin_end;
+      }
+
+      /// \brief Estimated ln(g) of bin 'b', up to a constant
+      double ln_g(Index b) const {
+        return m_ln_g[b - m_bin_begin];
+      }
+
+      /// \brief Histogram count of bin 'b', since the last reset
+      Index histogram(Index b) const {
+        return m_histogram[b - m_bin_begin];
+      }
+
+      /// \brief Return true if bin 'b' has ever been visited
+      bool visited(Index b) const {
+        return m_visited[b - m_bin_begin];
+      }
+
+      const WangLandauParams &params() const {
+        return m_params;
+      }
+
+    private:
+
+      double m_origin;
+
+      double m_bin_width;
+
+      Index m_bin_begin;
+
+      Index m_bin_end;
+
+      WangLandauParams m_params;
+
+      double m_ln_f;
+
+      bool m_is_one_over_t;
+
+      Index m_iterations;
+
+      Index m_steps;
+
+      /// Number of bins that have ever been visited
+      Index m_n_visited;
+
+      std::vector<double> m_ln_g;
+
+      std::vector<Index> m_histogram;
+
+      std::vector<bool> m_visited;
+
+    };
+
+    /// \brief Combine ln(g) of overlapping windows, in order of increasing energy
+    std::map<Index, double> stitch(const std::vector<WangLandau> &windows);
+
+  }
+}
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef CASM_WangLandauDriver_HH
+#define CASM_WangLandauDriver_HH
+
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include "casm/external/boost.hh"
+#include "casm/casm_io/json_io/container.hh"
+
+#include "casm/monte_carlo/MonteIO.hh"
+#include "casm/monte_carlo/MonteCarlo.hh"
+#include "casm/monte_carlo/MonteDriver.hh"
+#include "casm/monte_carlo/MonteSettings.hh"
+#include "casm/monte_carlo/WangLandau.hh"
+
+namespace CASM {
+
+  /**
+   * WangLandauDriver estimates the density of states, g(E), of the potential energy
+   * per unit cell, E, for the supercell and the first conditions in the conditions list,
+   * using the Wang-Landau method with the 1/t modification (see Monte::WangLandau).
+   *
+   * - The energy range "driver"/"wang_landau"/"energy_min" to "energy_max" is divided
+   *   into "windows" overlapping windows, each calculated by its own specialized
+   *   MonteCarlo object in its own thread. Events are proposed and applied by the
+   *   MonteCarlo object, as for Metropolis calculations, but accepted with probability
+   *   min(1, g(E)/g(E')).
+   * - Each window begins with the DoF specified for the "motif", and first steps toward
+   *   its energy range if it begins outside of it.
+   * - Histogram flatness is checked every "check_period" passes. A window stops once
+   *   converged, or after "data"/"max_pass" passes, if given.
+   * - ln(g) of the windows is stitched together and written, with each window, to
+   *   "output_dir/dos.json". ln(g) is shifted so that its minimum is 0.
+   * - Because the composition is fixed, temperature dependent properties at that
+   *   composition may be calculated from g(E) for any temperature.
+   *
+   * RunType must provide, in addition to the MonteDriver requirements:
+   * - const EventType &propose(), void accept(const EventType &), and
+   *   void reject(const EventType &), where EventType::dEpot() is the change in
+   *   potential energy of the supercell
+   * - double potential_energy() const, per unit cell
+   */
+
+  template<typename RunType>
+  class WangLandauDriver {
+
+  public:
+    typedef typename RunType::CondType CondType;
+    typedef typename RunType::SettingsType SettingsType;
+
+    /// \brief Constructor via MonteSettings
+    WangLandauDriver(PrimClex &primclex, const SettingsType &settings, Log &_log, Log &_err_log);
+
+    /// \brief Run everything requested by the MonteSettings
+    void run();
+
+  private:
+
+    /// Data for a single energy window
+    struct Window {
+
+      Window(PrimClex &primclex,
+             const SettingsType &settings,
+             int verbosity,
+             const Monte::WangLandau &_wl,
+             MTRand::uint32 seed) :
+        log(new OStringStreamLog(verbosity)),
+        mc(new RunType(primclex, settings, *log)),
+        wl(_wl),
+        mtrand(seed),
+        passes(0) {}
+
+      /// Window log, flushed to the driver log after running
+      std::unique_ptr<OStringStreamLog> log;
+
+      std::unique_ptr<RunType> mc;
+
+      Monte::WangLandau wl;
+
+      /// Random number generator for acceptance
+      MTRand mtrand;
+
+      MonteCounter::size_type passes;
+
+      /// Holds any exception thrown while running in a worker thread
+      std::exception_ptr error;
+    };
+
+    /// \brief Run window 'i' until converged
+    void _run_window(Index i);
+
+    /// \brief Write stitched ln(g) and the data for each window
+    void _write_results() const;
+
+    /// \brief Copy window log messages to the driver log, in order
+    void _flush_logs();
+
+
+    /// target for log messages
+    Log &m_log;
+
+    /// target for error messages
+    Log &m_err_log;
+
+    ///Copy of initial settings given at construction
+    SettingsType m_settings;
+
+    /// describes where to write output
+    MonteCarloDirectoryStructure m_dir;
+
+    ///List of specialized conditions; only the first is used
+    const std::vector<CondType> m_conditions_list;
+
+    /// Number of passes between histogram flatness checks
+    MonteCounter::size_type m_check_period;
+
+    /// One MonteCarlo object per energy window
+    std::vector<Window> m_window;
+
+    /// Random number generator for seeding windows
+    MTRand m_twister;
+  };
+
+
+  template<typename RunType>
+  WangLandauDriver<RunType>::WangLandauDriver(PrimClex &primclex, const SettingsType &settings, Log &_log, Log &_err_log):
+    m_log(_log),
+    m_err_log(_err_log),
+    m_settings(settings),
+    m_dir(m_settings.output_directory()),
+    m_conditions_list(make_conditions_list<RunType>(primclex, m_settings, m_dir, m_err_log)),
+    m_check_period(m_settings.wang_landau_check_period()) {
+
+    if(m_settings.is_enumeration()) {
+      throw std::runtime_error(
+        "Error in WangLandauDriver: \"data\"/\"enumeration\" is not supported.");
+    }
+    if(m_check_period < 1) {
+      throw std::runtime_error(
+        "Error in WangLandauDriver: \"driver\"/\"wang_landau\"/\"check_period\" must be >= 1.");
+    }
+
+    double energy_min = m_settings.wang_landau_energy_min();
+    double energy_max = m_settings.wang_landau_energy_max();
+    double bin_width = m_settings.wang_landau_bin_width();
+    Index n_windows = m_settings.wang_landau_windows();
+    double overlap = m_settings.wang_landau_overlap();
+    if(!(energy_max > energy_min) || !(bin_width > 0.0)) {
+      throw std::runtime_error(
+        "Error in WangLandauDriver: expected \"energy_max\" > \"energy_min\" and \"bin_width\" > 0.");
+    }
+    if(n_windows < 1 || !(overlap > 0.0 && overlap < 1.0)) {
+      throw std::runtime_error(
+        "Error in WangLandauDriver: expected \"windows\" >= 1 and 0 < \"overlap\" < 1.");
+    }
+
+    // n_bins = width + (n_windows-1)*width*(1-overlap)
+    Index n_bins = std::ceil((energy_max - energy_min) / bin_width);
+    double width = n_bins / (1.0 + (n_windows - 1) * (1.0 - overlap));
+    if(n_windows > 1 && width * overlap < 1.0) {
+      throw std::runtime_error(
+        "Error in WangLandauDriver: windows must overlap by at least one bin.");
+    }
+
+    // windows are constructed serially, so that any lazily constructed PrimClex
+    // data (Clexulator, ECI, neighbor lists) exists before running in parallel
+    Monte::WangLandauParams params = m_settings.wang_landau_params();
+    m_window.reserve(n_windows);
+    for(Index i = 0; i < n_windows; ++i) {
+      Index bin_begin = std::floor(i * width * (1.0 - overlap));
+      Index bin_end = (i + 1 == n_windows) ? n_bins : std::ceil(bin_begin + width);
+      m_window.emplace_back(
+        primclex, m_settings, m_log.verbosity(),
+        Monte::WangLandau(energy_min, bin_width, bin_begin, bin_end, params),
+        m_twister.randInt());
+    }
+    _flush_logs();
+  }
+
+  /// \brief Run calculations for all windows at once, and write the density of states
+  ///
+  /// - If "output_dir/dos.json" exists, the calculation is not repeated
+  template<typename RunType>
+  void WangLandauDriver<RunType>::run() {
+
+    m_log.check("For existing calculations");
+
+    if(fs::exists(m_dir.dos_json())) {
+      m_log << "found: " << m_dir.dos_json() << "\n";
+      m_log << "calculations already complete." << std::endl;
+      return;
+    }
+    m_log << "did not find existing calculations\n" << std::endl;
+
+    if(m_conditions_list.size() > 1) {
+      m_log << "only the first of " << m_conditions_list.size() << " conditions is used\n" << std::endl;
+    }
+
+    for(auto &w : m_window) {
+      w.mc->set_state(m_conditions_list[0], m_settings);
+    }
+    _flush_logs();
+
+    m_log.begin("Wang-Landau");
+    m_log << m_window.size() << " energy windows\n";
+    for(Index i = 0; i < m_window.size(); ++i) {
+      const auto &wl = m_window[i].wl;
+      m_log << "  " << i << ": [" << wl.energy(wl.bin_begin()) - 0.5 * m_settings.wang_landau_bin_width()
+            << ", " << wl.energy(wl.bin_end() - 1) + 0.5 * m_settings.wang_landau_bin_width() << ")\n";
+    }
+    m_log << "check period: " << m_check_period << " (passes)\n" << std::endl;
+    m_log.begin_lap();
+
+    std::vector<std::thread> threads;
+    for(Index i = 0; i < m_window.size(); ++i) {
+      threads.emplace_back(&WangLandauDriver::_run_window, this, i);
+    }
+    for(auto &t : threads) {
+      t.join();
+    }
+
+    _flush_logs();
+    for(auto &w : m_window) {
+      if(w.error) {
+        std::rethrow_exception(w.error);
+      }
+    }
+
+    // timing info:
+    double s = m_log.lap_time();
+    m_log.end("Wang-Landau");
+    m_log << "run time: " << s << " (s)\n" << std::endl;
+
+    m_log.write("Output files");
+    _write_results();
+    m_log << std::endl;
+  }
+
+  /// \brief Run window 'i' until converged
+  ///
+  /// - Runs in a worker thread, so all messages go to the window log and any
+  ///   exception is stored in the window
+  template<typename RunType>
+  void WangLandauDriver<RunType>::_run_window(Index i) {
+
+    Window &w = m_window[i];
+
+    try {
+
+      RunType &mc = *w.mc;
+      Monte::WangLandau &wl = w.wl;
+      Log &log = *w.log;
+      double N = mc.supercell().volume();
+      Index steps_per_pass = mc.steps_per_pass();
+
+      while(!wl.is_converged()) {
+
+        if(m_settings.is_max_pass() && w.passes >= m_settings.max_pass()) {
+          log.custom("Window " + std::to_string(i));
+          log << "maximum passes reached before convergence, ln(f): " << wl.ln_f() << "\n" << std::endl;
+          break;
+        }
+
+        for(Index step = 0; step < steps_per_pass; ++step) {
+          const auto &event = mc.propose();
+          double energy = mc.potential_energy();
+          if(wl.accept(energy, energy + event.dEpot() / N, w.mtrand.rand53())) {
+            mc.accept(event);
+          }
+          else {
+            mc.reject(event);
+          }
+          wl.update(mc.potential_energy());
+        }
+        ++w.passes;
+
+        if(w.passes % m_check_period == 0 && wl.check_flat()) {
+          log.custom<Log::verbose>("Window " + std::to_string(i) + " histogram is flat");
+          log << "pass: " << w.passes << "  "
+              << "iteration: " << wl.iterations() << "  "
+              << "ln(f): " << wl.ln_f()
+              << (wl.is_one_over_t() ? " (1/t)" : "") << "\n" << std::endl;
+        }
+      }
+    }
+    catch(...) {
+      w.error = std::current_exception();
+    }
+  }
+
+  /// \brief Write stitched ln(g) and the data for each window
+  ///
+  /// Writes "output_dir/dos.json":
+  /// \code
+  /// {
+  ///   "energy": [...],  // bin centers, per unit cell
+  ///   "ln_g": [...],    // stitched ln(g), minimum 0
+  ///   "bin_width": number,
+  ///   "volume": int,    // supercell volume, in unit cells
+  ///   "windows": [
+  ///     {"energy": [...], "ln_g": [...], "histogram": [...],
+  ///      "is_converged": bool, "ln_f": number, "iterations": int,
+  ///      "steps": int, "passes": int},
+  ///     ...
+  ///   ]
+  /// }
+  /// \endcode
+  template<typename RunType>
+  void WangLandauDriver<RunType>::_write_results() const {
+
+    std::vector<Monte::WangLandau> windows;
+    for(const auto &w : m_window) {
+      windows.push_back(w.wl);
+    }
+    auto ln_g = Monte::stitch(windows);
+
+    jsonParser json;
+    std::vector<double> energy_vec, ln_g_vec;
+    for(const auto &val : ln_g) {
+      energy_vec.push_back(windows[0].energy(val.first));
+      ln_g_vec.push_back(val.second);
+    }
+    to_json(energy_vec, json["energy"]);
+    to_json(ln_g_vec, json["ln_g"]);
+    json["bin_width"] = m_settings.wang_landau_bin_width();
+    json["volume"] = m_window[0].mc->supercell().volume();
+
+    json["windows"].put_array();
+    for(const auto &w : m_window) {
+      jsonParser window_json;
+      std::vector<double> window_energy, window_ln_g;
+      std::vector<Index> histogram;
+      for(Index b = w.wl.bin_begin(); b < w.wl.bin_end(); ++b) {
+        if(w.wl.visited(b)) {
+          window_energy.push_back(w.wl.energy(b));
+          window_ln_g.push_back(w.wl.ln_g(b));
+          histogram.push_back(w.wl.histogram(b));
+        }
+      }
+      to_json(window_energy, window_json["energy"]);
+      to_json(window_ln_g, window_json["ln_g"]);
+      to_json(histogram, window_json["histogram"]);
+      window_json["is_converged"] = w.wl.is_converged();
+      window_json["ln_f"] = w.wl.ln_f();
+      window_json["iterations"] = w.wl.iterations();
+      window_json["steps"] = w.wl.steps();
+      window_json["passes"] = w.passes;
+      json["windows"].push_back(window_json);
+    }
+
+    fs::create_directories(m_dir.output_dir());
+    m_log << "write: " << m_dir.dos_json() << "\n";
+    json.write(m_dir.dos_json());
+  }
+
+  /// \brief Copy window log messages to the driver log, in order
+  template<typename RunType>
+  void WangLandauDriver<RunType>::_flush_logs() {
+    for(auto &w : m_window) {
+      std::string msg = w.log->ss().str();
+      if(!msg.empty()) {
+        m_log.require<Log::none>() << msg;
+        w.log->ss().str("");
+      }
+    }
+    m_log << std::flush;
+  }
+
+}
+
+#endif
@@ -1,10 +1,15 @@
 #ifndef CASM_Canonical_HH
 #define CASM_Canonical_HH
 
+#include <memory>
 #include "casm/clex/Clex.hh"
 #include "casm/monte_carlo/MonteDefinitions.hh"
 #include "casm/monte_carlo/MonteCarlo.hh"
 #include "casm/monte_carlo/MonteCarloEnum.hh"
+#include "casm/monte_carlo/BiasPotential.hh"
+#include "casm/monte_carlo/Checkerboard.hh"
+#include "casm/monte_carlo/HopList.hh"
+#include "casm/monte_carlo/SumTree.hh"
 #include "casm/monte_carlo/Conversions.hh"
 #include "casm/monte_carlo/OccCandidate.hh"
 #include "casm/monte_carlo/OccLocation.hh"
@@ -58,6 +63,9 @@ namespace CASM {
       /// \brief Set configdof and clear previously collected data
       void set_configdof(const ConfigDoF &configdof, const std::string &msg = "");
 
+      /// \brief Set configdof without clearing previously collected data
+      void exchange_configdof(const ConfigDoF &configdof);
+
       /// \brief Set configdof and conditions and clear previously collected data
       std::pair<ConfigDoF, std::string> set_state(
         const CanonicalConditions &new_conditions,
@@ -80,6 +88,22 @@ namespace CASM {
       /// \brief Nothing needs to be done to reject a CanonicalEvent
       void reject(const EventType &event);
 
+      /// \brief Returns true if each pass is performed as a checkerboard parallel sweep
+      bool is_parallel_sweep() const {
+        return static_cast<bool>(m_checkerboard);
+      }
+
+      /// \brief Attempt to swap the occupants of pairs of variable sites, in parallel
+      void parallel_sweep();
+
+      /// \brief Returns true if performing kinetic Monte Carlo, where every step is a hop
+      bool is_rejection_free() const {
+        return static_cast<bool>(m_hops);
+      }
+
+      /// \brief Perform up to 'max_steps' kinetic Monte Carlo steps at once
+      Index rejection_free_step(Index max_steps, bool &accepted);
+
       void check_corr() {
         std::cout << "corr:" << std::endl;
         std::cout << correlations_vec(_configdof(), supercell(), _clexulator()) << std::endl;
@@ -89,6 +113,15 @@ namespace CASM {
       /// \brief Write results to files
       void write_results(Index cond_index) const;
 
+      /// \brief Write results for conditions 'cond_index', other than the results summary
+      void write_conditions_results(Index cond_index) const;
+
+      /// \brief Write MonteCarlo checkpoint data, and the state of the Canonical method
+      void write_checkpoint(std::ostream &sout) const;
+
+      /// \brief Restore data written by write_checkpoint
+      void read_checkpoint(std::istream &sin);
+
 
       /// \brief Formation energy, normalized per primitive cell
       const double &formation_energy() const {
@@ -110,6 +143,11 @@ namespace CASM {
         return *m_comp_n;
       }
 
+      /// \brief Bias potential, inactive unless umbrella sampling
+      const BiasPotential &bias() const {
+        return m_bias;
+      }
+
       /// \brief Get potential energy
       double potential_energy(const Configuration &config) const;
 
@@ -144,12 +182,23 @@ namespace CASM {
         return m_formation_energy_clex.eci();
       }
 
-      void _set_nlist(Index l) const;
-      void _calc_delta_point_corr(Index l, int new_occ, Eigen::VectorXd &dCorr_comp) const;
+      /// \brief Site 'l' of a swap, changing to occupant 'new_occ'
+      ClexSwapSite _swap_site(Index l, int new_occ) const;
+
+      /// \brief Calculate the change in correlations due to swapping the occupants of sites 'l_a' and 'l_b'
+      void _calc_delta_swap_corr(Clexulator &clexulator,
+                                 Index l_a,
+                                 int new_occ_a,
+                                 Index l_b,
+                                 int new_occ_b,
+                                 Eigen::VectorXd &dCorr) const;
 
       /// \brief Calculate delta correlations for an event
       void _set_dCorr(CanonicalEvent &event) const;
 
+      /// \brief Calculate the change in formation energy for an event, without delta correlations
+      double _calc_delta_energy(const CanonicalEvent &event) const;
+
       /// \brief Print correlations to _log()
       void _print_correlations(const Eigen::VectorXd &corr,
                                std::string title,
@@ -162,6 +211,33 @@ namespace CASM {
       /// \brief Calculate properties given current conditions
       void _update_properties();
 
+      /// \brief Check that the bias potential can be used with the requested method
+      void _bias_construct(const CanonicalSettings &settings);
+
+      /// \brief Decide whether to calculate changes in energy without delta correlations
+      void _delta_energy_construct();
+
+      /// \brief Construct data structures for kinetic Monte Carlo
+      void _kmc_construct(const CanonicalSettings &settings);
+
+      /// \brief Reset the kinetic Monte Carlo time and displacements, and calculate all hop rates
+      void _kmc_initialize();
+
+      /// \brief Select the next hop and the time it occurs
+      void _kmc_select();
+
+      /// \brief Perform a hop, update displacements, and update the rates of affected hops
+      void _kmc_hop(Index hop_index);
+
+      /// \brief Set m_event for a hop, returns false if the hop is not possible
+      bool _kmc_set_event(Index hop_index);
+
+      /// \brief Calculate the rate of a hop
+      void _kmc_update_rate(Index hop_index);
+
+      /// \brief Update the diffusion coefficient properties
+      void _kmc_update_diffusion();
+
       /// \brief Generate supercell filling ConfigDoF from default configuration
       ConfigDoF _default_motif() const;
 
@@ -204,6 +280,13 @@ namespace CASM {
       /// \brief If the supercell is large enough, calculate delta correlations directly
       bool m_use_deltas;
 
+      /// \brief If correlations are not needed, calculate the change in formation
+      ///        energy directly, without delta correlations
+      bool m_use_delta_energy;
+
+      /// \brief ECI for all correlations, zero if not included, if m_use_delta_energy
+      Eigen::VectorXd m_dense_eci;
+
       ///Keeps track of what sites have which occupants
       OccLocation m_occ_loc;
 
@@ -213,6 +296,64 @@ namespace CASM {
       /// Event to propose, check, accept/reject:
       CanonicalEvent m_event;
 
+      /// \brief Groups of non-interacting sites, if using checkerboard parallel sweeps
+      std::unique_ptr<Checkerboard> m_checkerboard;
+
+      /// \brief Per thread data for checkerboard parallel sweeps
+      std::vector<SweepData> m_sweep_data;
+
+      /// \brief Bias potential for umbrella sampling
+      BiasPotential m_bias;
+
+
+      // ---- Kinetic Monte Carlo
+
+      /// \brief Hops between sites, if performing kinetic Monte Carlo
+      std::unique_ptr<HopList> m_hops;
+
+      /// \brief Rate of each hop
+      SumTree m_kmc_rate;
+
+      /// \brief Hop attempt frequency
+      double m_kmc_nu;
+
+      /// \brief Kinetic Monte Carlo time interval of one step
+      double m_kmc_step_time;
+
+      /// \brief Number of steps since the state was set
+      Index m_kmc_steps;
+
+      /// \brief Next hop
+      Index m_kmc_next_hop;
+
+      /// \brief Kinetic Monte Carlo time of the next hop
+      double m_kmc_next_time;
+
+      /// \brief Kinetically resolved activation barrier, by species index, NaN if
+      ///        the species does not hop
+      std::vector<double> m_kmc_kra;
+
+      /// \brief True if a species is a vacancy, by species index
+      std::vector<bool> m_kmc_vacancy;
+
+      /// \brief Unit cells with a neighborhood that includes each unit cell
+      std::vector<std::vector<Index> > m_kmc_affected_uc;
+
+      /// \brief Used to update each hop rate once per step
+      std::vector<Index> m_kmc_stamp;
+
+      /// \brief Current value for m_kmc_stamp
+      Index m_kmc_curr_stamp;
+
+      /// \brief Number of each species in the supercell
+      Eigen::VectorXd m_kmc_N;
+
+      /// \brief Sum of squared displacements of each species
+      Eigen::VectorXd m_kmc_Rsq;
+
+      /// \brief Sum of displacements of each species, a column for each species
+      Eigen::MatrixXd m_kmc_R;
+
 
       // ---- Pointers to properties for faster access
 
@@ -228,6 +369,21 @@ namespace CASM {
       /// \brief Number of atoms of each type, normalized per primitive cell
       Eigen::VectorXd *m_comp_n;
 
+      /// \brief Kinetic Monte Carlo time
+      double *m_kmc_time;
+
+      /// \brief Tracer diffusion coefficient of each species
+      Eigen::VectorXd *m_D_tracer;
+
+      /// \brief Collective diffusion coefficient of each species
+      Eigen::VectorXd *m_D_collective;
+
+      /// \brief Bias potential order parameter
+      double *m_order_parameter;
+
+      /// \brief Bias energy, normalized per primitive cell
+      double *m_bias_energy;
+
     };
   }
 }
@@ -83,6 +83,12 @@ namespace CASM {
       ///Subtract temperature and all chemical potentials together and return a new Condition
       CanonicalConditions operator-(const CanonicalConditions &RHS) const;
 
+      ///Multiply temperature and all compositions of *this by a factor
+      CanonicalConditions &operator*=(double factor);
+
+      ///Multiply temperature and all compositions by a factor and return a new Condition
+      CanonicalConditions operator*(double factor) const;
+
       ///Compare temperature and all chemical potentials to *this
       bool operator==(const CanonicalConditions &RHS) const;
 
@@ -1,6 +1,7 @@
 #ifndef CASM_CanonicalSettings
 #define CASM_CanonicalSettings
 
+#include <map>
 #include "casm/monte_carlo/MonteSettings.hh"
 #include "casm/external/boost.hh"
 
@@ -51,6 +52,18 @@ namespace CASM {
       bool all_correlations() const;
 
 
+      // --- Kinetic Monte Carlo settings ---------------------
+
+      /// \brief Maximum hop distance
+      double kmc_hop_cutoff() const;
+
+      /// \brief Hop attempt frequency. Default 1e13.
+      double kmc_attempt_frequency() const;
+
+      /// \brief Kinetically resolved activation barrier of each species that hops
+      std::map<std::string, double> kmc_kra() const;
+
+
     private:
 
       CompositionConverter m_comp_converter;
@@ -70,6 +83,9 @@ namespace CASM {
       template<typename jsonParserIteratorType, typename SamplerInsertIterator>
       SamplerInsertIterator _make_query_samplers(const PrimClex &primclex, jsonParserIteratorType it, SamplerInsertIterator result) const;
 
+      template<typename jsonParserIteratorType, typename SamplerInsertIterator>
+      SamplerInsertIterator _make_diffusion_coefficient_samplers(const PrimClex &primclex, jsonParserIteratorType it, SamplerInsertIterator result) const;
+
     };
 
 
@@ -106,6 +122,12 @@ namespace CASM {
         "formation_energy"
       };
 
+      // the bias energy is required to recover unbiased averages
+      if(is_bias()) {
+        required.push_back("order_parameter");
+        required.push_back("bias_energy");
+      }
+
       // add required if not already requested
       for(auto it = required.begin(); it != required.end(); ++it) {
         if(std::find(input_measurements.begin(), input_measurements.end(), *it) == input_measurements.end()) {
@@ -126,7 +148,10 @@ namespace CASM {
           // scalar quantities that we incrementally update
           std::vector<std::string> scalar_possible = {
             "formation_energy",
-            "potential_energy"
+            "potential_energy",
+            "kmc_time",
+            "order_parameter",
+            "bias_energy"
           };
 
           // check if property found is in list of possible scalar properties
@@ -149,7 +174,8 @@ namespace CASM {
           // scalar quantities that we incrementally update
           std::vector<std::string> vector_possible = {
             "all_correlations",
-            "non_zero_eci_correlations"
+            "non_zero_eci_correlations",
+            "diffusion_coefficients"
           };
 
           // check if property found is in list of possible vector properties
@@ -167,6 +193,13 @@ namespace CASM {
 
               result = _make_non_zero_eci_correlations_samplers(primclex, it, result);
 
+            }
+
+            // construct MonteSamplers for 'diffusion_coefficients'
+            else if(prop_name == "diffusion_coefficients") {
+
+              result = _make_diffusion_coefficient_samplers(primclex, it, result);
+
             }
             continue;
           }
@@ -274,6 +307,46 @@ namespace CASM {
       return result;
     }
 
+    template<typename jsonParserIteratorType, typename SamplerInsertIterator>
+    SamplerInsertIterator CanonicalSettings::_make_diffusion_coefficient_samplers(
+      const PrimClex &primclex,
+      jsonParserIteratorType it,
+      SamplerInsertIterator result) const {
+
+      size_type data_maxlength = max_data_length();
+      std::string print_name;
+      bool must_converge;
+      double prec;
+      MonteSampler *ptr;
+
+      auto species_name = primclex.get_prim().get_struc_molecule_name();
+
+      for(std::string prop_name : {
+            "D_tracer", "D_collective"
+          }) {
+
+        for(size_type i = 0; i < species_name.size(); i++) {
+
+          print_name = prop_name + "(" + species_name[i] + ")";
+
+          std::tie(must_converge, prec) = _get_precision(it);
+
+          // if 'must converge'
+          if(must_converge) {
+            ptr = new VectorMonteSampler(prop_name, i, print_name, prec, confidence(), data_maxlength);
+          }
+          else {
+            ptr = new VectorMonteSampler(prop_name, i, print_name, confidence(), data_maxlength);
+          }
+
+          *result++ = std::make_pair(print_name, notstd::cloneable_ptr<MonteSampler>(ptr));
+
+        }
+      }
+
+      return result;
+    }
+
     template<typename jsonParserIteratorType, typename SamplerInsertIterator>
     SamplerInsertIterator CanonicalSettings::_make_query_samplers(
       const PrimClex &primclex,
@@ -5,6 +5,10 @@
 #include "casm/monte_carlo/MonteDefinitions.hh"
 #include "casm/monte_carlo/MonteCarlo.hh"
 #include "casm/monte_carlo/MonteCarloEnum.hh"
+#include "casm/monte_carlo/Conversions.hh"
+#include "casm/monte_carlo/OccCandidate.hh"
+#include "casm/monte_carlo/OccEventSpec.hh"
+#include "casm/monte_carlo/OccLocation.hh"
 #include "casm/monte_carlo/SiteExchanger.hh"
 #include "casm/monte_carlo/grand_canonical/ChargeNeutralGrandCanonicalEvent.hh"
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalConditions.hh"
@@ -81,6 +85,9 @@ class ChargeNeutralGrandCanonical : public MonteCarlo{
 	  /// \brief Write results to files
     void write_results(Index cond_index) const;
 
+    /// \brief Write results for conditions 'cond_index', other than the results summary
+    void write_conditions_results(Index cond_index) const;
+
     /// \brief Calculate the single spin flip low temperature expansion of the grand canonical potential
     double lte_grand_canonical_free_energy() const;
 
@@ -154,15 +161,15 @@ class ChargeNeutralGrandCanonical : public MonteCarlo{
 
 	/// This function needs to do all the math for energy and correlation deltas and store
 	/// the results inside the containers hosted by event.
-	  void _update_deltas(EventType &event, 
-						std::vector<Index> &mutating_sites,
-						std::vector<Index> &sublats,
-						std::vector<int> &curr_occs,
-						std::vector<int> &new_occs) const;
+	  void _update_deltas(EventType &event, const Monte::OccEvent &occ_event) const;
     
       /// \brief Calculate properties given current conditions
     void _update_properties();
 
+
+    /// \brief Multi-site events to propose, from settings or the default Ce/O triplets
+    std::vector<Monte::OccEventSpec> _occ_event_spec(const SettingsType &settings) const;
+
     /// \brief Generate supercell filling ConfigDoF from default configuration
     ConfigDoF _default_motif() const;
 
@@ -195,6 +202,25 @@ class ChargeNeutralGrandCanonical : public MonteCarlo{
     /// \brief If the supercell is large enough, calculate delta correlations directly
     bool m_use_deltas;
 
+    /// Sublattices with index < m_n_Ce are Ce4/Ce3 sites, the others are O/Va sites
+    Index m_n_Ce;
+
+
+    /// Index conversions
+    Monte::Conversions m_convert;
+
+    /// Allowed (asym, species) occupants
+    Monte::OccCandidateList m_cand;
+
+    /// Location of each (asym, species) occupant
+    Monte::OccLocation m_occ_loc;
+
+    /// Proposes multi-site events
+    Monte::OccEventProposer m_event_proposer;
+
+    /// Sites changed by the proposed event
+    Monte::OccEvent m_occ_event;
+
 
     // ---- Pointers to properties for faster access
 
@@ -9,9 +9,9 @@ namespace CASM{
 
 /// \brief Data structure for storing information regarding a proposed charge neutral grand canonical Monte Carlo event
 /// Zeyu: this is used as a data framework to store all informations related to charge neutral GCMC
-/// Proposing a ChargeNeutralGrandCanonicalEvent will propose 3 GrandCanonicalEvent:
-/// A event will be proposed: pick two sites, one Na/Va site and one Si/P site, and apply the same to_value() value in OccMod
-/// in this case the charge is always balanced
+/// Proposing a ChargeNeutralGrandCanonicalEvent will propose size() GrandCanonicalEvent that must occur together,
+/// for example: pick two Ce4/Ce3 sites and one O/Va site with the same occupant index and apply the same to_value() value in OccMod
+/// in this case the charge is always balanced. Changes to each of the sites are stored at index site().
 
 class ChargeNeutralGrandCanonicalEvent {
 	public:
@@ -27,6 +27,12 @@ class ChargeNeutralGrandCanonicalEvent {
     	///
     	ChargeNeutralGrandCanonicalEvent(size_type Nspecies, size_type Ncorr);
 
+		/// \brief Set the number of sites changed by this event
+		void resize(size_type n_sites);
+
+		/// \brief Number of sites changed by this event
+		size_type size() const;
+
     	/// \brief Set the change in (extensive) formation energy associated with this event
     	void set_dEf(double dEf);
 
@@ -64,18 +70,22 @@ class ChargeNeutralGrandCanonicalEvent {
     	/// \brief const Access the changes in (extensive) correlations associated with this event
     	const std::vector<Eigen::VectorXd> &dCorr() const;
 
-		void set_original_occ_first_swap(int occ);
-		int const original_occ_first_swap() const;
+		/// \brief Set which of the site changes the set_* functions and dN(Index) refer to
+		void set_site(size_type site);
+
+		/// \brief Which of the site changes the set_* functions and dN(Index) refer to
+		size_type site() const;
 
-	
-		void set_is_swapped(bool is_swapped);
-		bool is_swapped();
-		const bool is_swapped() const;
-		
 		void set_dEpot_swapped_twice(double dEpot_swapped_twice);
 		double dEpot_swapped_twice();
 		const double dEpot_swapped_twice() const;
 
+		/// \brief Set the ratio of proposal probabilities, P(reverse event) / P(this event)
+		void set_proposal_ratio(double proposal_ratio);
+
+		/// \brief Ratio of proposal probabilities, P(reverse event) / P(this event)
+		double proposal_ratio() const;
+
 
   	private:
     	/// \brief Change in (extensive) correlations due to this event
@@ -94,10 +104,21 @@ class ChargeNeutralGrandCanonicalEvent {
     	/// \brief The ConfigDoF modification performed by this event , Pairs
     	std::vector <OccMod> m_occ_mod;
 
-		/// dEpot for two swaps
+		/// Number of sites changed by this event, the containers may be larger
+		size_type m_size;
+
+		size_type m_Nspecies;
+
+		size_type m_Ncorr;
+
+		/// dEpot for all site changes
 		double m_dEpot_swapped_twice;
-		bool m_is_swapped;
-		int m_original_occ_first_swap;
+
+		/// Which of the site changes the set_* functions refer to
+		size_type m_site;
+
+		/// P(reverse event) / P(this event)
+		double m_proposal_ratio;
 		
 
 };
@@ -107,19 +128,32 @@ class ChargeNeutralGrandCanonicalEvent {
   /// \param Nspecies The number of different molecular species in this calculation (use CompositionConverter::components().size())
   /// \param Ncorr The total number of correlations that could be calculated (use Clexulator::corr_size)
   ///
-  inline ChargeNeutralGrandCanonicalEvent::ChargeNeutralGrandCanonicalEvent(size_type Nspecies, size_type Ncorr){
-		// if (!is_swapped()){
-			m_dCorr[0] = Eigen::VectorXd(Ncorr);
-			m_dN[0] = Eigen::VectorXl(Nspecies);
-			m_dCorr[1] = Eigen::VectorXd(Ncorr);
-			m_dN[1] = Eigen::VectorXl(Nspecies);
-			m_dCorr[2] = Eigen::VectorXd(Ncorr);
-			m_dN[2] = Eigen::VectorXl(Nspecies);
-
-		// }
-		// if (is_swapped()){ // for initialization....
-		// }
-	 }
+  inline ChargeNeutralGrandCanonicalEvent::ChargeNeutralGrandCanonicalEvent(size_type Nspecies, size_type Ncorr) :
+		m_dEpot_swapped_twice(0.0),
+		m_site(0),
+		m_proposal_ratio(1.0),
+		m_size(0),
+		m_Nspecies(Nspecies),
+		m_Ncorr(Ncorr) {}
+
+	  /// \brief Set the number of sites changed by this event
+	  ///
+	  /// - Containers only grow, so that proposing events of different sizes does not reallocate
+	  inline void ChargeNeutralGrandCanonicalEvent::resize(size_type n_sites) {
+		if(n_sites > m_dCorr.size()) {
+			m_dCorr.resize(n_sites, Eigen::VectorXd::Zero(m_Ncorr));
+			m_dEf.resize(n_sites, 0.0);
+			m_dEpot.resize(n_sites, 0.0);
+			m_dN.resize(n_sites, Eigen::VectorXl::Zero(m_Nspecies));
+			m_occ_mod.resize(n_sites);
+		}
+		m_size = n_sites;
+	  }
+
+	  /// \brief Number of sites changed by this event
+	  inline ChargeNeutralGrandCanonicalEvent::size_type ChargeNeutralGrandCanonicalEvent::size() const {
+		return m_size;
+	  }
 
 	  /// \brief Return change in total (formation) energy associated with this event
 	  inline std::vector<double> ChargeNeutralGrandCanonicalEvent::dEf() const {
@@ -127,12 +161,7 @@ class ChargeNeutralGrandCanonicalEvent {
 	  }
 	  /// \brief Set the change in total (formation) energy associated with this event
 	  inline void ChargeNeutralGrandCanonicalEvent::set_dEf(double dEf) {
-		if(!is_swapped()){
-			m_dEf[0] = dEf;
-		}
-		if (is_swapped()){
-	   		m_dEf[2] = dEf;
-		}
+		m_dEf[m_site] = dEf;
 	  }
 
 	  /// \brief Access change in number of all species (extensive). Order as in CompositionConverter::components().
@@ -146,32 +175,17 @@ class ChargeNeutralGrandCanonicalEvent {
 
 	  /// \brief const Access change in number of species (extensive) described by size_type. Order as in CompositionConverter::components().
 	  inline long int ChargeNeutralGrandCanonicalEvent::dN(size_type species_type_index) const {
-		if(!is_swapped()){
-			return m_dN[0](species_type_index);
-		}
-		if (is_swapped()){
-	   		return m_dN[2](species_type_index);
-		}
+		return m_dN[m_site](species_type_index);
 	  }
 
 	  /// \brief Set the change in number of species (extensive) described by size_type. Order as in CompositionConverter::components().
 	  inline void ChargeNeutralGrandCanonicalEvent::set_dN(size_type species_type_index, long int dNi) {
-		if(!is_swapped()){
-			 m_dN[0](species_type_index) = dNi;
-		}
-		if (is_swapped()){
-	   		 m_dN[2](species_type_index) = dNi;
-		}
+		 m_dN[m_site](species_type_index) = dNi;
 	  }
 
 	  /// \brief Set the change in potential energy: dEpot = dEf - sum_i(Nunit * param_chem_pot_i * dcomp_x_i)
 	  inline void ChargeNeutralGrandCanonicalEvent::set_dEpot(double dEpot) {
-		if(!is_swapped()){
-			m_dEpot[0] = dEpot;
-		}
-		if (is_swapped()){
-	   		m_dEpot[2] = dEpot;
-		}
+		m_dEpot[m_site] = dEpot;
 	  }
 
 	  /// \brief Return change in potential energy: dEpot = dEf - sum_i(Nunit * param_chem_pot_i * dcomp_x_i)
@@ -197,15 +211,12 @@ class ChargeNeutralGrandCanonicalEvent {
       inline const std::vector<Eigen::VectorXd> &ChargeNeutralGrandCanonicalEvent::dCorr() const{
 		  return m_dCorr;
 	  }
-	  inline void ChargeNeutralGrandCanonicalEvent::set_is_swapped(bool is_swapped){
-		  m_is_swapped = is_swapped;
+	  inline void ChargeNeutralGrandCanonicalEvent::set_site(size_type site){
+		  m_site = site;
+	  }
+	  inline ChargeNeutralGrandCanonicalEvent::size_type ChargeNeutralGrandCanonicalEvent::site() const {
+	    return m_site;
 	  }
-	  inline bool ChargeNeutralGrandCanonicalEvent::is_swapped() {
-	    return m_is_swapped;
-	  }	
-	  inline const bool ChargeNeutralGrandCanonicalEvent::is_swapped() const{
-	    return m_is_swapped;
-	  }	
 
 
 	  inline void ChargeNeutralGrandCanonicalEvent::set_dEpot_swapped_twice(double dEpot_swapped_twice) {
@@ -218,11 +229,11 @@ class ChargeNeutralGrandCanonicalEvent {
 	  inline const double ChargeNeutralGrandCanonicalEvent::dEpot_swapped_twice() const{
 	    return m_dEpot_swapped_twice;
 	  }	
-	  inline void ChargeNeutralGrandCanonicalEvent::set_original_occ_first_swap(int occ){
-		  m_original_occ_first_swap = occ;
+	  inline void ChargeNeutralGrandCanonicalEvent::set_proposal_ratio(double proposal_ratio){
+		  m_proposal_ratio = proposal_ratio;
 	  }
-	  inline const int ChargeNeutralGrandCanonicalEvent::original_occ_first_swap() const{
-		  return m_original_occ_first_swap;
+	  inline double ChargeNeutralGrandCanonicalEvent::proposal_ratio() const{
+		  return m_proposal_ratio;
 	  }
 
 }
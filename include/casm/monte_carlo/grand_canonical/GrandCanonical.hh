@@ -2,9 +2,13 @@
 #define CASM_GrandCanonical_HH
 
 #include "casm/clex/Clex.hh"
+#include <memory>
 #include "casm/monte_carlo/MonteDefinitions.hh"
+#include "casm/monte_carlo/Checkerboard.hh"
+#include "casm/monte_carlo/SumTree.hh"
 #include "casm/monte_carlo/MonteCarlo.hh"
 #include "casm/monte_carlo/MonteCarloEnum.hh"
+#include "casm/monte_carlo/BiasPotential.hh"
 #include "casm/monte_carlo/SiteExchanger.hh"
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalEvent.hh"
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalConditions.hh"
@@ -55,6 +59,9 @@ namespace CASM {
     /// \brief Set configdof and clear previously collected data
     void set_configdof(const ConfigDoF &configdof, const std::string &msg = "");
 
+    /// \brief Set configdof without clearing previously collected data
+    void exchange_configdof(const ConfigDoF &configdof);
+
     /// \brief Set configdof and conditions and clear previously collected data
     std::pair<ConfigDoF, std::string> set_state(
       const GrandCanonicalConditions &new_conditions,
@@ -77,6 +84,28 @@ namespace CASM {
     /// \brief Nothing needs to be done to reject a GrandCanonicalEvent
     void reject(const EventType &event);
 
+    /// \brief Returns true if each pass is performed as a checkerboard parallel sweep
+    bool is_parallel_sweep() const {
+      return static_cast<bool>(m_checkerboard);
+    }
+
+    /// \brief Attempt to change the occupant of every variable site once, in parallel
+    void parallel_sweep();
+
+    /// \brief Returns true if steps are performed using 'rejection_free_step'
+    bool is_rejection_free() const {
+      return m_rejection_free;
+    }
+
+    /// \brief Perform up to 'max_steps' steps at once, rejection-free
+    Index rejection_free_step(Index max_steps, bool &accepted);
+
+    /// \brief Returns true if changes in formation energy are calculated with
+    ///        Clexulator::calc_delta_point_energy, without delta correlations
+    bool use_delta_energy() const {
+      return m_use_delta_energy;
+    }
+
     void check_corr() {
       std::cout << "corr:" << std::endl;
       std::cout << correlations_vec(_configdof(), supercell(), _clexulator()) << std::endl;
@@ -86,10 +115,37 @@ namespace CASM {
     /// \brief Write results to files
     void write_results(Index cond_index) const;
 
+    /// \brief Write results for conditions 'cond_index', other than the results summary
+    void write_conditions_results(Index cond_index) const;
+
+    /// \brief Write MonteCarlo checkpoint data, and the state of the GrandCanonical method
+    void write_checkpoint(std::ostream &sout) const;
+
+    /// \brief Restore data written by write_checkpoint
+    void read_checkpoint(std::istream &sin);
+
 
     /// \brief Calculate the single spin flip low temperature expansion of the grand canonical potential
     double lte_grand_canonical_free_energy() const;
 
+    /// \brief Calculate the low temperature expansion of the grand canonical potential, including pair excitations
+    double lte2_grand_canonical_free_energy() const;
+
+    /// \brief Pair of interacting variable sites (indices into the
+    ///        variable sites of the supercell, in order of linear site index),
+    ///        representing 'multiplicity' equivalent pairs
+    struct LTEPair {
+      Index i;
+      Index j;
+      Index multiplicity;
+    };
+
+    /// \brief Symmetrically distinct pairs of interacting variable sites, as used by lte2_grand_canonical_free_energy
+    std::vector<LTEPair> lte_pairs() const;
+
+    /// \brief Change in (extensive) potential energy due to changing the occupant of one site
+    double site_dEpot(Index mutating_site, int new_occupant) const;
+
     /// \brief Formation energy, normalized per primitive cell
     const double &formation_energy() const {
       return *m_formation_energy;
@@ -110,6 +166,11 @@ namespace CASM {
       return *m_comp_n;
     }
 
+    /// \brief Bias potential, inactive unless umbrella sampling
+    const Monte::BiasPotential &bias() const {
+      return m_bias;
+    }
+
     /// \brief Get potential energy
     double potential_energy(const Configuration &config) const;
 
@@ -151,7 +212,8 @@ namespace CASM {
                     int current_occupant,
                     int new_occupant,
                     bool use_deltas,
-                    bool all_correlations) const;
+                    bool all_correlations,
+                    Clexulator &clexulator) const;
 
     /// \brief Print correlations to _log()
     void _print_correlations(const Eigen::VectorXd &corr,
@@ -161,14 +223,50 @@ namespace CASM {
 
     /// \brief Calculate delta properties for an event and update the event with those properties
     void _update_deltas(GrandCanonicalEvent &event,
+                        Index mutating_site,
+                        int sublat,
+                        int current_occupant,
+                        int new_occupant,
+                        Clexulator &clexulator) const;
+
+    /// \brief Update event properties, using the site energy cache if enabled
+    bool _update_energy(GrandCanonicalEvent &event,
                         Index mutating_site,
                         int sublat,
                         int current_occupant,
                         int new_occupant) const;
 
+    /// \brief Number of threads to use for the low temperature expansion
+    Index _lte_threads() const;
+
+    /// \brief Change in potential energy of each single site excitation, by
+    ///        variable site and index of the new occupant in possible_swap
+    std::vector<std::vector<double> > _lte_point_dEpot() const;
+
     /// \brief Calculate properties given current conditions
     void _update_properties();
 
+    /// \brief Check that the bias potential can be used with the requested method
+    void _bias_construct(const GrandCanonicalSettings &settings);
+
+    /// \brief Decide whether to calculate changes in energy without delta correlations
+    void _delta_energy_construct();
+
+    /// \brief Construct the cache of single site energy changes
+    void _site_energy_cache_construct();
+
+    /// \brief Construct data structures for the rejection-free method
+    void _rf_construct();
+
+    /// \brief Calculate the rates of all events and select the next event
+    void _rf_initialize();
+
+    /// \brief Calculate the rates of all events on variable site 'i'
+    void _rf_update_site(Index i);
+
+    /// \brief Select the next event and the number of steps rejected before it
+    void _rf_select();
+
     /// \brief Generate supercell filling ConfigDoF from default configuration
     ConfigDoF _default_motif() const;
 
@@ -200,6 +298,57 @@ namespace CASM {
     /// \brief If the supercell is large enough, calculate delta correlations directly
     bool m_use_deltas;
 
+    /// \brief If correlations are not needed, calculate the change in formation
+    ///        energy directly, without delta correlations
+    bool m_use_delta_energy;
+
+    /// \brief ECI for all correlations, zero if not included, if m_use_delta_energy
+    Eigen::VectorXd m_dense_eci;
+
+    /// \brief Groups of non-interacting sites, if using checkerboard parallel sweeps
+    std::unique_ptr<Monte::Checkerboard> m_checkerboard;
+
+    /// \brief Per thread data for checkerboard parallel sweeps
+    std::vector<Monte::SweepData> m_sweep_data;
+
+    /// \brief Bias potential for umbrella sampling
+    Monte::BiasPotential m_bias;
+
+    /// \brief True if m_event was found in the site energy cache and delta
+    ///        correlations must be calculated if it is accepted
+    bool m_event_dCorr_pending;
+
+
+    // ---- Rejection-free (n-fold way) method
+
+    /// \brief If true, use the rejection-free method
+    bool m_rejection_free;
+
+    /// \brief Total rate of the events on each variable site
+    Monte::SumTree m_rf_site_rate;
+
+    /// \brief Rate of each event, m_rf_rate[i*m_rf_max_cand + j] for the j-th
+    ///        possible new occupant of variable site i
+    std::vector<double> m_rf_rate;
+
+    /// \brief Maximum number of possible new occupants on any variable site
+    Index m_rf_max_cand;
+
+    /// \brief Variable sites (indices into m_site_swaps.variable_sites()) in each unit cell
+    std::vector<std::vector<Index> > m_rf_uc_sites;
+
+    /// \brief Unit cells with a neighborhood that includes each unit cell
+    std::vector<std::vector<Index> > m_rf_affected_uc;
+
+    /// \brief Variable site of the next event
+    Index m_rf_site;
+
+    /// \brief Index of the new occupant (in possible_swap) of the next event
+    Index m_rf_cand;
+
+    /// \brief Number of steps that are rejected before the next event
+    Index m_rf_rejections;
+
 
     // ---- Pointers to properties for faster access
 
@@ -215,6 +364,12 @@ namespace CASM {
     /// \brief Number of atoms of each type, normalized per primitive cell
     Eigen::VectorXd *m_comp_n;
 
+    /// \brief Bias potential order parameter
+    double *m_order_parameter;
+
+    /// \brief Bias energy, normalized per primitive cell
+    double *m_bias_energy;
+
   };
 
 }
@@ -79,6 +79,12 @@ namespace CASM {
     ///Subtract temperature and all chemical potentials together and return a new Condition
     GrandCanonicalConditions operator-(const GrandCanonicalConditions &RHS) const;
 
+    ///Multiply temperature and all chemical potentials of *this by a factor
+    GrandCanonicalConditions &operator*=(double factor);
+
+    ///Multiply temperature and all chemical potentials by a factor and return a new Condition
+    GrandCanonicalConditions operator*(double factor) const;
+
     ///Compare temperature and all chemical potentials to *this
     bool operator==(const GrandCanonicalConditions &RHS) const;
 
@@ -13,6 +13,7 @@ namespace CASM {
   class MonteCarlo;
   typedef const MonteCarlo *ConstMonteCarloPtr;
   class GrandCanonical;
+  class GrandCanonicalSettings;
   class MonteSettings;
   class Log;
   class GrandCanonicalConditions;
@@ -21,7 +22,7 @@ namespace CASM {
   DataFormatter<ConstMonteCarloPtr> make_results_formatter(const GrandCanonical &mc);
 
   /// \brief Make a results formatter
-  DataFormatter<ConstMonteCarloPtr> make_lte_results_formatter(const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname);
+  DataFormatter<ConstMonteCarloPtr> make_lte_results_formatter(const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname, const double *phi_LTE2 = nullptr);
 
 
   /// \brief Store GrandCanonicalConditions in JSON format
@@ -34,8 +35,14 @@ namespace CASM {
   /// \brief Print single spin flip LTE
   GenericDatumFormatter<double, ConstMonteCarloPtr> GrandCanonicalLTEFormatter(const double &phi_LTE1);
 
+  /// \brief Print LTE including pair excitations
+  GenericDatumFormatter<double, ConstMonteCarloPtr> GrandCanonicalLTE2Formatter(const double &phi_LTE2);
+
   /// \brief Will create new file or append to existing results file the results of the latest run
-  void write_lte_results(const MonteSettings &settings, const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname, Log &_log);
+  void write_lte_results(const MonteSettings &settings, const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname, Log &_log, const double *phi_LTE2 = nullptr);
+
+  /// \brief Integrate the grand canonical free energy along the path of conditions in the results summary
+  void write_free_energy(PrimClex &primclex, const GrandCanonicalSettings &settings, Log &_log);
 
 }
 
@@ -8,6 +8,11 @@ namespace CASM {
 
   class GrandCanonicalConditions;
 
+  namespace Monte {
+    class Conversions;
+    struct OccEventSpec;
+  }
+
   class GrandCanonicalSettings : public EquilibriumMonteSettings {
 
   public:
@@ -39,6 +44,12 @@ namespace CASM {
     /// \brief Get formation energy cluster expansion
     ClexDescription formation_energy(const PrimClex &primclex) const;
 
+    /// \brief Return true if multi-site events are specified
+    bool is_occ_event_spec() const;
+
+    /// \brief Multi-site events, from ["model"]["events"]
+    std::vector<Monte::OccEventSpec> occ_event_spec(const Monte::Conversions &convert) const;
+
 
     // --- Sampler settings ---------------------
 
@@ -121,6 +132,12 @@ namespace CASM {
       "comp_n"
     };
 
+    // the bias energy is required to recover unbiased averages
+    if(is_bias()) {
+      required.push_back("order_parameter");
+      required.push_back("bias_energy");
+    }
+
     // add required if not already requested
     for(auto it = required.begin(); it != required.end(); ++it) {
       if(std::find(input_measurements.begin(), input_measurements.end(), *it) == input_measurements.end()) {
@@ -141,7 +158,9 @@ namespace CASM {
         // scalar quantities that we incrementally update
         std::vector<std::string> scalar_possible = {
           "formation_energy",
-          "potential_energy"
+          "potential_energy",
+          "order_parameter",
+          "bias_energy"
         };
 
         // check if property found is in list of possible scalar properties
@@ -13,7 +13,16 @@
 
 namespace CASM {
 
+  class RuntimeLibraryCache;
+
   /// \brief Write, compile, load and use code at runtime
+  ///
+  /// If the source code contains a line '#define RUNTIME_LIBRARY_SHARDS N',
+  /// it is compiled N times in parallel, with '-DRUNTIME_LIBRARY_SHARD=0', ...,
+  /// '-DRUNTIME_LIBRARY_SHARD=N-1', and the object files are linked into one
+  /// shared library. The source code is responsible for compiling a distinct
+  /// part of itself for each shard.
+  ///
   class RuntimeLibrary : public Logging {
 
   public:
@@ -27,6 +36,16 @@ namespace CASM {
       std::string compile_msg,
       const Logging &logging = Logging());
 
+    /// \brief Construct a RuntimeLibrary object, using 'cache' instead of
+    ///        compiling if the '.so' file does not exist
+    RuntimeLibrary(
+      std::string _filename_base,
+      std::string _compile_options,
+      std::string _so_options,
+      std::string compile_msg,
+      const RuntimeLibraryCache &cache,
+      const Logging &logging = Logging());
+
     ~RuntimeLibrary();
 
     /// \brief Obtain a function from the current library
@@ -71,14 +90,32 @@ namespace CASM {
     /// \brief Return default libdir for boost
     static std::pair<fs::path, std::string> default_boost_libdir();
 
+    /// \brief Return default number of shards to compile in parallel
+    ///
+    /// - $CASM_COMPILE_JOBS, or if unset or 0, the number of hardware threads,
+    ///   but no more than max_default_compile_jobs
+    static std::pair<Index, std::string> default_compile_jobs();
+
+    /// \brief Maximum number of shards compiled in parallel if $CASM_COMPILE_JOBS is unset or 0
+    static const Index max_default_compile_jobs = 4;
+
 
   private:
 
+    /// \brief Load the '.so' file, compiling it or using the cache if necessary
+    void _init(std::string compile_msg, const RuntimeLibraryCache *cache);
+
+    /// \brief Compile a shared library, with messages
+    void _compile(std::string out_base, std::string compile_msg);
+
     /// \brief Compile a shared library
-    void _compile();
+    void _compile(std::string out_base);
+
+    /// \brief Number of shards to compile the source code in
+    Index _n_shards() const;
 
     /// \brief Load a library with a given name
-    void _load();
+    void _load(std::string so_path);
 
     /// \brief Close the current library
     void _close();
@@ -0,0 +1,95 @@
+#ifndef RuntimeLibraryCache_HH
+#define RuntimeLibraryCache_HH
+
+#include <string>
+#include <functional>
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief A user-level cache of compiled runtime libraries, shared by projects
+  ///
+  /// Libraries are stored by a hash of the preprocessed source code, the
+  /// compile and shared library options, and the compiler version, so identical
+  /// source code compiled with identical options is only compiled once:
+  /// \code
+  /// cache_dir/
+  ///   cache.lock
+  ///   <key>.lock
+  ///   <key>/<name>.o
+  ///   <key>/<name>.so
+  ///   tmp/
+  /// \endcode
+  ///
+  /// - Entries are read with a shared lock on '<key>.lock' and created with an
+  ///   exclusive lock, so concurrent processes compile a library at most once
+  /// - New entries are compiled in 'tmp/' and renamed into place
+  /// - A symbolic link to the cached library is created next to the source
+  ///   code, so that loading it again does not require preprocessing
+  /// - When the total size of the entries exceeds max_size(), the least recently
+  ///   used entries that are not locked are removed
+  ///
+  class RuntimeLibraryCache {
+
+  public:
+
+    /// \brief Construct a RuntimeLibraryCache
+    ///
+    /// \param _dir Cache directory, created if necessary. If empty, the cache is disabled.
+    /// \param _max_size Maximum total size of the cached libraries, in bytes
+    ///
+    RuntimeLibraryCache(fs::path _dir, uintmax_t _max_size);
+
+    /// \brief Construct a RuntimeLibraryCache using default_dir() and default_max_size()
+    RuntimeLibraryCache();
+
+    /// \brief Cache directory
+    const fs::path &dir() const {
+      return m_dir;
+    }
+
+    /// \brief Maximum total size of the cached libraries, in bytes
+    uintmax_t max_size() const {
+      return m_max_size;
+    }
+
+    /// \brief True if the cache directory is set
+    bool enabled() const {
+      return !m_dir.empty();
+    }
+
+    /// \brief Load a library from the cache, compiling it first if necessary
+    bool load(const fs::path &src,
+              std::string compile_options,
+              std::string so_options,
+              std::function<void (const fs::path &out_base)> compile,
+              std::function<void (const fs::path &so_path)> load) const;
+
+    /// \brief Load a library through a link created by 'load'
+    bool load_link(const fs::path &link,
+                   std::function<void (const fs::path &so_path)> load) const;
+
+    /// \brief Cache key for 'src' compiled with 'compile_options' and 'so_options'
+    std::string key(const fs::path &src,
+                    std::string compile_options,
+                    std::string so_options) const;
+
+    /// \brief Remove least recently used entries until the cache is no larger than max_size()
+    void evict(std::string keep = "") const;
+
+    /// \brief Return default cache directory and specifying variable
+    static std::pair<fs::path, std::string> default_dir();
+
+    /// \brief Return default maximum cache size, in bytes, and specifying variable
+    static std::pair<uintmax_t, std::string> default_max_size();
+
+  private:
+
+    fs::path m_dir;
+    uintmax_t m_max_size;
+
+  };
+
+}
+
+#endif
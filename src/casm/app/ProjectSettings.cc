@@ -7,6 +7,7 @@
 
 #include "casm/clex/ConfigIOSelected.hh"
 #include "casm/clex/ConfigSelection.hh"
+#include "casm/system/RuntimeLibraryCache.hh"
 
 namespace CASM {
 
@@ -88,7 +89,8 @@ namespace CASM {
   ProjectSettings::ProjectSettings(fs::path root, std::string name, const Logging &logging) :
     Logging(logging),
     m_dir(root),
-    m_name(name) {
+    m_name(name),
+    m_clexulator_backend("compiled") {
 
     if(fs::exists(m_dir.casm_dir())) {
       throw std::runtime_error(
@@ -187,6 +189,7 @@ namespace CASM {
 
         // other options
         settings.get_if(m_view_command, "view_command");
+        settings.get_else(m_clexulator_backend, "clexulator_backend", std::string("compiled"));
         from_json(m_name, settings["name"]);
 
         // precision options
@@ -403,6 +406,15 @@ namespace CASM {
     return m_view_command;
   }
 
+  /// \brief Get Clexulator backend, "compiled" or "table"
+  ///
+  /// - "compiled": compile and load the generated Clexulator source code
+  /// - "table": evaluate the basis function tables written by 'casm bset -u',
+  ///   which does not require a c++ compiler
+  std::string ProjectSettings::clexulator_backend() const {
+    return m_clexulator_backend;
+  }
+
   /// \brief Get current project crystallography tolerance
   double ProjectSettings::crystallography_tol() const {
     return m_crystallography_tol;
@@ -567,6 +579,17 @@ namespace CASM {
     return true;
   }
 
+  /// \brief Set Clexulator backend, "compiled" or "table"
+  bool ProjectSettings::set_clexulator_backend(std::string opt) {
+    if(opt != "compiled" && opt != "table") {
+      err_log().error("Setting clexulator backend");
+      err_log() << "Expected 'compiled' or 'table', received: '" << opt << "'\n" << std::endl;
+      return false;
+    }
+    m_clexulator_backend = opt;
+    return true;
+  }
+
   /// \brief Set crystallography tolerance
   bool ProjectSettings::set_crystallography_tol(double _tol) {
     m_crystallography_tol = _tol;
@@ -605,6 +628,7 @@ namespace CASM {
       fs::remove(m_dir.clexulator_src(name(), *it));
       fs::remove(m_dir.clexulator_o(name(), *it));
       fs::remove(m_dir.clexulator_so(name(), *it));
+      fs::remove(m_dir.clexulator_table(name(), *it));
     }
   }
 
@@ -647,6 +671,7 @@ namespace CASM {
     _write_if("so_options", m_depr_so_options);
 
     json["view_command"] = view_command();
+    json["clexulator_backend"] = clexulator_backend();
     json["crystallography_tol"] = crystallography_tol();
     json["crystallography_tol"].set_scientific();
     json["lin_alg_tol"] = lin_alg_tol();
@@ -692,6 +717,19 @@ namespace CASM {
           "to use begin using the individually set settings.\n";
     }
     log << "so command: '" << so_options() << "'\n\n";
+
+    log << "clexulator backend: '" << clexulator_backend() << "'\n\n";
+
+    auto cache_dir = RuntimeLibraryCache::default_dir();
+    if(cache_dir.first.empty()) {
+      log << "clexulator cache: disabled (" << cache_dir.second << ")\n\n";
+    }
+    else {
+      auto cache_size = RuntimeLibraryCache::default_max_size();
+      log << _wdefaultval("clexulator cache", cache_dir)
+          << "clexulator cache size: " << cache_size.first / (1024 * 1024) << " MiB ("
+          << cache_size.second << ")\n\n";
+    }
   }
 
   /// \brief Print summary of ProjectSettings, as for 'casm settings -l'
@@ -6,6 +6,7 @@
 #include "casm/app/AppIO.hh"
 #include "casm/clusterography/Orbitree.hh"
 #include "casm/clex/PrimClex.hh"
+#include "casm/clex/ClexulatorTable.hh"
 #include "casm/clusterography/jsonClust.hh"
 #include "casm/completer/Handlers.hh"
 
@@ -125,7 +126,8 @@ namespace CASM {
                                        dir.basis(bset),
                                        dir.clexulator_src(set.name(), bset),
                                        dir.clexulator_o(set.name(), bset),
-                                       dir.clexulator_so(set.name(), bset)
+                                       dir.clexulator_so(set.name(), bset),
+                                       dir.clexulator_table(set.name(), bset)
                                       });
 
       bool any_existing_files = false;
@@ -147,6 +149,7 @@ namespace CASM {
           fs::remove(dir.clexulator_src(set.name(), bset));
           fs::remove(dir.clexulator_o(set.name(), bset));
           fs::remove(dir.clexulator_so(set.name(), bset));
+          fs::remove(dir.clexulator_table(set.name(), bset));
           if(args.primclex) {
             args.primclex->refresh(false, false, false, false, true);
           }
@@ -158,9 +161,13 @@ namespace CASM {
       }
 
       SiteOrbitree tree(prim.lattice(), primclex.crystallography_tol());
+      bool delta_point_energy = true;
 
       try {
         jsonParser bspecs_json(dir.bspecs(bset));
+        if(bspecs_json.contains("basis_functions") && bspecs_json["basis_functions"].contains("delta_point_energy")) {
+          delta_point_energy = bspecs_json["basis_functions"]["delta_point_energy"].get<bool>();
+        }
 
         args.log.generate("Cluster orbits");
         args.log.begin_lap();
@@ -226,11 +233,30 @@ namespace CASM {
       // write source code
       fs::ofstream outfile;
       outfile.open(dir.clexulator_src(set.name(), bset));
-      print_clexulator(prim, tree, nlist, set.clexulator(), outfile, primclex.crystallography_tol());
+      print_clexulator(prim, tree, nlist, set.clexulator(), outfile, primclex.crystallography_tol(), delta_point_energy);
       outfile.close();
       args.log << "write: " << dir.clexulator_src(set.name(), bset) << "\n" << std::endl;
 
-      // compile clexulator
+      // write basis function tables, for the 'table' clexulator backend
+      try {
+        jsonParser table_json;
+        to_json(make_clexulator_table(prim, tree, nlist, primclex.crystallography_tol()), table_json);
+        outfile.open(dir.clexulator_table(set.name(), bset));
+        table_json.print(outfile, 2, 17);
+        outfile.close();
+        args.log << "write: " << dir.clexulator_table(set.name(), bset) << "\n" << std::endl;
+      }
+      catch(std::exception &e) {
+        if(set.clexulator_backend() == "table") {
+          args.err_log.error("Writing basis function tables");
+          args.err_log << e.what() << "\n" << std::endl;
+          return ERR_INVALID_INPUT_FILE;
+        }
+        args.log << "Note: basis function tables not written, the 'table' clexulator backend is not available.\n"
+                 << e.what() << "\n" << std::endl;
+      }
+
+      // compile clexulator, or load tables if using the 'table' backend
       primclex.clexulator(set.default_clex());
     }
     else if(vm.count("orbits") || vm.count("clusters") || vm.count("functions")) {
@@ -1008,6 +1008,12 @@ K_POINTS automatic\n\
                 << "'casm bset --functions'\n\n";
 
 
+      args.log << "The 'basis_functions' option 'delta_point_energy' (default true) controls  \n" <<
+               "whether the Clexulator includes a method that calculates the change in    \n" <<
+               "energy of an occupant change directly from the ECI, without calculating   \n" <<
+               "the change in correlations. Monte Carlo uses it when correlations are not \n" <<
+               "sampled.\n\n";
+
       args.log << "The JSON object 'orbit_branch_specs' specifies the maximum size of pair,   \n" <<
                "triplet, quadruplet, etc. clusters in terms of the maximum distance \n" <<
                "between any two sites in the cluster.\n\n";
@@ -1406,7 +1412,13 @@ Direct\n\
                "    \"Canonical\" or \"canonical\": Canonical Monte Carlo \n" <<
                "    calculation in which the total number of each type of occupant \n"
                "    is fixed. Each Monte Carlo step attempts to swap a pair of     \n"
-               "    occupants.                                                     \n\n\n" <<
+               "    occupants.                                                     \n\n" <<
+
+               "    \"ChargeNeutralGrandCanonical\" or                            \n" <<
+               "    \"charge_neutral_grand_canonical\": Semi-grand canonical Monte\n" <<
+               "    Carlo calculation in which several occupant changes that must  \n" <<
+               "    occur together are attempted at once, as specified by         \n" <<
+               "    \"model\"/\"events\".                                         \n\n\n" <<
 
 
                "\"method\" (string):                                               \n\n" <<
@@ -1417,14 +1429,100 @@ Direct\n\
                "    using the Metropolis algorithm.                                \n\n" <<
 
                "    \"LTE1\" or \"lte1\": Single spin flip low temperature         \n" <<
-               "    expansion calculations.                                        \n\n\n" <<
+               "    expansion calculations.                                        \n\n" <<
+
+               "    \"ReplicaExchange\" or \"replica_exchange\": Run Metropolis    \n" <<
+               "    Monte Carlo calculations at all conditions simultaneously, one \n" <<
+               "    thread per conditions, and periodically attempt to exchange the\n" <<
+               "    states of neighboring conditions (parallel tempering). Every   \n" <<
+               "    calculation begins with the \"motif\", and incomplete results \n" <<
+               "    are recalculated for all conditions. Enumeration is not        \n" <<
+               "    supported. For the \"canonical\" ensemble all conditions must \n" <<
+               "    have the same composition.                                     \n\n" <<
+
+               "    \"KMC\" or \"kmc\": For the \"canonical\" ensemble, run kinetic   \n" <<
+               "    Monte Carlo calculations, in which atoms hop to neighboring    \n" <<
+               "    vacancies, chosen with probability proportional to their rate, \n" <<
+               "    and time advances by the residence time. The rate of a hop is  \n" <<
+               "    nu*exp(-Ea/kT), with activation barrier                        \n" <<
+               "    Ea = max(E_kra + dE/2, dE, 0), where dE is the change in       \n" <<
+               "    formation energy. Each step is a fixed interval of time, equal \n" <<
+               "    to the mean residence time of the initial state, so samples are\n" <<
+               "    taken on a uniform time grid. Requires \"kmc\" settings.     \n\n" <<
+
+               "    \"WangLandau\" or \"wang_landau\": For the \"canonical\"       \n" <<
+               "    ensemble, calculate the density of states g(E) of the potential\n" <<
+               "    energy per unit cell, at the composition of the first          \n" <<
+               "    conditions, using the Wang-Landau method with the 1/t          \n" <<
+               "    modification. Energy windows are calculated at once, one thread\n" <<
+               "    per window, and stitched together. ln(g) is written to         \n" <<
+               "    \"output_directory\"/dos.json. Requires \"driver\"/\"wang_landau\"\n" <<
+               "    settings. Enumeration is not supported.                       \n\n\n" <<
+
+
+               "\"kmc\": (JSON object, \"method\": \"KMC\" only)                  \n\n" <<
+
+               "  /\"hop_cutoff\": (number)                                       \n" <<
+               "    Maximum distance, in Angstrom, between sites an atom may hop   \n" <<
+               "    between.                                                       \n\n" <<
+
+               "  /\"attempt_frequency\": (number, default 1e13)                  \n" <<
+               "    Hop attempt frequency, nu, in 1/s.                             \n\n" <<
+
+               "  /\"kra\": (JSON object)                                         \n" <<
+               "    Kinetically resolved activation barrier, E_kra, in eV, for each\n" <<
+               "    species that hops, Ex: {\"A\": 0.6, \"B\": 0.8}. Species that  \n" <<
+               "    are not included do not hop.                                   \n\n\n" <<
+
+
+               "\"bias\": (JSON object, optional, \"method\": \"Metropolis\" only)\n\n" <<
+
+               "  Umbrella sampling. A bias potential, u(q), per unit cell, of an  \n" <<
+               "  order parameter, q, is added to the change in potential energy  \n" <<
+               "  when deciding whether to accept an event. The properties        \n" <<
+               "  \"order_parameter\" and \"bias_energy\" are sampled, and for  \n" <<
+               "  each sampled property the mean reweighted to remove the bias,   \n" <<
+               "  \"unbiased(<X>)\", is included in the results. Not supported   \n" <<
+               "  with \"parallel_sweep\" or \"rejection_free\".                 \n\n" <<
+
+               "  /\"order_parameter\": (JSON object)                             \n" <<
+               "    /\"corr\": (JSON object)                                      \n" <<
+               "      Correlation indices and weights, q = sum_i w_i*corr_i, using  \n" <<
+               "      correlations per unit cell, Ex: {\"1\": 1.0, \"2\": -1.0}.   \n" <<
+               "      Point correlations may be used for sublattice compositions.   \n" <<
+               "      Unless \"all_correlations\" is sampled, all correlations   \n" <<
+               "      must have non-zero ECI.                                        \n\n" <<
+
+               "  /\"potential\": (JSON object)                                   \n" <<
+               "    {\"type\": \"harmonic\", \"center\": q0, \"spring\": k}:       \n" <<
+               "      u(q) = 0.5*k*(q - q0)^2                                       \n" <<
+               "    {\"type\": \"linear\", \"slope\": a}:                          \n" <<
+               "      u(q) = a*q                                                     \n" <<
+               "    {\"type\": \"table\", \"order_parameter\": [...], \"value\": [...]}:\n" <<
+               "      Linear interpolation of u(q), with q in increasing order, and \n" <<
+               "      constant beyond the first and last values.                     \n\n\n" <<
 
 
                "\"model\": (JSON object)                                           \n\n" <<
 
                "  /\"formation_energy\": (string, optional, default=\"formation_energy\")\n" <<
                "    Specifies the cluster expansion to use to calculated formation \n"
-               "    energy. Should be one of the ones listed by 'casm settings -l'.\n\n\n" <<
+               "    energy. Should be one of the ones listed by 'casm settings -l'.\n\n" <<
+
+               "  /\"events\": (JSON array, \"charge_neutral_grand_canonical\" only)\n" <<
+               "    Occupation changes that must occur together. Each event is an  \n" <<
+               "    object with a \"name\" and an array of \"sites\", each with  \n" <<
+               "    \"sublats\" (array of sublattice indices, including all that \n" <<
+               "    are symmetrically equivalent), \"from\" and \"to\" species. \n" <<
+               "    The reverse of each event is also attempted. Ex:               \n" <<
+               "      [{\"name\": \"reduction\", \"sites\": [                    \n" <<
+               "        {\"sublats\": [0], \"from\": \"Ce4\", \"to\": \"Ce3\"},   \n" <<
+               "        {\"sublats\": [0], \"from\": \"Ce4\", \"to\": \"Ce3\"},   \n" <<
+               "        {\"sublats\": [1], \"from\": \"O\", \"to\": \"Va\"}]}]     \n" <<
+               "    Sites with the same species must have the same or              \n" <<
+               "    non-overlapping \"sublats\". Default: two sites on sublattice \n" <<
+               "    0 and one site on the others, all with the same occupant index,\n" <<
+               "    change occupant index together.                                \n\n\n" <<
 
 
                "\"supercell\": (3x3 JSON arrays of integers)                      \n" <<
@@ -1466,6 +1564,11 @@ Direct\n\
                "      \"non_zero_eci_correlations\": correlations (per unit cell)  \n" <<
                "        which have non-zero eci values.                            \n" <<
                "      \"all_correlations\": correlations (per unit cell)           \n" <<
+               "      \"kmc_time\": kinetic Monte Carlo time, in s (\"KMC\" only)    \n" <<
+               "      \"diffusion_coefficients\": tracer and collective diffusion  \n" <<
+               "        coefficients of each species, in Angstrom^2/s, calculated  \n" <<
+               "        from displacements since the start of the calculation      \n" <<
+               "        (\"KMC\" only)                                             \n" <<
                "      \"<anything else>\": is interpreted as a 'casm query' query  \n\n" <<
 
                "  /\"confidence\": (number, range (0.0, 1.0), default 0.95)        \n" <<
@@ -1519,6 +1622,25 @@ Direct\n\
                "      where 'i' is the condition index and 'ext' is the output     \n" <<
                "      format.                                                      \n\n" <<
 
+               "    /\"trajectory_format\": (string, default \"output_format\")    \n" <<
+               "      If \"binary\", the trajectory is instead written as it is    \n" <<
+               "      sampled, to the file:                                        \n" <<
+               "        \"output_directory\"/conditions.i/trajectory.bin           \n" <<
+               "      which stores occupant indices of all sites at keyframes, and \n" <<
+               "      only the sites that changed for other samples. Use          \n" <<
+               "      MonteTrajectoryReader to read it.                            \n\n" <<
+
+               "    /\"trajectory_keyframe_period\": (integer, default 100)        \n" <<
+               "      Number of samples between keyframes of a binary trajectory. \n\n" <<
+
+               "    /\"checkpoint_period\": (integer, default 0)                   \n" <<
+               "      If > 0, write a checkpoint of the calculation at each set of \n" <<
+               "      conditions about every \"checkpoint_period\" passes, to:     \n" <<
+               "        \"output_directory\"/conditions.i/checkpoint.bin           \n" <<
+               "      If a calculation is stopped and restarted, it continues from \n" <<
+               "      the checkpoint as if it had not stopped. The checkpoint is   \n" <<
+               "      removed once results for the conditions are written.         \n\n" <<
+
                "  /\"enumeration\": (JSON object, optional)                        \n" <<
                "    If included, save configurations encountered during Monte      \n" <<
                "    Carlo calculations by keeping a 'hall of fame' of best scoring \n" <<
@@ -1615,7 +1737,24 @@ Direct\n\
                "        incremental conditions up to (and including) the final     \n" <<
                "        conditions.                                                \n\n" <<
                "      \"custom\": perform one or more calculations, as specified by\n" <<
-               "        the \"custom_conditions\".                                 \n\n" <<
+               "        the \"custom_conditions\".                                 \n" <<
+               "      \"adaptive\": as \"incremental\", but if a results summary  \n" <<
+               "        property changes by more than allowed between adjacent     \n" <<
+               "        conditions, also calculate the conditions half way between \n" <<
+               "        them. Conditions are numbered in the order calculated. Only \n" <<
+               "        for the \"metropolis\" method. Requires \"adaptive\".  \n\n" <<
+
+               "  /\"adaptive\": (JSON object, \"adaptive\" mode only)        \n\n" <<
+
+               "    /\"max_jump\": (JSON object)                                \n" <<
+               "      Maximum change in results summary properties between adjacent\n" <<
+               "      conditions. For example:                                     \n" <<
+               "        {\"<potential_energy>\": 0.005, \"<comp(a)>\": 0.02,     \n" <<
+               "         \"heat_capacity\": 1.0}                                  \n" <<
+               "    /\"max_refinement\": (integer, default 3)                    \n" <<
+               "      Maximum number of times an increment may be halved, so the   \n" <<
+               "      minimum step is incremental_conditions/2^max_refinement. The \n" <<
+               "      choices made are recorded in \"adaptive.json\" for restarts.\n\n" <<
 
                "  /\"dependent_runs\": (boolean, default true)                     \n\n" <<
 
@@ -1623,6 +1762,124 @@ Direct\n\
                "    previous calculation. If false, begin each calculation with the\n" <<
                "    DoF specified for the \"motif\".\n\n" <<
 
+               "  /\"threads\": (integer, default 1)                              \n\n" <<
+
+               "    If \"dependent_runs\" is false, the number of conditions to   \n" <<
+               "    calculate at once, each in its own thread. If 0, use the number\n" <<
+               "    of hardware threads. The results summary is written in order of\n" <<
+               "    conditions. Not used if \"enumeration\" is requested.\n\n" <<
+
+               "  /\"swap_period\": (integer, default 1)                          \n\n" <<
+
+               "    For \"method\": \"ReplicaExchange\", the number of passes each \n" <<
+               "    calculation runs between attempts to exchange states between   \n" <<
+               "    neighboring conditions.\n\n" <<
+
+               "  /\"wang_landau\": (JSON object, \"method\": \"WangLandau\" only) \n\n" <<
+
+               "    /\"energy_min\", /\"energy_max\": (number)                      \n" <<
+               "      Range of potential energy, per unit cell, to calculate.      \n" <<
+               "    /\"bin_width\": (number)                                      \n" <<
+               "      Width of energy bins, per unit cell.                         \n" <<
+               "    /\"windows\": (integer, default 1)                            \n" <<
+               "      Number of overlapping energy windows.                        \n" <<
+               "    /\"overlap\": (number, default 0.5)                           \n" <<
+               "      Fraction of each window that overlaps the next.              \n" <<
+               "    /\"check_period\": (integer, default 10)                      \n" <<
+               "      Number of passes between histogram flatness checks.          \n" <<
+               "    /\"flatness\": (number, default 0.8)                          \n" <<
+               "      The histogram is flat if min(H) >= flatness*mean(H), over    \n" <<
+               "      visited bins. Then ln(f) is halved and H is reset.           \n" <<
+               "    /\"ln_f_initial\": (number, default 1.0)                      \n" <<
+               "    /\"ln_f_final\": (number, default 1e-6)                       \n" <<
+               "      A window is converged once ln(f) <= ln_f_final, or stops     \n" <<
+               "      after \"data\"/\"max_pass\" passes, if given.                \n" <<
+               "    /\"one_over_t\": (bool, default true)                         \n" <<
+               "      If true, once ln(f) would be less than 1/t, where t is the   \n" <<
+               "      number of steps per visited bin, use ln(f) = 1/t.\n\n" <<
+
+               "  /\"parallel_sweep\": (integer, optional)                       \n\n" <<
+
+               "    If given, each pass is performed as a sweep over groups of     \n" <<
+               "    non-interacting sites, using this number of threads to attempt \n" <<
+               "    changes to the sites in a group at once. If 0, use the number  \n" <<
+               "    of hardware threads. Requires \"sample_by\": \"pass\" and a    \n" <<
+               "    supercell large enough that periodic images of the cluster     \n" <<
+               "    expansion neighborhood do not overlap. For \"canonical\", the  \n" <<
+               "    parallel sweep only swaps sites within a group, so it is       \n" <<
+               "    followed by a serial phase of (number of variable sites) /     \n" <<
+               "    (number of threads) swap attempts between any allowed sites.\n\n" <<
+
+               "  /\"corr_threads\": (integer, default 1)                        \n\n" <<
+
+               "    Number of threads to use to calculate correlations by summing   \n" <<
+               "    over all unit cells in the supercell, such as when setting the  \n" <<
+               "    initial state for each conditions. If 0, use the number of      \n" <<
+               "    hardware threads. Only supercells with more than 256 unit cells \n" <<
+               "    are divided among threads, and the result does not depend on    \n" <<
+               "    the number of threads.\n\n" <<
+
+               "  /\"rejection_free\": (boolean, default false)                   \n\n" <<
+
+               "    For \"grand_canonical\", if true, use the rejection-free       \n" <<
+               "    (n-fold way) method. The rate of every possible event is stored \n" <<
+               "    and updated after each accepted event, the next event is chosen \n" <<
+               "    with probability proportional to its rate, and the number of    \n" <<
+               "    steps that would have been rejected before it is counted        \n" <<
+               "    without being performed. Results are equivalent to the          \n" <<
+               "    Metropolis method, but much faster when most proposals would    \n" <<
+               "    be rejected, such as at low temperature. Requires a supercell   \n" <<
+               "    large enough that periodic images of the cluster expansion      \n" <<
+               "    neighborhood do not overlap.\n\n" <<
+
+               "  /\"site_energy_cache\": (boolean, default false)                \n\n" <<
+
+               "    For \"grand_canonical\", if true, store the change in formation \n" <<
+               "    energy of changing the occupant of each site, and recalculate   \n" <<
+               "    it only after an accepted event changes a site in its cluster   \n" <<
+               "    expansion neighborhood. Speeds up proposals at low acceptance   \n" <<
+               "    rates, the rejection-free method, and the low temperature       \n" <<
+               "    expansion. Uses memory for (number of sites) x (number of       \n" <<
+               "    occupants) values. May not be used with \"parallel_sweep\" or  \n" <<
+               "    \"bias\". Cache hits and memory are written to the log.\n\n" <<
+
+               "  /\"lte\": (JSON object, optional)                              \n\n" <<
+
+               "    Options for the \"lte1\" method:                             \n" <<
+               "    /\"threads\": (integer, default 1)                          \n" <<
+               "      Number of threads used to calculate excitation energies. If  \n" <<
+               "      0, use the number of hardware threads.                       \n" <<
+               "    /\"order\": (integer, default 1)                            \n" <<
+               "      If 2, also calculate \"phi_LTE2\", which includes pairs of \n" <<
+               "      single site excitations on sites that share a cluster        \n" <<
+               "      expansion neighborhood. Symmetrically equivalent pairs, under\n" <<
+               "      the operations that leave the ground state unchanged, are    \n" <<
+               "      calculated once.\n\n" <<
+
+               "  /\"free_energy\": (JSON object, optional)                      \n\n" <<
+
+               "    For \"grand_canonical\" \"metropolis\" and \"replica_exchange\",\n" <<
+               "    if given, after the run integrate the grand canonical free      \n" <<
+               "    energy, phi, per unit cell, along the path of conditions,       \n" <<
+               "    using d(Beta*phi) = <potential_energy>*dBeta -                  \n" <<
+               "    Beta*<comp(a)>*dparam_chem_pot(a) - ..., and write it to        \n" <<
+               "    \"free_energy.json\" (and \"free_energy.csv\"). Requires the   \n" <<
+               "    \"json\" output format. Integration stops at the first         \n" <<
+               "    conditions that are not equilibrated. When re-run, such as     \n" <<
+               "    after restarting or extending a run, only conditions with new  \n" <<
+               "    results are integrated. May also be run with                   \n" <<
+               "    'casm monte --free-energy'.                                    \n" <<
+               "    /\"anchor\": (string, required)                             \n" <<
+               "      Where phi is known, at the first conditions along the path:  \n" <<
+               "      \"lte\": low temperature expansion about the ground state,   \n" <<
+               "        using \"lte\"/\"order\". Requires \"motif\"/\"configname\" \n" <<
+               "        \"auto\" or \"restricted_auto\".                         \n" <<
+               "      \"high_temperature\": phi = <potential_energy> - kT*ln(W),   \n" <<
+               "        where W is the number of possible occupations of one unit  \n" <<
+               "        cell. Only accurate if the first temperature is high.     \n" <<
+               "      \"value\": phi given by \"value\".                          \n" <<
+               "    /\"value\": (number, required if \"anchor\" is \"value\")      \n\n" <<
+
 
                "  /\"initial_conditions\",\n" <<
                "  /\"incremental_conditions\", \n" <<
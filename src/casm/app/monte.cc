@@ -8,6 +8,8 @@
 #include "casm/monte_carlo/canonical/CanonicalIO.hh"
 #include "casm/monte_carlo/MonteIO.hh"
 #include "casm/monte_carlo/MonteDriver.hh"
+#include "casm/monte_carlo/ReplicaExchangeDriver.hh"
+#include "casm/monte_carlo/WangLandauDriver.hh"
 #include "casm/app/casm_functions.hh"
 #include "casm/completer/Handlers.hh"
 
@@ -52,7 +54,17 @@ namespace CASM {
          "    - The trajectory file must exist. This is generated when\n" <<
          "      using input option \"data\"/\"storage\"/\"write_trajectory\" = true  \n" <<
          "    - Written at: output_directory/conditions.5/trajectory/POSCAR.i,\n" <<
-         "      where i is the sample index.                          \n\n";
+         "      where i is the sample index.                          \n\n" <<
+
+         "  casm monte --settings input_file.json --free-energy         \n" <<
+         "    - Integrate the grand canonical free energy along the path\n" <<
+         "      of conditions in the existing results summary, starting \n" <<
+         "      from the \"driver\"/\"free_energy\"/\"anchor\". Only new\n" <<
+         "      or changed results are integrated if the output file exists.\n" <<
+         "    - This is done automatically after grand canonical Metropolis\n" <<
+         "      and replica exchange runs if \"driver\"/\"free_energy\" is given.\n" <<
+         "    - Requires results.json.                                  \n" <<
+         "    - Written at: output_directory/free_energy.json           \n\n";
 
   }
 
@@ -68,7 +80,8 @@ namespace CASM {
       m_desc.add_options()
       ("initial-POSCAR", po::value<Index>(&m_condition_index), "Given the condition index, print a POSCAR for the initial state of a monte carlo run.")
       ("final-POSCAR", po::value<Index>(&m_condition_index), "Given the condition index, print a POSCAR for the final state of a monte carlo run.")
-      ("traj-POSCAR", po::value<Index>(&m_condition_index), "Given the condition index, print POSCARs for the state at every sample of monte carlo run. Requires an existing trajectory file.");
+      ("traj-POSCAR", po::value<Index>(&m_condition_index), "Given the condition index, print POSCARs for the state at every sample of monte carlo run. Requires an existing trajectory file.")
+      ("free-energy", "Integrate the grand canonical free energy along the path of conditions in existing results. Requires \"driver\"/\"free_energy\" settings.");
       return;
     }
 
@@ -90,6 +103,14 @@ namespace CASM {
   template<typename MCType>
   int _driver(PrimClex &primclex, const CommandArgs &args, const Completer::MonteOption &monte_opt);
 
+  template<typename MCType>
+  int _replica_exchange_driver(PrimClex &primclex, const CommandArgs &args, const Completer::MonteOption &monte_opt);
+
+  template<typename MCType>
+  int _wang_landau_driver(PrimClex &primclex, const CommandArgs &args, const Completer::MonteOption &monte_opt);
+
+  int _free_energy(PrimClex &primclex, const CommandArgs &args, const Completer::MonteOption &monte_opt);
+
   int _run_GrandCanonical(
     PrimClex &primclex,
     const MonteSettings &monte_settings,
@@ -285,6 +306,49 @@ namespace CASM {
     }
   }
 
+  template<typename MCType>
+  int _replica_exchange_driver(PrimClex &primclex, const CommandArgs &args, const Completer::MonteOption &monte_opt) {
+    try {
+      typename MCType::SettingsType mc_settings(primclex, monte_opt.settings_path());
+      ReplicaExchangeDriver<MCType> driver(primclex, mc_settings, args.log, args.err_log);
+      driver.run();
+      return 0;
+    }
+    catch(std::exception &e) {
+      args.err_log << "ERROR running " << to_string(MCType::ensemble) << " replica exchange Monte Carlo.\n\n";
+      args.err_log << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  template<typename MCType>
+  int _wang_landau_driver(PrimClex &primclex, const CommandArgs &args, const Completer::MonteOption &monte_opt) {
+    try {
+      typename MCType::SettingsType mc_settings(primclex, monte_opt.settings_path());
+      WangLandauDriver<MCType> driver(primclex, mc_settings, args.log, args.err_log);
+      driver.run();
+      return 0;
+    }
+    catch(std::exception &e) {
+      args.err_log << "ERROR running " << to_string(MCType::ensemble) << " Wang-Landau Monte Carlo.\n\n";
+      args.err_log << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  int _free_energy(PrimClex &primclex, const CommandArgs &args, const Completer::MonteOption &monte_opt) {
+    try {
+      GrandCanonicalSettings gc_settings(primclex, monte_opt.settings_path());
+      write_free_energy(primclex, gc_settings, args.log);
+      return 0;
+    }
+    catch(std::exception &e) {
+      args.err_log << "ERROR integrating " << to_string(GrandCanonical::ensemble) << " free energy.\n\n";
+      args.err_log << e.what() << std::endl;
+      return 1;
+    }
+  }
+
   int _run_GrandCanonical(
     PrimClex &primclex,
     const MonteSettings &monte_settings,
@@ -303,6 +367,9 @@ namespace CASM {
     else if(vm.count("traj-POSCAR")) {
       return _traj_POSCAR<MCType>(primclex, args, monte_opt);
     }
+    else if(vm.count("free-energy")) {
+      return _free_energy(primclex, args, monte_opt);
+    }
     else if(monte_settings.method() == Monte::METHOD::LTE1) {
 
       try {
@@ -348,7 +415,14 @@ namespace CASM {
         args.log.custom("LTE Calculation");
         args.log << "Phi_LTE(1) = potential_energy_gs - kT*ln(Z'(1))/N" << std::endl;
         args.log << "Z'(1) = sum_i(exp(-dPE_i/kT), summing over ground state and single spin flips" << std::endl;
-        args.log << "dPE_i: (potential_energy_i - potential_energy_gs)*N" << "\n\n" << std::endl;
+        args.log << "dPE_i: (potential_energy_i - potential_energy_gs)*N" << "\n" << std::endl;
+        if(gc_settings.lte_order() == 2) {
+          args.log << "Phi_LTE(2) = potential_energy_gs - kT*ln(Z'(2))/N" << std::endl;
+          args.log << "ln(Z'(2)) = sum_i(x_i) - sum_s((sum_(i on s) x_i)^2)/2 + sum_ij(x_ij - x_i*x_j)" << std::endl;
+          args.log << "x_i = exp(-dPE_i/kT), x_ij = exp(-dPE_ij/kT), summing over single spin flips i," << std::endl;
+          args.log << "  sites s, and pairs of single spin flips ij on interacting sites" << std::endl;
+        }
+        args.log << "threads: " << gc_settings.lte_threads() << "\n\n" << std::endl;
 
         auto init = gc_settings.initial_conditions();
         auto incr = init;
@@ -380,8 +454,16 @@ namespace CASM {
 
           double phi_LTE1 = gc.lte_grand_canonical_free_energy();
 
-          args.log.write("Output files");
-          write_lte_results(gc_settings, gc, phi_LTE1, configname, args.log);
+          if(gc_settings.lte_order() == 2) {
+            double phi_LTE2 = gc.lte2_grand_canonical_free_energy();
+
+            args.log.write("Output files");
+            write_lte_results(gc_settings, gc, phi_LTE1, configname, args.log, &phi_LTE2);
+          }
+          else {
+            args.log.write("Output files");
+            write_lte_results(gc_settings, gc, phi_LTE1, configname, args.log);
+          }
           args.log << std::endl;
           cond += incr;
 
@@ -398,7 +480,18 @@ namespace CASM {
       }
     }
     else if(monte_settings.method() == Monte::METHOD::Metropolis) {
-      return _driver<GrandCanonical>(primclex, args, monte_opt);
+      int result = _driver<GrandCanonical>(primclex, args, monte_opt);
+      if(result || !monte_settings.is_free_energy()) {
+        return result;
+      }
+      return _free_energy(primclex, args, monte_opt);
+    }
+    else if(monte_settings.method() == Monte::METHOD::ReplicaExchange) {
+      int result = _replica_exchange_driver<GrandCanonical>(primclex, args, monte_opt);
+      if(result || !monte_settings.is_free_energy()) {
+        return result;
+      }
+      return _free_energy(primclex, args, monte_opt);
     }
     else {
       args.err_log << "ERROR running " << to_string(GrandCanonical::ensemble) << " Monte Carlo. No valid option given.\n\n";
@@ -424,9 +517,16 @@ namespace CASM {
     else if(vm.count("traj-POSCAR")) {
       return _traj_POSCAR<MCType>(primclex, args, monte_opt);
     }
-    else if(monte_settings.method() == Monte::METHOD::Metropolis) {
+    else if(monte_settings.method() == Monte::METHOD::Metropolis ||
+            monte_settings.method() == Monte::METHOD::KMC) {
       return _driver<MCType>(primclex, args, monte_opt);
     }
+    else if(monte_settings.method() == Monte::METHOD::ReplicaExchange) {
+      return _replica_exchange_driver<MCType>(primclex, args, monte_opt);
+    }
+    else if(monte_settings.method() == Monte::METHOD::WangLandau) {
+      return _wang_landau_driver<MCType>(primclex, args, monte_opt);
+    }
     else {
       args.err_log << "ERROR running " << to_string(Monte::Canonical::ensemble) << " Monte Carlo. No valid option given.\n\n";
       return ERR_INVALID_INPUT_FILE;
@@ -55,6 +55,7 @@ namespace CASM {
       ("set-eci", po::value<std::string>(&m_input_str), "Set the effective cluster interactions (ECI)")
       ("set-all", po::value<std::vector<std::string> >(&m_input_vec)->multitoken(), "Set the current property, calctype, ref, bset, and eci all at once.")
       ("set-view-command", po::value<std::string>(&m_input_str), "Set the command used by 'casm view'.")
+      ("set-clexulator-backend", po::value<std::string>(&m_input_str), "Set the Clexulator backend: 'compiled' (default) or 'table'.")
       ("set-cxx", po::value<std::string>(&m_input_str), "Set the c++ compiler. Use '' to revert to default.")
       ("set-cxxflags", po::value<std::string>(&m_input_str), "Set the c++ compiler options. Use '' to revert to default.")
       ("set-soflags", po::value<std::string>(&m_input_str), "Set the shared library compilation options. Use '' to revert to default.")
@@ -279,7 +280,7 @@ namespace CASM {
                                             "set-cxx", "set-cxxflags", "set-soflags",
                                             "set-casm-prefix", "set-casm-includedir", "set-casm-libdir",
                                             "set-boost-prefix", "set-boost-includedir", "set-boost-libdir",
-                                            "set-view-command"
+                                            "set-view-command", "set-clexulator-backend"
                                            };
         int option_count = 0;
         for(int i = 0; i < all_opt.size(); i++) {
@@ -397,6 +398,12 @@ namespace CASM {
                    "        2) $CASM_SOFLAGS \n"
                    "        3) \"-shared -lboost_system\" \n\n"
 
+                   "      $CASM_COMPILE_JOBS \n"
+                   "      - Maximum number of compiler processes used to compile \n"
+                   "        the shards of a large Clexulator in parallel. If unset\n"
+                   "        or 0, uses the number of hardware threads, but at most\n"
+                   "        4, because each process may use a lot of memory. \n\n"
+
                    "      casm settings --set-casm-prefix 'casm_prefix' \n"
                    "      casm settings --set-casm-includedir 'casm_includedir' \n"
                    "      casm settings --set-casm-libdir 'casm_libdir' \n"
@@ -424,7 +431,16 @@ namespace CASM {
                    "        visualization software.                              \n" <<
                    "      - Will be executed with '/path/to/POSCAR' as an        \n" <<
                    "        argument, the location of a POSCAR for a configuration\n" <<
-                   "        selected for visualization.                          \n" <<
+                   "        selected for visualization.                          \n\n" <<
+
+                   "      casm settings --set-clexulator-backend 'table'         \n" <<
+                   "      - Sets how basis functions are evaluated:              \n" <<
+                   "        'compiled': (default) compile and load the Clexulator\n" <<
+                   "          source code written by 'casm bset -u'.             \n" <<
+                   "        'table': evaluate the basis function tables written  \n" <<
+                   "          by 'casm bset -u'. Does not require a c++ compiler,\n" <<
+                   "          but is slower. Only supports occupation basis      \n" <<
+                   "          functions.                                         \n" <<
                    "\n";
 
           if(call_help)
@@ -846,6 +862,21 @@ namespace CASM {
       return 0;
     }
 
+    // set Clexulator backend
+    else if(vm.count("set-clexulator-backend")) {
+      if(!set.set_clexulator_backend(single_input)) {
+        return ERR_INVALID_ARG;
+      }
+      set.commit();
+      if(args.primclex) {
+        args.primclex->refresh(true, false, false, false, true);
+      }
+
+      args.log << "Set clexulator backend to: '" << set.clexulator_backend() << "'\n\n";
+
+      return 0;
+    }
+
     args.log << std::endl;
 
     return 0;
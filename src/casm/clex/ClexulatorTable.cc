@@ -0,0 +1,499 @@
+#include "casm/clex/ClexulatorTable.hh"
+
+#include <algorithm>
+#include <map>
+
+#include "casm/casm_io/jsonParser.hh"
+#include "casm/casm_io/json_io/container.hh"
+#include "casm/basis_set/PolynomialFunction.hh"
+#include "casm/basis_set/OccupantFunction.hh"
+#include "casm/clusterography/Orbitree.hh"
+#include "casm/crystallography/Structure.hh"
+#include "casm/misc/algorithm.hh"
+#include "casm/clex/PrimClex.hh"
+
+namespace CASM {
+
+  namespace {
+
+    typedef ClexTermTable::size_type size_type;
+
+    /// \brief Number of unit cells evaluated together by TableClexulator::calc_global_corr_sum
+    const size_type corr_batch_size = 64;
+
+    /// \brief Offsets into ClexulatorTable::occ_func, by (basis_ind, occ_func_ind)
+    typedef std::map<std::pair<Index, Index>, size_type> OccFuncIndex;
+
+    /// \brief Append the terms of 'func', times 'scale', to the current function of 'table'
+    ///
+    /// - Factors on the site with neighbor list index 'center' are placed first
+    /// - Use center == -1 if no site is changing
+    void _add_terms(ClexTermTable &table,
+                    Function const *func,
+                    double scale,
+                    Index center,
+                    const OccFuncIndex &occ_func_index) {
+
+      if(!func) {
+        return;
+      }
+
+      auto poly = dynamic_cast<PolynomialFunction const *>(func);
+      if(!poly) {
+        throw std::runtime_error(
+          std::string("Error in make_clexulator_table: basis function type '") +
+          func->type_name() + "' is not supported");
+      }
+
+      std::vector<size_type> site_nlist, site_func, other_nlist, other_func;
+
+      PolyTrie<double>::const_iterator it(poly->poly_coeffs().begin()), it_end(poly->poly_coeffs().end());
+      for(; it != it_end; ++it) {
+        if(almost_zero(*it)) {
+          continue;
+        }
+
+        site_nlist.clear();
+        site_func.clear();
+        other_nlist.clear();
+        other_func.clear();
+
+        const Array<Index> &key = it.key();
+        for(Index i = 0; i < key.size(); ++i) {
+          if(key[i] == 0) {
+            continue;
+          }
+
+          auto occ = dynamic_cast<OccupantFunction const *>(poly->poly_argument(i));
+          if(!occ) {
+            throw std::runtime_error(
+              "Error in make_clexulator_table: only polynomials of occupation functions are supported");
+          }
+
+          size_type f = occ_func_index.at(std::make_pair(occ->basis_ind(), occ->occ_func_ind()));
+          Index n = occ->dof().ID();
+          for(Index e = 0; e < key[i]; ++e) {
+            if(n == center) {
+              site_nlist.push_back(n);
+              site_func.push_back(f);
+            }
+            else {
+              other_nlist.push_back(n);
+              other_func.push_back(f);
+            }
+          }
+        }
+
+        table.coeff.push_back(scale * (*it));
+        table.nlist.insert(table.nlist.end(), site_nlist.begin(), site_nlist.end());
+        table.func.insert(table.func.end(), site_func.begin(), site_func.end());
+        table.site_end.push_back(table.nlist.size());
+        table.nlist.insert(table.nlist.end(), other_nlist.begin(), other_nlist.end());
+        table.func.insert(table.func.end(), other_func.begin(), other_func.end());
+        table.factor_begin.push_back(table.nlist.size());
+      }
+    }
+
+    /// \brief Finish the current function of 'table' and begin the next
+    void _end_function(ClexTermTable &table) {
+      table.term_begin.push_back(table.coeff.size());
+    }
+
+    /// \brief True if 'begin' starts at 0, is non-decreasing, and ends at 'end'
+    bool _is_begin_index(const std::vector<ClexTermTable::size_type> &begin, ClexTermTable::size_type end) {
+      if(begin.empty() || begin.front() != 0 || begin.back() != end) {
+        return false;
+      }
+      return std::is_sorted(begin.begin(), begin.end());
+    }
+
+    /// \brief Check that the factors of 'terms' index into the neighbor list and occ_func
+    void _check_factors(const ClexTermTable &terms, const ClexulatorTable &table) {
+      for(ClexTermTable::size_type k = 0; k < terms.nlist.size(); ++k) {
+        if(terms.nlist[k] >= table.nlist_size) {
+          throw std::runtime_error("Error reading Clexulator table: neighbor list index out of range");
+        }
+        if(terms.func[k] > table.occ_func.size() ||
+           table.occ_func.size() - terms.func[k] < table.max_occ) {
+          throw std::runtime_error("Error reading Clexulator table: occupation function index out of range");
+        }
+      }
+    }
+
+    /// \brief Initialize an empty ClexTermTable
+    void _begin_table(ClexTermTable &table) {
+      table = ClexTermTable();
+      table.term_begin.push_back(0);
+      table.factor_begin.push_back(0);
+    }
+  }
+
+  jsonParser &to_json(const ClexTermTable &table, jsonParser &json) {
+    json.put_obj();
+    json["term_begin"] = table.term_begin;
+    json["coeff"] = table.coeff;
+    json["factor_begin"] = table.factor_begin;
+    json["site_end"] = table.site_end;
+    json["nlist"] = table.nlist;
+    json["func"] = table.func;
+    return json;
+  }
+
+  void from_json(ClexTermTable &table, const jsonParser &json) {
+    from_json(table.term_begin, json["term_begin"]);
+    from_json(table.coeff, json["coeff"]);
+    from_json(table.factor_begin, json["factor_begin"]);
+    from_json(table.site_end, json["site_end"]);
+    from_json(table.nlist, json["nlist"]);
+    from_json(table.func, json["func"]);
+
+    if(table.term_begin.empty() ||
+       table.factor_begin.size() != table.coeff.size() + 1 ||
+       table.site_end.size() != table.coeff.size() ||
+       table.nlist.size() != table.func.size()) {
+      throw std::runtime_error("Error reading Clexulator table: inconsistent term table sizes");
+    }
+
+    if(!_is_begin_index(table.term_begin, table.coeff.size()) ||
+       !_is_begin_index(table.factor_begin, table.nlist.size())) {
+      throw std::runtime_error("Error reading Clexulator table: invalid term or factor ranges");
+    }
+
+    for(ClexTermTable::size_type t = 0; t < table.site_end.size(); ++t) {
+      if(table.site_end[t] < table.factor_begin[t] || table.site_end[t] > table.factor_begin[t + 1]) {
+        throw std::runtime_error("Error reading Clexulator table: invalid site factor range");
+      }
+    }
+  }
+
+  jsonParser &to_json(const ClexulatorTable &table, jsonParser &json) {
+    json.put_obj();
+    json["nlist_size"] = table.nlist_size;
+    json["corr_size"] = table.corr_size;
+    json["max_occ"] = table.max_occ;
+    json["weight_matrix"] = table.weight_matrix;
+    json["neighborhood"] = table.neighborhood;
+    json["orbit_neighborhood"] = table.orbit_neighborhood;
+    json["occ_func"] = table.occ_func;
+    json["orbit"] = table.orbit;
+    json["flower"] = table.flower;
+    return json;
+  }
+
+  void from_json(ClexulatorTable &table, const jsonParser &json) {
+    from_json(table.nlist_size, json["nlist_size"]);
+    from_json(table.corr_size, json["corr_size"]);
+    from_json(table.max_occ, json["max_occ"]);
+    from_json(table.weight_matrix, json["weight_matrix"]);
+    from_json(table.neighborhood, json["neighborhood"]);
+    from_json(table.orbit_neighborhood, json["orbit_neighborhood"]);
+    from_json(table.occ_func, json["occ_func"]);
+    from_json(table.orbit, json["orbit"]);
+    from_json(table.flower, json["flower"]);
+
+    if(table.orbit.size() != table.corr_size ||
+       table.orbit_neighborhood.size() != table.corr_size) {
+      throw std::runtime_error("Error reading Clexulator table: inconsistent number of correlations");
+    }
+    for(const auto &flower : table.flower) {
+      if(flower.size() != table.corr_size) {
+        throw std::runtime_error("Error reading Clexulator table: inconsistent number of correlations");
+      }
+    }
+
+    _check_factors(table.orbit, table);
+    for(const auto &flower : table.flower) {
+      _check_factors(flower, table);
+    }
+  }
+
+  /// \brief Make the basis function tables equivalent to print_clexulator
+  ///
+  /// - Basis functions must be polynomials of occupation functions, else throws
+  /// - Coefficients are normalized by orbit multiplicity, as in print_clexulator
+  ///
+  ClexulatorTable make_clexulator_table(const Structure &prim,
+                                        SiteOrbitree &tree,
+                                        const PrimNeighborList &nlist,
+                                        double xtal_tol) {
+
+    set_nlist_ind(prim, tree, nlist, xtal_tol);
+
+    ClexulatorTable table;
+    Index N_sublat = prim.basis.size();
+    Index N_corr = tree.basis_set_size();
+    table.nlist_size = nlist.size();
+    table.corr_size = N_corr;
+    table.weight_matrix = nlist.weight_matrix();
+
+    // Occupation function tables, as in OccupationDoFEnvironment::print_to_clexulator_constructor
+    OccFuncIndex occ_func_index;
+    const SiteOrbitBranch &asym_unit(tree.asym_unit());
+    table.max_occ = 0;
+    for(Index b = 0; b < N_sublat; b++) {
+      table.max_occ = std::max<ClexulatorTable::size_type>(table.max_occ, prim.basis[b].site_occupant().size());
+    }
+    for(Index no = 0; no < asym_unit.size(); no++) {
+      for(Index ne = 0; ne < asym_unit[no].size(); ne++) {
+        Index b = asym_unit[no][ne][0].basis_ind();
+        Array<Index> occ_ID(1, asym_unit[no][ne][0].site_occupant().ID());
+        for(Index f = 0; f < asym_unit[no][ne].clust_basis.size(); f++) {
+          occ_func_index[std::make_pair(b, f)] = table.occ_func.size();
+          for(Index s = 0; s < asym_unit[no][ne][0].site_occupant().size(); s++) {
+            table.occ_func.push_back(asym_unit[no][ne].clust_basis[f]->eval(occ_ID, Array<Index>(1, s)));
+          }
+          table.occ_func.resize(occ_func_index[std::make_pair(b, f)] + table.max_occ, 0.0);
+        }
+      }
+    }
+
+    _begin_table(table.orbit);
+    table.flower.resize(N_sublat);
+    for(Index nb = 0; nb < N_sublat; nb++) {
+      _begin_table(table.flower[nb]);
+    }
+
+    neighborhood(std::inserter(table.neighborhood, table.neighborhood.begin()), tree, prim, TOL);
+    table.orbit_neighborhood.reserve(N_corr);
+
+    for(Index np = 0; np < tree.size(); np++) {
+      for(Index no = 0; no < tree[np].size(); no++) {
+        auto &orbit = tree[np][no];
+        Index N_func = orbit.prototype.clust_basis.size();
+        double scale = 1.0 / orbit.size();
+
+        std::set<UnitCellCoord> orbit_nbors;
+        orbit_neighborhood(std::inserter(orbit_nbors, orbit_nbors.begin()), tree, prim, np, no, TOL);
+        for(Index nf = 0; nf < N_func; nf++) {
+          table.orbit_neighborhood.push_back(orbit_nbors);
+        }
+
+        // contribution to global correlations, using the nlist indices set by set_nlist_ind
+        for(Index nf = 0; nf < N_func; nf++) {
+          for(Index ne = 0; ne < orbit.size(); ne++) {
+            _add_terms(table.orbit, orbit[ne].clust_basis[nf], scale, -1, occ_func_index);
+          }
+          _end_function(table.orbit);
+        }
+
+        // point correlations, summing over each translation of each cluster
+        // that includes the basis site
+        for(Index nb = 0; nb < N_sublat; nb++) {
+          auto nlist_index = find_index(nlist.sublat_indices(), nb);
+          for(Index nf = 0; nf < N_func; nf++) {
+            if(nlist_index != nlist.sublat_indices().size()) {
+              for(Index ne = 0; ne < orbit.size(); ne++) {
+                for(Index nt = 0; nt < orbit[ne].trans_nlists().size(); nt++) {
+                  Index ib = orbit[ne].trans_nlist(nt).find(nlist_index);
+                  if(ib == orbit[ne].size()) {
+                    continue;
+                  }
+                  orbit[ne].set_nlist_inds(orbit[ne].trans_nlist(nt));
+                  _add_terms(table.flower[nb], orbit[ne].clust_basis[nf], scale, orbit[ne][ib].nlist_ind(), occ_func_index);
+                }
+              }
+            }
+            _end_function(table.flower[nb]);
+          }
+        }
+      }
+    }
+
+    return table;
+  }
+
+  namespace Clexulator_impl {
+
+    TableClexulator::TableClexulator(ClexulatorTable table) :
+      Base(table.nlist_size, table.corr_size) {
+
+      m_weight_matrix = table.weight_matrix;
+      m_neighborhood = table.neighborhood;
+      m_orbit_neighborhood = table.orbit_neighborhood;
+      m_table = std::make_shared<const ClexulatorTable>(std::move(table));
+      m_occ_func = m_table->occ_func.data();
+
+      // collect the distinct (neighbor, occupation function) pairs
+      auto gather = std::make_shared<GatherTable>();
+      std::map<std::pair<size_type, size_type>, size_type> pair_index;
+      const ClexTermTable &orbit = m_table->orbit;
+      for(size_type k = 0; k < orbit.nlist.size(); k++) {
+        auto res = pair_index.insert(std::make_pair(std::make_pair(orbit.nlist[k], orbit.func[k]), pair_index.size()));
+        if(res.second) {
+          gather->pair_nlist.push_back(orbit.nlist[k]);
+          gather->pair_func.push_back(orbit.func[k]);
+        }
+        gather->factor_pair.push_back(res.first->second);
+      }
+      m_gather = gather;
+    }
+
+    void TableClexulator::calc_global_corr_contribution(double *corr_begin) const {
+      for(size_type i = 0; i < corr_size(); i++) {
+        *(corr_begin + i) = _eval(m_table->orbit, i);
+      }
+    }
+
+    void TableClexulator::calc_restricted_global_corr_contribution(double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const {
+      for(; ind_list_begin < ind_list_end; ind_list_begin++) {
+        *(corr_begin + *ind_list_begin) = _eval(m_table->orbit, *ind_list_begin);
+      }
+    }
+
+    void TableClexulator::calc_point_corr(int b_index, double *corr_begin) const {
+      const ClexTermTable &flower = m_table->flower[b_index];
+      for(size_type i = 0; i < corr_size(); i++) {
+        *(corr_begin + i) = _eval(flower, i);
+      }
+    }
+
+    void TableClexulator::calc_restricted_point_corr(int b_index, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const {
+      const ClexTermTable &flower = m_table->flower[b_index];
+      for(; ind_list_begin < ind_list_end; ind_list_begin++) {
+        *(corr_begin + *ind_list_begin) = _eval(flower, *ind_list_begin);
+      }
+    }
+
+    void TableClexulator::calc_delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin) const {
+      const ClexTermTable &flower = m_table->flower[b_index];
+      for(size_type i = 0; i < corr_size(); i++) {
+        *(corr_begin + i) = _eval_delta(flower, i, occ_i, occ_f);
+      }
+    }
+
+    void TableClexulator::calc_restricted_delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const {
+      const ClexTermTable &flower = m_table->flower[b_index];
+      for(; ind_list_begin < ind_list_end; ind_list_begin++) {
+        *(corr_begin + *ind_list_begin) = _eval_delta(flower, *ind_list_begin, occ_i, occ_f);
+      }
+    }
+
+    double TableClexulator::calc_delta_point_energy(int b_index, int occ_i, int occ_f, double const *eci) const {
+      const ClexTermTable &flower = m_table->flower[b_index];
+      double dE = 0.0;
+      for(size_type i = 0; i < corr_size(); i++) {
+        if(eci[i] != 0.0) {
+          dE += eci[i] * _eval_delta(flower, i, occ_i, occ_f);
+        }
+      }
+      return dE;
+    }
+
+    /// Unit cells are evaluated in batches of corr_batch_size:
+    /// - Occupation function values are gathered into m_phi, one contiguous
+    ///   array of unit cells per distinct (neighbor, occupation function) pair
+    /// - Each term is then a product of arrays over the unit cells in the batch
+    void TableClexulator::calc_global_corr_sum(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin) {
+
+      const ClexTermTable &orbit = m_table->orbit;
+      const GatherTable &gather = *m_gather;
+      size_type n_pairs = gather.pair_nlist.size();
+      m_phi.resize(n_pairs * corr_batch_size);
+
+      std::fill(corr_begin, corr_begin + corr_size(), 0.0);
+
+      double prod[corr_batch_size];
+      double acc[corr_batch_size];
+
+      for(size_type c_begin = 0; c_begin < n_cells; c_begin += corr_batch_size) {
+        size_type n = std::min(corr_batch_size, n_cells - c_begin);
+        const long int *const *cell_nlist = nlist_ptrs + c_begin;
+
+        // gather, with zeros for unused cells in the last batch
+        for(size_type p = 0; p < n_pairs; p++) {
+          double *phi = m_phi.data() + p * corr_batch_size;
+          double const *occ_func = m_occ_func + gather.pair_func[p];
+          size_type nlist_ind = gather.pair_nlist[p];
+          size_type c = 0;
+          for(; c < n; c++) {
+            phi[c] = occ_func[m_occ_ptr[cell_nlist[c][nlist_ind]]];
+          }
+          for(; c < corr_batch_size; c++) {
+            phi[c] = 0.0;
+          }
+        }
+
+        for(size_type i = 0; i < corr_size(); i++) {
+          std::fill(acc, acc + corr_batch_size, 0.0);
+          for(size_type t = orbit.term_begin[i]; t < orbit.term_begin[i + 1]; t++) {
+            std::fill(prod, prod + corr_batch_size, orbit.coeff[t]);
+            for(size_type k = orbit.factor_begin[t]; k < orbit.factor_begin[t + 1]; k++) {
+              double const *phi = m_phi.data() + gather.factor_pair[k] * corr_batch_size;
+              for(size_type c = 0; c < corr_batch_size; c++) {
+                prod[c] *= phi[c];
+              }
+            }
+            for(size_type c = 0; c < corr_batch_size; c++) {
+              acc[c] += prod[c];
+            }
+          }
+
+          // constant terms are not zero for unused cells, so only sum 'n'
+          double sum = 0.0;
+          for(size_type c = 0; c < n; c++) {
+            sum += acc[c];
+          }
+          *(corr_begin + i) += sum;
+        }
+      }
+    }
+
+    double TableClexulator::_eval(const ClexTermTable &table, size_type i) const {
+      double result = 0.0;
+      for(size_type t = table.term_begin[i]; t < table.term_begin[i + 1]; t++) {
+        double term = table.coeff[t];
+        for(size_type k = table.factor_begin[t]; k < table.factor_begin[t + 1]; k++) {
+          term *= m_occ_func[table.func[k] + m_occ_ptr[m_nlist_ptr[table.nlist[k]]]];
+        }
+        result += term;
+      }
+      return result;
+    }
+
+    /// The occupant of the changing site is 'occ_i', so only terms with
+    /// factors on that site contribute:
+    ///   coeff * (other factors) * (site factors(occ_f) - site factors(occ_i))
+    double TableClexulator::_eval_delta(const ClexTermTable &table, size_type i, int occ_i, int occ_f) const {
+      double result = 0.0;
+      for(size_type t = table.term_begin[i]; t < table.term_begin[i + 1]; t++) {
+        size_type k = table.factor_begin[t];
+        if(k == table.site_end[t]) {
+          continue;
+        }
+        double site_f = 1.0;
+        double site_i = 1.0;
+        for(; k < table.site_end[t]; k++) {
+          site_f *= m_occ_func[table.func[k] + occ_f];
+          site_i *= m_occ_func[table.func[k] + occ_i];
+        }
+        double term = table.coeff[t] * (site_f - site_i);
+        for(; k < table.factor_begin[t + 1]; k++) {
+          term *= m_occ_func[table.func[k] + m_occ_ptr[m_nlist_ptr[table.nlist[k]]]];
+        }
+        result += term;
+      }
+      return result;
+    }
+
+  }
+
+  /// \brief Construct a Clexulator that evaluates the basis function tables
+  ///        written at 'table_path'
+  ///
+  /// \param name Class name for the Clexulator, typically 'X_Clexulator'
+  /// \param table_path Path to the JSON file written by 'casm bset -u'
+  /// \param nlist, A PrimNeighborList to be updated to include the neighborhood
+  ///        of this Clexulator
+  ///
+  Clexulator make_table_clexulator(std::string name,
+                                   const boost::filesystem::path &table_path,
+                                   PrimNeighborList &nlist) {
+    ClexulatorTable table;
+    from_json(table, jsonParser(table_path));
+    return Clexulator(
+             name,
+             std::unique_ptr<Clexulator_impl::Base>(new Clexulator_impl::TableClexulator(std::move(table))),
+             nlist);
+  }
+
+}
@@ -6,6 +6,7 @@
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/Supercell.hh"
 #include "casm/clex/NeighborList.hh"
+#include "casm/misc/parallel.hh"
 
 
 namespace CASM {
@@ -196,79 +197,86 @@ namespace CASM {
     A.swap(B);
   }
 
-  /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
-  Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator) {
-
-    //Size of the supercell will be used for normalizing correlations to a per primitive cell value
-    int scel_vol = scel.volume();
-
-    Correlation correlations = Correlation::Zero(clexulator.corr_size());
-
-    //Inform Clexulator of the bitstring
-
-    //TODO: This will probably get more complicated with displacements and stuff
-    clexulator.set_config_occ(configdof.occupation().begin());
-    //mc_clexor.set_config_disp(mc_confdof.m_displacements.begin());   //or whatever
-    //mc_clexor.set_config_strain(mc_confdof.m_strain.begin());   //or whatever
-
-    //Holds contribution to global correlations from a particular neighborhood
-    std::vector<double> tcorr(clexulator.corr_size(), 0.0);
-    //std::vector<double> corr(clexulator.corr_size(), 0.0);
-
-    for(int v = 0; v < scel_vol; v++) {
-
-      //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.nlist().sites(v).data());
+  namespace {
+
+    /// \brief Number of unit cells summed together before adding to the total correlations
+    const Index corr_block_size = 256;
+
+    /// \brief Sum of the contributions to global correlations from each unit cell
+    ///
+    /// - Unit cells are summed in blocks of corr_block_size, and block sums are
+    ///   added in order, so the result does not depend on the number of threads
+    /// - Blocks are summed in rounds, one block per thread, into one partial sum
+    ///   per thread, which are then added in block order
+    /// - Each block is summed by Clexulator::calc_global_corr_sum, which may
+    ///   evaluate the unit cells of a block together
+    /// - Each thread other than the calling thread uses its own copy of 'clexulator'
+    Eigen::VectorXd _sum_corr_contributions(const ConfigDoF &configdof,
+                                            const Supercell &scel,
+                                            Clexulator &clexulator,
+                                            Index n_threads) {
+
+      Index scel_vol = scel.volume();
+      Index n_blocks = (scel_vol + corr_block_size - 1) / corr_block_size;
+      Index T = std::max(Index(1), std::min(resolve_threads(n_threads), n_blocks));
+
+      std::vector<Clexulator> clexulator_copy(T - 1, clexulator);
+      std::vector<Eigen::VectorXd> partial_corr(T, Eigen::VectorXd::Zero(clexulator.corr_size()));
+
+      // neighbor list of each unit cell
+      std::vector<const long int *> nlist_ptrs(scel_vol);
+      for(Index v = 0; v < scel_vol; v++) {
+        nlist_ptrs[v] = scel.nlist().sites(v).data();
+      }
 
-      //Fill up contributions
-      clexulator.calc_global_corr_contribution(&tcorr[0]);
+      //Inform Clexulator of the bitstring
 
-      //Add contributions to total correlations
-      for(int i = 0; i < tcorr.size(); i++) {
-        correlations[i] += tcorr[i];
+      //TODO: This will probably get more complicated with displacements and stuff
+      clexulator.set_config_occ(configdof.occupation().begin());
+      for(auto &clex : clexulator_copy) {
+        clex.set_config_occ(configdof.occupation().begin());
       }
 
+      Eigen::VectorXd correlations = Eigen::VectorXd::Zero(clexulator.corr_size());
+      for(Index first = 0; first < n_blocks; first += T) {
+
+        // thread t sums block 'first + t'
+        Index n = std::min(T, n_blocks - first);
+        parallel_for(n, n, [&](Index t, Index k) {
+          Clexulator &clex = t ? clexulator_copy[t - 1] : clexulator;
+          Index begin = (first + k) * corr_block_size;
+          Index end = std::min(scel_vol, begin + corr_block_size);
+          clex.calc_global_corr_sum(nlist_ptrs.data() + begin, end - begin, partial_corr[k].data());
+        });
+
+        for(Index k = 0; k < n; ++k) {
+          correlations += partial_corr[k];
+        }
+      }
+      return correlations;
     }
+  }
 
-    // normalize by supercell volume
-    for(int i = 0; i < clexulator.corr_size(); i++) {
-      correlations[i] /= (double) scel_vol;
-    }
-
-    return correlations;
+  /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
+  ///
+  /// - If 'n_threads' is not 1, unit cells are divided among up to 'n_threads'
+  ///   threads. If 0, use the number of hardware threads.
+  Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator, Index n_threads) {
+    return correlations_vec(configdof, scel, clexulator, n_threads);
   }
 
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
-  Eigen::VectorXd correlations_vec(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator) {
+  ///
+  /// - If 'n_threads' is not 1, unit cells are divided among up to 'n_threads'
+  ///   threads. If 0, use the number of hardware threads.
+  Eigen::VectorXd correlations_vec(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator, Index n_threads) {
 
     //Size of the supercell will be used for normalizing correlations to a per primitive cell value
     int scel_vol = scel.volume();
 
-    Eigen::VectorXd correlations = Eigen::VectorXd::Zero(clexulator.corr_size());
-
-    //Inform Clexulator of the bitstring
-
-    //TODO: This will probably get more complicated with displacements and stuff
-    clexulator.set_config_occ(configdof.occupation().begin());
-    //mc_clexor.set_config_disp(mc_confdof.m_displacements.begin());   //or whatever
-    //mc_clexor.set_config_strain(mc_confdof.m_strain.begin());   //or whatever
-
-    //Holds contribution to global correlations from a particular neighborhood
-    Eigen::VectorXd tcorr = correlations;
-    //std::vector<double> corr(clexulator.corr_size(), 0.0);
-
-    for(int v = 0; v < scel_vol; v++) {
-
-      //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.nlist().sites(v).data());
-
-      //Fill up contributions
-      clexulator.calc_global_corr_contribution(tcorr.data());
-
-      correlations += tcorr;
-
-    }
+    Eigen::VectorXd correlations = _sum_corr_contributions(configdof, scel, clexulator, n_threads);
 
+    // normalize by supercell volume
     correlations /= (double) scel_vol;
 
     return correlations;
@@ -1554,8 +1554,11 @@ namespace CASM {
   }
 
   /// \brief Returns correlations using 'clexulator'.
-  Correlation correlations(const Configuration &config, Clexulator &clexulator) {
-    return correlations(config.configdof(), config.get_supercell(), clexulator);
+  ///
+  /// - If 'n_threads' is not 1, unit cells are divided among up to 'n_threads'
+  ///   threads. If 0, use the number of hardware threads.
+  Correlation correlations(const Configuration &config, Clexulator &clexulator, Index n_threads) {
+    return correlations(config.configdof(), config.get_supercell(), clexulator, n_threads);
   }
 
   /// Returns parametric composition, as calculated using PrimClex::param_comp
@@ -8,6 +8,7 @@
 #include "casm/clex/ScelEnum.hh"
 #include "casm/clusterography/jsonClust.hh"
 #include "casm/system/RuntimeLibrary.hh"
+#include "casm/clex/ClexulatorTable.hh"
 #include "casm/casm_io/SafeOfstream.hh"
 #include "casm/crystallography/Coordinate.hh"
 #include "casm/app/AppIO.hh"
@@ -1018,6 +1019,9 @@ namespace CASM {
   bool PrimClex::has_clexulator(const ClexDescription &key) const {
     auto it = m_clexulator.find(key);
     if(it == m_clexulator.end()) {
+      if(settings().clexulator_backend() == "table") {
+        return fs::exists(dir().clexulator_table(settings().name(), key.bset));
+      }
       if(!fs::exists(dir().clexulator_src(settings().name(), key.bset))) {
         return false;
       }
@@ -1030,7 +1034,20 @@ namespace CASM {
   Clexulator PrimClex::clexulator(const ClexDescription &key) const {
 
     auto it = m_clexulator.find(key);
-    if(it == m_clexulator.end()) {
+    if(it == m_clexulator.end() && settings().clexulator_backend() == "table") {
+
+      fs::path table_path = dir().clexulator_table(settings().name(), key.bset);
+      if(!fs::exists(table_path)) {
+        throw std::runtime_error(
+          std::string("Error loading clexulator ") + key.bset + ". No basis function tables exist. Try 'casm bset -uf'.");
+      }
+
+      it = m_clexulator.insert(
+             std::make_pair(key, make_table_clexulator(settings().name() + "_Clexulator",
+                                                       table_path,
+                                                       nlist()))).first;
+    }
+    else if(it == m_clexulator.end()) {
 
       if(!fs::exists(dir().clexulator_src(settings().name(), key.bset))) {
         throw std::runtime_error(
@@ -1216,12 +1233,21 @@ namespace CASM {
 
   //*******************************************************************************************
   /// \brief Print clexulator
+  ///
+  /// - If 'delta_point_energy', also print 'calc_delta_point_energy', which sums
+  ///   ECI times the delta basis functions of each sublattice without writing
+  ///   delta correlations
+  /// - If the basis function implementations are longer than 'shard_size'
+  ///   characters, they are split by orbit into shards that RuntimeLibrary
+  ///   compiles in parallel. If 'shard_size' is 0, they are not split.
   void print_clexulator(const Structure &prim,
                         SiteOrbitree &tree,
                         const PrimNeighborList &nlist,
                         std::string class_name,
                         std::ostream &stream,
-                        double xtal_tol) {
+                        double xtal_tol,
+                        bool delta_point_energy,
+                        Index shard_size) {
 
     set_nlist_ind(prim, tree, nlist, xtal_tol);
 
@@ -1244,7 +1270,7 @@ namespace CASM {
     dof_manager.register_dofs(tree);
 
     Index N_corr(tree.basis_set_size());
-    std::stringstream private_def_stream, public_def_stream, interface_imp_stream, bfunc_imp_stream;
+    std::stringstream private_def_stream, public_def_stream, interface_imp_stream;
 
     std::string uclass_name;
     for(Index i = 0; i < class_name.size(); i++)
@@ -1283,6 +1309,15 @@ namespace CASM {
                        indent << "  // array of pointers to member functions for calculating DELTA flower functions\n" <<
                        indent << "  DeltaBasisFuncPtr m_delta_func_lists[" << Nsublat << "][" << N_corr << "];\n\n";
 
+    if(delta_point_energy) {
+      private_def_stream <<
+                         indent << "  // typedef for method pointers\n" <<
+                         indent << "  typedef double (" << class_name << "::*DeltaEnergyFuncPtr)(int, int, double const *) const;\n\n" <<
+
+                         indent << "  // array of pointers to member functions for calculating DELTA energy\n" <<
+                         indent << "  DeltaEnergyFuncPtr m_delta_energy_func_list[" << Nsublat << "];\n\n";
+    }
+
     /**** for separate 1D method pointer lists:
     indent << "  DeltaBasisFuncPtr";
 
@@ -1302,7 +1337,12 @@ namespace CASM {
     private_def_stream <<
                        indent << "  //default functions for basis function evaluation \n" <<
                        indent << "  double zero_func() const{ return 0.0;};\n" <<
-                       indent << "  double zero_func(int,int) const{ return 0.0;};\n\n";
+                       indent << "  double zero_func(int,int) const{ return 0.0;};\n";
+    if(delta_point_energy) {
+      private_def_stream <<
+                         indent << "  double zero_func(int,int,double const*) const{ return 0.0;};\n";
+    }
+    private_def_stream << "\n";
 
     public_def_stream <<
                       indent << "  " << class_name << "();\n\n" <<
@@ -1319,6 +1359,9 @@ namespace CASM {
                       indent << "  /// \\brief Calculate contribution to select global correlations from one unit cell\n" <<
                       indent << "  void calc_restricted_global_corr_contribution(double *corr_begin, size_type const* ind_list_begin, size_type const* ind_list_end) const override;\n\n" <<
 
+                      indent << "  /// \\brief Calculate the sum of contributions to global correlations from several unit cells\n" <<
+                      indent << "  void calc_global_corr_sum(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin) override;\n\n" <<
+
                       indent << "  /// \\brief Calculate point correlations about basis site 'b_index'\n" <<
                       indent << "  void calc_point_corr(int b_index, double *corr_begin) const override;\n\n" <<
 
@@ -1331,6 +1374,17 @@ namespace CASM {
                       indent << "  /// \\brief Calculate the change in select point correlations due to changing an occupant\n" <<
                       indent << "  void calc_restricted_delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin, size_type const* ind_list_begin, size_type const* ind_list_end) const override;\n\n";
 
+    if(delta_point_energy) {
+      public_def_stream <<
+                        indent << "  /// \\brief Returns true, calc_delta_point_energy is implemented\n" <<
+                        indent << "  bool has_delta_point_energy() const override {\n" <<
+                        indent << "    return true;\n" <<
+                        indent << "  }\n\n" <<
+
+                        indent << "  /// \\brief Calculate the change in energy due to changing an occupant\n" <<
+                        indent << "  double calc_delta_point_energy(int b_index, int occ_i, int occ_f, double const* eci) const override;\n\n";
+    }
+
     dof_manager.print_clexulator_public_method_definitions(public_def_stream, tree, indent + "  ");
 
 
@@ -1352,17 +1406,27 @@ namespace CASM {
 
     bool make_newline(false);
 
+    // implementations of the basis functions of each orbit, and the orbit of
+    // each basis function
+    Array<std::string> orbit_imp;
+    Array<Index> func_orbit(N_corr);
+    std::stringstream orbit_imp_stream;
+
+    // methods summing the basis functions of each orbit over many unit cells
+    Array<std::string> orbit_sum_method_names;
+
     //loop over orbits
     for(Index np = 0; np < tree.size(); np++) {
       for(Index no = 0; no < tree[np].size(); no++) {
+        orbit_imp_stream.str("");
         if(np == 0)
-          bfunc_imp_stream <<
+          orbit_imp_stream <<
                            indent << "// Basis functions for empty cluster:\n";
         else {
-          bfunc_imp_stream <<
+          orbit_imp_stream <<
                            indent << "/**** Basis functions for orbit " << np << ", " << no << "****\n";
-          tree[np][no].prototype.print(bfunc_imp_stream, '\n');
-          bfunc_imp_stream << "****/\n";
+          tree[np][no].prototype.print(orbit_imp_stream, '\n');
+          orbit_imp_stream << "****/\n";
         }
 
         formulae = tree[np][no].orbit_function_cpp_strings(labelers);
@@ -1377,17 +1441,48 @@ namespace CASM {
           private_def_stream <<
                              indent << "  double " << orbit_method_names[lf + nf] << "() const;\n";
 
-          bfunc_imp_stream <<
+          orbit_imp_stream <<
                            indent << "double " << class_name << "::" << orbit_method_names[lf + nf] << "() const{\n" <<
                            indent << "  return " << formulae[nf] << ";\n" <<
                            indent << "}\n";
         }
         if(make_newline) {
-          bfunc_imp_stream << '\n';
+          orbit_imp_stream << '\n';
           private_def_stream << '\n';
         }
         make_newline = false;
 
+        // sum of the basis functions of the orbit over many unit cells, with
+        // one accumulator per basis function, so that occupation function
+        // values are shared by the basis functions of the orbit
+        std::stringstream sum_init_stream, sum_add_stream, sum_store_stream;
+        for(Index nf = 0; nf < tlf; nf++) {
+          if(!orbit_method_names[lf + nf].size())
+            continue;
+          sum_init_stream <<
+                          indent << "  double sum_" << nf << " = 0.0;\n";
+          sum_add_stream <<
+                         indent << "    sum_" << nf << " += " << orbit_method_names[lf + nf] << "();\n";
+          sum_store_stream <<
+                           indent << "  *(corr_begin+" << lf + nf << ") = sum_" << nf << ";\n";
+        }
+        if(sum_init_stream.str().size()) {
+          std::string method_name = "global_corr_sum_" + std::to_string(np) + "_" + std::to_string(no);
+          orbit_sum_method_names.push_back(method_name);
+          private_def_stream <<
+                             indent << "  void " << method_name << "(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin);\n\n";
+
+          orbit_imp_stream <<
+                           indent << "void " << class_name << "::" << method_name << "(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin){\n" <<
+                           sum_init_stream.str() <<
+                           indent << "  for(size_type c=0; c<n_cells; c++){\n" <<
+                           indent << "    m_nlist_ptr = nlist_ptrs[c];\n" <<
+                           sum_add_stream.str() <<
+                           indent << "  }\n" <<
+                           sum_store_stream.str() <<
+                           indent << "}\n\n";
+        }
+
         // loop over flowers (i.e., basis sites of prim)
         const SiteOrbitBranch &asym_unit(tree.asym_unit());
         for(Index na = 0; na < asym_unit.size(); na++) {
@@ -1404,7 +1499,7 @@ namespace CASM {
                 private_def_stream <<
                                    indent << "  double " << flower_method_names[nb][lf + nf] << "() const;\n";
 
-                bfunc_imp_stream <<
+                orbit_imp_stream <<
                                  indent << "double " << class_name << "::" << flower_method_names[nb][lf + nf] << "() const{\n" <<
                                  indent << "  return " << formulae[nf] << ";\n" <<
                                  indent << "}\n";
@@ -1412,7 +1507,7 @@ namespace CASM {
               }
             }
             if(make_newline) {
-              bfunc_imp_stream << '\n';
+              orbit_imp_stream << '\n';
               private_def_stream << '\n';
             }
             make_newline = false;
@@ -1453,13 +1548,13 @@ namespace CASM {
               private_def_stream <<
                                  indent << "  double " << dflower_method_names[nb][lf + nf] << "(int occ_i, int occ_f) const;\n";
 
-              bfunc_imp_stream <<
+              orbit_imp_stream <<
                                indent << "double " << class_name << "::" << dflower_method_names[nb][lf + nf] << "(int occ_i, int occ_f) const{\n" <<
                                indent << "  return " << formulae[nf] << ";\n" <<
                                indent << "}\n";
             }
             if(make_newline) {
-              bfunc_imp_stream << '\n';
+              orbit_imp_stream << '\n';
               private_def_stream << '\n';
             }
             make_newline = false;
@@ -1467,10 +1562,93 @@ namespace CASM {
           }
         }//\End loop over flowers
 
+        for(Index nf = 0; nf < tlf; nf++) {
+          func_orbit[lf + nf] = orbit_imp.size();
+        }
+        orbit_imp.push_back(orbit_imp_stream.str());
         lf += tlf;
       }
     }//Finished writing method definitions and implementations for basis functions
 
+    // Divide the orbits, in order, into shards of about 'shard_size' characters
+    Index total_size = 0;
+    for(Index i = 0; i < orbit_imp.size(); i++) {
+      total_size += orbit_imp[i].size();
+    }
+    Index n_shards = 1;
+    if(shard_size > 0 && total_size > shard_size) {
+      n_shards = std::min((total_size + shard_size - 1) / shard_size, Index(orbit_imp.size()));
+    }
+    Array<Index> orbit_shard(orbit_imp.size());
+    Array<std::string> shard_imp(n_shards);
+    Index partial_size = 0;
+    for(Index i = 0; i < orbit_imp.size(); i++) {
+      orbit_shard[i] = std::min(n_shards - 1, (partial_size * n_shards) / std::max(total_size, Index(1)));
+      shard_imp[orbit_shard[i]] += orbit_imp[i];
+      partial_size += orbit_imp[i].size();
+    }
+
+    // ECI-weighted sums of the delta flower functions of each sublattice
+    // - If sharded, each shard sums its own delta flower functions, so that
+    //   they may be inlined, and the shard sums are added in the first shard
+    Array<std::string> denergy_method_names(Nsublat);
+    if(delta_point_energy) {
+      for(Index nb = 0; nb < dflower_method_names.size(); nb++) {
+        Array<std::string> sum_str(n_shards);
+        for(Index nf = 0; nf < dflower_method_names[nb].size(); nf++) {
+          if(dflower_method_names[nb][nf].size() == 0)
+            continue;
+          std::stringstream sum_stream;
+          sum_stream <<
+                     indent << "  if(eci[" << nf << "] != 0.0) dE += eci[" << nf << "]*" << dflower_method_names[nb][nf] << "(occ_i, occ_f);\n";
+          sum_str[orbit_shard[func_orbit[nf]]] += sum_stream.str();
+        }
+
+        std::stringstream total_stream;
+        for(Index k = 0; k < n_shards; k++) {
+          if(!sum_str[k].size())
+            continue;
+
+          std::string method_name = "delta_energy_at_" + std::to_string(nb);
+          if(n_shards > 1) {
+            method_name += "_shard_" + std::to_string(k);
+            total_stream <<
+                         indent << "  dE += " << method_name << "(occ_i, occ_f, eci);\n";
+          }
+          else {
+            total_stream << sum_str[k];
+          }
+          private_def_stream <<
+                             indent << "  double " << method_name << "(int occ_i, int occ_f, double const* eci) const;\n";
+
+          std::stringstream imp_stream;
+          imp_stream <<
+                     indent << "double " << class_name << "::" << method_name << "(int occ_i, int occ_f, double const* eci) const{\n" <<
+                     indent << "  double dE = 0.0;\n" <<
+                     sum_str[k] <<
+                     indent << "  return dE;\n" <<
+                     indent << "}\n\n";
+          shard_imp[k] += imp_stream.str();
+        }
+        if(!total_stream.str().size())
+          continue;
+
+        denergy_method_names[nb] = "delta_energy_at_" + std::to_string(nb);
+        if(n_shards > 1) {
+          private_def_stream <<
+                             indent << "  double " << denergy_method_names[nb] << "(int occ_i, int occ_f, double const* eci) const;\n";
+
+          interface_imp_stream <<
+                               indent << "double " << class_name << "::" << denergy_method_names[nb] << "(int occ_i, int occ_f, double const* eci) const{\n" <<
+                               indent << "  double dE = 0.0;\n" <<
+                               total_stream.str() <<
+                               indent << "  return dE;\n" <<
+                               indent << "}\n\n";
+        }
+      }
+      private_def_stream << '\n';
+    }
+
     //clean up:
     for(Index nl = 0; nl < labelers.size(); nl++)
       delete labelers[nl];
@@ -1518,6 +1696,18 @@ namespace CASM {
       interface_imp_stream << "\n\n";
     }
 
+    if(delta_point_energy) {
+      for(Index nb = 0; nb < denergy_method_names.size(); nb++) {
+        if(denergy_method_names[nb].size() == 0)
+          interface_imp_stream <<
+                               indent << "  m_delta_energy_func_list[" << nb << "] = &" << class_name << "::zero_func;\n";
+        else
+          interface_imp_stream <<
+                               indent << "  m_delta_energy_func_list[" << nb << "] = &" << class_name << "::" << denergy_method_names[nb] << ";\n";
+      }
+      interface_imp_stream << "\n\n";
+    }
+
     // Write weight matrix used for the neighbor list
     PrimNeighborList::Matrix3Type W = nlist.weight_matrix();
     interface_imp_stream << indent << "  m_weight_matrix.row(0) << " << W(0, 0) << ", " << W(0, 1) << ", " << W(0, 2) << ";\n";
@@ -1628,6 +1818,16 @@ namespace CASM {
                          indent << "  }\n" <<
                          indent << "}\n\n" <<
 
+                         indent << "/// \\brief Calculate the sum of contributions to global correlations from several unit cells\n" <<
+                         indent << "void " << class_name << "::calc_global_corr_sum(const long int *const *nlist_ptrs, size_type n_cells, double *corr_begin) {\n" <<
+                         indent << "  std::fill(corr_begin, corr_begin+corr_size(), 0.0);\n";
+    for(Index i = 0; i < orbit_sum_method_names.size(); i++) {
+      interface_imp_stream <<
+                           indent << "  " << orbit_sum_method_names[i] << "(nlist_ptrs, n_cells, corr_begin);\n";
+    }
+    interface_imp_stream <<
+                         indent << "}\n\n" <<
+
                          indent << "/// \\brief Calculate point correlations about basis site 'b_index'\n" <<
                          indent << "void " << class_name << "::calc_point_corr(int b_index, double *corr_begin) const {\n" <<
                          indent << "  for(size_type i=0; i<corr_size(); i++){\n" <<
@@ -1656,8 +1856,24 @@ namespace CASM {
                          indent << "  }\n" <<
                          indent << "}\n\n";
 
+    if(delta_point_energy) {
+      interface_imp_stream <<
+                           indent << "/// \\brief Calculate the change in energy due to changing an occupant\n" <<
+                           indent << "double " << class_name << "::calc_delta_point_energy(int b_index, int occ_i, int occ_f, double const* eci) const {\n" <<
+                           indent << "  return (this->*m_delta_energy_func_list[b_index])(occ_i, occ_f, eci);\n" <<
+                           indent << "}\n\n";
+    }
+
 
     // PUT EVERYTHING TOGETHER
+    // - If sharded, the implementations are wrapped in '#if' blocks, so that
+    //   each shard can be compiled separately and linked together (see
+    //   RuntimeLibrary). The first shard has the constructor and interface.
+    auto begin_shard = [&](Index k) {
+      return n_shards > 1 ? "#if RUNTIME_LIBRARY_SHARD_ENABLED(" + std::to_string(k) + ")\n" : std::string();
+    };
+    std::string end_shard = n_shards > 1 ? "#endif\n" : "";
+
     stream <<
            "#include <cstddef>\n" <<
            "#include \"casm/clex/Clexulator.hh\"\n" <<
@@ -1669,10 +1885,25 @@ namespace CASM {
     stream << json;
 
     stream <<
-           "**/\n\n\n" <<
+           "**/\n\n\n";
+
+    if(n_shards > 1) {
+      stream <<
+             "// Compile each shard with -DRUNTIME_LIBRARY_SHARD=0, 1, ..., " << n_shards - 1 << "\n" <<
+             "// and link the objects, or compile all shards at once without it\n" <<
+             "#define RUNTIME_LIBRARY_SHARDS " << n_shards << "\n" <<
+             "#ifdef RUNTIME_LIBRARY_SHARD\n" <<
+             "#define RUNTIME_LIBRARY_SHARD_ENABLED(k) (RUNTIME_LIBRARY_SHARD == k)\n" <<
+             "#else\n" <<
+             "#define RUNTIME_LIBRARY_SHARD_ENABLED(k) 1\n" <<
+             "#endif\n\n\n";
+    }
 
+    stream <<
            "/// \\brief Returns a Clexulator_impl::Base* owning a " << class_name << "\n" <<
            "extern \"C\" CASM::Clexulator_impl::Base* make_" + class_name << "();\n\n" <<
+           "/// \\brief Returns the Clexulator_impl::abi_version " << class_name << " was compiled with\n" <<
+           "extern \"C\" int abi_version_" + class_name << "();\n\n" <<
 
            "namespace CASM {\n\n" <<
 
@@ -1691,16 +1922,32 @@ namespace CASM {
 
            "//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n\n" <<
 
-           interface_imp_stream.str() <<
-           bfunc_imp_stream.str() <<
+           begin_shard(0) <<
+           interface_imp_stream.str();
+
+    for(Index k = 0; k < n_shards; k++) {
+      if(k > 0) {
+        stream << end_shard << "\n" << begin_shard(k);
+      }
+      stream << shard_imp[k];
+    }
+
+    stream <<
+           end_shard <<
            "}\n\n\n" <<      // close namespace
 
+           begin_shard(0) <<
            "extern \"C\" {\n" <<
            indent << "/// \\brief Returns a Clexulator_impl::Base* owning a " << class_name << "\n" <<
            indent << "CASM::Clexulator_impl::Base* make_" + class_name << "() {\n" <<
            indent << "  return new CASM::" + class_name + "();\n" <<
            indent << "}\n\n" <<
+           indent << "/// \\brief Returns the Clexulator_impl::abi_version " << class_name << " was compiled with\n" <<
+           indent << "int abi_version_" + class_name << "() {\n" <<
+           indent << "  return CASM::Clexulator_impl::abi_version;\n" <<
+           indent << "}\n\n" <<
            "}\n" <<
+           end_shard <<
 
            "\n";
     // EOF
@@ -0,0 +1,161 @@
+#include "casm/monte_carlo/BiasPotential.hh"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "casm/casm_io/jsonParser.hh"
+#include "casm/casm_io/json_io/container.hh"
+
+namespace CASM {
+
+  namespace Monte {
+
+    /// \brief Construct a harmonic or linear bias potential
+    ///
+    /// \param weights pair(correlation index, weight) for the order parameter
+    /// \param type HARMONIC or LINEAR
+    /// \param a spring constant (HARMONIC) or slope (LINEAR)
+    /// \param b center (HARMONIC), not used for LINEAR
+    BiasPotential::BiasPotential(const std::vector<std::pair<Index, double> > &weights, TYPE type, double a, double b) :
+      m_is_active(true),
+      m_weights(weights),
+      m_type(type),
+      m_a(a),
+      m_b(b) {
+
+      if(type == TYPE::TABLE) {
+        throw std::runtime_error("Error constructing BiasPotential: a table potential requires table values");
+      }
+    }
+
+    /// \brief Construct a tabulated bias potential
+    ///
+    /// \param weights pair(correlation index, weight) for the order parameter
+    /// \param table_q Order parameter values, in increasing order
+    /// \param table_u Bias potential, per unit cell, at each of 'table_q'
+    BiasPotential::BiasPotential(const std::vector<std::pair<Index, double> > &weights,
+                                 const std::vector<double> &table_q,
+                                 const std::vector<double> &table_u) :
+      m_is_active(true),
+      m_weights(weights),
+      m_type(TYPE::TABLE),
+      m_a(0.0),
+      m_b(0.0),
+      m_table_q(table_q),
+      m_table_u(table_u) {
+
+      if(!table_q.size() || table_q.size() != table_u.size()) {
+        throw std::runtime_error(
+          "Error constructing BiasPotential: table order parameter and value must be the same non-zero size");
+      }
+      if(!std::is_sorted(table_q.begin(), table_q.end())) {
+        throw std::runtime_error(
+          "Error constructing BiasPotential: table order parameter must be in increasing order");
+      }
+    }
+
+    /// \brief Bias potential, per unit cell
+    double BiasPotential::value(double q) const {
+
+      switch(m_type) {
+
+      case TYPE::HARMONIC:
+        return 0.5 * m_a * (q - m_b) * (q - m_b);
+
+      case TYPE::LINEAR:
+        return m_a * q;
+
+      case TYPE::TABLE: {
+        if(q <= m_table_q.front()) {
+          return m_table_u.front();
+        }
+        if(q >= m_table_q.back()) {
+          return m_table_u.back();
+        }
+        Index i = std::upper_bound(m_table_q.begin(), m_table_q.end(), q) - m_table_q.begin();
+        double f = (q - m_table_q[i - 1]) / (m_table_q[i] - m_table_q[i - 1]);
+        return m_table_u[i - 1] + f * (m_table_u[i] - m_table_u[i - 1]);
+      }
+
+      default:
+        throw std::runtime_error("Error in BiasPotential::value: unknown type");
+      }
+    }
+
+    /// \brief Weights that recover unbiased averages from biased samples
+    ///
+    /// \param bias_energy Bias potential, per unit cell, of each sample
+    /// \param beta 1/(k*T)
+    /// \param volume Supercell volume, in unit cells
+    ///
+    /// \returns w_i = exp(beta*N*u_i) / sum_j exp(beta*N*u_j), so that the
+    ///          unbiased mean of A is sum_i w_i*A_i
+    ///
+    /// - The largest exponent is subtracted before exponentiating, to avoid overflow
+    Eigen::VectorXd reweighting_weights(const Eigen::VectorXd &bias_energy, double beta, double volume) {
+      if(!bias_energy.size()) {
+        return Eigen::VectorXd();
+      }
+      Eigen::VectorXd w = bias_energy * (beta * volume);
+      w = (w.array() - w.maxCoeff()).exp().matrix();
+      return w / w.sum();
+    }
+
+    /// \brief Unbiased mean of biased samples
+    ///
+    /// \param observations Sampled values
+    /// \param bias_energy Bias potential, per unit cell, of each sample
+    /// \param beta 1/(k*T)
+    /// \param volume Supercell volume, in unit cells
+    ///
+    double reweighted_mean(const Eigen::VectorXd &observations,
+                           const Eigen::VectorXd &bias_energy,
+                           double beta,
+                           double volume) {
+      if(observations.size() != bias_energy.size()) {
+        throw std::runtime_error("Error in reweighted_mean: observations and bias_energy sizes differ");
+      }
+      return reweighting_weights(bias_energy, beta, volume).dot(observations);
+    }
+
+  }
+
+  /// \brief Read BiasPotential
+  Monte::BiasPotential jsonConstructor<Monte::BiasPotential>::from_json(const jsonParser &json, Index corr_size) {
+
+    typedef Monte::BiasPotential BiasPotential;
+
+    std::vector<std::pair<Index, double> > weights;
+    for(auto it = json["order_parameter"]["corr"].cbegin(); it != json["order_parameter"]["corr"].cend(); ++it) {
+      Index index = std::stol(it.name());
+      if(index < 0 || index >= corr_size) {
+        throw std::runtime_error(
+          "Error reading bias potential: correlation index " + it.name() + " is out of range");
+      }
+      weights.push_back(std::make_pair(index, it->get<double>()));
+    }
+    if(!weights.size()) {
+      throw std::runtime_error(
+        "Error reading bias potential: \"order_parameter\"/\"corr\" must include at least one correlation");
+    }
+
+    const jsonParser &potential = json["potential"];
+    std::string type = potential["type"].get<std::string>();
+    if(type == "harmonic") {
+      return BiasPotential(weights, BiasPotential::TYPE::HARMONIC,
+                           potential["spring"].get<double>(),
+                           potential["center"].get<double>());
+    }
+    else if(type == "linear") {
+      return BiasPotential(weights, BiasPotential::TYPE::LINEAR,
+                           potential["slope"].get<double>());
+    }
+    else if(type == "table") {
+      return BiasPotential(weights,
+                           potential["order_parameter"].get<std::vector<double> >(),
+                           potential["value"].get<std::vector<double> >());
+    }
+    throw std::runtime_error(
+      "Error reading bias potential: \"potential\"/\"type\" must be one of \"harmonic\", \"linear\", or \"table\"");
+  }
+
+}
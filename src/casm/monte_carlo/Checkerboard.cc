@@ -0,0 +1,211 @@
+#include "casm/monte_carlo/Checkerboard.hh"
+#include "casm/clex/NeighborList.hh"
+#include "casm/monte_carlo/MonteCheckpoint.hh"
+
+namespace CASM {
+  namespace Monte {
+
+    /// \brief Constructor
+    ///
+    /// \param nlist SuperNeighborList of the supercell
+    /// \param volume Number of unit cells in the supercell
+    /// \param variable_sites Linear indices of sites to include in groups
+    /// \param n_threads Number of threads to use in sweeps
+    /// \param mtrand Used to seed one MTRand per thread
+    ///
+    /// - Unit cells are colored greedily, in order, with the lowest color not
+    ///   used by any unit cell in their neighborhood
+    ///
+    Checkerboard::Checkerboard(const SuperNeighborList &nlist,
+                               Index volume,
+                               const std::vector<Index> &variable_sites,
+                               Index n_threads,
+                               MTRand &mtrand) :
+      m_n_colors(0),
+      m_chunk(n_threads),
+      m_exception(n_threads),
+      m_waiting(0),
+      m_generation(0),
+      m_work(nullptr),
+      m_sweep(0),
+      m_finished(0),
+      m_stop(false) {
+
+      if(nlist.overlaps()) {
+        throw std::runtime_error(
+          "Error constructing Checkerboard: the supercell is too small, "
+          "periodic images of the neighborhood overlap.");
+      }
+      if(n_threads < 1) {
+        throw std::runtime_error(
+          "Error constructing Checkerboard: number of threads must be >= 1");
+      }
+
+      // color unit cells
+      Index uncolored = volume;
+      std::vector<Index> color(volume, uncolored);
+      std::vector<Index> forbidden;
+      for(Index uc = 0; uc < volume; ++uc) {
+        for(const auto &nuc : nlist.unitcells(uc)) {
+          if(color[nuc] != uncolored) {
+            forbidden[color[nuc]] = uc;
+          }
+        }
+        Index c = 0;
+        while(c < forbidden.size() && forbidden[c] == uc) {
+          ++c;
+        }
+        if(c == forbidden.size()) {
+          forbidden.push_back(volume);
+        }
+        color[uc] = c;
+      }
+      m_n_colors = forbidden.size();
+
+      // check, in case the neighborhood is not symmetric
+      for(Index uc = 0; uc < volume; ++uc) {
+        for(const auto &nuc : nlist.unitcells(uc)) {
+          if(nuc != uc && color[nuc] == color[uc]) {
+            throw std::runtime_error(
+              "Error constructing Checkerboard: neighboring unit cells have the same color.");
+          }
+        }
+      }
+
+      // group sites by (color, sublattice)
+      Index n_sublat = 0;
+      for(const auto &l : variable_sites) {
+        n_sublat = std::max(n_sublat, Index(nlist.sublat_index(l) + 1));
+      }
+      std::vector<std::vector<Index> > group(m_n_colors * n_sublat);
+      for(const auto &l : variable_sites) {
+        group[color[nlist.unitcell_index(l)] * n_sublat + nlist.sublat_index(l)].push_back(l);
+      }
+      for(auto &g : group) {
+        if(g.size()) {
+          m_group.push_back(g);
+        }
+      }
+
+      // seed one MTRand per thread
+      for(Index t = 0; t < n_threads; ++t) {
+        m_mtrand.push_back(MTRand(mtrand.randInt()));
+      }
+    }
+
+    /// \brief Stops and joins the sweep threads
+    Checkerboard::~Checkerboard() {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+      m_start_cv.notify_all();
+      for(auto &thread : m_thread) {
+        thread.join();
+      }
+    }
+
+    /// \brief Write the state of the MTRand of each thread
+    void Checkerboard::write_checkpoint(std::ostream &sout) const {
+      checkpoint::write(sout, n_threads());
+      MTRand::uint32 state[MTRand::SAVE];
+      for(const auto &mtrand : m_mtrand) {
+        mtrand.save(state);
+        for(Index i = 0; i < MTRand::SAVE; ++i) {
+          checkpoint::write(sout, state[i]);
+        }
+      }
+    }
+
+    /// \brief Restore data written by write_checkpoint
+    void Checkerboard::read_checkpoint(std::istream &sin) {
+      checkpoint::check(sin, n_threads(), "number of parallel sweep threads");
+      MTRand::uint32 state[MTRand::SAVE];
+      for(auto &mtrand : m_mtrand) {
+        for(Index i = 0; i < MTRand::SAVE; ++i) {
+          checkpoint::read(sin, state[i]);
+        }
+        mtrand.load(state);
+      }
+    }
+
+    /// \brief Run 'work(t)' for every thread, with thread 0 being the caller
+    ///
+    /// - Starts the sweep threads on first use, and returns once all threads
+    ///   have finished 'work'
+    void Checkerboard::_run(const std::function<void (Index)> &work) {
+      Index T = n_threads();
+      if(T == 1) {
+        work(0);
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_work = &work;
+        m_finished = 0;
+        ++m_sweep;
+      }
+      if(m_thread.empty()) {
+        for(Index t = 1; t < T; ++t) {
+          m_thread.emplace_back(&Checkerboard::_worker, this, t);
+        }
+      }
+      else {
+        m_start_cv.notify_all();
+      }
+
+      work(0);
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_finish_cv.wait(lock, [&]() {
+        return m_finished == T - 1;
+      });
+      m_work = nullptr;
+    }
+
+    /// \brief Loop run by sweep thread 't', for t > 0
+    void Checkerboard::_worker(Index t) {
+      Index sweep = 0;
+      while(true) {
+        const std::function<void (Index)> *work;
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_start_cv.wait(lock, [&]() {
+            return m_stop || m_sweep != sweep;
+          });
+          if(m_stop) {
+            return;
+          }
+          sweep = m_sweep;
+          work = m_work;
+        }
+
+        (*work)(t);
+
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          ++m_finished;
+        }
+        m_finish_cv.notify_one();
+      }
+    }
+
+    /// \brief Wait for all threads to finish the current group
+    void Checkerboard::_wait() {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      Index generation = m_generation;
+      if(++m_waiting == n_threads()) {
+        m_waiting = 0;
+        ++m_generation;
+        m_cv.notify_all();
+      }
+      else {
+        m_cv.wait(lock, [&]() {
+          return generation != m_generation;
+        });
+      }
+    }
+
+  }
+}
@@ -0,0 +1,104 @@
+#include "casm/monte_carlo/HopList.hh"
+#include <cmath>
+#include "casm/monte_carlo/Conversions.hh"
+#include "casm/clex/Supercell.hh"
+#include "casm/crystallography/Structure.hh"
+
+namespace CASM {
+  namespace Monte {
+
+    /// \brief Construct the list of hops in a supercell
+    ///
+    /// \param scel Supercell
+    /// \param convert Used to determine which sites have variable occupation
+    /// \param cutoff Maximum hop distance
+    ///
+    /// - Hops are found between sites of the prim, and then translated to every
+    ///   unit cell of the supercell
+    ///
+    HopList::HopList(const Supercell &scel, const Conversions &convert, double cutoff) :
+      m_site_hops(scel.num_sites()),
+      m_cutoff(cutoff) {
+
+      const Structure &prim = scel.get_prim();
+      const Eigen::Matrix3d &L = prim.lattice().lat_column_mat();
+      const Eigen::Matrix3d &L_inv = prim.lattice().inv_lat_column_mat();
+      Index volume = scel.volume();
+      Index basis_size = prim.basis.size();
+
+      std::vector<bool> variable(basis_size);
+      for(Index b = 0; b < basis_size; ++b) {
+        variable[b] = convert.occ_size(convert.l_to_asym(b * volume)) > 1;
+      }
+
+      // range of unit cell translations that may be within the cutoff
+      Eigen::Vector3l max_t;
+      for(int i = 0; i < 3; ++i) {
+        max_t(i) = std::ceil(cutoff * L_inv.row(i).norm()) + 1;
+      }
+
+      // hops in the prim: (b_a, b_b, translation, dr), each pair of sites once
+      struct PrimHop {
+        Index b_a;
+        Index b_b;
+        UnitCell t;
+        Eigen::Vector3d dr;
+      };
+      std::vector<PrimHop> prim_hops;
+      for(Index b_a = 0; b_a < basis_size; ++b_a) {
+        if(!variable[b_a]) {
+          continue;
+        }
+        for(Index b_b = b_a; b_b < basis_size; ++b_b) {
+          if(!variable[b_b]) {
+            continue;
+          }
+          Eigen::Vector3d r_ab = prim.basis[b_b].const_cart() - prim.basis[b_a].const_cart();
+          for(Index i = -max_t(0); i <= max_t(0); ++i) {
+            for(Index j = -max_t(1); j <= max_t(1); ++j) {
+              for(Index k = -max_t(2); k <= max_t(2); ++k) {
+                UnitCell t(i, j, k);
+
+                // for hops between sites on the same sublattice, keep only one direction
+                if(b_a == b_b && !(i > 0 || (i == 0 && (j > 0 || (j == 0 && k > 0))))) {
+                  continue;
+                }
+
+                Eigen::Vector3d dr = r_ab + L * t.cast<double>();
+                if(dr.norm() < cutoff + TOL) {
+                  prim_hops.push_back({b_a, b_b, t, dr});
+                }
+              }
+            }
+          }
+        }
+      }
+
+      // hops in the supercell
+      for(Index uc = 0; uc < volume; ++uc) {
+        for(const auto &prim_hop : prim_hops) {
+          Index l_a = prim_hop.b_a * volume + uc;
+          UnitCellCoord bijk_a = scel.uccoord(l_a);
+          Index l_b = scel.find(UnitCellCoord(prim_hop.b_b, bijk_a.unitcell() + prim_hop.t));
+
+          bool unique = (l_a != l_b);
+          for(const auto &i : m_site_hops[l_a]) {
+            if(m_hop[i].l_a == l_b || m_hop[i].l_b == l_b) {
+              unique = false;
+            }
+          }
+          if(!unique) {
+            throw std::runtime_error(
+              "Error constructing HopList: the supercell is too small, "
+              "periodic images of a site are within the hop cutoff distance.");
+          }
+
+          m_site_hops[l_a].push_back(m_hop.size());
+          m_site_hops[l_b].push_back(m_hop.size());
+          m_hop.push_back({l_a, l_b, prim_hop.dr});
+        }
+      }
+    }
+
+  }
+}
@@ -1,5 +1,8 @@
 #include "casm/monte_carlo/MCData.hh"
 
+#include <algorithm>
+#include <cmath>
+
 #include "casm/external/boost.hh"
 
 namespace CASM {
@@ -106,87 +109,87 @@ namespace CASM {
   }
 
 
-  /// \brief Check convergence of a range of observations
+  /// \brief Check convergence of the observations in range [start, data.size())
   ///
-  /// \param observations An Eigen::VectorXd of observations
+  /// \param data MCData, including blocking statistics
+  /// \param start Index of the first observation to include
   /// \param conf Desired confidence level
   ///
-  /// We check for convergence using the algorithm of:
-  ///  Van de Walle and Asta, Modelling Simul. Mater. Sci. Eng. 10 (2002) 521–538.
+  /// The variance of the mean is estimated by the blocking method of:
+  ///  Flyvbjerg and Petersen, J. Chem. Phys. 91 (1989) 461-466,
+  /// choosing the block size as in:
+  ///  Lee, Drummond, and Needs, Phys. Rev. B 83 (2011) 245106.
   ///
   /// The observations are considered converged to the desired prec and conf if:
   /// - calculated_prec <= prec,
   ///
   /// where:
-  /// - calculated_prec = sqrt(Var)*z_alpha,
-  /// - z_alpha = sqrt(2.0)*inv_erf(1.0-conf)
-  /// - var_of_mean = (CoVar[0]/observations.size())*((1.0+rho)/(1.0-rho))
-  /// - CoVar[i] = ( (1.0/(observations.size()-i))*sum_j(j=0:L-i-1, observations(j)*observations(j+1)) ) - sqr(observations.mean());
-  /// - rho = pow(2.0, -1.0/i), using min i such that CoVar[i]/CoVar[0] < 0.5
+  /// - calculated_prec = sqrt(var_of_mean)*z_alpha,
+  /// - z_alpha = sqrt(2.0)*inv_erf(conf)
+  /// - var_of_mean = Var[k]/n[k], the variance of the means of the n[k] complete
+  ///   blocks of size 2^k in the range, divided by n[k]
+  /// - k is the min k such that pow(2.0, 3*k) > 2*N*pow(var_of_mean[k]/var_of_mean[0], 2.0),
+  ///   with N = data.size() - start
   ///
-  MCDataConvergence::MCDataConvergence(const Eigen::VectorXd &observations, double conf) :
-    m_is_converged(false),
-    m_mean(observations.mean()),
-    m_squared_norm(observations.squaredNorm()) {
-
-    // will check if Var <= criteria
-    double z_alpha = sqrt(2.0) * boost::math::erf_inv(conf);
-
-    bool found_rho;
-    double rho;
-    double CoVar0;
-    size_type N = observations.size();
-
-    // try to calculate variance taking into account correlations
-    std::tie(found_rho, rho, CoVar0) = _calc_rho(observations);
-
-    if(!found_rho) {
-      m_is_converged = false;
-      m_calculated_prec = 1.0 / 0.0;
-      return;
-    }
-
-
-    double var_of_mean = (CoVar0 / N) * (1.0 + rho) / (1.0 - rho);
-
-    m_calculated_prec = z_alpha * sqrt(var_of_mean);
-  }
-
-  double covariance(const Eigen::VectorXd &X, const Eigen::VectorXd &Y, double mean) {
-    Eigen::VectorXd vmean = Eigen::VectorXd::Ones(X.size()) * mean;
-    return (X - vmean).dot(Y - vmean) / X.size();
-  }
-
-
-  /// \brief Try to find rho = pow(2.0, -1.0/i), using min i such that CoVar[i]/CoVar[0] <= 0.5
+  /// If no block size satisfies the criteria, there are too few observations to
+  /// estimate the correlation time and calculated_prec is infinite.
   ///
-  /// \returns std::tuple<bool, double> : (found_rho?, rho)
+  /// The block sums are maintained by MCData::push_back, so this takes
+  /// O(log(N)), rather than the O(N^2) required to find the covariance at each
+  /// lag.
   ///
-  std::tuple<bool, double, double> MCDataConvergence::_calc_rho(const Eigen::VectorXd &observations) {
-
-    size_type N = observations.size();
-    double CoVar0 = m_squared_norm / N - m_mean * m_mean;
+  MCDataConvergence::MCDataConvergence(const MCData &data, size_type start, double conf) :
+    m_is_converged(false) {
 
-    // if there is essentially no variation, return rho(l==1)
-    if(std::abs(CoVar0 / m_mean) < 1e-8 || CoVar0 == 0.0) {
-      CoVar0 = 0.0;
-      return std::make_tuple(true, pow(2.0, -1.0 / 1), CoVar0);
-    }
+    size_type N = data.size() - start;
+    double shift = data.shift();
 
-    // simple incremental search for now, could try bracketing / bisection
-    for(size_type i = 1; i < N; ++i) {
+    // mean and sum of squares, from level 0 (single observation blocks)
+    double S1 = data.block_sum(0, data.size()) - data.block_sum(0, start);
+    double S2 = data.block_sqsum(0, data.size()) - data.block_sqsum(0, start);
+    m_mean = shift + S1 / N;
+    m_squared_norm = S2 + 2.0 * shift * S1 + N * shift * shift;
 
-      size_type range_size = N - i;
+    // will check if Var <= criteria
+    double z_alpha = sqrt(2.0) * boost::math::erf_inv(conf);
 
-      double cov = covariance(observations.segment(0, range_size), observations.segment(i, range_size), m_mean);
+    // variance of the mean, estimated from blocks at level k
+    auto var_of_mean = [&](Index k) {
+      size_type block_size = size_type(1) << k;
+      size_type begin = (start + block_size - 1) / block_size;
+      size_type end = data.size() / block_size;
+      if(end < begin + 2) {
+        return -1.0;
+      }
+      double n = end - begin;
+      double sum = data.block_sum(k, end) - data.block_sum(k, begin);
+      double sqsum = data.block_sqsum(k, end) - data.block_sqsum(k, begin);
+      double var = (sqsum - sum * sum / n) / (n - 1.0);
+      return std::max(var, 0.0) / n;
+    };
+
+    // if there is essentially no variation, the mean is converged
+    double CoVar0 = S2 / N - (S1 / N) * (S1 / N);
+    if(N < 2 || std::abs(CoVar0 / m_mean) < 1e-8 || CoVar0 <= 0.0) {
+      m_calculated_prec = 0.0;
+      return;
+    }
 
-      if(std::abs(cov / CoVar0) <= 0.5) {
-        return std::make_tuple(true, pow(2.0, (-1.0 / i)), CoVar0);
+    double var0 = var_of_mean(0);
+    for(Index k = 0; k < data.block_levels(); ++k) {
+      double var_k = var_of_mean(k);
+      if(var_k < 0.0) {
+        break;
+      }
+      double ratio = var_k / var0;
+      if(pow(2.0, 3.0 * k) > 2.0 * N * ratio * ratio) {
+        m_calculated_prec = z_alpha * sqrt(var_k);
+        return;
       }
     }
 
     // if could not find:
-    return std::make_tuple(false, 0.0, CoVar0);
+    m_calculated_prec = 1.0 / 0.0;
   }
 
 }
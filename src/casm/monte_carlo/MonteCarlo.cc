@@ -1,4 +1,6 @@
 #include "casm/monte_carlo/MonteCarlo.hh"
+#include "casm/monte_carlo/MonteIO.hh"
+#include "casm/monte_carlo/MonteCheckpoint.hh"
 #include "casm/clex/Configuration.hh"
 
 namespace CASM {
@@ -28,14 +30,37 @@ namespace CASM {
   /// \brief Samples all requested property data, and stores pass and step number sample was taken at
   void MonteCarlo::sample_data(const MonteCounter &counter) {
 
-    // call MonteSamper::sample(*this) for all samplers
-    for(auto it = m_sampler.begin(); it != m_sampler.end(); ++it) {
-      it->second->sample(*this, counter);
+    // copy elements of MonteCarlo properties, one property at a time
+    for(const auto &samples : m_property_samples) {
+      if(samples.is_vector) {
+        const Eigen::VectorXd &value = vector_property(samples.property);
+        for(const auto &element_col : samples.element_col) {
+          m_sample_row(element_col.second) = value(element_col.first);
+        }
+      }
+      else {
+        double value = scalar_property(samples.property);
+        for(const auto &element_col : samples.element_col) {
+          m_sample_row(element_col.second) = value;
+        }
+      }
+    }
+
+    // evaluate remaining samplers
+    for(const auto &sampler_col : m_other_samples) {
+      m_sample_row(sampler_col.second) = sampler_col.first->value(*this, counter);
     }
+
+    m_sample_store->push_back(m_sample_row.data());
     m_sample_time.push_back(std::make_pair(counter.pass(), counter.step()));
 
     if(m_write_trajectory) {
-      m_trajectory.push_back(configdof());
+      if(m_trajectory_writer) {
+        m_trajectory_writer->write(counter.pass(), counter.step(), configdof().occupation());
+      }
+      else {
+        m_trajectory.push_back(configdof());
+      }
     }
 
     m_is_equil_uptodate = false;
@@ -47,7 +72,9 @@ namespace CASM {
     for(auto it = m_sampler.begin(); it != m_sampler.end(); ++it) {
       it->second->clear();
     }
+    m_sample_store->clear();
     m_trajectory.clear();
+    m_trajectory_writer.reset();
     m_sample_time.clear();
 
     m_is_equil_uptodate = false;
@@ -55,6 +82,165 @@ namespace CASM {
     m_next_convergence_check = m_convergence_check_period;
   }
 
+  /// \brief Begin writing snapshots for conditions 'cond_index' to a binary
+  ///        trajectory file, if requested
+  ///
+  /// - Does nothing unless MonteSettings::write_binary_trajectory
+  /// - Snapshots taken by sample_data are written as they are taken, rather
+  ///   than stored, until end_trajectory or clear_samples
+  void MonteCarlo::begin_trajectory(Index cond_index) {
+    m_trajectory_writer.reset();
+    if(!m_write_trajectory || !settings().write_binary_trajectory()) {
+      return;
+    }
+    MonteCarloDirectoryStructure dir(settings().output_directory());
+    fs::create_directories(dir.conditions_dir(cond_index));
+    m_trajectory_writer.reset(
+      new MonteTrajectoryWriter(
+        dir.trajectory_bin(cond_index),
+        configdof().size(),
+        settings().trajectory_keyframe_period()));
+  }
+
+  /// \brief Finish writing any binary trajectory file
+  void MonteCarlo::end_trajectory() {
+    if(m_trajectory_writer) {
+      m_trajectory_writer->flush();
+      m_trajectory_writer.reset();
+    }
+  }
+
+  /// \brief Write sampled data, properties, and random number generator state
+  ///
+  /// - Includes everything needed by read_checkpoint to continue sampling as if
+  ///   the calculation had not stopped: sampled observations, sample times,
+  ///   stored snapshots, the position in any binary trajectory, the MTRand
+  ///   state, and the current scalar and vector property values
+  /// - The ConfigDoF and conditions are not included; they are set by the
+  ///   derived class 'set_state' before calling read_checkpoint
+  void MonteCarlo::write_checkpoint(std::ostream &sout) const {
+
+    // observations, by sample, so that read_checkpoint can rebuild block statistics
+    checkpoint::write(sout, m_sample_store->cols());
+    checkpoint::write(sout, Index(m_sample_store->size()));
+    for(MCDataStore::size_type i = 0; i < m_sample_store->size(); ++i) {
+      sout.write(reinterpret_cast<const char *>(m_sample_store->sample(i)),
+                 sizeof(double) * m_sample_store->cols());
+    }
+
+    checkpoint::write(sout, Index(m_sample_time.size()));
+    for(const auto &t : m_sample_time) {
+      checkpoint::write(sout, t.first);
+      checkpoint::write(sout, t.second);
+    }
+
+    checkpoint::write(sout, Index(m_trajectory.size()));
+    for(const auto &snapshot : m_trajectory) {
+      checkpoint::write(sout, snapshot.occupation());
+    }
+
+    checkpoint::write(sout, std::uint8_t(m_trajectory_writer ? 1 : 0));
+    if(m_trajectory_writer) {
+      m_trajectory_writer->write_checkpoint(sout);
+    }
+
+    MTRand::uint32 state[MTRand::SAVE];
+    m_twister.save(state);
+    for(Index i = 0; i < MTRand::SAVE; ++i) {
+      checkpoint::write(sout, state[i]);
+    }
+    checkpoint::write(sout, m_next_convergence_check);
+
+    checkpoint::write(sout, Index(m_scalar_property.size()));
+    for(const auto &prop : m_scalar_property) {
+      checkpoint::write(sout, prop.first);
+      checkpoint::write(sout, prop.second);
+    }
+    checkpoint::write(sout, Index(m_vector_property.size()));
+    for(const auto &prop : m_vector_property) {
+      checkpoint::write(sout, prop.first);
+      checkpoint::write(sout, prop.second);
+    }
+  }
+
+  /// \brief Restore data written by write_checkpoint
+  ///
+  /// - Expects the same samplers and supercell as when the checkpoint was written
+  /// - Clears existing samples first
+  /// - Property values are assigned in place, so references held by derived
+  ///   classes remain valid
+  void MonteCarlo::read_checkpoint(std::istream &sin) {
+
+    clear_samples();
+
+    checkpoint::check(sin, m_sample_store->cols(), "number of samplers");
+    Index n_samples;
+    checkpoint::read(sin, n_samples);
+    std::vector<double> row(m_sample_store->cols());
+    for(Index i = 0; i < n_samples; ++i) {
+      sin.read(reinterpret_cast<char *>(row.data()), sizeof(double) * row.size());
+      if(!sin) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: unexpected end of file");
+      }
+      m_sample_store->push_back(row.data());
+    }
+
+    Index n_times;
+    checkpoint::read(sin, n_times);
+    m_sample_time.resize(n_times);
+    for(auto &t : m_sample_time) {
+      checkpoint::read(sin, t.first);
+      checkpoint::read(sin, t.second);
+    }
+
+    Index n_snapshots;
+    checkpoint::read(sin, n_snapshots);
+    Array<int> occupation;
+    for(Index i = 0; i < n_snapshots; ++i) {
+      checkpoint::read(sin, occupation);
+      m_trajectory.push_back(ConfigDoF(occupation));
+    }
+
+    std::uint8_t has_writer;
+    checkpoint::read(sin, has_writer);
+    if(has_writer) {
+      m_trajectory_writer.reset(new MonteTrajectoryWriter(sin));
+    }
+
+    MTRand::uint32 state[MTRand::SAVE];
+    for(Index i = 0; i < MTRand::SAVE; ++i) {
+      checkpoint::read(sin, state[i]);
+    }
+    m_twister.load(state);
+    checkpoint::read(sin, m_next_convergence_check);
+
+    Index n_prop;
+    std::string name;
+    checkpoint::read(sin, n_prop);
+    for(Index i = 0; i < n_prop; ++i) {
+      checkpoint::read(sin, name);
+      auto it = m_scalar_property.find(name);
+      if(it == m_scalar_property.end()) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: unknown property '" + name + "'");
+      }
+      checkpoint::read(sin, it->second);
+    }
+    checkpoint::read(sin, n_prop);
+    Eigen::VectorXd value;
+    for(Index i = 0; i < n_prop; ++i) {
+      checkpoint::read(sin, name);
+      auto it = m_vector_property.find(name);
+      checkpoint::read(sin, value);
+      if(it == m_vector_property.end() || it->second.size() != value.size()) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: unknown property '" + name + "'");
+      }
+      it->second = value;
+    }
+
+    m_is_equil_uptodate = false;
+    m_is_converged_uptodate = false;
+  }
+
   /// \brief Returns pair(true, equil_samples) if required equilibration has occured for all samplers that must converge
   ///
   /// - equil_samples is the number of samples required for all samplers that must equilibrate to equilibrate
@@ -202,4 +388,55 @@ namespace CASM {
 
   }
 
-}
\ No newline at end of file
+  /// \brief Attach all samplers to columns of m_sample_store, and group them
+  ///        by the MonteCarlo property they sample
+  ///
+  /// - Samplers are stored by column, in m_sampler order, in one MCDataStore
+  ///   with space reserved for 'data_initsize' observations
+  /// - Samplers that are elements of a scalar or vector property are copied
+  ///   directly by sample_data, with one property lookup per property
+  void MonteCarlo::_init_sample_store(size_type data_initsize) {
+
+    m_sample_store.reset(new MCDataStore(m_sampler.size(), data_initsize));
+    m_sample_time.reserve(data_initsize);
+    m_sample_row = Eigen::VectorXd::Zero(m_sampler.size());
+    m_property_samples.clear();
+    m_other_samples.clear();
+
+    std::map<std::pair<std::string, bool>, Index> property_index;
+    Index col = 0;
+    for(auto it = m_sampler.begin(); it != m_sampler.end(); ++it, ++col) {
+      it->second->attach(*m_sample_store, col);
+
+      MonteSampler::PropertyElement element;
+      if(!it->second->property_element(element)) {
+        m_other_samples.push_back(std::make_pair(&(*it->second), col));
+        continue;
+      }
+
+      auto key = std::make_pair(element.property, element.is_vector);
+      auto res = property_index.insert(std::make_pair(key, m_property_samples.size()));
+      if(res.second) {
+        PropertySamples samples;
+        samples.property = element.property;
+        samples.is_vector = element.is_vector;
+        m_property_samples.push_back(samples);
+      }
+      m_property_samples[res.first->second].element_col.push_back(std::make_pair(element.index, col));
+    }
+  }
+
+  /// \brief Write cache hits, misses, and memory to _log(), if the cache is enabled
+  void MonteCarlo::_log_site_energy_cache() const {
+    const Monte::SiteEnergyCache &cache = site_energy_cache();
+    if(!cache.is_enabled()) {
+      return;
+    }
+    _log().results("Site energy cache");
+    _log() << "hits: " << cache.hits() << "\n"
+           << "misses: " << cache.misses() << "\n"
+           << "hit rate: " << cache.hit_rate() << "\n"
+           << "memory (MB): " << cache.memory() / (1024.0 * 1024.0) << "\n" << std::endl;
+  }
+
+}
@@ -176,6 +176,61 @@ namespace CASM {
   }
 
 
+  /// \brief Increment by a full pass, for methods that attempt every step of a pass at once
+  ///
+  /// - Only valid when sampling by pass, and at the beginning of a pass
+  MonteCounter &MonteCounter::increment_pass() {
+
+    if(m_sample_mode != Monte::SAMPLE_MODE::PASS || m_step != 0) {
+      throw std::runtime_error(
+        "Error in MonteCounter::increment_pass: must sample by pass, and begin at step 0");
+    }
+
+    ++m_pass;
+    ++m_since_last_sample;
+
+    return *this;
+  }
+
+  /// \brief Maximum number of steps that may be taken at once using 'increment'
+  ///
+  /// - The number of steps until the end of the current pass or the next sample
+  ///   time, whichever comes first, but at least 1
+  MonteCounter::size_type MonteCounter::max_increment() const {
+    size_type n = m_steps_per_pass - m_step;
+    if(m_sample_mode == Monte::SAMPLE_MODE::STEP) {
+      n = std::min(n, std::max(size_type(1), m_sample_period - m_since_last_sample));
+    }
+    return n;
+  }
+
+  /// \brief Increment by 'n' steps, for methods that perform many steps at once
+  ///
+  /// - Equivalent to 'n' prefix increments, for 1 <= n <= max_increment()
+  MonteCounter &MonteCounter::increment(size_type n) {
+
+    if(n < 1 || n > max_increment()) {
+      throw std::runtime_error(
+        "Error in MonteCounter::increment: must increment by 1 to max_increment() steps");
+    }
+
+    m_step += n;
+    if(m_step == m_steps_per_pass) {
+      ++m_pass;
+      m_step = 0;
+
+      if(m_sample_mode == Monte::SAMPLE_MODE::PASS) {
+        ++m_since_last_sample;
+      }
+    }
+
+    if(m_sample_mode == Monte::SAMPLE_MODE::STEP) {
+      m_since_last_sample += n;
+    }
+
+    return *this;
+  }
+
   /// \brief Check if requested number of pass, step, or samples has been met
   bool MonteCounter::is_complete() const {
     if(m_is_N_step && step() >= m_N_step) {
@@ -15,7 +15,10 @@ namespace CASM {
 
   const std::multimap<Monte::METHOD, std::vector<std::string> > traits<Monte::METHOD>::strval = {
     {Monte::METHOD::Metropolis, {"Metropolis", "metropolis"} },
-    {Monte::METHOD::LTE1, {"LTE1", "lte1"} }
+    {Monte::METHOD::LTE1, {"LTE1", "lte1"} },
+    {Monte::METHOD::ReplicaExchange, {"ReplicaExchange", "replica_exchange"} },
+    {Monte::METHOD::KMC, {"KMC", "kmc"} },
+    {Monte::METHOD::WangLandau, {"WangLandau", "wang_landau"} }
   };
 
 
@@ -31,7 +34,8 @@ namespace CASM {
 
   const std::multimap<Monte::DRIVE_MODE, std::vector<std::string> > traits<Monte::DRIVE_MODE>::strval = {
     {Monte::DRIVE_MODE::INCREMENTAL, {"Incremental", "incremental"} },
-    {Monte::DRIVE_MODE::CUSTOM, {"Custom", "custom"} }
+    {Monte::DRIVE_MODE::CUSTOM, {"Custom", "custom"} },
+    {Monte::DRIVE_MODE::ADAPTIVE, {"Adaptive", "adaptive"} }
   };
 
   const std::string traits<Monte::ENUM_SAMPLE_MODE>::name = "sample_mode";
@@ -3,6 +3,7 @@
 #include "casm/casm_io/VaspIO.hh"
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/monte_carlo/MonteCarlo.hh"
+#include "casm/monte_carlo/MonteTrajectory.hh"
 
 namespace CASM {
 
@@ -209,6 +210,65 @@ namespace CASM {
     return formatter;
   }
 
+  /// \brief Will create new file or append to existing file a results summary
+  void write_results(const MonteSettings &settings, const MonteResultsSummary &summary, Log &_log) {
+    try {
+
+      fs::create_directories(settings.output_directory());
+      MonteCarloDirectoryStructure dir(settings.output_directory());
+
+      // write csv path results
+      if(settings.write_csv()) {
+        _log << "write: " << dir.results_csv() << "\n";
+        fs::path file = dir.results_csv();
+        fs::ofstream sout;
+
+        if(!fs::exists(file)) {
+          sout.open(file);
+          sout << summary.csv_header;
+        }
+        else {
+          sout.open(file, std::ios::app);
+        }
+
+        sout << summary.csv;
+
+        sout.close();
+      }
+
+      // write json path results
+      if(settings.write_json()) {
+        _log << "write: " << dir.results_json() << "\n";
+        fs::path file = dir.results_json();
+
+        jsonParser results;
+        if(fs::exists(file)) {
+          results.read(file);
+        }
+        else {
+          results = jsonParser::object();
+        }
+
+        for(auto it = summary.json.begin(); it != summary.json.end(); ++it) {
+          auto res_it = results.find(it.name());
+          if(res_it == results.end()) {
+            results[it.name()].put_array();
+            res_it = results.find(it.name());
+          }
+          for(auto val_it = it->begin(); val_it != it->end(); ++val_it) {
+            res_it->push_back(*val_it);
+          }
+        }
+        results.write(file);
+      }
+    }
+    catch(...) {
+      std::cerr << "ERROR writing results" << std::endl;
+      throw;
+    }
+
+  }
+
   /// \brief Will create (and possibly overwrite) new file with all observations from run with conditions.cond_index
   void write_observations(const MonteSettings &settings, const MonteCarlo &mc, Index cond_index, Log &_log) {
     try {
@@ -266,6 +326,11 @@ namespace CASM {
   /// [["A", "B"],["A" "C"], ... ]
   /// \endcode
   ///
+  /// - If MonteSettings::write_binary_trajectory, the trajectory is written with
+  ///   MonteTrajectoryWriter, as "trajectory.bin", and "occupation_key.json" is
+  ///   written. Snapshots are usually written as they are taken (see
+  ///   MonteCarlo::begin_trajectory), otherwise they are written here.
+  ///
   void write_trajectory(const MonteSettings &settings, const MonteCarlo &mc, Index cond_index, Log &_log) {
     try {
 
@@ -275,9 +340,32 @@ namespace CASM {
 
       MonteCarloDirectoryStructure dir(settings.output_directory());
       fs::create_directories(dir.conditions_dir(cond_index));
-      auto formatter = make_trajectory_formatter(mc);
       const Structure &prim = mc.primclex().get_prim();
 
+      if(settings.write_binary_trajectory()) {
+
+        // snapshots that were stored rather than written as they were taken
+        if(mc.trajectory().size()) {
+          MonteTrajectoryWriter writer(
+            dir.trajectory_bin(cond_index),
+            mc.configdof().size(),
+            settings.trajectory_keyframe_period());
+          for(Index i = 0; i < mc.trajectory().size(); ++i) {
+            writer.write(mc.sample_times()[i].first, mc.sample_times()[i].second, mc.trajectory()[i].occupation());
+          }
+        }
+        _log << "write: " << dir.trajectory_bin(cond_index) << "\n";
+
+        jsonParser key = jsonParser::array();
+        for(int i = 0; i < prim.basis.size(); i++) {
+          key.push_back(prim.basis[i].allowed_occupants());
+        }
+        key.write(dir.occupation_key_json());
+        _log << "write: " << dir.occupation_key_json() << "\n";
+        return;
+      }
+
+      auto formatter = make_trajectory_formatter(mc);
       std::vector<std::pair<ConstMonteCarloPtr, Index> > observations;
       ConstMonteCarloPtr ptr = &mc;
       for(MonteSampler::size_type i = 0; i < mc.sample_times().size(); ++i) {
@@ -437,7 +525,25 @@ namespace CASM {
     BasicStructure<Site> primstruc = mc.supercell().get_prim();
     BasicStructure<Site> superstruc = primstruc.create_superstruc(mc.supercell().get_real_super_lattice());
 
-    if(mc.settings().write_json()) {
+    if(mc.settings().write_binary_trajectory()) {
+
+      fs::path filename = dir.trajectory_bin(cond_index);
+
+      if(!fs::exists(filename)) {
+        throw std::runtime_error(
+          std::string("ERROR in 'write_POSCAR_trajectory(const MonteCarlo &mc, Index cond_index)'\n") +
+          "  File not found: " + filename.string());
+      }
+
+      MonteTrajectoryReader reader(filename);
+      while(reader.next()) {
+        pass.push_back(reader.pass(reader.sample()));
+        step.push_back(reader.step(reader.sample()));
+        trajectory.push_back(ConfigDoF(reader.occupation()));
+      }
+
+    }
+    else if(mc.settings().write_json()) {
 
       std::string filename = dir.trajectory_json(cond_index).string() + ".gz";
 
@@ -63,9 +63,17 @@ namespace CASM {
     m_property_name(_property_name) {}
 
 
-  /// \brief Sample data from a MonteCarlo calculation
-  void ScalarMonteSampler::sample(const MonteCarlo &mc, const MonteCounter &counter) {
-    data().push_back(mc.scalar_property(m_property_name));
+  /// \brief Evaluate the sampled property for a MonteCarlo calculation
+  double ScalarMonteSampler::value(const MonteCarlo &mc, const MonteCounter &counter) {
+    return mc.scalar_property(m_property_name);
+  }
+
+  /// \brief Sampled property is mc.scalar_property(property_name)
+  bool ScalarMonteSampler::property_element(PropertyElement &element) const {
+    element.property = m_property_name;
+    element.is_vector = false;
+    element.index = 0;
+    return true;
   }
 
 
@@ -108,9 +116,17 @@ namespace CASM {
     m_index(_index) {}
 
 
-  /// \brief Sample data from a MonteCarlo calculation
-  void VectorMonteSampler::sample(const MonteCarlo &mc, const MonteCounter &counter) {
-    data().push_back(mc.vector_property(m_property_name)(m_index));
+  /// \brief Evaluate the sampled property for a MonteCarlo calculation
+  double VectorMonteSampler::value(const MonteCarlo &mc, const MonteCounter &counter) {
+    return mc.vector_property(m_property_name)(m_index);
+  }
+
+  /// \brief Sampled property is mc.vector_property(property_name)(index)
+  bool VectorMonteSampler::property_element(PropertyElement &element) const {
+    element.property = m_property_name;
+    element.is_vector = true;
+    element.index = m_index;
+    return true;
   }
 
 
@@ -157,9 +173,9 @@ namespace CASM {
     m_formatter(formatter) {}
 
 
-  /// \brief Sample data from a MonteCarlo calculation
-  void QueryMonteSampler::sample(const MonteCarlo &mc, const MonteCounter &counter) {
-    data().push_back(m_formatter->sample(mc, counter)[m_index]);
+  /// \brief Evaluate the sampled property for a MonteCarlo calculation
+  double QueryMonteSampler::value(const MonteCarlo &mc, const MonteCounter &counter) {
+    return m_formatter->sample(mc, counter)[m_index];
   }
 
 
@@ -201,14 +217,13 @@ namespace CASM {
     m_comp_converter(_comp_converter) {}
 
 
-  /// \brief Sample data from a MonteCarlo calculation
-  void CompMonteSampler::sample(const MonteCarlo &mc, const MonteCounter &counter) {
+  /// \brief Evaluate the sampled property for a MonteCarlo calculation
+  double CompMonteSampler::value(const MonteCarlo &mc, const MonteCounter &counter) {
 
     auto comp_n = mc.vector_property("comp_n");
     auto comp = m_comp_converter.param_composition(comp_n);
 
-    data().push_back(comp(m_index));
-
+    return comp(m_index);
   }
 
 
@@ -250,9 +265,9 @@ namespace CASM {
     m_basis_size(_basis_size) {}
 
 
-  /// \brief Sample data from a MonteCarlo calculation
-  void SiteFracMonteSampler::sample(const MonteCarlo &mc, const MonteCounter &counter) {
-    data().push_back(mc.vector_property("comp_n")(m_index) / m_basis_size);
+  /// \brief Evaluate the sampled property for a MonteCarlo calculation
+  double SiteFracMonteSampler::value(const MonteCarlo &mc, const MonteCounter &counter) {
+    return mc.vector_property("comp_n")(m_index) / m_basis_size;
   }
 
 
@@ -294,17 +309,18 @@ namespace CASM {
     m_vacancy_index(_vacancy_index) {}
 
 
-  /// \brief Sample data from a MonteCarlo calculation
-  void AtomFracMonteSampler::sample(const MonteCarlo &mc, const MonteCounter &counter) {
+  /// \brief Evaluate the sampled property for a MonteCarlo calculation
+  double AtomFracMonteSampler::value(const MonteCarlo &mc, const MonteCounter &counter) {
 
+    const Eigen::VectorXd &comp_n = mc.vector_property("comp_n");
     double atom_sum = 0.0;
-    for(size_type i = 0; i < mc.vector_property("comp_n").size(); ++i) {
+    for(size_type i = 0; i < comp_n.size(); ++i) {
       if(i != m_vacancy_index) {
-        atom_sum += mc.vector_property("comp_n")(i);
+        atom_sum += comp_n(i);
       }
     }
 
-    data().push_back(mc.vector_property("comp_n")(m_index) / atom_sum);
+    return comp_n(m_index) / atom_sum;
   }
 
 }
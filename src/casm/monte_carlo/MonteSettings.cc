@@ -3,6 +3,7 @@
 #include "casm/monte_carlo/MonteCarloEnum.hh"
 #include "casm/container/LinearAlgebra.hh"
 #include "casm/misc/HallOfFame.hh"
+#include "casm/misc/parallel.hh"
 
 namespace CASM {
 
@@ -123,6 +124,309 @@ namespace CASM {
     return _get_setting<bool>("driver", "dependent_runs", help);
   }
 
+  /// \brief Number of passes between replica exchange attempts. Default 1.
+  MonteSettings::size_type MonteSettings::swap_period() const {
+    if(!_is_setting("driver", "swap_period")) {
+      return 1;
+    }
+    std::string help = "int (default=1)\n"
+                       "  Number of passes each replica runs between attempts to exchange\n"
+                       "    states between neighboring conditions. Only used with\n"
+                       "    \"method\": \"ReplicaExchange\".\n";
+    return _get_setting<size_type>("driver", "swap_period", help);
+  }
+
+  /// \brief Number of conditions to calculate at once if not dependent runs, or
+  ///        replicas to run at once for replica exchange. Default 1.
+  ///
+  /// - If "driver"/"threads" is 0, use the number of hardware threads
+  MonteSettings::size_type MonteSettings::threads() const {
+    if(!_is_setting("driver", "threads")) {
+      return 1;
+    }
+    std::string help = "int (default=1)\n"
+                       "  Number of conditions to calculate at once, each in its own thread.\n"
+                       "    Only used if \"dependent_runs\" is false, or with \"method\":\n"
+                       "    \"ReplicaExchange\". If 0, use the number of hardware threads.\n";
+    size_type n = _get_setting<size_type>("driver", "threads", help);
+    return resolve_threads(n);
+  }
+
+  /// \brief Returns true if a random number generator seed is given
+  bool MonteSettings::is_seed() const {
+    return _is_setting("driver", "seed");
+  }
+
+  /// \brief Random number generator seed for the first conditions
+  ///
+  /// - The random number generator is seeded with "driver"/"seed" + i before
+  ///   calculating conditions i, so results do not depend on the order, or
+  ///   number of threads, with which conditions are calculated
+  unsigned long MonteSettings::seed() const {
+    std::string help = "int (optional)\n"
+                       "  If given, seed the random number generator with this value plus i\n"
+                       "    before calculating conditions i. If not given, the random number\n"
+                       "    generator is seeded from /dev/urandom or the time.\n";
+    return _get_setting<unsigned long>("driver", "seed", help);
+  }
+
+  /// \brief Maximum change in each results summary property between adjacent
+  ///        conditions, for the adaptive drive mode
+  ///
+  /// - Expects "driver"/"adaptive"/"max_jump": {"<property>": <number>, ...},
+  ///   where property names are results summary columns, such as
+  ///   "<potential_energy>", "<comp(a)>", or "heat_capacity"
+  std::map<std::string, double> MonteSettings::adaptive_max_jump() const {
+    std::string help = "object\n"
+                       "  Maximum change in results summary properties between adjacent conditions,\n"
+                       "    before inserting conditions between them. For example:\n"
+                       "      {\"<potential_energy>\": 0.005, \"<comp(a)>\": 0.02, \"heat_capacity\": 1.0}\n";
+    jsonParser json = _get_setting<jsonParser>("driver", "adaptive", "max_jump", help);
+    std::map<std::string, double> max_jump;
+    for(auto it = json.begin(); it != json.end(); ++it) {
+      max_jump[it.name()] = it->get<double>();
+    }
+    if(max_jump.empty()) {
+      throw std::runtime_error(std::string("Error reading Monte Carlo settings: ") +
+                               "[\"driver\"][\"adaptive\"][\"max_jump\"] must include at least one property\n" + help);
+    }
+    return max_jump;
+  }
+
+  /// \brief Maximum number of times an increment may be halved in the adaptive drive mode. Default 3.
+  MonteSettings::size_type MonteSettings::adaptive_max_refinement() const {
+    if(!_is_setting("driver", "adaptive", "max_refinement")) {
+      return 3;
+    }
+    std::string help = "int (default=3)\n"
+                       "  Maximum number of times the \"incremental_conditions\" step may be halved, so\n"
+                       "    the minimum step is incremental_conditions/2^max_refinement.\n";
+    return _get_setting<size_type>("driver", "adaptive", "max_refinement", help);
+  }
+
+  /// \brief Lower edge of the Wang-Landau energy range, per unit cell
+  double MonteSettings::wang_landau_energy_min() const {
+    std::string help = "number (required)\n"
+                       "  Lower edge of the potential energy range, per unit cell, over which the\n"
+                       "    density of states is calculated.\n";
+    return _get_setting<double>("driver", "wang_landau", "energy_min", help);
+  }
+
+  /// \brief Upper edge of the Wang-Landau energy range, per unit cell
+  double MonteSettings::wang_landau_energy_max() const {
+    std::string help = "number (required)\n"
+                       "  Upper edge of the potential energy range, per unit cell, over which the\n"
+                       "    density of states is calculated.\n";
+    return _get_setting<double>("driver", "wang_landau", "energy_max", help);
+  }
+
+  /// \brief Width of Wang-Landau energy bins, per unit cell
+  double MonteSettings::wang_landau_bin_width() const {
+    std::string help = "number (required)\n"
+                       "  Width of potential energy bins, per unit cell.\n";
+    return _get_setting<double>("driver", "wang_landau", "bin_width", help);
+  }
+
+  /// \brief Number of Wang-Landau energy windows. Default 1.
+  MonteSettings::size_type MonteSettings::wang_landau_windows() const {
+    if(!_is_setting("driver", "wang_landau", "windows")) {
+      return 1;
+    }
+    std::string help = "int (default=1)\n"
+                       "  Number of overlapping energy windows, each calculated in its own thread.\n";
+    return _get_setting<size_type>("driver", "wang_landau", "windows", help);
+  }
+
+  /// \brief Fraction of each Wang-Landau window that overlaps the next. Default 0.5.
+  double MonteSettings::wang_landau_overlap() const {
+    if(!_is_setting("driver", "wang_landau", "overlap")) {
+      return 0.5;
+    }
+    std::string help = "number (default=0.5)\n"
+                       "  Fraction of each energy window that overlaps the next window.\n";
+    return _get_setting<double>("driver", "wang_landau", "overlap", help);
+  }
+
+  /// \brief Number of passes between Wang-Landau histogram flatness checks. Default 10.
+  MonteSettings::size_type MonteSettings::wang_landau_check_period() const {
+    if(!_is_setting("driver", "wang_landau", "check_period")) {
+      return 10;
+    }
+    std::string help = "int (default=10)\n"
+                       "  Number of passes between checks of histogram flatness.\n";
+    return _get_setting<size_type>("driver", "wang_landau", "check_period", help);
+  }
+
+  /// \brief Parameters controlling the Wang-Landau convergence
+  ///
+  /// - "driver"/"wang_landau"/"ln_f_initial", "ln_f_final", "flatness", and
+  ///   "one_over_t" are optional, with defaults given by Monte::WangLandauParams
+  Monte::WangLandauParams MonteSettings::wang_landau_params() const {
+    Monte::WangLandauParams params;
+    if(_is_setting("driver", "wang_landau", "ln_f_initial")) {
+      params.ln_f_initial = _get_setting<double>("driver", "wang_landau", "ln_f_initial", "number (default=1.0)");
+    }
+    if(_is_setting("driver", "wang_landau", "ln_f_final")) {
+      params.ln_f_final = _get_setting<double>("driver", "wang_landau", "ln_f_final", "number (default=1e-6)");
+    }
+    if(_is_setting("driver", "wang_landau", "flatness")) {
+      params.flatness = _get_setting<double>("driver", "wang_landau", "flatness", "number (default=0.8)");
+    }
+    if(_is_setting("driver", "wang_landau", "one_over_t")) {
+      params.one_over_t = _get_setting<bool>("driver", "wang_landau", "one_over_t", "bool (default=true)");
+    }
+    return params;
+  }
+
+  /// \brief Returns true if checkerboard parallel sweeps are requested
+  bool MonteSettings::is_parallel_sweep() const {
+    return _is_setting("driver", "parallel_sweep");
+  }
+
+  /// \brief Number of threads to use for checkerboard parallel sweeps
+  ///
+  /// - If "driver"/"parallel_sweep" is 0, use the number of hardware threads
+  MonteSettings::size_type MonteSettings::parallel_sweep() const {
+    std::string help = "int (optional)\n"
+                       "  If given, each pass is performed as a sweep over groups of non-interacting\n"
+                       "    sites, using this number of threads. If 0, use the number of hardware\n"
+                       "    threads. Requires \"sample_by\": \"pass\".\n";
+    size_type n = _get_setting<size_type>("driver", "parallel_sweep", help);
+    return resolve_threads(n);
+  }
+
+  /// \brief Number of threads to use to calculate correlations over all unit cells. Default 1.
+  ///
+  /// - If "driver"/"corr_threads" is 0, use the number of hardware threads
+  MonteSettings::size_type MonteSettings::corr_threads() const {
+    if(!_is_setting("driver", "corr_threads")) {
+      return 1;
+    }
+    std::string help = "int (default=1)\n"
+                       "  Number of threads to use to calculate correlations by summing over all\n"
+                       "    unit cells in the supercell. If 0, use the number of hardware threads.\n";
+    size_type n = _get_setting<size_type>("driver", "corr_threads", help);
+    return resolve_threads(n);
+  }
+
+  /// \brief If true, use the rejection-free (n-fold way) method. Default false.
+  bool MonteSettings::is_rejection_free() const {
+    if(!_is_setting("driver", "rejection_free")) {
+      return false;
+    }
+    std::string help = "bool (default=false)\n"
+                       "  If true, select only events that are accepted, with probability\n"
+                       "    proportional to their Metropolis acceptance probability, and skip the\n"
+                       "    steps that would have been rejected. Only used by \"grand_canonical\".\n";
+    return _get_setting<bool>("driver", "rejection_free", help);
+  }
+
+  /// \brief If true, cache single site energy changes. Default false.
+  bool MonteSettings::is_site_energy_cache() const {
+    if(!_is_setting("driver", "site_energy_cache")) {
+      return false;
+    }
+    std::string help = "bool (default=false)\n"
+                       "  If true, store the change in energy of each single site event, and only\n"
+                       "    recalculate it after an event changes a site in its neighborhood. Only\n"
+                       "    used by \"grand_canonical\".\n";
+    return _get_setting<bool>("driver", "site_energy_cache", help);
+  }
+
+  /// \brief Number of threads to use for the low temperature expansion. Default 1.
+  ///
+  /// - If "driver"/"lte"/"threads" is 0, use the number of hardware threads
+  MonteSettings::size_type MonteSettings::lte_threads() const {
+    if(!_is_setting("driver", "lte", "threads")) {
+      return 1;
+    }
+    std::string help = "int (default=1)\n"
+                       "  Number of threads to use to calculate excitation energies for the low\n"
+                       "    temperature expansion. If 0, use the number of hardware threads.\n";
+    size_type n = _get_setting<size_type>("driver", "lte", "threads", help);
+    return resolve_threads(n);
+  }
+
+  /// \brief Order of the low temperature expansion, 1 or 2. Default 1.
+  MonteSettings::size_type MonteSettings::lte_order() const {
+    if(!_is_setting("driver", "lte", "order")) {
+      return 1;
+    }
+    std::string help = "int (default=1)\n"
+                       "  If 1, include single site excitations in the low temperature expansion.\n"
+                       "    If 2, also include pairs of excitations on interacting sites.\n";
+    size_type order = _get_setting<size_type>("driver", "lte", "order", help);
+    if(order != 1 && order != 2) {
+      throw std::runtime_error(std::string("Error reading Monte Carlo settings: ") +
+                               "[\"driver\"][\"lte\"][\"order\"] must be 1 or 2\n" + help);
+    }
+    return order;
+  }
+
+  /// \brief Returns true if the free energy should be integrated along the path of conditions
+  bool MonteSettings::is_free_energy() const {
+    return _is_setting("driver", "free_energy");
+  }
+
+  /// \brief Reference for free energy integration: "lte", "high_temperature", or "value"
+  std::string MonteSettings::free_energy_anchor() const {
+    std::string help = "string (required)\n"
+                       "  Where the free energy is known, at the first conditions along the path:\n"
+                       "    \"lte\": low temperature expansion about the ground state\n"
+                       "    \"high_temperature\": first order high temperature expansion\n"
+                       "    \"value\": given by [\"driver\"][\"free_energy\"][\"value\"]\n";
+    std::string anchor = _get_setting<std::string>("driver", "free_energy", "anchor", help);
+    if(anchor != "lte" && anchor != "high_temperature" && anchor != "value") {
+      throw std::runtime_error(std::string("Error reading Monte Carlo settings: ") +
+                               "[\"driver\"][\"free_energy\"][\"anchor\"] must be one of \"lte\", " +
+                               "\"high_temperature\", or \"value\"\n" + help);
+    }
+    return anchor;
+  }
+
+  /// \brief Free energy, per unit cell, at the first conditions, if the anchor is "value"
+  double MonteSettings::free_energy_anchor_value() const {
+    std::string help = "number (required if \"anchor\" is \"value\")\n"
+                       "  Grand canonical free energy, per unit cell, at the first conditions.\n";
+    return _get_setting<double>("driver", "free_energy", "value", help);
+  }
+
+  /// \brief Returns true if a bias potential is given
+  bool MonteSettings::is_bias() const {
+    return contains("bias");
+  }
+
+  /// \brief Bias potential for umbrella sampling
+  ///
+  /// \param corr_size Number of correlations, for checking the order parameter
+  ///
+  /// - Returns an inactive BiasPotential if no "bias" is given
+  Monte::BiasPotential MonteSettings::bias_potential(Index corr_size) const {
+    if(!is_bias()) {
+      return Monte::BiasPotential();
+    }
+    std::string help = "object (optional)\n"
+                       "  Bias potential, u(q), per unit cell, added to the potential energy when\n"
+                       "    deciding whether to accept events. The order parameter, q, is a linear\n"
+                       "    combination of correlations:\n"
+                       "      \"order_parameter\": {\"corr\": {\"<index>\": <weight>, ...}}\n"
+                       "    and \"potential\" is one of:\n"
+                       "      {\"type\": \"harmonic\", \"center\": <number>, \"spring\": <number>}\n"
+                       "      {\"type\": \"linear\", \"slope\": <number>}\n"
+                       "      {\"type\": \"table\", \"order_parameter\": [...], \"value\": [...]}\n";
+    jsonParser json = _get_setting<jsonParser>("bias", help);
+    try {
+      return jsonConstructor<Monte::BiasPotential>::from_json(json, corr_size);
+    }
+    catch(std::runtime_error &e) {
+      Log &err_log = default_err_log();
+      err_log.error<Log::standard>("Monte Carlo setting [\"bias\"]");
+      err_log << e.what() << "\n";
+      err_log << "[\"bias\"]: " << help << std::endl;
+      throw;
+    }
+  }
+
   /// \brief Directory where output should go
   const fs::path MonteSettings::output_directory() const {
     return m_output_directory;
@@ -155,6 +459,69 @@ namespace CASM {
     return _get_setting<bool>(level1, level2, level3, help);
   }
 
+  /// \brief Returns true if snapshots should be written with MonteTrajectoryWriter
+  ///
+  /// - Requires write_trajectory
+  /// - Expects ["data"]["storage"]["trajectory_format"] == "binary", otherwise
+  ///   the trajectory is written as csv and/or json, as for observations
+  bool MonteSettings::write_binary_trajectory() const {
+    std::string level1 = "data";
+    std::string level2 = "storage";
+    std::string level3 = "trajectory_format";
+    std::string help = "(string, optional, default='output_format')\n"
+                       "  Accepts: 'binary' to write a compact binary trajectory\n"
+                       "           'output_format' to write trajectory files using 'output_format'\n";
+    if(!write_trajectory() || !_is_setting(level1, level2, level3)) {
+      return false;
+    }
+
+    std::string input = _get_setting<std::string>(level1, level2, level3, help);
+    if(input == "binary") {
+      return true;
+    }
+    if(input != "output_format") {
+      throw std::runtime_error(std::string("Error reading Monte Carlo settings: ") +
+                               "unexpected [\"data\"][\"storage\"][\"trajectory_format\"]: '" + input + "'\n" + help);
+    }
+    return false;
+  }
+
+  /// \brief Number of samples between keyframes of a binary trajectory. Default 100.
+  Index MonteSettings::trajectory_keyframe_period() const {
+    std::string level1 = "data";
+    std::string level2 = "storage";
+    std::string level3 = "trajectory_keyframe_period";
+    std::string help = "(int, optional, default=100)";
+    if(!_is_setting(level1, level2, level3)) {
+      return 100;
+    }
+
+    return _get_setting<Index>(level1, level2, level3, help);
+  }
+
+  /// \brief Number of passes between checkpoints. Default 0, no checkpoints.
+  ///
+  /// - If > 0, a checkpoint is written after the first sample taken at least
+  ///   'checkpoint_period' passes after the previous checkpoint, and a run that
+  ///   is restarted continues from the last checkpoint of the conditions it was
+  ///   calculating
+  MonteCounter::size_type MonteSettings::checkpoint_period() const {
+    std::string level1 = "data";
+    std::string level2 = "storage";
+    std::string level3 = "checkpoint_period";
+    std::string help = "(int, optional, default=0)";
+    if(!_is_setting(level1, level2, level3)) {
+      return 0;
+    }
+
+    auto period = _get_setting<MonteCounter::size_type>(level1, level2, level3, help);
+    if(period < 0) {
+      throw std::runtime_error(std::string("Error reading Monte Carlo settings: ") +
+                               "[\"data\"][\"storage\"][\"checkpoint_period\"] must be >= 0\n" + help);
+    }
+    return period;
+  }
+
   /// \brief Returns true if POSCARs of snapshots are requsted. Requires write_trajectory.
   bool MonteSettings::write_POSCAR_snapshots() const {
     std::string level1 = "data";
@@ -0,0 +1,301 @@
+#include "casm/monte_carlo/MonteTrajectory.hh"
+#include "casm/monte_carlo/MonteCheckpoint.hh"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace CASM {
+
+  namespace {
+
+    const char trajectory_magic[8] = {'C', 'A', 'S', 'M', 'T', 'R', 'J', '1'};
+
+    const std::uint8_t keyframe_record = 0;
+    const std::uint8_t delta_record = 1;
+
+    /// \brief Write unsigned integer 'value' as 'bytes' little-endian bytes
+    void write_uint(std::ostream &sout, std::uint64_t value, int bytes) {
+      char buf[8];
+      for(int i = 0; i < bytes; ++i) {
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+      }
+      sout.write(buf, bytes);
+    }
+
+    /// \brief Read an unsigned integer written as 'bytes' little-endian bytes
+    std::uint64_t read_uint(std::istream &sin, int bytes) {
+      unsigned char buf[8];
+      sin.read(reinterpret_cast<char *>(buf), bytes);
+      std::uint64_t value = 0;
+      for(int i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(buf[i]) << (8 * i);
+      }
+      return value;
+    }
+
+    /// \brief Append 'value' as an unsigned LEB128 varint
+    void push_varint(std::vector<char> &buf, std::uint64_t value) {
+      while(value >= 0x80) {
+        buf.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+      }
+      buf.push_back(static_cast<char>(value));
+    }
+
+    /// \brief Read an unsigned LEB128 varint from buf[pos], and advance pos
+    std::uint64_t get_varint(const std::vector<char> &buf, Index &pos) {
+      std::uint64_t value = 0;
+      int shift = 0;
+      while(true) {
+        if(pos >= buf.size()) {
+          throw std::runtime_error("Error reading trajectory: corrupt delta record");
+        }
+        std::uint8_t byte = static_cast<std::uint8_t>(buf[pos++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) {
+          return value;
+        }
+        shift += 7;
+      }
+    }
+
+  }
+
+  /// \brief Create (or overwrite) the trajectory file 'filepath'
+  ///
+  /// \param filepath Output file
+  /// \param n_sites Number of sites in the supercell
+  /// \param keyframe_period Number of samples between keyframes
+  ///
+  MonteTrajectoryWriter::MonteTrajectoryWriter(const fs::path &filepath, Index n_sites, Index keyframe_period) :
+    m_filepath(filepath),
+    m_file(filepath, std::ios::out | std::ios::binary | std::ios::trunc),
+    m_n_sites(n_sites),
+    m_keyframe_period(keyframe_period),
+    m_size(0),
+    m_prev(n_sites, 0) {
+
+    if(!m_file) {
+      throw std::runtime_error("Error in MonteTrajectoryWriter: could not open " + filepath.string());
+    }
+    if(m_keyframe_period < 1) {
+      throw std::runtime_error("Error in MonteTrajectoryWriter: keyframe period must be >= 1");
+    }
+
+    m_file.write(trajectory_magic, 8);
+    write_uint(m_file, m_n_sites, 8);
+    write_uint(m_file, m_keyframe_period, 4);
+    m_file.flush();
+  }
+
+  /// \brief Resume writing a trajectory file, from data written by write_checkpoint
+  ///
+  /// - Any records written after the checkpoint are discarded, so that the
+  ///   file is continued exactly as if the calculation had not stopped
+  MonteTrajectoryWriter::MonteTrajectoryWriter(std::istream &sin) {
+
+    std::string filepath;
+    std::streamoff file_size;
+    checkpoint::read(sin, filepath);
+    checkpoint::read(sin, m_n_sites);
+    checkpoint::read(sin, m_keyframe_period);
+    checkpoint::read(sin, m_size);
+    checkpoint::read(sin, file_size);
+    checkpoint::read(sin, m_prev);
+    m_filepath = filepath;
+
+    if(!fs::exists(m_filepath) || std::streamoff(fs::file_size(m_filepath)) < file_size) {
+      throw std::runtime_error("Error in MonteTrajectoryWriter: " + filepath + " is shorter than at the checkpoint");
+    }
+    fs::resize_file(m_filepath, file_size);
+
+    m_file.open(m_filepath, std::ios::out | std::ios::binary | std::ios::app);
+    if(!m_file) {
+      throw std::runtime_error("Error in MonteTrajectoryWriter: could not open " + filepath);
+    }
+  }
+
+  /// \brief Flush output, and write the data needed to resume writing
+  void MonteTrajectoryWriter::write_checkpoint(std::ostream &sout) {
+    m_file.flush();
+    checkpoint::write(sout, m_filepath.string());
+    checkpoint::write(sout, m_n_sites);
+    checkpoint::write(sout, m_keyframe_period);
+    checkpoint::write(sout, m_size);
+    checkpoint::write(sout, std::streamoff(m_file.tellp()));
+    checkpoint::write(sout, m_prev);
+  }
+
+  /// \brief Write the occupation of a sample taken at 'pass' and 'step'
+  ///
+  /// - Writes a keyframe every 'keyframe_period' samples, and otherwise only
+  ///   the sites that changed since the previous sample
+  void MonteTrajectoryWriter::write(size_type pass, size_type step, const Array<int> &occupation) {
+
+    if(occupation.size() != m_n_sites) {
+      throw std::runtime_error("Error in MonteTrajectoryWriter::write: occupation size does not match the trajectory");
+    }
+
+    bool keyframe = (m_size % m_keyframe_period == 0);
+    m_payload.clear();
+
+    if(keyframe) {
+      for(Index l = 0; l < m_n_sites; ++l) {
+        if(occupation[l] < 0 || occupation[l] > 255) {
+          throw std::runtime_error("Error in MonteTrajectoryWriter::write: occupant index out of range [0, 255]");
+        }
+        m_prev[l] = static_cast<std::uint8_t>(occupation[l]);
+      }
+      m_payload.insert(m_payload.end(), m_prev.begin(), m_prev.end());
+    }
+    else {
+      // count changes first, so the count can lead the record
+      Index n_changed = 0;
+      for(Index l = 0; l < m_n_sites; ++l) {
+        if(occupation[l] != m_prev[l]) {
+          ++n_changed;
+        }
+      }
+      push_varint(m_payload, n_changed);
+
+      Index prev_l = 0;
+      for(Index l = 0; l < m_n_sites; ++l) {
+        if(occupation[l] != m_prev[l]) {
+          if(occupation[l] < 0 || occupation[l] > 255) {
+            throw std::runtime_error("Error in MonteTrajectoryWriter::write: occupant index out of range [0, 255]");
+          }
+          push_varint(m_payload, l - prev_l);
+          m_prev[l] = static_cast<std::uint8_t>(occupation[l]);
+          m_payload.push_back(static_cast<char>(m_prev[l]));
+          prev_l = l;
+        }
+      }
+    }
+
+    write_uint(m_file, keyframe ? keyframe_record : delta_record, 1);
+    write_uint(m_file, pass, 8);
+    write_uint(m_file, step, 8);
+    write_uint(m_file, m_payload.size(), 4);
+    m_file.write(m_payload.data(), m_payload.size());
+    ++m_size;
+
+    if(keyframe) {
+      m_file.flush();
+    }
+    if(!m_file) {
+      throw std::runtime_error("Error in MonteTrajectoryWriter::write: could not write " + m_filepath.string());
+    }
+  }
+
+
+  /// \brief Open the trajectory file 'filepath'
+  MonteTrajectoryReader::MonteTrajectoryReader(const fs::path &filepath) :
+    m_filepath(filepath),
+    m_file(filepath, std::ios::in | std::ios::binary) {
+
+    if(!m_file) {
+      throw std::runtime_error("Error in MonteTrajectoryReader: could not open " + filepath.string());
+    }
+
+    char magic[8];
+    m_file.read(magic, 8);
+    if(!m_file || std::memcmp(magic, trajectory_magic, 8) != 0) {
+      throw std::runtime_error("Error in MonteTrajectoryReader: " + filepath.string() + " is not a trajectory file");
+    }
+    m_n_sites = read_uint(m_file, 8);
+    m_keyframe_period = read_uint(m_file, 4);
+
+    // scan record headers; a partial record at the end (from an interrupted run) is ignored
+    m_file.seekg(0, std::ios::end);
+    std::streamoff end = m_file.tellg();
+    std::streamoff pos = 20;
+    const std::streamoff header_size = 21;
+    while(pos + header_size <= end) {
+      m_file.seekg(pos);
+      read_uint(m_file, 1);
+      size_type pass = read_uint(m_file, 8);
+      size_type step = read_uint(m_file, 8);
+      std::streamoff payload_size = read_uint(m_file, 4);
+      if(!m_file || pos + header_size + payload_size > end) {
+        break;
+      }
+      m_offset.push_back(pos);
+      m_pass.push_back(pass);
+      m_step.push_back(step);
+      pos += header_size + payload_size;
+    }
+    m_file.clear();
+
+    m_sample = size();
+    m_occupation = Array<int>(m_n_sites, 0);
+  }
+
+  /// \brief Read sample 'i'
+  void MonteTrajectoryReader::seek(Index i) {
+
+    if(i >= size()) {
+      throw std::runtime_error("Error in MonteTrajectoryReader::seek: sample " + std::to_string(i) + " does not exist");
+    }
+
+    // continue from the current sample if that is no further than the keyframe
+    Index begin = (i / m_keyframe_period) * m_keyframe_period;
+    if(m_sample < size() && m_sample <= i && m_sample >= begin) {
+      begin = m_sample + 1;
+    }
+
+    for(Index j = begin; j <= i; ++j) {
+      m_file.seekg(m_offset[j]);
+      _read_record();
+      m_sample = j;
+    }
+  }
+
+  /// \brief Read the sample after the current sample, or the first sample if
+  ///        none has been read yet
+  ///
+  /// \returns false if there are no more samples
+  bool MonteTrajectoryReader::next() {
+    Index i = (m_sample == size()) ? 0 : m_sample + 1;
+    if(i >= size()) {
+      return false;
+    }
+    seek(i);
+    return true;
+  }
+
+  /// \brief Read the record at the current file position into m_occupation
+  void MonteTrajectoryReader::_read_record() {
+
+    std::uint8_t type = read_uint(m_file, 1);
+    read_uint(m_file, 8);
+    read_uint(m_file, 8);
+    Index payload_size = read_uint(m_file, 4);
+    m_payload.resize(payload_size);
+    m_file.read(m_payload.data(), payload_size);
+    if(!m_file) {
+      throw std::runtime_error("Error in MonteTrajectoryReader: could not read " + m_filepath.string());
+    }
+
+    if(type == keyframe_record) {
+      if(payload_size != m_n_sites) {
+        throw std::runtime_error("Error reading trajectory: corrupt keyframe record");
+      }
+      for(Index l = 0; l < m_n_sites; ++l) {
+        m_occupation[l] = static_cast<std::uint8_t>(m_payload[l]);
+      }
+    }
+    else {
+      Index pos = 0;
+      Index n_changed = get_varint(m_payload, pos);
+      Index l = 0;
+      for(Index c = 0; c < n_changed; ++c) {
+        l += get_varint(m_payload, pos);
+        if(l >= m_n_sites || pos >= payload_size) {
+          throw std::runtime_error("Error reading trajectory: corrupt delta record");
+        }
+        m_occupation[l] = static_cast<std::uint8_t>(m_payload[pos++]);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,271 @@
+#include "casm/monte_carlo/OccEventSpec.hh"
+#include <algorithm>
+#include <set>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "casm/casm_io/jsonParser.hh"
+#include "casm/casm_io/json_io/container.hh"
+#include "casm/monte_carlo/Conversions.hh"
+#include "casm/monte_carlo/OccCandidate.hh"
+#include "casm/monte_carlo/OccLocation.hh"
+
+namespace CASM {
+
+  namespace Monte {
+
+    /// \brief The event that undoes this event
+    OccEventSpec OccEventSpec::reverse() const {
+      OccEventSpec res(*this);
+      res.name = "reverse_" + name;
+      for(auto &f : res.flip) {
+        std::swap(f.from_species, f.to_species);
+      }
+      return res;
+    }
+
+    jsonParser &to_json(const OccEventSpec &spec, const Conversions &convert, jsonParser &json) {
+      json.put_obj();
+      json["name"] = spec.name;
+      json["sites"].put_array();
+      for(const auto &f : spec.flip) {
+        jsonParser tmp;
+        tmp["asym"] = f.asym;
+        tmp["from"] = convert.species_name(f.from_species);
+        tmp["to"] = convert.species_name(f.to_species);
+        json["sites"].push_back(tmp);
+      }
+      return json;
+    }
+  }
+
+  Monte::OccEventSpec jsonConstructor<Monte::OccEventSpec>::from_json(const jsonParser &json, const Monte::Conversions &convert) {
+
+    Monte::OccEventSpec spec;
+    if(json.contains("name")) {
+      spec.name = json["name"].get<std::string>();
+    }
+
+    auto species = [&](std::string name) {
+      Index res = convert.species_index(name);
+      if(res == convert.species_size()) {
+        throw std::runtime_error(
+          "Error reading OccEventSpec \"" + spec.name + "\": unknown species \"" + name + "\"");
+      }
+      return res;
+    };
+
+    for(const auto &site : json["sites"]) {
+
+      std::set<Index> sublats;
+      for(const auto &b : site["sublats"]) {
+        sublats.insert(b.get<Index>());
+      }
+
+      // sublattices -> asymmetric units, which must be complete
+      std::vector<Index> asym;
+      for(Index a = 0; a < convert.asym_size(); ++a) {
+        const auto &asym_b = convert.asym_to_b(a);
+        Index n_found = 0;
+        for(const auto &b : asym_b) {
+          n_found += sublats.count(b);
+        }
+        if(n_found == asym_b.size()) {
+          asym.push_back(a);
+        }
+        else if(n_found) {
+          throw std::runtime_error(
+            "Error reading OccEventSpec \"" + spec.name + "\": \"sublats\" must include all "
+            "symmetrically equivalent sublattices.");
+        }
+      }
+      if(!asym.size()) {
+        throw std::runtime_error(
+          "Error reading OccEventSpec \"" + spec.name + "\": \"sublats\" is empty or invalid.");
+      }
+
+      spec.flip.emplace_back(
+        asym,
+        species(site["from"].get<std::string>()),
+        species(site["to"].get<std::string>()));
+    }
+
+    return spec;
+  }
+
+  namespace Monte {
+
+    OccEventProposer::OccEventProposer(const Conversions &convert,
+                                       const OccCandidateList &cand,
+                                       const std::vector<OccEventSpec> &spec) :
+      m_convert(&convert),
+      m_cand(&cand),
+      m_dsize(cand.size(), 0) {
+
+      if(!spec.size()) {
+        throw std::runtime_error("Error constructing OccEventProposer: no events.");
+      }
+
+      for(const auto &s : spec) {
+        m_spec.push_back(s);
+        m_spec.push_back(s.reverse());
+      }
+
+      auto cand_index = [&](const OccEventSpec & s, Index asym, Index species_index) {
+        Index res = m_cand->index(asym, species_index);
+        if(res == m_cand->size()) {
+          throw std::runtime_error(
+            "Error constructing OccEventProposer: in event \"" + s.name + "\", species \"" +
+            m_convert->species_name(species_index) + "\" is not allowed on asymmetric unit " +
+            std::to_string(asym));
+        }
+        return res;
+      };
+
+      // must be identical or non-overlapping
+      auto compatible = [&](const std::vector<Index> &A, const std::vector<Index> &B) {
+        std::set<Index> a(A.begin(), A.end());
+        std::set<Index> b(B.begin(), B.end());
+        if(a == b) {
+          return true;
+        }
+        for(const auto &x : a) {
+          if(b.count(x)) {
+            return false;
+          }
+        }
+        return true;
+      };
+
+      for(const auto &s : m_spec) {
+
+        if(!s.flip.size()) {
+          throw std::runtime_error(
+            "Error constructing OccEventProposer: event \"" + s.name + "\" has no sites.");
+        }
+
+        std::vector<Flip> flip;
+        for(Index i = 0; i < s.flip.size(); ++i) {
+          const auto &f = s.flip[i];
+          if(f.from_species == f.to_species) {
+            throw std::runtime_error(
+              "Error constructing OccEventProposer: in event \"" + s.name + "\", \"from\" and "
+              "\"to\" species are the same.");
+          }
+
+          Flip tflip;
+          for(const auto &asym : f.asym) {
+            tflip.from_cand.push_back(cand_index(s, asym, f.from_species));
+            tflip.to_cand.push_back(cand_index(s, asym, f.to_species));
+          }
+          std::sort(tflip.from_cand.begin(), tflip.from_cand.end());
+          std::sort(tflip.to_cand.begin(), tflip.to_cand.end());
+
+          tflip.n_prev_to = 0;
+          for(Index j = 0; j < i; ++j) {
+            if(!compatible(tflip.from_cand, flip[j].from_cand) ||
+               !compatible(tflip.to_cand, flip[j].to_cand)) {
+              throw std::runtime_error(
+                "Error constructing OccEventProposer: in event \"" + s.name + "\", sites with the "
+                "same species must have the same or non-overlapping \"sublats\".");
+            }
+            if(tflip.from_cand == flip[j].from_cand) {
+              tflip.prev_from.push_back(j);
+            }
+            if(tflip.to_cand == flip[j].to_cand) {
+              ++tflip.n_prev_to;
+            }
+          }
+          flip.push_back(tflip);
+        }
+        m_flip.push_back(flip);
+      }
+    }
+
+    /// \brief Propose an event
+    ///
+    /// \returns P(reverse event) / P(event), or 0.0 if the randomly chosen
+    ///          type of event is not possible, in which case 'e' has no
+    ///          occ_transform
+    ///
+    /// - P(event) = (1/size()) * prod_i 1/(n_i - p_i), where n_i is the number of
+    ///   sites matching flip i, and p_i the number of those already chosen
+    double OccEventProposer::propose(OccEvent &e, const OccLocation &occ_loc, MTRand &mtrand) const {
+
+      e.occ_transform.clear();
+      e.species_traj.clear();
+
+      Index t = mtrand.randInt(m_spec.size() - 1);
+      const OccEventSpec &spec = m_spec[t];
+      const std::vector<Flip> &flip = m_flip[t];
+
+      double ratio = 1.0;
+      std::vector<Index> skip;
+      m_chosen.clear();
+      for(Index i = 0; i < flip.size(); ++i) {
+        const Flip &f = flip[i];
+
+        Index n = _count(f.from_cand, occ_loc);
+        if(n <= f.prev_from.size()) {
+          e.occ_transform.clear();
+          return 0.0;
+        }
+        Index avail = n - f.prev_from.size();
+        ratio *= avail;
+
+        // choose uniformly among the sites not already chosen
+        Index pos = mtrand.randInt(avail - 1);
+        skip.clear();
+        for(const auto &j : f.prev_from) {
+          skip.push_back(m_chosen[j]);
+        }
+        std::sort(skip.begin(), skip.end());
+        for(const auto &p : skip) {
+          if(pos >= p) {
+            ++pos;
+          }
+        }
+        m_chosen.push_back(pos);
+
+        for(const auto &c : f.from_cand) {
+          Index size = occ_loc.cand_size(c);
+          if(pos < size) {
+            Index mol_id = occ_loc.mol_id(c, pos);
+            const Mol &mol = occ_loc.mol(mol_id);
+            e.occ_transform.push_back({mol.l, mol_id, mol.asym, spec.flip[i].from_species, spec.flip[i].to_species});
+            break;
+          }
+          pos -= size;
+        }
+      }
+
+      // number of matching sites for the reverse event, after this event
+      for(const auto &occ : e.occ_transform) {
+        --m_dsize[m_cand->index(occ.asym, occ.from_species)];
+        ++m_dsize[m_cand->index(occ.asym, occ.to_species)];
+      }
+      for(Index i = 0; i < flip.size(); ++i) {
+        const Flip &f = flip[i];
+        long n = _count(f.to_cand, occ_loc);
+        for(const auto &c : f.to_cand) {
+          n += m_dsize[c];
+        }
+        ratio /= (n - f.n_prev_to);
+      }
+      for(const auto &occ : e.occ_transform) {
+        m_dsize[m_cand->index(occ.asym, occ.from_species)] = 0;
+        m_dsize[m_cand->index(occ.asym, occ.to_species)] = 0;
+      }
+
+      return ratio;
+    }
+
+    /// \brief Number of sites of any of the candidates
+    Index OccEventProposer::_count(const std::vector<Index> &cand, const OccLocation &occ_loc) const {
+      Index n = 0;
+      for(const auto &c : cand) {
+        n += occ_loc.cand_size(c);
+      }
+      return n;
+    }
+
+  }
+}
@@ -2,17 +2,27 @@
 #include "casm/monte_carlo/Conversions.hh"
 #include "casm/monte_carlo/OccCandidate.hh"
 #include "casm/clex/Configuration.hh"
+#include "casm/monte_carlo/MonteCheckpoint.hh"
 #include "casm/external/MersenneTwister/MersenneTwister.h"
 
 
 namespace CASM {
   namespace Monte {
 
-    OccLocation::OccLocation(const Conversions &_convert, const OccCandidateList &_cand) :
+    OccLocation::OccLocation(const Conversions &_convert, const OccCandidateList &_cand, bool _kmc) :
       m_convert(_convert),
       m_cand(_cand),
       m_loc(_cand.size()),
-      m_kmc(false) {}
+      m_kmc(_kmc),
+      m_canonical_swap_weight(_cand.canonical_swap().size()),
+      m_cand_to_canonical_swap(_cand.size()) {
+
+      const auto &canonical_swap = m_cand.canonical_swap();
+      for(Index i = 0; i < canonical_swap.size(); ++i) {
+        m_cand_to_canonical_swap[m_cand.index(canonical_swap[i].cand_a)].push_back(i);
+        m_cand_to_canonical_swap[m_cand.index(canonical_swap[i].cand_b)].push_back(i);
+      }
+    }
 
     /// Fill tables with occupation info
     void OccLocation::initialize(const Configuration &config) {
@@ -55,6 +65,8 @@ namespace CASM {
               spec.species_index = species_index;
               spec.id = m_species.size();
               spec.bijk_begin = m_convert.l_to_bijk(l);
+              spec.mol_comp_begin = j;
+              spec.displacement = Eigen::Vector3d::Zero();
               mol.component.push_back(spec.id);
 
               m_species.push_back(spec);
@@ -72,6 +84,10 @@ namespace CASM {
       if(m_kmc) {
         m_tmol = m_mol;
       }
+
+      for(Index cand_index = 0; cand_index < m_loc.size(); ++cand_index) {
+        _update_canonical_swap_weight(cand_index);
+      }
     }
 
     /// Total number of mutating sites
@@ -87,6 +103,19 @@ namespace CASM {
       return m_mol[mol_id];
     }
 
+    /// Total number of Species, if tracking Species locations
+    OccLocation::size_type OccLocation::species_size() const {
+      return m_species.size();
+    }
+
+    Species &OccLocation::species(Index species_id) {
+      return m_species[species_id];
+    }
+
+    const Species &OccLocation::species(Index species_id) const {
+      return m_species[species_id];
+    }
+
     /// Total number of mutating sites, of OccCandidate type, specified by index
     OccLocation::size_type OccLocation::cand_size(Index cand_index) const {
       return m_loc[cand_index].size();
@@ -113,11 +142,26 @@ namespace CASM {
     }
 
     /// Propose canonical OccEvent
+    ///
+    /// - Swap types are chosen with probability proportional to the number of
+    ///   possible swaps of that type, then the sites are chosen uniformly
+    /// - If 'canonical_swap' is m_cand.canonical_swap(), the swap type is chosen
+    ///   in O(log(canonical_swap.size())) using weights that are updated by apply,
+    ///   otherwise the weights are calculated for each proposal
+    /// - Throws if no swap is possible
     OccEvent &OccLocation::propose_canonical(
       OccEvent &e,
       const std::vector<OccSwap> &canonical_swap,
       MTRand &mtrand) const {
 
+      if(&canonical_swap == &m_cand.canonical_swap()) {
+        if(canonical_swap.empty() || m_canonical_swap_weight.sum() <= 0.) {
+          throw std::runtime_error("OccLocation::propose_canonical error");
+        }
+        Index i = m_canonical_swap_weight.find(mtrand.randExc(m_canonical_swap_weight.sum()));
+        return _propose(e, canonical_swap[i], mtrand);
+      }
+
       Index tsize = canonical_swap.size();
       m_tsum.resize(tsize + 1);
 
@@ -201,6 +245,81 @@ namespace CASM {
           m_mol[traj.to.mol_id].component[traj.to.mol_comp] = m_tmol[traj.from.mol_id].component[traj.from.mol_comp];
         }
       }
+
+      // update weights of swaps involving candidates with changed size
+      for(const auto &occ : e.occ_transform) {
+        _update_canonical_swap_weight(m_cand.index(occ.asym, occ.from_species));
+        _update_canonical_swap_weight(m_cand.index(occ.asym, occ.to_species));
+      }
+    }
+
+    /// Write the order of Mol and Species, for restarting a calculation
+    ///
+    /// - Proposals depend on the order of Mol in the candidate lists, which
+    ///   changes as events are applied, so restarting from a checkpoint
+    ///   requires this rather than 'initialize'
+    /// - Includes the Species on each Mol, and their initial position and
+    ///   displacement, if tracking Species locations
+    void OccLocation::write_checkpoint(std::ostream &sout) const {
+      checkpoint::write(sout, size());
+      checkpoint::write(sout, species_size());
+      for(const auto &loc : m_loc) {
+        checkpoint::write(sout, loc);
+      }
+      for(const auto &mol : m_mol) {
+        checkpoint::write(sout, mol.species_index);
+        checkpoint::write(sout, mol.component);
+      }
+      for(const auto &spec : m_species) {
+        checkpoint::write(sout, spec.species_index);
+        checkpoint::write(sout, spec.bijk_begin.sublat());
+        for(Index i = 0; i < 3; ++i) {
+          checkpoint::write(sout, spec.bijk_begin.unitcell()(i));
+        }
+        checkpoint::write(sout, spec.mol_comp_begin);
+        checkpoint::write(sout, Eigen::VectorXd(spec.displacement));
+      }
+    }
+
+    /// Restore data written by write_checkpoint
+    ///
+    /// - Call after 'initialize' with the checkpointed configuration
+    void OccLocation::read_checkpoint(std::istream &sin) {
+      checkpoint::check(sin, size(), "number of variable sites");
+      checkpoint::check(sin, species_size(), "number of species");
+      for(auto &loc : m_loc) {
+        checkpoint::read(sin, loc);
+      }
+      for(auto &mol : m_mol) {
+        checkpoint::check(sin, mol.species_index, "occupant at site " + std::to_string(mol.l));
+        checkpoint::read(sin, mol.component);
+      }
+      for(Index cand_index = 0; cand_index < m_loc.size(); ++cand_index) {
+        for(Index loc = 0; loc < m_loc[cand_index].size(); ++loc) {
+          Mol &mol = m_mol.at(m_loc[cand_index][loc]);
+          if(m_cand.index(mol.asym, mol.species_index) != cand_index) {
+            throw std::runtime_error("Error reading Monte Carlo checkpoint: occupant locations do not match");
+          }
+          mol.loc = loc;
+        }
+      }
+      Eigen::VectorXd displacement;
+      for(auto &spec : m_species) {
+        checkpoint::read(sin, spec.species_index);
+        checkpoint::read(sin, spec.bijk_begin.sublat());
+        for(Index i = 0; i < 3; ++i) {
+          checkpoint::read(sin, spec.bijk_begin.unitcell()(i));
+        }
+        checkpoint::read(sin, spec.mol_comp_begin);
+        checkpoint::read(sin, displacement);
+        spec.displacement = displacement;
+      }
+      if(m_kmc) {
+        m_tmol = m_mol;
+      }
+      for(Index cand_index = 0; cand_index < m_loc.size(); ++cand_index) {
+        _update_canonical_swap_weight(cand_index);
+      }
     }
 
     /// Canonical propose
@@ -227,6 +346,16 @@ namespace CASM {
       return e;
     }
 
+    /// Update m_canonical_swap_weight for swaps involving a candidate
+    void OccLocation::_update_canonical_swap_weight(Index cand_index) {
+      const auto &canonical_swap = m_cand.canonical_swap();
+      for(const auto &i : m_cand_to_canonical_swap[cand_index]) {
+        m_canonical_swap_weight.set(i,
+                                    ((double) cand_size(canonical_swap[i].cand_a)) *
+                                    ((double) cand_size(canonical_swap[i].cand_b)));
+      }
+    }
+
     /// Canonical propose
     OccEvent &OccLocation::_propose(OccEvent &e, const OccSwap &swap, MTRand &mtrand) const {
       Index cand_a = m_cand.index(swap.cand_a);
@@ -0,0 +1,73 @@
+#include "casm/monte_carlo/SiteEnergyCache.hh"
+#include <set>
+#include <stdexcept>
+#include "casm/clex/Supercell.hh"
+#include "casm/clex/PrimClex.hh"
+#include "casm/clex/NeighborList.hh"
+#include "casm/clex/Clexulator.hh"
+
+namespace CASM {
+
+  namespace Monte {
+
+    /// \brief Construct a SiteEnergyCache for all sites in a Supercell
+    ///
+    /// \param scel Supercell, with a SuperNeighborList that includes the
+    ///        neighborhood of 'clexulator'
+    /// \param clexulator Clexulator used to calculate the cached values
+    /// \param max_occ Maximum number of occupants of any site
+    ///
+    /// - The value for site 's' depends on site 'l' if 'l' is in the neighborhood
+    ///   of the unit cell of 's', so changing 'l', in unit cell 'uc', invalidates
+    ///   the values for all sites in unit cells 'uc - t', for each unit cell 't'
+    ///   in Clexulator::neighborhood()
+    /// - This is usually smaller than the SuperNeighborList neighborhood, which
+    ///   may be expanded for other Clexulator and includes all unit cells within
+    ///   its range
+    SiteEnergyCache::SiteEnergyCache(const Supercell &scel, const Clexulator &clexulator, Index max_occ) :
+      m_max_occ(max_occ),
+      m_volume(scel.volume()),
+      m_nlist(&scel.nlist()),
+      m_value(scel.num_sites() * max_occ, std::numeric_limits<double>::quiet_NaN()),
+      m_hits(0),
+      m_misses(0) {
+
+      const PrimNeighborList &prim_nlist = scel.get_primclex().nlist();
+      std::vector<UnitCell> prim_uc(prim_nlist.begin(), prim_nlist.end());
+
+      std::set<Index> affected;
+      auto add = [&](const UnitCell & t) {
+        UnitCell inv = -t;
+        Index i = std::find(prim_uc.begin(), prim_uc.end(), inv) - prim_uc.begin();
+        if(i == prim_uc.size()) {
+          throw std::runtime_error(
+            "Error constructing SiteEnergyCache: neighbor list does not include the Clexulator neighborhood");
+        }
+        affected.insert(i);
+      };
+
+      // the value for a site always depends on its own occupant
+      add(UnitCell(0, 0, 0));
+      for(const auto &uccoord : clexulator.neighborhood()) {
+        add(uccoord.unitcell());
+      }
+      m_affected.assign(affected.begin(), affected.end());
+    }
+
+    /// \brief Invalidate values that depend on the occupant of site 'l'
+    void SiteEnergyCache::invalidate(Index l) {
+
+      const auto &unitcells = m_nlist->unitcells(m_nlist->unitcell_index(l));
+      Index n_sublat = m_value.size() / (m_max_occ * m_volume);
+      double nan = std::numeric_limits<double>::quiet_NaN();
+
+      for(const auto &i : m_affected) {
+        for(Index b = 0; b < n_sublat; ++b) {
+          auto begin = m_value.begin() + (b * m_volume + unitcells[i]) * m_max_occ;
+          std::fill(begin, begin + m_max_occ, nan);
+        }
+      }
+    }
+
+  }
+}
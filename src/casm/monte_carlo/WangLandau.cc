@@ -0,0 +1,214 @@
+#include "casm/monte_carlo/WangLandau.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace CASM {
+  namespace Monte {
+
+    /// \brief Construct a window, covering bins [bin_begin, bin_end)
+    ///
+    /// \param origin Lower edge of bin 0
+    /// \param bin_width Width of each bin
+    /// \param bin_begin First bin in the window
+    /// \param bin_end One past the last bin in the window
+    /// \param params Parameters controlling the calculation
+    ///
+    WangLandau::WangLandau(double origin,
+                           double bin_width,
+                           Index bin_begin,
+                           Index bin_end,
+                           const WangLandauParams &params) :
+      m_origin(origin),
+      m_bin_width(bin_width),
+      m_bin_begin(bin_begin),
+      m_bin_end(bin_end),
+      m_params(params),
+      m_ln_f(params.ln_f_initial),
+      m_is_one_over_t(false),
+      m_iterations(0),
+      m_steps(0),
+      m_n_visited(0),
+      m_ln_g(bin_end - bin_begin, 0.0),
+      m_histogram(bin_end - bin_begin, 0),
+      m_visited(bin_end - bin_begin, false) {
+
+      if(!(bin_width > 0.0)) {
+        throw std::runtime_error("Error in WangLandau: bin width must be > 0");
+      }
+      if(bin_end <= bin_begin) {
+        throw std::runtime_error("Error in WangLandau: window must include at least one bin");
+      }
+      if(!(params.flatness > 0.0 && params.flatness < 1.0)) {
+        throw std::runtime_error("Error in WangLandau: flatness must be in (0, 1)");
+      }
+    }
+
+    /// \brief Bin containing 'energy', which may be outside the window
+    Index WangLandau::bin(double energy) const {
+      return static_cast<Index>(std::floor((energy - m_origin) / m_bin_width));
+    }
+
+    /// \brief Decide whether to accept a change from 'energy' to 'new_energy',
+    ///        given a random number in [0, 1)
+    ///
+    /// - If 'energy' is in the window, accept with probability min(1, g(E)/g(E')),
+    ///   or reject if 'new_energy' is outside the window
+    /// - If 'energy' is outside the window, accept if 'new_energy' is no further
+    ///   from the window, measured in bins
+    bool WangLandau::accept(double energy, double new_energy, double rand) const {
+
+      Index b = bin(energy);
+      Index new_b = bin(new_energy);
+
+      if(!contains(b)) {
+        auto distance = [&](Index _b) {
+          return (_b < m_bin_begin) ? m_bin_begin - _b : std::max<Index>(_b - (m_bin_end - 1), 0);
+        };
+        return distance(new_b) <= distance(b);
+      }
+
+      if(!contains(new_b)) {
+        return false;
+      }
+
+      double d = ln_g(b) - ln_g(new_b);
+      return d >= 0.0 || rand < std::exp(d);
+    }
+
+    /// \brief Update ln(g) and the histogram with the energy after a step
+    ///
+    /// - Does nothing if 'energy' is outside the window
+    /// - If using ln(f) = 1/t, ln(f) is updated after each step
+    void WangLandau::update(double energy) {
+
+      Index b = bin(energy);
+      if(!contains(b)) {
+        return;
+      }
+
+      Index i = b - m_bin_begin;
+      m_ln_g[i] += m_ln_f;
+      ++m_histogram[i];
+      if(!m_visited[i]) {
+        m_visited[i] = true;
+        ++m_n_visited;
+      }
+      ++m_steps;
+
+      if(m_is_one_over_t) {
+        m_ln_f = static_cast<double>(m_n_visited) / m_steps;
+      }
+    }
+
+    /// \brief If the histogram is flat, reduce ln(f), reset the histogram and return true
+    ///
+    /// - The histogram is flat if min(H) >= flatness * mean(H), over all bins
+    ///   that have ever been visited
+    /// - Once using ln(f) = 1/t, the histogram is no longer checked and this
+    ///   always returns false
+    bool WangLandau::check_flat() {
+
+      if(m_is_one_over_t || !m_n_visited) {
+        return false;
+      }
+
+      Index min_H = -1;
+      Index sum_H = 0;
+      for(Index i = 0; i < m_histogram.size(); ++i) {
+        if(m_visited[i]) {
+          if(min_H < 0 || m_histogram[i] < min_H) {
+            min_H = m_histogram[i];
+          }
+          sum_H += m_histogram[i];
+        }
+      }
+
+      double mean_H = static_cast<double>(sum_H) / m_n_visited;
+      if(!sum_H || min_H < m_params.flatness * mean_H) {
+        return false;
+      }
+
+      ++m_iterations;
+      std::fill(m_histogram.begin(), m_histogram.end(), 0);
+
+      double one_over_t = static_cast<double>(m_n_visited) / m_steps;
+      if(m_params.one_over_t && m_ln_f / 2.0 < one_over_t) {
+        m_is_one_over_t = true;
+        m_ln_f = one_over_t;
+      }
+      else {
+        m_ln_f /= 2.0;
+      }
+      return true;
+    }
+
+    /// \brief Combine ln(g) of overlapping windows, in order of increasing energy
+    ///
+    /// \returns map of bin -> ln(g), for all visited bins, shifted so that the
+    ///          minimum ln(g) is 0
+    ///
+    /// - Windows must share the same bin grid, and be given in order of
+    ///   increasing bin_begin
+    /// - Each window is shifted to match the combined ln(g) of the previous windows
+    ///   by the mean difference over the bins visited in both, and then used for
+    ///   bins from the middle of the overlap upward
+    ///
+    std::map<Index, double> stitch(const std::vector<WangLandau> &windows) {
+
+      std::map<Index, double> result;
+      if(!windows.size()) {
+        return result;
+      }
+
+      for(Index b = windows[0].bin_begin(); b < windows[0].bin_end(); ++b) {
+        if(windows[0].visited(b)) {
+          result[b] = windows[0].ln_g(b);
+        }
+      }
+
+      for(Index w = 1; w < windows.size(); ++w) {
+
+        const WangLandau &window = windows[w];
+        if(window.bin_begin() < windows[w - 1].bin_begin()) {
+          throw std::runtime_error("Error in stitch: windows must be in order of increasing energy");
+        }
+
+        std::vector<Index> overlap;
+        double shift = 0.0;
+        for(Index b = window.bin_begin(); b < window.bin_end(); ++b) {
+          auto it = result.find(b);
+          if(it != result.end() && window.visited(b)) {
+            overlap.push_back(b);
+            shift += it->second - window.ln_g(b);
+          }
+        }
+        if(!overlap.size()) {
+          throw std::runtime_error(
+            "Error in stitch: no visited bins in common between windows " +
+            std::to_string(w - 1) + " and " + std::to_string(w));
+        }
+        shift /= overlap.size();
+
+        Index join = overlap[overlap.size() / 2];
+        result.erase(result.lower_bound(join), result.end());
+        for(Index b = join; b < window.bin_end(); ++b) {
+          if(window.visited(b)) {
+            result[b] = window.ln_g(b) + shift;
+          }
+        }
+      }
+
+      double min_ln_g = result.begin()->second;
+      for(const auto &val : result) {
+        min_ln_g = std::min(min_ln_g, val.second);
+      }
+      for(auto &val : result) {
+        val.second -= min_ln_g;
+      }
+      return result;
+    }
+
+  }
+}
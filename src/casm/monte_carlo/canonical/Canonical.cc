@@ -1,11 +1,14 @@
 
 #include "casm/monte_carlo/canonical/Canonical.hh"
+#include <cmath>
+#include <limits>
 #include "casm/monte_carlo/MonteCarloEnum_impl.hh"
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/ConfigIterator.hh"
 #include "casm/clex/Norm.hh"
 #include "casm/monte_carlo/canonical/CanonicalIO.hh"
 #include "casm/monte_carlo/MonteIO_impl.hh"
+#include "casm/monte_carlo/MonteCheckpoint.hh"
 
 namespace CASM {
   namespace Monte {
@@ -21,7 +24,7 @@ namespace CASM {
       m_convert(_supercell()),
       m_cand(m_convert),
       m_all_correlations(settings.all_correlations()),
-      m_occ_loc(m_convert, m_cand),
+      m_occ_loc(m_convert, m_cand, settings.method() == METHOD::KMC),
       m_event(primclex.composition_axes().components().size(), _clexulator().corr_size()) {
 
       const auto &desc = m_formation_energy_clex.desc();
@@ -32,6 +35,7 @@ namespace CASM {
       // If the simulation is big enough, use delta cluster functions;
       // else, calculate all cluster functions
       m_use_deltas = !nlist().overlaps();
+      m_use_delta_energy = false;
 
       _log().construct("Canonical Monte Carlo");
       _log() << "project: " << this->primclex().get_path() << "\n";
@@ -59,6 +63,55 @@ namespace CASM {
 
       _log() << std::pair<const OccCandidateList &, const Conversions &>(m_cand, m_convert) << std::endl;
 
+      if(settings.is_parallel_sweep()) {
+
+        if(!m_use_deltas) {
+          throw std::runtime_error(
+            "Error in Canonical: \"parallel_sweep\" requires a supercell large enough to use delta correlations.");
+        }
+        if(!settings.sample_by_pass()) {
+          throw std::runtime_error(
+            "Error in Canonical: \"parallel_sweep\" requires \"sample_by\": \"pass\".");
+        }
+        if(debug()) {
+          throw std::runtime_error(
+            "Error in Canonical: \"parallel_sweep\" may not be used in debug mode.");
+        }
+
+        std::vector<Index> variable_sites;
+        for(Index l = 0; l < _configdof().size(); ++l) {
+          if(m_convert.occ_size(m_convert.l_to_asym(l)) > 1) {
+            variable_sites.push_back(l);
+          }
+        }
+
+        Index n_threads = settings.parallel_sweep();
+        m_checkerboard.reset(new Checkerboard(
+                               nlist(),
+                               supercell().volume(),
+                               variable_sites,
+                               n_threads,
+                               _mtrand()));
+        for(Index t = 0; t < n_threads; ++t) {
+          m_sweep_data.emplace_back(_clexulator(), m_event.dCorr().size(), m_event.dN().size());
+        }
+
+        _log().construct("Checkerboard parallel sweep");
+        _log() << "threads: " << n_threads << "\n";
+        _log() << "colors: " << m_checkerboard->n_colors() << "\n";
+        _log() << "groups: " << m_checkerboard->size() << "\n" << std::endl;
+      }
+
+      if(settings.method() == METHOD::KMC) {
+        _kmc_construct(settings);
+      }
+
+      if(settings.is_bias()) {
+        _bias_construct(settings);
+      }
+
+      _delta_energy_construct();
+
     }
 
     /// \brief Return number of steps per pass. Equals number of sites with variable occupation.
@@ -98,6 +151,18 @@ namespace CASM {
       _update_properties();
     }
 
+    /// \brief Set configdof without clearing previously collected data
+    ///
+    /// - Used by ReplicaExchangeDriver to swap states between replicas, where
+    ///   the samples already collected at the current conditions remain valid
+    /// - The composition is not enforced, so 'configdof' must already have the
+    ///   composition of the current conditions
+    void Canonical::exchange_configdof(const ConfigDoF &configdof) {
+      _configdof() = configdof;
+      m_occ_loc.initialize(_config());
+      _update_properties();
+    }
+
     /// \brief Set configdof and conditions and clear previously collected data
     ///
     /// \returns Specified ConfigDoF and configname (or configdof path)
@@ -185,7 +250,14 @@ namespace CASM {
     /// \brief Based on a random number, decide if the change in energy from the proposed event is low enough to be accepted.
     bool Canonical::check(const CanonicalEvent &event) {
 
-      if(event.dEpot() < 0.0) {
+      // the bias potential only changes which events are accepted
+      double dEpot = event.dEpot();
+      if(m_bias.is_active()) {
+        double dq = m_bias.delta_order_parameter(event.dCorr(), supercell().volume());
+        dEpot += m_bias.delta(*m_order_parameter, dq, supercell().volume());
+      }
+
+      if(dEpot < 0.0) {
 
         if(debug()) {
           _log().custom("Check event");
@@ -195,7 +267,7 @@ namespace CASM {
       }
 
       double rand = _mtrand().rand53();
-      double prob = exp(-event.dEpot() * m_condition.beta());
+      double prob = exp(-dEpot * m_condition.beta());
 
       if(debug()) {
         _log().custom("Check event");
@@ -225,9 +297,16 @@ namespace CASM {
       // Next update all properties that changed from the event
       _formation_energy() += event.dEf() / supercell().volume();
       _potential_energy() += event.dEpot() / supercell().volume();
-      _corr() += event.dCorr() / supercell().volume();
+      if(!m_use_delta_energy) {
+        _corr() += event.dCorr() / supercell().volume();
+      }
       _comp_n() += event.dN().cast<double>() / supercell().volume();
 
+      if(m_bias.is_active()) {
+        *m_order_parameter += m_bias.delta_order_parameter(event.dCorr(), supercell().volume());
+        *m_bias_energy = m_bias.value(*m_order_parameter);
+      }
+
       return;
     }
 
@@ -240,15 +319,204 @@ namespace CASM {
       return;
     }
 
+    /// \brief Perform up to 'max_steps' kinetic Monte Carlo steps at once
+    ///
+    /// \param max_steps Maximum number of steps to perform, >= 1
+    /// \param accepted Set to true if any hop was performed
+    ///
+    /// \returns Number of steps performed
+    ///
+    /// Each step is a fixed interval of kinetic Monte Carlo time (see
+    /// _kmc_initialize), so that samples taken at regular intervals of steps or
+    /// passes are on a uniform time grid and weight each state by its residence
+    /// time. The next hop, and the time it occurs, are selected in advance (see
+    /// _kmc_select). If the next hop occurs after 'max_steps' steps, those steps
+    /// are performed without changing the state. Otherwise, steps are performed
+    /// up to the first step ending at or after the hop, and all hops that occur
+    /// before the end of that step are performed.
+    ///
+    Index Canonical::rejection_free_step(Index max_steps, bool &accepted) {
+
+      double t = m_kmc_steps * m_kmc_step_time;
+      double n = std::ceil((m_kmc_next_time - t) / m_kmc_step_time);
+
+      Index steps = max_steps;
+      accepted = false;
+      if(n <= max_steps) {
+        steps = std::max(Index(1), Index(n));
+      }
+      m_kmc_steps += steps;
+      *m_kmc_time = m_kmc_steps * m_kmc_step_time;
+
+      while(m_kmc_next_time <= *m_kmc_time) {
+        _kmc_hop(m_kmc_next_hop);
+        _kmc_select();
+        accepted = true;
+      }
+      _kmc_update_diffusion();
+
+      return steps;
+    }
+
+    /// \brief Attempt to swap the occupants of pairs of variable sites, in parallel
+    ///
+    /// - Sites are visited in groups of non-interacting sites on a single
+    ///   sublattice (see Checkerboard). Each thread randomly pairs the sites it is
+    ///   assigned and proposes swapping the occupants of each pair, accepting by the
+    ///   Metropolis criterion, as by propose/check/accept.
+    /// - Only swaps between sites in the same group are proposed in the parallel
+    ///   phase, which conserves the composition of each group. Which pairs are
+    ///   proposed depends on the number of threads.
+    /// - Each thread uses its own Clexulator and MTRand. The OccLocation and
+    ///   properties are updated with the accepted swaps from each thread, in order,
+    ///   after the sweep.
+    /// - The sweep is followed by a serial phase of steps_per_pass() / n_threads
+    ///   swaps proposed by OccLocation, as by propose/check/accept, between any
+    ///   sites allowed by the canonical swaps. This exchanges occupants between
+    ///   groups, so the combined pass is ergodic. Each phase satisfies detailed
+    ///   balance, so the combination samples the canonical ensemble.
+    ///
+    void Canonical::parallel_sweep() {
+
+      for(auto &data : m_sweep_data) {
+        data.reset();
+      }
+
+      double beta = m_condition.beta();
+
+      m_checkerboard->sweep(_mtrand(), [&](Index t, const std::vector<Index> &sites) {
+
+        SweepData &data = m_sweep_data[t];
+        MTRand &mtrand = m_checkerboard->mtrand(t);
+
+        std::vector<Index> order(sites);
+        for(Index i = order.size(); i > 1; --i) {
+          std::swap(order[i - 1], order[mtrand.randInt(i - 1)]);
+        }
+
+        data.clexulator.set_config_occ(_configdof().occupation().begin());
+
+        for(Index i = 0; i + 1 < order.size(); i += 2) {
+
+          Index l_a = order[i];
+          Index l_b = order[i + 1];
+          int occ_a = _configdof().occ(l_a);
+          int occ_b = _configdof().occ(l_b);
+          if(occ_a == occ_b) {
+            continue;
+          }
+
+          _calc_delta_swap_corr(data.clexulator, l_a, occ_b, l_b, occ_a, data.dCorr_tmp);
+
+          double dEf = _eci() * data.dCorr_tmp.data();
+
+          if(dEf < 0.0 || mtrand.rand53() < exp(-dEf * beta)) {
+
+            _configdof().occ(l_a) = occ_b;
+            _configdof().occ(l_b) = occ_a;
+            data.dEf += dEf;
+            data.dEpot += dEf;
+            data.dCorr += data.dCorr_tmp;
+
+            Index asym = m_convert.l_to_asym(l_a);
+            Index species_a = m_convert.species_index(asym, occ_a);
+            Index species_b = m_convert.species_index(asym, occ_b);
+            OccEvent e;
+            e.occ_transform.push_back({l_a, m_occ_loc.l_to_mol_id(l_a), asym, species_a, species_b});
+            e.occ_transform.push_back({l_b, m_occ_loc.l_to_mol_id(l_b), asym, species_b, species_a});
+            data.accepted.push_back(e);
+          }
+        }
+      });
+
+      for(const auto &data : m_sweep_data) {
+        for(const auto &e : data.accepted) {
+          m_occ_loc.apply(e, _configdof());
+        }
+        _formation_energy() += data.dEf / supercell().volume();
+        _potential_energy() += data.dEpot / supercell().volume();
+        _corr() += data.dCorr / supercell().volume();
+      }
+
+      // serial phase, exchanging occupants between groups
+      if(m_cand.canonical_swap().empty()) {
+        return;
+      }
+      Index n_serial = std::max(Index(1), steps_per_pass() / m_checkerboard->n_threads());
+      for(Index i = 0; i < n_serial; ++i) {
+        const EventType &event = propose();
+        if(check(event)) {
+          accept(event);
+        }
+        else {
+          reject(event);
+        }
+      }
+    }
+
     /// \brief Write results to files
     void Canonical::write_results(Index cond_index) const {
       CASM::write_results(settings(), *this, _log());
+      write_conditions_results(cond_index);
+    }
+
+    /// \brief Write results for conditions 'cond_index', other than the results summary
+    void Canonical::write_conditions_results(Index cond_index) const {
       write_conditions_json(settings(), *this, cond_index, _log());
       write_observations(settings(), *this, cond_index, _log());
       write_trajectory(settings(), *this, cond_index, _log());
       //write_pos_trajectory(settings(), *this, cond_index);
     }
 
+    /// \brief Write MonteCarlo checkpoint data, and the state of the Canonical method
+    ///
+    /// - Includes the order of occupants in OccLocation, which determines
+    ///   proposals, and the MTRand of each thread for parallel sweeps
+    /// - For kinetic Monte Carlo, also includes the summed displacements, the
+    ///   hop rates, and the selected next hop and time, so that a resumed
+    ///   calculation continues exactly as if it had not stopped
+    void Canonical::write_checkpoint(std::ostream &sout) const {
+      MonteCarlo::write_checkpoint(sout);
+      m_occ_loc.write_checkpoint(sout);
+      if(m_checkerboard) {
+        m_checkerboard->write_checkpoint(sout);
+      }
+      if(!m_hops) {
+        return;
+      }
+      checkpoint::write(sout, m_kmc_Rsq);
+      checkpoint::write(sout, m_kmc_R);
+      checkpoint::write(sout, m_kmc_rate);
+      checkpoint::write(sout, m_kmc_step_time);
+      checkpoint::write(sout, m_kmc_steps);
+      checkpoint::write(sout, m_kmc_next_hop);
+      checkpoint::write(sout, m_kmc_next_time);
+    }
+
+    /// \brief Restore data written by write_checkpoint
+    ///
+    /// - Call after 'set_state' with the checkpointed ConfigDoF
+    void Canonical::read_checkpoint(std::istream &sin) {
+      MonteCarlo::read_checkpoint(sin);
+      m_occ_loc.read_checkpoint(sin);
+      if(m_checkerboard) {
+        m_checkerboard->read_checkpoint(sin);
+      }
+      if(!m_hops) {
+        return;
+      }
+      checkpoint::read(sin, m_kmc_Rsq);
+      checkpoint::read(sin, m_kmc_R);
+      checkpoint::read(sin, m_kmc_rate);
+      if(m_kmc_rate.size() != m_hops->size()) {
+        throw std::runtime_error("Error reading Monte Carlo checkpoint: number of hops does not match");
+      }
+      checkpoint::read(sin, m_kmc_step_time);
+      checkpoint::read(sin, m_kmc_steps);
+      checkpoint::read(sin, m_kmc_next_hop);
+      checkpoint::read(sin, m_kmc_next_time);
+    }
+
     /// \brief Get potential energy
     ///
     /// - if(&config == &this->config()) { return potential_energy(); }, else
@@ -256,73 +524,38 @@ namespace CASM {
     double Canonical::potential_energy(const Configuration &config) const {
       //if(&config == &this->config()) { return potential_energy(); }
 
-      auto corr = correlations(config, _clexulator());
+      auto corr = correlations(config, _clexulator(), corr_threads());
       return _eci() * corr.data();
     }
 
-    void Canonical::_set_nlist(Index l) const {
-      _clexulator().set_nlist(nlist().sites(nlist().unitcell_index(l)).data());
-    };
-
-    void Canonical::_calc_delta_point_corr(Index l, int new_occ, Eigen::VectorXd &dCorr_comp) const {
-
-      int sublat = _config().get_b(l);
-      int curr_occ = _configdof().occ(l);
-      _set_nlist(l);
+    /// \brief Site 'l' of a swap, changing to occupant 'new_occ'
+    ClexSwapSite Canonical::_swap_site(Index l, int new_occ) const {
+      const std::vector<Index> &sites = nlist().sites(nlist().unitcell_index(l));
+      return ClexSwapSite {l, _config().get_b(l), _configdof().occ(l), new_occ, sites.data(), sites.data() + sites.size()};
+    }
 
-      // Calculate the change in correlations due to this event
-      if(m_use_deltas) {
-        if(m_all_correlations) {
-          _clexulator().calc_delta_point_corr(sublat,
-                                              curr_occ,
-                                              new_occ,
-                                              dCorr_comp.data());
-        }
-        else {
-          auto begin = _eci().index().data();
-          auto end = begin + _eci().index().size();
-          _clexulator().calc_restricted_delta_point_corr(sublat,
-                                                         curr_occ,
-                                                         new_occ,
-                                                         dCorr_comp.data(),
-                                                         begin,
-                                                         end);
-        }
+    /// \brief Calculate the change in correlations due to swapping the occupants of sites 'l_a' and 'l_b'
+    ///
+    /// - The occupation is not modified, so this may be used concurrently with
+    ///   a Clexulator per thread
+    void Canonical::_calc_delta_swap_corr(Clexulator &clexulator,
+                                          Index l_a,
+                                          int new_occ_a,
+                                          Index l_b,
+                                          int new_occ_b,
+                                          Eigen::VectorXd &dCorr) const {
+
+      ClexSwapSite a = _swap_site(l_a, new_occ_a);
+      ClexSwapSite b = _swap_site(l_b, new_occ_b);
+      const int *occ_ptr = _configdof().occupation().begin();
+
+      if(m_all_correlations) {
+        clexulator.calc_delta_swap_corr(occ_ptr, a, b, m_use_deltas, dCorr.data());
       }
       else {
-        Eigen::VectorXd before { Eigen::VectorXd::Zero(dCorr_comp.size()) };
-        Eigen::VectorXd after { Eigen::VectorXd::Zero(dCorr_comp.size()) };
-
-        // Calculate the change in points correlations due to this event
-        if(m_all_correlations) {
-
-          // Calculate before
-          _clexulator().calc_point_corr(sublat, before.data());
-
-          // Apply change
-          _configdof().occ(l) = new_occ;
-
-          // Calculate after
-          _clexulator().calc_point_corr(sublat, after.data());
-        }
-        else {
-          auto begin = _eci().index().data();
-          auto end = begin + _eci().index().size();
-
-          // Calculate before
-          _clexulator().calc_restricted_point_corr(sublat, before.data(), begin, end);
-
-          // Apply change
-          _configdof().occ(l) = new_occ;
-
-          // Calculate after
-          _clexulator().calc_restricted_point_corr(sublat, after.data(), begin, end);
-
-        }
-        dCorr_comp = after - before;
-
-        // Unapply changes
-        _configdof().occ(l) = curr_occ;
+        auto begin = _eci().index().data();
+        auto end = begin + _eci().index().size();
+        clexulator.calc_restricted_delta_swap_corr(occ_ptr, a, b, m_use_deltas, dCorr.data(), begin, end);
       }
     }
 
@@ -333,34 +566,32 @@ namespace CASM {
       const OccTransform &f_a = e.occ_transform[0];
       const OccTransform &f_b = e.occ_transform[1];
 
-      int curr_occ_a = _configdof().occ(f_a.l);
-      Index new_occ_a = m_convert.occ_index(f_a.asym, f_a.to_species);
-      Index new_occ_b = m_convert.occ_index(f_b.asym, f_b.to_species);
-
-      Eigen::VectorXd dCorr_comp { Eigen::VectorXd::Zero(event.dCorr().size()) };
-
-
-      // Point the Clexulator to the right neighborhood and right ConfigDoF
-      _clexulator().set_config_occ(_configdof().occupation().begin());
-
-      // calc dCorr for first site
-      _calc_delta_point_corr(f_a.l, new_occ_a, event.dCorr());
-
-      // change occ on first site
-      _configdof().occ(f_a.l) = new_occ_a;
-
-      // calc dCorr for second site
-      _calc_delta_point_corr(f_b.l, new_occ_b, dCorr_comp);
-      event.dCorr() += dCorr_comp;
-
-      // unchange occ on first site
-      _configdof().occ(f_a.l) = curr_occ_a;
+      _calc_delta_swap_corr(_clexulator(),
+                            f_a.l,
+                            m_convert.occ_index(f_a.asym, f_a.to_species),
+                            f_b.l,
+                            m_convert.occ_index(f_b.asym, f_b.to_species),
+                            event.dCorr());
 
       if(debug()) {
         _print_correlations(event.dCorr(), "delta correlations", "dCorr", m_all_correlations);
       }
     }
 
+    /// \brief Calculate the change in formation energy for an event, without delta correlations
+    double Canonical::_calc_delta_energy(const CanonicalEvent &event) const {
+
+      const OccEvent &e = event.occ_event();
+      const OccTransform &f_a = e.occ_transform[0];
+      const OccTransform &f_b = e.occ_transform[1];
+
+      return _clexulator().calc_delta_swap_energy(
+               _configdof().occupation().begin(),
+               _swap_site(f_a.l, m_convert.occ_index(f_a.asym, f_a.to_species)),
+               _swap_site(f_b.l, m_convert.occ_index(f_b.asym, f_b.to_species)),
+               m_dense_eci.data());
+    }
+
     /// \brief Print correlations to _log()
     void Canonical::_print_correlations(
       const Eigen::VectorXd &corr,
@@ -403,6 +634,11 @@ namespace CASM {
     /// \brief Update delta properties in 'event'
     void Canonical::_update_deltas(CanonicalEvent &event) const {
 
+      if(m_use_delta_energy) {
+        event.set_dEf(_calc_delta_energy(event));
+        return;
+      }
+
       // ---- set dcorr --------------
       _set_dCorr(event);
 
@@ -414,7 +650,7 @@ namespace CASM {
     void Canonical::_update_properties() {
 
       // initialize properties and store pointers to the data strucures
-      _vector_properties()["corr"] = correlations_vec(_configdof(), supercell(), _clexulator());
+      _vector_properties()["corr"] = correlations_vec(_configdof(), supercell(), _clexulator(), corr_threads());
       m_corr = &_vector_property("corr");
 
       _vector_properties()["comp_n"] = CASM::comp_n(_configdof(), supercell());
@@ -426,6 +662,27 @@ namespace CASM {
       _scalar_properties()["potential_energy"] = formation_energy();
       m_potential_energy = &_scalar_property("potential_energy");
 
+      if(m_bias.is_active()) {
+        _scalar_properties()["order_parameter"] = m_bias.order_parameter(corr());
+        m_order_parameter = &_scalar_property("order_parameter");
+
+        _scalar_properties()["bias_energy"] = m_bias.value(*m_order_parameter);
+        m_bias_energy = &_scalar_property("bias_energy");
+      }
+
+      if(m_hops) {
+        _scalar_properties()["kmc_time"] = 0.0;
+        m_kmc_time = &_scalar_property("kmc_time");
+
+        _vector_properties()["D_tracer"] = Eigen::VectorXd::Zero(m_convert.species_size());
+        m_D_tracer = &_vector_property("D_tracer");
+
+        _vector_properties()["D_collective"] = Eigen::VectorXd::Zero(m_convert.species_size());
+        m_D_collective = &_vector_property("D_collective");
+
+        _kmc_initialize();
+      }
+
       if(debug()) {
 
         _print_correlations(corr(), "correlations", "corr", m_all_correlations);
@@ -452,6 +709,293 @@ namespace CASM {
 
     }
 
+    /// \brief Check that the bias potential can be used with the requested method
+    ///
+    /// - The bias potential is only applied in 'check', so it requires the
+    ///   Metropolis method without parallel sweeps
+    /// - If not calculating all correlations, the order parameter may only include
+    ///   correlations with non-zero ECI, because only those are updated by events
+    void Canonical::_bias_construct(const CanonicalSettings &settings) {
+
+      m_bias = settings.bias_potential(_clexulator().corr_size());
+
+      if(settings.method() != METHOD::Metropolis) {
+        throw std::runtime_error(
+          "Error in Canonical: \"bias\" requires the Metropolis method.");
+      }
+      if(m_checkerboard) {
+        throw std::runtime_error(
+          "Error in Canonical: \"bias\" may not be used with \"parallel_sweep\".");
+      }
+      if(!m_all_correlations) {
+        for(const auto &w : m_bias.weights()) {
+          if(find_index(_eci().index(), w.first) == _eci().index().size()) {
+            throw std::runtime_error(
+              "Error in Canonical: \"bias\" order parameter includes correlation " +
+              std::to_string(w.first) + ", which has zero ECI, so \"all_correlations\" must be sampled.");
+          }
+        }
+      }
+
+      _log().construct("Bias potential");
+      _log() << "order parameter: ";
+      for(const auto &w : m_bias.weights()) {
+        _log() << " " << w.second << "*corr(" << w.first << ")";
+      }
+      _log() << "\n" << std::endl;
+    }
+
+    /// \brief Decide whether to calculate changes in energy without delta correlations
+    ///
+    /// - The change in formation energy is calculated with
+    ///   Clexulator::calc_delta_point_energy if delta correlations are not needed:
+    ///   correlations are not sampled, only correlations with non-zero ECI are
+    ///   calculated, no bias potential is used, and not in debug mode
+    /// - Then the "corr" property is not updated by events
+    void Canonical::_delta_energy_construct() {
+
+      m_use_delta_energy = m_use_deltas &&
+                           !m_all_correlations &&
+                           !m_bias.is_active() &&
+                           !debug() &&
+                           _clexulator().has_delta_point_energy();
+
+      for(auto it = samplers().cbegin(); it != samplers().cend(); ++it) {
+        if(it->first.compare(0, 5, "corr(") == 0) {
+          m_use_delta_energy = false;
+        }
+      }
+
+      if(m_use_delta_energy) {
+        m_dense_eci = Eigen::VectorXd::Zero(_clexulator().corr_size());
+        for(Index i = 0; i < _eci().index().size(); ++i) {
+          m_dense_eci(_eci().index()[i]) = _eci().value()[i];
+        }
+      }
+
+      _log() << "use_delta_energy: " << std::boolalpha << m_use_delta_energy << "\n" << std::endl;
+    }
+
+    /// \brief Construct data structures for kinetic Monte Carlo
+    ///
+    /// - Hops are vacancy exchanges between sites within "kmc"/"hop_cutoff"
+    /// - The activation barrier of a hop is Ea = max(E_kra + dEf/2, dEf, 0),
+    ///   where E_kra is given for the hopping species by "kmc"/"kra" and dEf is
+    ///   the change in formation energy, which satisfies detailed balance
+    ///
+    void Canonical::_kmc_construct(const CanonicalSettings &settings) {
+
+      if(!m_use_deltas) {
+        throw std::runtime_error(
+          "Error in Canonical: kinetic Monte Carlo requires a supercell large enough to use delta correlations.");
+      }
+      if(m_checkerboard) {
+        throw std::runtime_error(
+          "Error in Canonical: kinetic Monte Carlo may not be used with \"parallel_sweep\".");
+      }
+      if(debug()) {
+        throw std::runtime_error(
+          "Error in Canonical: kinetic Monte Carlo may not be used in debug mode.");
+      }
+
+      m_kmc_nu = settings.kmc_attempt_frequency();
+
+      m_kmc_kra.assign(m_convert.species_size(), std::numeric_limits<double>::quiet_NaN());
+      m_kmc_vacancy.resize(m_convert.species_size());
+      for(Index s = 0; s < m_convert.species_size(); ++s) {
+        if(m_convert.components_size(s) != 1) {
+          throw std::runtime_error(
+            "Error in Canonical: kinetic Monte Carlo does not yet support molecular species");
+        }
+        m_kmc_vacancy[s] = m_convert.species_to_mol(s).is_vacancy();
+      }
+      for(const auto &val : settings.kmc_kra()) {
+        m_kmc_kra[m_convert.species_index(val.first)] = val.second;
+      }
+
+      m_hops.reset(new HopList(supercell(), m_convert, settings.kmc_hop_cutoff()));
+      m_kmc_rate.resize(m_hops->size());
+      m_kmc_stamp.assign(m_hops->size(), 0);
+      m_kmc_curr_stamp = 0;
+
+      Index volume = supercell().volume();
+      m_kmc_affected_uc.assign(volume, std::vector<Index>());
+      for(Index uc = 0; uc < volume; ++uc) {
+        for(const auto &nuc : nlist().unitcells(uc)) {
+          m_kmc_affected_uc[nuc].push_back(uc);
+        }
+      }
+
+      _log().construct("Kinetic Monte Carlo");
+      _log() << "hop_cutoff: " << m_hops->cutoff() << "\n";
+      _log() << "attempt_frequency: " << m_kmc_nu << "\n";
+      _log() << "hops: " << m_hops->size() << "\n";
+      _log() << "kra: \n";
+      for(const auto &val : settings.kmc_kra()) {
+        _log() << "  " << val.first << ": " << val.second << "\n";
+      }
+      _log() << std::endl;
+    }
+
+    /// \brief Reset the kinetic Monte Carlo time and displacements, and calculate all hop rates
+    ///
+    /// - The time interval of one step is set to the mean residence time of the
+    ///   current state, 1/(total rate), so that a pass takes about as long as
+    ///   steps_per_pass() hops
+    void Canonical::_kmc_initialize() {
+
+      m_occ_loc.initialize(_config());
+
+      Index N_species = m_convert.species_size();
+      m_kmc_N = Eigen::VectorXd::Zero(N_species);
+      for(Index i = 0; i < m_occ_loc.species_size(); ++i) {
+        m_kmc_N(m_occ_loc.species(i).species_index) += 1.0;
+      }
+      m_kmc_Rsq = Eigen::VectorXd::Zero(N_species);
+      m_kmc_R = Eigen::MatrixXd::Zero(3, N_species);
+
+      for(Index h = 0; h < m_hops->size(); ++h) {
+        _kmc_update_rate(h);
+      }
+
+      double total_rate = m_kmc_rate.sum();
+      if(!(total_rate > 0.0)) {
+        throw std::runtime_error("Error in Canonical kinetic Monte Carlo: no hops are possible");
+      }
+      m_kmc_step_time = 1.0 / total_rate;
+      m_kmc_steps = 0;
+      m_kmc_next_time = 0.0;
+      _kmc_select();
+    }
+
+    /// \brief Select the next hop, with probability proportional to its rate, and
+    ///        the time it occurs
+    ///
+    /// - The hop occurs after a residence time, -ln(u)/(total rate), following
+    ///   the previous hop
+    void Canonical::_kmc_select() {
+
+      double total_rate = m_kmc_rate.sum();
+      if(!(total_rate > 0.0)) {
+        throw std::runtime_error("Error in Canonical kinetic Monte Carlo: no hops are possible");
+      }
+
+      m_kmc_next_hop = m_kmc_rate.find(_mtrand().rand53() * total_rate);
+      m_kmc_next_time -= std::log(1.0 - _mtrand().rand53()) / total_rate;
+    }
+
+    /// \brief Perform a hop, update displacements, and update the rates of
+    ///        affected hops
+    ///
+    /// - The displacement of the hopping species and vacancy are accumulated, and
+    ///   the rates of hops with an energy that depends on the changed sites are
+    ///   recalculated
+    void Canonical::_kmc_hop(Index hop_index) {
+
+      _kmc_set_event(hop_index);
+      accept(m_event);
+
+      // update displacements, using the Species now on each site of the hop
+      const Hop &hop = (*m_hops)[hop_index];
+      for(const auto &traj : m_event.occ_event().species_traj) {
+        Species &spec = m_occ_loc.species(m_occ_loc.mol(traj.to.mol_id).component[traj.to.mol_comp]);
+        Eigen::Vector3d dr = (traj.to.l == hop.l_b) ? hop.dr : Eigen::Vector3d(-hop.dr);
+        Index s = spec.species_index;
+        m_kmc_Rsq(s) += (spec.displacement + dr).squaredNorm() - spec.displacement.squaredNorm();
+        m_kmc_R.col(s) += dr;
+        spec.displacement += dr;
+      }
+
+      // update rates of hops with an endpoint in a unit cell with a neighborhood
+      // that includes a changed site
+      ++m_kmc_curr_stamp;
+      Index volume = supercell().volume();
+      Index basis_size = supercell().basis_size();
+      for(Index l : {
+            hop.l_a, hop.l_b
+          }) {
+        for(const auto &uc : m_kmc_affected_uc[nlist().unitcell_index(l)]) {
+          for(Index b = 0; b < basis_size; ++b) {
+            for(const auto &h : m_hops->site_hops(b * volume + uc)) {
+              if(m_kmc_stamp[h] != m_kmc_curr_stamp) {
+                m_kmc_stamp[h] = m_kmc_curr_stamp;
+                _kmc_update_rate(h);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    /// \brief Set m_event for a hop, returns false if the hop is not possible
+    ///
+    /// - A hop is possible if it exchanges a vacancy and a species with a
+    ///   kinetically resolved activation barrier, and each is allowed on the
+    ///   other site
+    bool Canonical::_kmc_set_event(Index hop_index) {
+
+      const Hop &hop = (*m_hops)[hop_index];
+      Index mol_a = m_occ_loc.l_to_mol_id(hop.l_a);
+      Index mol_b = m_occ_loc.l_to_mol_id(hop.l_b);
+      const Mol &A = m_occ_loc.mol(mol_a);
+      const Mol &B = m_occ_loc.mol(mol_b);
+
+      if(m_kmc_vacancy[A.species_index] == m_kmc_vacancy[B.species_index]) {
+        return false;
+      }
+      Index hop_species = m_kmc_vacancy[A.species_index] ? B.species_index : A.species_index;
+      if(std::isnan(m_kmc_kra[hop_species]) ||
+         !m_convert.species_allowed(A.asym, B.species_index) ||
+         !m_convert.species_allowed(B.asym, A.species_index)) {
+        return false;
+      }
+
+      OccEvent &e = m_event.occ_event();
+      e.occ_transform.resize(2);
+      e.occ_transform[0] = {hop.l_a, mol_a, A.asym, A.species_index, B.species_index};
+      e.occ_transform[1] = {hop.l_b, mol_b, B.asym, B.species_index, A.species_index};
+
+      e.species_traj.resize(2);
+      e.species_traj[0] = {{hop.l_a, mol_a, 0}, {hop.l_b, mol_b, 0}};
+      e.species_traj[1] = {{hop.l_b, mol_b, 0}, {hop.l_a, mol_a, 0}};
+
+      _update_deltas(m_event);
+      return true;
+    }
+
+    /// \brief Calculate the rate of a hop
+    void Canonical::_kmc_update_rate(Index hop_index) {
+
+      if(!_kmc_set_event(hop_index)) {
+        m_kmc_rate.set(hop_index, 0.0);
+        return;
+      }
+
+      const OccTransform &f = m_event.occ_event().occ_transform[0];
+      Index hop_species = m_kmc_vacancy[f.from_species] ? f.to_species : f.from_species;
+      double dEf = m_event.dEf();
+      double Ea = std::max(m_kmc_kra[hop_species] + dEf / 2.0, std::max(dEf, 0.0));
+      m_kmc_rate.set(hop_index, m_kmc_nu * exp(-Ea * m_condition.beta()));
+    }
+
+    /// \brief Update the diffusion coefficient properties
+    ///
+    /// - D_tracer = sum_i |R_i|^2 / (6 * N * t)
+    /// - D_collective = |sum_i R_i|^2 / (6 * N * t)
+    ///
+    /// where the sums are over all N of a species, R_i is displacement since the
+    /// state was set, and t is the kinetic Monte Carlo time
+    void Canonical::_kmc_update_diffusion() {
+      for(Index s = 0; s < m_kmc_N.size(); ++s) {
+        if(m_kmc_N(s) == 0.0 || *m_kmc_time <= 0.0) {
+          continue;
+        }
+        double norm = 6.0 * m_kmc_N(s) * (*m_kmc_time);
+        (*m_D_tracer)(s) = m_kmc_Rsq(s) / norm;
+        (*m_D_collective)(s) = m_kmc_R.col(s).squaredNorm() / norm;
+      }
+    }
+
     /// \brief Generate supercell filling ConfigDoF from default configuration
     ConfigDoF Canonical::_default_motif() const {
       _log().set("DoF");
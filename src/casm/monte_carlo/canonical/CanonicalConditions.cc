@@ -115,6 +115,18 @@ namespace CASM {
       return CanonicalConditions(*this) -= RHS;
     }
 
+    ///Multiply temperature and all compositions of *this by a factor
+    CanonicalConditions &CanonicalConditions::operator*=(double factor) {
+      m_temperature *= factor;
+      m_param_composition *= factor;
+      m_beta = 1.0 / (CASM::KB * m_temperature);
+      return *this;
+    }
+
+    CanonicalConditions CanonicalConditions::operator*(double factor) const {
+      return CanonicalConditions(*this) *= factor;
+    }
+
     bool CanonicalConditions::operator==(const CanonicalConditions &RHS) const {
       if(!almost_zero(m_temperature - RHS.m_temperature, m_tolerance)) {
         return false;
@@ -84,6 +84,15 @@ namespace CASM {
       // include heat_capacity
       formatter.push_back(MonteCarloHeatCapacityFormatter<Canonical>());
 
+      // include unbiased means, if using a bias potential
+      if(mc.bias().is_active()) {
+        for(auto it = mc.samplers().cbegin(); it != mc.samplers().cend(); ++it) {
+          if(it->first != "bias_energy") {
+            formatter.push_back(MonteCarloUnbiasedMeanFormatter<Canonical>(it->first));
+          }
+        }
+      }
+
       return formatter;
     }
 
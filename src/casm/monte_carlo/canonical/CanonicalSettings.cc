@@ -39,7 +39,7 @@ namespace CASM {
 
     /// \brief Expects initial_conditions
     CanonicalConditions CanonicalSettings::initial_conditions() const {
-      if(drive_mode() == Monte::DRIVE_MODE::INCREMENTAL) {
+      if(drive_mode() == Monte::DRIVE_MODE::INCREMENTAL || drive_mode() == Monte::DRIVE_MODE::ADAPTIVE) {
         return _conditions("initial_conditions");
       }
       else if(drive_mode() == Monte::DRIVE_MODE::CUSTOM) {
@@ -156,6 +156,40 @@ namespace CASM {
 
     }
 
+    // --- Kinetic Monte Carlo settings ---------------------
+
+    /// \brief Maximum hop distance
+    double CanonicalSettings::kmc_hop_cutoff() const {
+      std::string help = "number (required)\n"
+                         "  Maximum distance, in Angstrom, between sites an atom may hop between.\n";
+      return _get_setting<double>("kmc", "hop_cutoff", help);
+    }
+
+    /// \brief Hop attempt frequency. Default 1e13.
+    double CanonicalSettings::kmc_attempt_frequency() const {
+      if(!_is_setting("kmc", "attempt_frequency")) {
+        return 1e13;
+      }
+      std::string help = "number (default=1e13)\n"
+                         "  Hop attempt frequency, in 1/s.\n";
+      return _get_setting<double>("kmc", "attempt_frequency", help);
+    }
+
+    /// \brief Kinetically resolved activation barrier of each species that hops
+    ///
+    /// - Expects "kmc"/"kra": {"<species name>": <barrier in eV>, ...}
+    std::map<std::string, double> CanonicalSettings::kmc_kra() const {
+      std::string help = "JSON object (required)\n"
+                         "  Kinetically resolved activation barrier, in eV, of each species that\n"
+                         "    hops by exchanging sites with a vacancy. Ex: {\"A\": 0.6, \"B\": 0.8}\n";
+      jsonParser json = _get_setting<jsonParser>("kmc", "kra", help);
+      std::map<std::string, double> kra;
+      for(auto it = json.cbegin(); it != json.cend(); ++it) {
+        kra[it.name()] = it->get<double>();
+      }
+      return kra;
+    }
+
     CanonicalConditions CanonicalSettings::_conditions(std::string name) const {
 
       std::string level1 = "driver";
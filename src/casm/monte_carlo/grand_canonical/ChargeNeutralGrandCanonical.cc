@@ -5,14 +5,24 @@
 
 
 namespace CASM {
-    const Monte::ENSEMBLE ChargeNeutralGrandCanonical::ensemble = Monte::ENSEMBLE::ChargeNeutralGrandCanonical; //Zeyu : not sure if this is correct??
+    const Monte::ENSEMBLE ChargeNeutralGrandCanonical::ensemble = Monte::ENSEMBLE::ChargeNeutralGrandCanonical;
 
     ChargeNeutralGrandCanonical::ChargeNeutralGrandCanonical(PrimClex &primclex, const SettingsType &settings, Log &log):
     MonteCarlo(primclex, settings, log),
     m_site_swaps(supercell()),
     m_formation_energy_clex(primclex, settings.formation_energy(primclex)),
     m_all_correlations(settings.all_correlations()),
-    m_event(primclex.composition_axes().components().size(), _clexulator().corr_size()) {
+    m_event(primclex.composition_axes().components().size(), _clexulator().corr_size()),
+    m_n_Ce(1),
+    m_convert(_supercell()),
+    m_cand(m_convert),
+    m_occ_loc(m_convert, m_cand),
+    m_event_proposer(m_convert, m_cand, _occ_event_spec(settings)) {
+        if(settings.is_bias()) {
+          throw std::runtime_error(
+            "Error in ChargeNeutralGrandCanonical: \"bias\" is not supported.");
+        }
+
         const auto &desc = m_formation_energy_clex.desc();
 
         // set the SuperNeighborList...
@@ -32,6 +42,11 @@ namespace CASM {
         _log() << std::setw(16) << "eci: " << desc.eci << "\n";
         _log() << "supercell: \n" << supercell().get_transf_mat() << "\n";
         _log() << "use_deltas: " << std::boolalpha << m_use_deltas << "\n";
+        _log() << "events: \n";
+        for(Index i = 0; i < m_event_proposer.size(); ++i) {
+          jsonParser json;
+          _log() << to_json(m_event_proposer.spec(i), m_convert, json) << "\n";
+        }
         _log() << "\nSampling: \n";
         _log() << std::setw(24) << "quantity" << std::setw(24) << "requested_precision" << "\n";
         for(auto it = samplers().begin(); it != samplers().end(); ++it) {
@@ -158,112 +173,46 @@ namespace CASM {
   }
 
     /// \brief Propose a new event, calculate delta properties, and return reference to it
-    /// <- Conrad: This is different from GrandCanonical.cc, under construction......
+    ///
+    /// - Events are proposed by m_event_proposer, from the "model"/"events"
+    ///   settings, or by default two Ce4/Ce3 sites and one O/Va site with the same
+    ///   occupant index that flip together, so the event is charge neutral
+    /// - The ratio of reverse to forward proposal probabilities is stored in the
+    ///   event, for use by check. If the randomly chosen type of event is not
+    ///   possible, the event changes no sites and the ratio is 0.0.
     const ChargeNeutralGrandCanonical::EventType &ChargeNeutralGrandCanonical::propose(){
-        Index random_variable_site_1,random_variable_site_2, random_variable_site_3;
-        Index mutating_site_1,mutating_site_2,mutating_site_3;
-        Index sublat_1,sublat_2,sublat_3;
-        int current_occupant_1,current_occupant_2,current_occupant_3;
-	    int n_Ce = 1;
-        
-        // Conrad: 3 mutations at the same time; pick two Ce4/Ce3 and one O/Va with the same occupancy and flip them together
-        do{
-          // Randomly pick a site that's allowed more than one occupant
-          random_variable_site_1 = _mtrand().randInt(m_site_swaps.variable_sites().size() - 1);
-          random_variable_site_2 = _mtrand().randInt(m_site_swaps.variable_sites().size() - 1);
-          random_variable_site_3 = _mtrand().randInt(m_site_swaps.variable_sites().size() - 1);
-
-        // Determine what that site's linear index is and what the sublattice index is
-          mutating_site_1 = m_site_swaps.variable_sites()[random_variable_site_1];
-          mutating_site_2 = m_site_swaps.variable_sites()[random_variable_site_2];
-          mutating_site_3 = m_site_swaps.variable_sites()[random_variable_site_3];
-
-          sublat_1 = m_site_swaps.sublat()[random_variable_site_1];
-          sublat_2 = m_site_swaps.sublat()[random_variable_site_2];
-          sublat_3 = m_site_swaps.sublat()[random_variable_site_3];
-      
-          // Determine the current occupant of the mutating site
-          current_occupant_1 = configdof().occ(mutating_site_1);
-          current_occupant_2 = configdof().occ(mutating_site_2);
-          current_occupant_3 = configdof().occ(mutating_site_3);
-        }
-        while(!((current_occupant_1 == current_occupant_2 && current_occupant_2 == current_occupant_3) && ((sublat_1 < n_Ce && sublat_2 < n_Ce && sublat_3 >= n_Ce) || (sublat_1 < n_Ce && sublat_2 >= n_Ce && sublat_3 < n_Ce) || (sublat_1 >= n_Ce && sublat_2 < n_Ce && sublat_3 < n_Ce))));
-
-        // Randomly pick a new occupant for the mutating site
-        const std::vector<int> &possible_mutation_1 = m_site_swaps.possible_swap()[sublat_1][current_occupant_1];
-        int new_occupant_1 = possible_mutation_1[_mtrand().randInt(possible_mutation_1.size() - 1)];
-        const std::vector<int> &possible_mutation_2 = m_site_swaps.possible_swap()[sublat_2][current_occupant_2];
-        int new_occupant_2 = possible_mutation_2[_mtrand().randInt(possible_mutation_2.size() - 1)];
-        const std::vector<int> &possible_mutation_3 = m_site_swaps.possible_swap()[sublat_3][current_occupant_3];
-        int new_occupant_3 = possible_mutation_3[_mtrand().randInt(possible_mutation_3.size() - 1)];
-
-        if(debug()) {
-          const auto &site_occ_1 = primclex().get_prim().basis[sublat_1].site_occupant();
-          const auto &site_occ_2 = primclex().get_prim().basis[sublat_2].site_occupant();
-          const auto &site_occ_3 = primclex().get_prim().basis[sublat_3].site_occupant();
-          _log().custom("Propose charge neutral grand canonical event");
 
-          _log()  << "  Mutating site 1 (linear index): " << mutating_site_1 << "\n"
-                  << "  Sublattice: "<< sublat_1<<"\n"
-                  << "  Mutating site (b, i, j, k): " << supercell().uccoord(mutating_site_1) << "\n"
-                  << "  Current occupant: " << current_occupant_1 << " (" << site_occ_1[current_occupant_1].name << ")\n"
-                  << "  Proposed occupant: " << new_occupant_1 << " (" << site_occ_1[new_occupant_1].name << ")\n\n"
-
-                  << "  Mutating site 2 (linear index): " << mutating_site_2 << "\n"
-                  << "  Sublattice: "<< sublat_2<<"\n"
-                  << "  Mutating site (b, i, j, k): " << supercell().uccoord(mutating_site_2) << "\n"
-                  << "  Current occupant: " << current_occupant_2 << " (" << site_occ_2[current_occupant_2].name << ")\n"
-                  << "  Proposed occupant: " << new_occupant_2 << " (" << site_occ_2[new_occupant_2].name << ")\n\n"
-		  
-		          << "  Mutating site 3 (linear index): " << mutating_site_3 << "\n"
-                  << "  Sublattice: "<< sublat_3<<"\n"
-                  << "  Mutating site (b, i, j, k): " << supercell().uccoord(mutating_site_3) << "\n"
-                  << "  Current occupant: " << current_occupant_3 << " (" << site_occ_3[current_occupant_3].name << ")\n"
-                  << "  Proposed occupant: " << new_occupant_3 << " (" << site_occ_3[new_occupant_3].name << ")\n\n"
-
-                  << "  beta: " << m_condition.beta() << "\n"
-                  << "  T: " << m_condition.temperature() << std::endl;
-        }
-
-        // Conrad: creating triplets
-        std::vector<Index> mutating_sites (mutating_site_1, mutating_site_3);
-        std::vector<Index> sublats (sublat_1, sublat_3);
-        std::vector<int> current_occupants (current_occupant_1 ,current_occupant_3);
-        std::vector<int> new_occupants (new_occupant_1, new_occupant_3);
+        double proposal_ratio = m_event_proposer.propose(m_occ_event, m_occ_loc, _mtrand());
 
         // Update delta properties in m_event
-        // Zeyu: Pairs are passing into _update_deltas()
-        _update_deltas(m_event, mutating_sites, sublats, current_occupants, new_occupants);
+        _update_deltas(m_event, m_occ_event);
+        m_event.set_proposal_ratio(proposal_ratio);
 
         if(debug()) {
+          _log().custom("Propose charge neutral grand canonical event");
 
-          auto origin = primclex().composition_axes().origin();
           auto exchange_chem_pot = m_condition.exchange_chem_pot();
-          auto param_chem_pot = m_condition.param_chem_pot();
-          auto Mpinv = primclex().composition_axes().dparam_dmol();
-          // auto V = supercell().volume();
-          Index curr_species_1 = m_site_swaps.sublat_to_mol()[sublat_1][current_occupant_1];
-          Index new_species_1 = m_site_swaps.sublat_to_mol()[sublat_1][new_occupant_1];
-          Index curr_species_2 = m_site_swaps.sublat_to_mol()[sublat_2][current_occupant_2];
-          Index new_species_2 = m_site_swaps.sublat_to_mol()[sublat_2][new_occupant_2];
-          Index curr_species_3 = m_site_swaps.sublat_to_mol()[sublat_3][current_occupant_3];
-          Index new_species_3 = m_site_swaps.sublat_to_mol()[sublat_3][new_occupant_3];
-
-          _log() << "  components: " << jsonParser(primclex().composition_axes().components()) << "\n"
-                 << "  d(N1): " << m_event.dN()[0].transpose() << "\n"
-                 << "  d(N2): " << m_event.dN()[0].transpose() << "\n"
-                 << "    dx_dn: \n" << Mpinv << "\n"
-                 << "    param_chem_pot.transpose() * dx_dn: \n" << param_chem_pot.transpose()*Mpinv << "\n"
-                 << "    param_chem_pot.transpose() * dx_dn * dN: " << param_chem_pot.transpose()*Mpinv *m_event.dN()[0].cast<double>() << "\n"
-                 << "Swap step 1: d(Nunit * param_chem_pot * x): " << exchange_chem_pot(new_species_1, curr_species_1) << "\n"
-
-                 << "Swap step 2: d(Nunit * param_chem_pot * x): " << exchange_chem_pot(new_species_2, curr_species_2) << "\n"
-		  
-		         << "Swap step 3: d(Nunit * param_chem_pot * x): " << exchange_chem_pot(new_species_3, curr_species_3) << "\n"
-
-                 << "  d(Ef2): " << m_event.dEf()[2] << "\n"
-                 << "  d(Epot2): " << m_event.dEf()[2] - exchange_chem_pot(new_species_2, curr_species_2) << "\n"
-                 << std::endl;
+          for(Index i = 0; i < m_event.size(); ++i) {
+            const auto &occ = m_occ_event.occ_transform[i];
+            Index sublat = m_convert.l_to_b(occ.l);
+            int curr_occ = m_convert.occ_index(occ.asym, occ.from_species);
+            int new_occ = m_convert.occ_index(occ.asym, occ.to_species);
+            Index curr_species = m_site_swaps.sublat_to_mol()[sublat][curr_occ];
+            Index new_species = m_site_swaps.sublat_to_mol()[sublat][new_occ];
+            _log() << "  Mutating site " << i << " (linear index): " << occ.l << "\n"
+                   << "  Sublattice: " << sublat << "\n"
+                   << "  Mutating site (b, i, j, k): " << supercell().uccoord(occ.l) << "\n"
+                   << "  Current occupant: " << curr_occ << " (" << m_convert.species_name(occ.from_species) << ")\n"
+                   << "  Proposed occupant: " << new_occ << " (" << m_convert.species_name(occ.to_species) << ")\n"
+                   << "  d(N): " << m_event.dN()[i].transpose() << "\n"
+                   << "  d(Nunit * param_chem_pot * x): " << exchange_chem_pot(new_species, curr_species) << "\n"
+                   << "  d(Ef): " << m_event.dEf()[i] << "\n"
+                   << "  d(Epot): " << m_event.dEpot()[i] << "\n\n";
+          }
+          _log() << "  total d(Epot): " << m_event.dEpot_swapped_twice() << "\n"
+                 << "  proposal ratio: " << proposal_ratio << "\n"
+                 << "  beta: " << m_condition.beta() << "\n"
+                 << "  T: " << m_condition.temperature() << std::endl;
         }
 
         return m_event;
@@ -272,8 +221,13 @@ namespace CASM {
     
 
 	/// \brief Based on a random number, decide if the change in energy from the proposed event is low enough to be accepted.
+    ///
+    /// - Accepted with probability min(1, proposal_ratio * exp(-beta * dEpot)),
+    ///   which corrects for the number of possible events changing with the event
     bool ChargeNeutralGrandCanonical::check(const EventType &event){
-      if(event.dEpot_swapped_twice() < 0.0) {
+      double prob = event.proposal_ratio() * exp(-event.dEpot_swapped_twice() * m_condition.beta());
+
+      if(prob >= 1.0) {
 
         if(debug()) {
           _log().custom("Check event");
@@ -283,11 +237,11 @@ namespace CASM {
       }
 
       double rand = _mtrand().rand53();
-      double prob = exp(-event.dEpot_swapped_twice() * m_condition.beta()); 
 
       if(debug()) {
         _log().custom("Check event");
-        _log() << "Probability to accept: " << prob << "\n"
+        _log() << "Proposal ratio: " << event.proposal_ratio() << "\n"
+               << "Probability to accept: " << prob << "\n"
                << "Random number: " << rand << "\n" << std::endl;
       }
 
@@ -302,24 +256,16 @@ namespace CASM {
           _log() << std::endl;
         }
 
-        // First apply changes to configuration (just a single occupant change)
-        _configdof().occ(event.occupational_change()[0].site_index()) = event.occupational_change()[0].to_value();
-        _configdof().occ(event.occupational_change()[1].site_index()) = event.occupational_change()[1].to_value();
-        _configdof().occ(event.occupational_change()[2].site_index()) = event.occupational_change()[2].to_value();
-
-        // Next update all properties that changed from the event // Zeyu: update twice, the volume does not change throughout the simulation
-        _formation_energy() += event.dEf()[0] / supercell().volume();
-        _formation_energy() += event.dEf()[1] / supercell().volume();
-        _formation_energy() += event.dEf()[2] / supercell().volume();
-        _potential_energy() += event.dEpot()[0] / supercell().volume();
-        _potential_energy() += event.dEpot()[1] / supercell().volume();
-        _potential_energy() += event.dEpot()[2] / supercell().volume();
-        _corr() += event.dCorr()[0] / supercell().volume();
-        _corr() += event.dCorr()[1] / supercell().volume();
-        _corr() += event.dCorr()[2] / supercell().volume();
-        _comp_n() += event.dN()[0].cast<double>() / supercell().volume();
-        _comp_n() += event.dN()[1].cast<double>() / supercell().volume();
-        _comp_n() += event.dN()[2].cast<double>() / supercell().volume();
+        // First apply changes to configuration and update m_occ_loc
+        m_occ_loc.apply(m_occ_event, _configdof());
+
+        // Next update all properties that changed from the event, the volume does not change throughout the simulation
+        for(Index i = 0; i < event.size(); ++i) {
+          _formation_energy() += event.dEf()[i] / supercell().volume();
+          _potential_energy() += event.dEpot()[i] / supercell().volume();
+          _corr() += event.dCorr()[i] / supercell().volume();
+          _comp_n() += event.dN()[i].cast<double>() / supercell().volume();
+        }
 
         return;
     }
@@ -343,6 +289,7 @@ namespace CASM {
     const SiteExchanger &site_exch = m_site_swaps;
     const ConfigDoF &config_dof = configdof();
     ChargeNeutralGrandCanonicalEvent event = m_event;
+    Monte::OccEvent occ_event;
 
     double tol = 1e-12;
 
@@ -385,16 +332,26 @@ namespace CASM {
               for(auto new_occ_it_2 = possible_2.begin(); new_occ_it_2 != possible_2.end(); ++new_occ_it_2) {
                   for(auto new_occ_it_3 = possible_3.begin(); new_occ_it_3 != possible_3.end(); ++new_occ_it_3) {
 
-              // Conrad: creating vectors
-              std::vector<Index> mutating_sites (mutating_site_1, mutating_site_3);
-              std::vector<Index> sublats (sublat_1, sublat_3);
-              std::vector<int> current_occupants (current_occupant_1, current_occupant_3);
-              std::vector<int> new_occupants (new_occupant_1, new_occupant_3);
+              // Conrad: creating triplets
+              std::vector<Index> mutating_sites {mutating_site_1, mutating_site_2, mutating_site_3};
+              std::vector<int> current_occupants {current_occupant_1, current_occupant_2, current_occupant_3};
+              std::vector<int> new_occupants {*new_occ_it_1, *new_occ_it_2, *new_occ_it_3};
+              occ_event.occ_transform.resize(3);
+              for(Index i = 0; i < 3; ++i) {
+                Index asym = m_convert.l_to_asym(mutating_sites[i]);
+                occ_event.occ_transform[i] = {
+                  mutating_sites[i],
+                  m_occ_loc.l_to_mol_id(mutating_sites[i]),
+                  asym,
+                  m_convert.species_index(asym, current_occupants[i]),
+                  m_convert.species_index(asym, new_occupants[i])
+                };
+              }
 
-              _update_deltas(event, mutating_sites, sublats, current_occupants, new_occ_its);
+              _update_deltas(event, occ_event);
 
               //save the result
-              double dpot_nrg = event.dEpot()[0]+event.dEpot()[2];
+              double dpot_nrg = event.dEpot_swapped_twice();
               if(dpot_nrg < 0.0) {
                 Log &err_log = default_err_log();
                 err_log.error<Log::standard>("Calculating low temperature expansion");
@@ -461,6 +418,11 @@ namespace CASM {
 	/// \brief Write results to files
     void ChargeNeutralGrandCanonical::write_results(Index cond_index) const{
         CASM::write_results(settings(), *this, _log());
+        write_conditions_results(cond_index);
+    }
+
+	/// \brief Write results for conditions 'cond_index', other than the results summary
+    void ChargeNeutralGrandCanonical::write_conditions_results(Index cond_index) const{
         write_conditions_json(settings(), *this, cond_index, _log());
         write_observations(settings(), *this, cond_index, _log());
         write_trajectory(settings(), *this, cond_index, _log());
@@ -474,7 +436,7 @@ namespace CASM {
   double ChargeNeutralGrandCanonical::potential_energy(const Configuration &config) const {
     //if(&config == &this->config()) { return potential_energy(); }
 
-    auto corr = correlations(config, _clexulator());
+    auto corr = correlations(config, _clexulator(), corr_threads());
     double formation_energy = _eci() * corr.data();
     auto comp_x = primclex().composition_axes().param_composition(CASM::comp_n(config));
     return formation_energy - comp_x.dot(m_condition.param_chem_pot());
@@ -495,54 +457,30 @@ namespace CASM {
     _clexulator().set_config_occ(_configdof().occupation().begin());
     _clexulator().set_nlist(nlist().sites(nlist().unitcell_index(mutating_site)).data());
 
+    Eigen::VectorXd &dCorr = event.dCorr()[event.site()];
+
     if(use_deltas) {
       // Calculate the change in correlations due to this event
       if(all_correlations) {
-        if (!event.is_swapped()) {
-        _clexulator().calc_delta_point_corr(sublat,
-                                            current_occupant,
-                                            new_occupant,
-                                            event.dCorr()[0].data());
-                                            }
-        if (event.is_swapped()) {
         _clexulator().calc_delta_point_corr(sublat,
                                             current_occupant,
                                             new_occupant,
-                                            event.dCorr()[2].data());
-                                            }
+                                            dCorr.data());
       }
       else {
         auto begin = _eci().index().data();
         auto end = begin + _eci().index().size();
-        if (!event.is_swapped()){
         _clexulator().calc_restricted_delta_point_corr(sublat,
                                                        current_occupant,
                                                        new_occupant,
-                                                       event.dCorr()[0].data(),
+                                                       dCorr.data(),
                                                        begin,
                                                        end);
-        }
-        if (event.is_swapped()){
-        _clexulator().calc_restricted_delta_point_corr(sublat,
-                                                       current_occupant,
-                                                       new_occupant,
-                                                       event.dCorr()[2].data(),
-                                                       begin,
-                                                       end);          
-        }
       }
     }
     else {
-      Eigen::VectorXd before;
-      Eigen::VectorXd after;
-      if (!event.is_swapped()){
-      before = Eigen::VectorXd::Zero(event.dCorr()[0].size()); //Zeyu: is this correct????
-      after = Eigen::VectorXd::Zero(event.dCorr()[2].size());
-      }
-      if (event.is_swapped()){
-      before = Eigen::VectorXd::Zero(event.dCorr()[0].size());
-      after = Eigen::VectorXd::Zero(event.dCorr()[2].size());        
-      }
+      Eigen::VectorXd before = Eigen::VectorXd::Zero(dCorr.size());
+      Eigen::VectorXd after = Eigen::VectorXd::Zero(dCorr.size());
 
       // Calculate the change in points correlations due to this event
       if(all_correlations) {
@@ -572,24 +510,14 @@ namespace CASM {
       }
 
       // Calculate the change in correlations due to this event
-      if (!event.is_swapped()){
-      event.dCorr()[0] = after - before;
-      }
-      if (event.is_swapped()){
-      event.dCorr()[2] = after - before;  
-      }
+      dCorr = after - before;
 
       // Unapply changes
       _configdof().occ(mutating_site) = current_occupant;
     }
 
     if(debug()) {
-      if (!event.is_swapped()){
-      _print_correlations(event.dCorr()[0], "delta correlations", "dCorr", all_correlations);
-      }
-      if (event.is_swapped()){
-      _print_correlations(event.dCorr()[2], "delta correlations", "dCorr", all_correlations);
-      }
+      _print_correlations(dCorr, "delta correlations", "dCorr", all_correlations);
     }
   }
 
@@ -632,98 +560,141 @@ namespace CASM {
   }
 
 	/// This function needs to do all the math for energy and correlation deltas and store
-	/// the results inside the containers hosted by event. 
-    /// <- Zeyu: This is different from GrandCanonical.cc, not finished
-    /// do this site by site and then calculate total dEpot and store in ChargeNeutralGrandCanonicalEvent
-    /// and use it to for check()
-	void ChargeNeutralGrandCanonical::_update_deltas(EventType &event, 
-						std::vector<Index> &mutating_sites,
-						std::vector<Index> &sublats,
-						std::vector<int> &curr_occs,
-						std::vector<int> &new_occs) const{
-        // reset the flag
-        event.set_is_swapped(false);
-
-        // Site 1
-        // ---- set OccMod --------------
-        event.occupational_change()[0].set(mutating_sites[0], sublats[0], new_occs[0]);
-
-        // ---- set dspecies --------------
-        for(int i = 0; i < event.dN()[0].size(); ++i) {
-          event.set_dN(i, 0);
+	/// the results inside the containers hosted by event.
+    ///
+    /// - The site changes are calculated in order, each with the previous changes
+    ///   applied, so that the sum of the deltas is the change due to the whole event
+    /// - The configuration is restored before returning
+	void ChargeNeutralGrandCanonical::_update_deltas(EventType &event, const Monte::OccEvent &occ_event) const {
+
+        const auto &occ_transform = occ_event.occ_transform;
+        event.resize(occ_transform.size());
+
+        double dEpot_total = 0.0;
+        for(Index i = 0; i < occ_transform.size(); ++i) {
+
+          const Monte::OccTransform &occ = occ_transform[i];
+          Index sublat = m_convert.l_to_b(occ.l);
+          int curr_occ = m_convert.occ_index(occ.asym, occ.from_species);
+          int new_occ = m_convert.occ_index(occ.asym, occ.to_species);
+
+          event.set_site(i);
+
+          // ---- set OccMod --------------
+          event.occupational_change()[i].set(occ.l, sublat, new_occ);
+
+          // ---- set dspecies --------------
+          for(int j = 0; j < event.dN()[i].size(); ++j) {
+            event.set_dN(j, 0);
+          }
+          Index curr_species = m_site_swaps.sublat_to_mol()[sublat][curr_occ];
+          Index new_species = m_site_swaps.sublat_to_mol()[sublat][new_occ];
+          event.set_dN(curr_species, -1);
+          event.set_dN(new_species, 1);
+
+          // ---- set dcorr --------------
+          _set_dCorr(event, occ.l, sublat, curr_occ, new_occ, m_use_deltas, m_all_correlations);
+
+          // ---- set dformation_energy --------------
+          event.set_dEf(_eci() * event.dCorr()[i].data());
+
+          // ---- set dpotential_energy --------------
+          double dEpot = event.dEf()[i] - m_condition.exchange_chem_pot(new_species, curr_species);
+          event.set_dEpot(dEpot);
+          dEpot_total += dEpot;
+
+          // apply this change before calculating the next
+          _configdof().occ(occ.l) = new_occ;
+        }
+        event.set_dEpot_swapped_twice(dEpot_total);
+
+        // restore the configuration
+        for(Index i = occ_transform.size(); i > 0; --i) {
+          const Monte::OccTransform &occ = occ_transform[i - 1];
+          _configdof().occ(occ.l) = m_convert.occ_index(occ.asym, occ.from_species);
+        }
+        event.set_site(0);
+    }
+
+  /// \brief Multi-site events to propose, from settings or the default Ce/O triplets
+  ///
+  /// - The default events flip two sites on sublattices with index < m_n_Ce and
+  ///   one site on the other sublattices, all from occupant index 'i' to 'j'
+  std::vector<Monte::OccEventSpec> ChargeNeutralGrandCanonical::_occ_event_spec(const SettingsType &settings) const {
+
+    if(settings.is_occ_event_spec()) {
+      return settings.occ_event_spec(m_convert);
+    }
+
+    // group asym with variable occupation into Ce and O sites
+    std::vector<Index> Ce_asym;
+    std::vector<Index> O_asym;
+    for(Index asym = 0; asym < m_convert.asym_size(); ++asym) {
+      if(m_convert.occ_size(asym) < 2) {
+        continue;
+      }
+      if(*m_convert.asym_to_b(asym).begin() < m_n_Ce) {
+        Ce_asym.push_back(asym);
+      }
+      else {
+        O_asym.push_back(asym);
+      }
+    }
+
+    // species with occupant index 'occ' on all of 'asym', or species_size() if not consistent
+    auto species = [&](const std::vector<Index> &asym, Index occ) {
+      Index res = m_convert.species_size();
+      for(const auto &a : asym) {
+        if(occ >= m_convert.occ_size(a)) {
+          return m_convert.species_size();
         }
-        Index curr_species_1 = m_site_swaps.sublat_to_mol()[sublats[0]][curr_occs[0]];
-        Index new_species_1 = m_site_swaps.sublat_to_mol()[sublats[0]][new_occs[0]];
-        event.set_dN(curr_species_1, -1);
-        event.set_dN(new_species_1, 1);
-
-        // ---- set dcorr --------------
-        _set_dCorr(event, mutating_sites[0], sublats[0], curr_occs[0], new_occs[0], m_use_deltas, m_all_correlations); // Zeyu: Shall we rewrite _set_dCorr?
-
-        // ---- set dformation_energy --------------
-        event.set_dEf(_eci() * event.dCorr()[0].data());
-
-        // ---- set dpotential_energy --------------
-        double dEpot_1 = event.dEf()[0] - m_condition.exchange_chem_pot(new_species_1, curr_species_1);
-        event.set_dEpot(dEpot_1);
-        // back up site 1 occupation
-        event.set_original_occ_first_swap(_configdof().occ(event.occupational_change()[0].site_index()));
-        // // Site 1 modification finished, update configuration ....
-        _configdof().occ(event.occupational_change()[0].site_index()) = event.occupational_change()[0].to_value();
-        // mark the changes of the first site
-        event.set_is_swapped(true);
-        // Site 2
-        // ---- set OccMod --------------
-        event.occupational_change()[1].set(mutating_sites[1], sublats[1], new_occs[1]);
-        // ---- set dspecies --------------
-        for(int i = 0; i < event.dN()[1].size(); ++i) {
-          event.set_dN(i, 0);
+        Index tspecies = m_convert.species_index(a, occ);
+        if(res != m_convert.species_size() && tspecies != res) {
+          return m_convert.species_size();
         }
-        Index curr_species_2 = m_site_swaps.sublat_to_mol()[sublats[1]][curr_occs[1]];
-        Index new_species_2 = m_site_swaps.sublat_to_mol()[sublats[1]][new_occs[1]];
-        event.set_dN(curr_species_2, -1);
-        event.set_dN(new_species_2, 1);
-        // ---- set dcorr --------------
-        _set_dCorr(event, mutating_sites[1], sublats[1], curr_occs[1], new_occs[1], m_use_deltas, m_all_correlations);
-        // ---- set dformation_energy --------------
-        event.set_dEf(_eci() * event.dCorr()[1].data());
-        // ---- set dpotential_energy --------------
-        double dEpot_2 = event.dEf()[1] - m_condition.exchange_chem_pot(new_species_2, curr_species_2);
-        event.set_dEpot(dEpot_2);
-        // Calculate dEpot after two swaps
-        event.set_dEpot_swapped_twice(dEpot_1+dEpot_2);
-		
-	 // Site 3
-        // ---- set OccMod --------------
-        event.occupational_change()[2].set(mutating_sites[2], sublats[2], new_occs[2]);
-        // ---- set dspecies --------------
-        for(int i = 0; i < event.dN()[2].size(); ++i) {
-          event.set_dN(i, 0);
+        res = tspecies;
+      }
+      return res;
+    };
+
+    std::vector<Monte::OccEventSpec> spec;
+    if(Ce_asym.size() && O_asym.size()) {
+      Index n_occ = 0;
+      for(const auto &a : Ce_asym) {
+        n_occ = std::max(n_occ, m_convert.occ_size(a));
+      }
+      for(Index i = 0; i < n_occ; ++i) {
+        for(Index j = i + 1; j < n_occ; ++j) {
+          Index Ce_i = species(Ce_asym, i);
+          Index Ce_j = species(Ce_asym, j);
+          Index O_i = species(O_asym, i);
+          Index O_j = species(O_asym, j);
+          if(Ce_i == m_convert.species_size() || Ce_j == m_convert.species_size() ||
+             O_i == m_convert.species_size() || O_j == m_convert.species_size()) {
+            continue;
+          }
+          Monte::OccFlipSpec Ce_flip(Ce_asym, Ce_i, Ce_j);
+          Monte::OccFlipSpec O_flip(O_asym, O_i, O_j);
+          spec.push_back(Monte::OccEventSpec(
+                           m_convert.species_name(Ce_i) + "_" + m_convert.species_name(O_i),
+                           {Ce_flip, Ce_flip, O_flip}));
         }
-        Index curr_species_3 = m_site_swaps.sublat_to_mol()[sublats[2]][curr_occs[2]];
-        Index new_species_3 = m_site_swaps.sublat_to_mol()[sublats[2]][new_occs[2]];
-        event.set_dN(curr_species_2, -1);
-        event.set_dN(new_species_2, 1);
-        // ---- set dcorr --------------
-        _set_dCorr(event, mutating_sites[2], sublats[2], curr_occs[2], new_occs[2], m_use_deltas, m_all_correlations);
-        // ---- set dformation_energy --------------
-        event.set_dEf(_eci() * event.dCorr()[2].data());
-        // ---- set dpotential_energy --------------
-        double dEpot_3 = event.dEf()[2] - m_condition.exchange_chem_pot(new_species_3, curr_species_3);
-        event.set_dEpot(dEpot_3);
-        // Calculate dEpot after three swaps
-        event.set_dEpot_swapped_twice(dEpot_1+dEpot_2+dEpot_3);
-        // Zeyu: after get dEpot_swapped_twice, change configuration back to origin....
-        _configdof().occ(event.occupational_change()[0].site_index()) = event.original_occ_first_swap();
-        event.set_is_swapped(false);
-        
+      }
     }
 
+    if(!spec.size()) {
+      throw std::runtime_error(
+        "Error in ChargeNeutralGrandCanonical: could not construct default events, "
+        "specify [\"model\"][\"events\"].");
+    }
+    return spec;
+  }
+
   /// \brief Calculate properties given current conditions
   void ChargeNeutralGrandCanonical::_update_properties() {
 
     // initialize properties and store pointers to the data strucures
-    _vector_properties()["corr"] = correlations_vec(_configdof(), supercell(), _clexulator());
+    _vector_properties()["corr"] = correlations_vec(_configdof(), supercell(), _clexulator(), corr_threads());
     m_corr = &_vector_property("corr");
 
     _vector_properties()["comp_n"] = CASM::comp_n(_configdof(), supercell());
@@ -735,6 +706,8 @@ namespace CASM {
     _scalar_properties()["potential_energy"] = formation_energy() - primclex().composition_axes().param_composition(comp_n()).dot(m_condition.param_chem_pot());
     m_potential_energy = &_scalar_property("potential_energy");
 
+    m_occ_loc.initialize(_config());
+
     if(debug()) {
 
       _print_correlations(corr(), "correlations", "corr", m_all_correlations);
@@ -1,10 +1,14 @@
 
 #include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
+#include <cmath>
+#include <limits>
 #include "casm/monte_carlo/MonteCarloEnum_impl.hh"
 #include "casm/monte_carlo/MonteIO_impl.hh"
+#include "casm/monte_carlo/MonteCheckpoint.hh"
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/ConfigIterator.hh"
 #include "casm/clex/Norm.hh"
+#include "casm/misc/parallel.hh"
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalIO.hh"
 
 namespace CASM {
@@ -19,7 +23,9 @@ namespace CASM {
     m_site_swaps(supercell()),
     m_formation_energy_clex(primclex, settings.formation_energy(primclex)),
     m_all_correlations(settings.all_correlations()),
-    m_event(primclex.composition_axes().components().size(), _clexulator().corr_size()) {
+    m_event(primclex.composition_axes().components().size(), _clexulator().corr_size()),
+    m_event_dCorr_pending(false),
+    m_rejection_free(settings.is_rejection_free()) {
 
     const auto &desc = m_formation_energy_clex.desc();
 
@@ -29,6 +35,7 @@ namespace CASM {
     // If the simulation is big enough, use delta cluster functions;
     // else, calculate all cluster functions
     m_use_deltas = !nlist().overlaps();
+    m_use_delta_energy = false;
 
     _log().construct("Grand Canonical Monte Carlo");
     _log() << "project: " << this->primclex().get_path() << "\n";
@@ -54,6 +61,52 @@ namespace CASM {
     _log() << "\nautomatic convergence mode?: " << std::boolalpha << must_converge() << std::endl;
     _log() << std::endl;
 
+    if(settings.is_parallel_sweep()) {
+
+      if(!m_use_deltas) {
+        throw std::runtime_error(
+          "Error in GrandCanonical: \"parallel_sweep\" requires a supercell large enough to use delta correlations.");
+      }
+      if(!settings.sample_by_pass()) {
+        throw std::runtime_error(
+          "Error in GrandCanonical: \"parallel_sweep\" requires \"sample_by\": \"pass\".");
+      }
+      if(debug()) {
+        throw std::runtime_error(
+          "Error in GrandCanonical: \"parallel_sweep\" may not be used in debug mode.");
+      }
+
+      Index n_threads = settings.parallel_sweep();
+      m_checkerboard.reset(new Monte::Checkerboard(
+                             nlist(),
+                             supercell().volume(),
+                             m_site_swaps.variable_sites(),
+                             n_threads,
+                             _mtrand()));
+      for(Index t = 0; t < n_threads; ++t) {
+        m_sweep_data.emplace_back(_clexulator(), m_event.dCorr().size(), m_event.dN().size());
+      }
+
+      _log().construct("Checkerboard parallel sweep");
+      _log() << "threads: " << n_threads << "\n";
+      _log() << "colors: " << m_checkerboard->n_colors() << "\n";
+      _log() << "groups: " << m_checkerboard->size() << "\n" << std::endl;
+    }
+
+    if(m_rejection_free) {
+      _rf_construct();
+    }
+
+    if(settings.is_bias()) {
+      _bias_construct(settings);
+    }
+
+    _delta_energy_construct();
+
+    if(settings.is_site_energy_cache()) {
+      _site_energy_cache_construct();
+    }
+
   }
 
   /// \brief Return number of steps per pass. Equals number of sites with variable occupation.
@@ -93,6 +146,16 @@ namespace CASM {
     _update_properties();
   }
 
+  /// \brief Set configdof without clearing previously collected data
+  ///
+  /// - Used by ReplicaExchangeDriver to swap states between replicas, where
+  ///   the samples already collected at the current conditions remain valid
+  void GrandCanonical::exchange_configdof(const ConfigDoF &configdof) {
+    _configdof() = configdof;
+    _site_energy_cache().clear();
+    _update_properties();
+  }
+
   /// \brief Set configdof and conditions and clear previously collected data
   ///
   /// \returns Specified ConfigDoF and configname (or configdof path)
@@ -201,7 +264,8 @@ namespace CASM {
     }
 
     // Update delta properties in m_event
-    _update_deltas(m_event, mutating_site, sublat, current_occupant, new_occupant);
+    m_event_dCorr_pending = !_update_energy(m_event, mutating_site, sublat, current_occupant, new_occupant) &&
+                            !m_use_delta_energy;
 
     if(debug()) {
 
@@ -232,7 +296,14 @@ namespace CASM {
   /// \brief Based on a random number, decide if the change in energy from the proposed event is low enough to be accepted.
   bool GrandCanonical::check(const GrandCanonicalEvent &event) {
 
-    if(event.dEpot() < 0.0) {
+    // the bias potential only changes which events are accepted
+    double dEpot = event.dEpot();
+    if(m_bias.is_active()) {
+      double dq = m_bias.delta_order_parameter(event.dCorr(), supercell().volume());
+      dEpot += m_bias.delta(*m_order_parameter, dq, supercell().volume());
+    }
+
+    if(dEpot < 0.0) {
 
       if(debug()) {
         _log().custom("Check event");
@@ -242,7 +313,7 @@ namespace CASM {
     }
 
     double rand = _mtrand().rand53();
-    double prob = exp(-event.dEpot() * m_condition.beta());
+    double prob = exp(-dEpot * m_condition.beta());
 
     if(debug()) {
       _log().custom("Check event");
@@ -266,15 +337,40 @@ namespace CASM {
       _log() << std::endl;
     }
 
+    const auto &occ_change = event.occupational_change();
+
+    // Events found in the site energy cache do not include delta correlations
+    if(m_event_dCorr_pending && &event == &m_event) {
+      _set_dCorr(m_event,
+                 occ_change.site_index(),
+                 occ_change.sublat(),
+                 configdof().occ(occ_change.site_index()),
+                 occ_change.to_value(),
+                 m_use_deltas,
+                 m_all_correlations,
+                 _clexulator());
+      m_event_dCorr_pending = false;
+    }
+
     // First apply changes to configuration (just a single occupant change)
-    _configdof().occ(event.occupational_change().site_index()) = event.occupational_change().to_value();
+    _configdof().occ(occ_change.site_index()) = occ_change.to_value();
+    if(site_energy_cache().is_enabled()) {
+      _site_energy_cache().invalidate(occ_change.site_index());
+    }
 
     // Next update all properties that changed from the event
     _formation_energy() += event.dEf() / supercell().volume();
     _potential_energy() += event.dEpot() / supercell().volume();
-    _corr() += event.dCorr() / supercell().volume();
+    if(!m_use_delta_energy) {
+      _corr() += event.dCorr() / supercell().volume();
+    }
     _comp_n() += event.dN().cast<double>() / supercell().volume();
 
+    if(m_bias.is_active()) {
+      *m_order_parameter += m_bias.delta_order_parameter(event.dCorr(), supercell().volume());
+      *m_bias_energy = m_bias.value(*m_order_parameter);
+    }
+
     return;
   }
 
@@ -287,6 +383,107 @@ namespace CASM {
     return;
   }
 
+  /// \brief Perform up to 'max_steps' steps at once, rejection-free
+  ///
+  /// \param max_steps Maximum number of steps to perform, >= 1
+  /// \param accepted Set to true if the last step performed was accepted
+  ///
+  /// \returns Number of steps performed
+  ///
+  /// The next event, and the number of steps the Metropolis method would reject
+  /// before accepting it, are selected in advance (see _rf_select). If fewer than
+  /// 'max_steps' steps remain before the next event, those steps and the event are
+  /// performed. Otherwise, 'max_steps' rejected steps are performed, which does not
+  /// change the state.
+  ///
+  /// Because the number of rejected steps is counted, samples taken at regular
+  /// intervals of steps or passes weight each state by its residence time, so
+  /// averages are the same as for the Metropolis method.
+  ///
+  Index GrandCanonical::rejection_free_step(Index max_steps, bool &accepted) {
+
+    if(m_rf_rejections >= max_steps) {
+      m_rf_rejections -= max_steps;
+      accepted = false;
+      return max_steps;
+    }
+
+    Index steps = m_rf_rejections + 1;
+
+    // perform the selected event
+    Index mutating_site = m_site_swaps.variable_sites()[m_rf_site];
+    Index sublat = m_site_swaps.sublat()[m_rf_site];
+    int current_occupant = configdof().occ(mutating_site);
+    int new_occupant = m_site_swaps.possible_swap()[sublat][current_occupant][m_rf_cand];
+
+    _update_deltas(m_event, mutating_site, sublat, current_occupant, new_occupant, _clexulator());
+    accept(m_event);
+
+    // update the rates of events with a neighborhood that includes the mutating site
+    for(const auto &uc : m_rf_affected_uc[nlist().unitcell_index(mutating_site)]) {
+      for(const auto &i : m_rf_uc_sites[uc]) {
+        _rf_update_site(i);
+      }
+    }
+
+    _rf_select();
+
+    accepted = true;
+    return steps;
+  }
+
+  /// \brief Attempt to change the occupant of every variable site once, in parallel
+  ///
+  /// - Sites are visited in groups of non-interacting sites (see Monte::Checkerboard),
+  ///   proposing a random new occupant for each and accepting by the Metropolis
+  ///   criterion, as by propose/check/accept
+  /// - Each thread uses its own Clexulator and MTRand, and properties are updated
+  ///   with the changes from each thread, in order, after the sweep
+  ///
+  void GrandCanonical::parallel_sweep() {
+
+    for(auto &data : m_sweep_data) {
+      data.reset();
+    }
+
+    double beta = m_condition.beta();
+
+    m_checkerboard->sweep(_mtrand(), [&](Index t, const std::vector<Index> &sites) {
+
+      Monte::SweepData &data = m_sweep_data[t];
+      MTRand &mtrand = m_checkerboard->mtrand(t);
+      GrandCanonicalEvent event(data.dN.size(), data.dCorr.size());
+
+      for(const auto &mutating_site : sites) {
+
+        int sublat = nlist().sublat_index(mutating_site);
+        int current_occupant = configdof().occ(mutating_site);
+
+        const std::vector<int> &possible_mutation = m_site_swaps.possible_swap()[sublat][current_occupant];
+        int new_occupant = possible_mutation[mtrand.randInt(possible_mutation.size() - 1)];
+
+        _update_deltas(event, mutating_site, sublat, current_occupant, new_occupant, data.clexulator);
+
+        if(event.dEpot() < 0.0 || mtrand.rand53() < exp(-event.dEpot() * beta)) {
+          _configdof().occ(mutating_site) = new_occupant;
+          data.dEf += event.dEf();
+          data.dEpot += event.dEpot();
+          if(!m_use_delta_energy) {
+            data.dCorr += event.dCorr();
+          }
+          data.dN += event.dN();
+        }
+      }
+    });
+
+    for(const auto &data : m_sweep_data) {
+      _formation_energy() += data.dEf / supercell().volume();
+      _potential_energy() += data.dEpot / supercell().volume();
+      _corr() += data.dCorr / supercell().volume();
+      _comp_n() += data.dN.cast<double>() / supercell().volume();
+    }
+  }
+
   /// \brief Calculate the single spin flip low temperature expansion of the grand canonical potential
   ///
   /// Returns low temperature expansion estimate of the grand canonical free energy.
@@ -316,9 +513,7 @@ namespace CASM {
   ///
   double GrandCanonical::lte_grand_canonical_free_energy() const {
 
-    const SiteExchanger &site_exch = m_site_swaps;
-    const ConfigDoF &config_dof = configdof();
-    GrandCanonicalEvent event = m_event;
+    std::vector<std::vector<double> > dEpot = _lte_point_dEpot();
 
     double tol = 1e-12;
 
@@ -331,33 +526,8 @@ namespace CASM {
     // no defect case
     hist[0.0] = 1;
 
-    // double sum_exp = 0.0;
-
-    //Loop over sites that can change occupants
-    for(Index exch_ind = 0; exch_ind < site_exch.variable_sites().size(); exch_ind++) {
-
-      //Transform exchanger index to ConfigDoF index
-      Index mutating_site = site_exch.variable_sites()[exch_ind];
-      int sublat = site_exch.sublat()[exch_ind];
-      int current_occupant = config_dof.occ(mutating_site);
-
-      //Loop over possible occupants for site that can change
-      const auto &possible = site_exch.possible_swap()[sublat][current_occupant];
-      for(auto new_occ_it = possible.begin(); new_occ_it != possible.end(); ++new_occ_it) {
-
-        _update_deltas(event, mutating_site, sublat, current_occupant, *new_occ_it);
-
-        //save the result
-        double dpot_nrg = event.dEpot();
-        if(dpot_nrg < 0.0) {
-          Log &err_log = default_err_log();
-          err_log.error<Log::standard>("Calculating low temperature expansion");
-          err_log << "  Defect lowered the potential energy. Your motif configuration "
-                  << "is not the 0K ground state.\n" << std::endl;
-          throw std::runtime_error("Error calculating low temperature expansion. Not in the ground state.");
-        }
-
-
+    for(const auto &site_dEpot : dEpot) {
+      for(double dpot_nrg : site_dEpot) {
         auto it = hist.find(dpot_nrg);
         if(it == hist.end()) {
           hist[dpot_nrg] = 1;
@@ -406,13 +576,211 @@ namespace CASM {
 
   }
 
+  /// \brief Calculate the low temperature expansion of the grand canonical potential, including pair excitations
+  ///
+  /// The partition function is expanded in excitations from the ground state,
+  /// and ln(Z) is approximated by the sum of connected terms up to pairs:
+  ///
+  /// ln(Z/boltz(\Omega_0)) = SUM_i(x_i) - SUM_s((SUM_(i on s) x_i)^2)/2 + SUM_(i,j)(x_ij - x_i*x_j)
+  ///
+  /// where x_i = boltz(D\Omega_i) for single site excitations i, x_ij =
+  /// boltz(D\Omega_ij) for pairs of excitations i,j on different sites, the
+  /// second term removes pairs of excitations on the same site, and the last sum
+  /// is over pairs of sites that share a neighborhood. Then
+  ///
+  /// Phi=(\Omega_0-kB*T*ln(Z/boltz(\Omega_0)))/N
+  ///
+  /// - Symmetrically equivalent pairs of sites are evaluated once, using the
+  ///   operations of the supercell factor group that leave the ground state
+  ///   unchanged
+  /// - Excitation energies are calculated using "driver"/"lte"/"threads" threads
+  ///
+  double GrandCanonical::lte2_grand_canonical_free_energy() const {
+
+    const SiteExchanger &site_exch = m_site_swaps;
+    const ConfigDoF &config_dof = configdof();
+    double beta = m_condition.beta();
+
+    std::vector<std::vector<double> > dEpot = _lte_point_dEpot();
+
+    // single site excitations, and pairs of excitations on the same site
+    std::vector<std::vector<double> > x(dEpot.size());
+    double sum_point = 0.0;
+    double sum_same_site = 0.0;
+    for(Index i = 0; i < dEpot.size(); ++i) {
+      double site_sum = 0.0;
+      for(double dpot_nrg : dEpot[i]) {
+        x[i].push_back(exp(-beta * dpot_nrg));
+        site_sum += x[i].back();
+      }
+      sum_point += site_sum;
+      sum_same_site -= 0.5 * site_sum * site_sum;
+    }
+
+    // pairs of excitations on interacting sites
+    std::vector<LTEPair> pairs = lte_pairs();
+    Index n_threads = _lte_threads();
+    std::vector<Clexulator> clexulator(n_threads, _clexulator());
+    std::vector<Eigen::VectorXd> dCorr(n_threads, Eigen::VectorXd::Zero(_clexulator().corr_size()));
+    std::vector<double> pair_sum(pairs.size(), 0.0);
+    const int *occ_ptr = config_dof.occupation().begin();
+
+    auto swap_site = [&](Index i, int new_occ) {
+      Index l = site_exch.variable_sites()[i];
+      const std::vector<Index> &sites = nlist().sites(nlist().unitcell_index(l));
+      return ClexSwapSite {l, site_exch.sublat()[i], config_dof.occ(l), new_occ, sites.data(), sites.data() + sites.size()};
+    };
+
+    auto exchange_chem_pot = [&](const ClexSwapSite & site) {
+      const auto &to_mol = site_exch.sublat_to_mol()[site.b];
+      return m_condition.exchange_chem_pot(to_mol[site.occ_f], to_mol[site.occ_i]);
+    };
+
+    parallel_for(pairs.size(), n_threads, [&](Index t, Index k) {
+
+      const LTEPair &pair = pairs[k];
+      const auto &possible_i = site_exch.possible_swap()[site_exch.sublat()[pair.i]][config_dof.occ(site_exch.variable_sites()[pair.i])];
+      const auto &possible_j = site_exch.possible_swap()[site_exch.sublat()[pair.j]][config_dof.occ(site_exch.variable_sites()[pair.j])];
+
+      for(Index a = 0; a < possible_i.size(); ++a) {
+        ClexSwapSite site_a = swap_site(pair.i, possible_i[a]);
+        for(Index b = 0; b < possible_j.size(); ++b) {
+          ClexSwapSite site_b = swap_site(pair.j, possible_j[b]);
+
+          double dEf;
+          if(m_use_delta_energy) {
+            dEf = clexulator[t].calc_delta_swap_energy(occ_ptr, site_a, site_b, m_dense_eci.data());
+          }
+          else {
+            if(m_all_correlations) {
+              clexulator[t].calc_delta_swap_corr(occ_ptr, site_a, site_b, m_use_deltas, dCorr[t].data());
+            }
+            else {
+              auto begin = _eci().index().data();
+              auto end = begin + _eci().index().size();
+              clexulator[t].calc_restricted_delta_swap_corr(occ_ptr, site_a, site_b, m_use_deltas, dCorr[t].data(), begin, end);
+            }
+            dEf = _eci() * dCorr[t].data();
+          }
+
+          double dpot_nrg = dEf - exchange_chem_pot(site_a) - exchange_chem_pot(site_b);
+          if(dpot_nrg < 0.0) {
+            throw std::runtime_error("Error calculating low temperature expansion. Not in the ground state.");
+          }
+
+          // x_ij - x_i*x_j, without cancellation when the sites barely interact
+          double interaction = dpot_nrg - dEpot[pair.i][a] - dEpot[pair.j][b];
+          pair_sum[k] += x[pair.i][a] * x[pair.j][b] * std::expm1(-beta * interaction);
+        }
+      }
+    });
+
+    double sum_pair = 0.0;
+    Index n_pairs = 0;
+    for(Index k = 0; k < pairs.size(); ++k) {
+      sum_pair += pairs[k].multiplicity * pair_sum[k];
+      n_pairs += pairs[k].multiplicity;
+    }
+
+    double N = supercell().volume();
+    double phi = potential_energy() - (sum_point + sum_same_site + sum_pair) / beta / N;
+
+    _log().results("Ground state, point defect, and pair defect potential energy details");
+    _log() << "T: " << m_condition.temperature() << std::endl;
+    _log() << "kT: " << 1.0 / beta << std::endl;
+    _log() << "Beta: " << beta << std::endl;
+    _log() << "threads: " << n_threads << std::endl;
+    _log() << "interacting pairs of sites: " << n_pairs << std::endl;
+    _log() << "symmetrically distinct pairs of sites: " << pairs.size() << std::endl << std::endl;
+
+    _log() << std::setw(24) << "term" << " "
+           << std::setw(24) << "sum/N" << " "
+           << std::setw(16) << "dphi" << std::endl;
+    _log() << std::setw(24) << "point" << " "
+           << std::setw(24) << std::setprecision(8) << sum_point / N << " "
+           << std::setw(16) << std::setprecision(8) << -sum_point / beta / N << std::endl;
+    _log() << std::setw(24) << "same site" << " "
+           << std::setw(24) << std::setprecision(8) << sum_same_site / N << " "
+           << std::setw(16) << std::setprecision(8) << -sum_same_site / beta / N << std::endl;
+    _log() << std::setw(24) << "pair" << " "
+           << std::setw(24) << std::setprecision(8) << sum_pair / N << " "
+           << std::setw(16) << std::setprecision(8) << -sum_pair / beta / N << std::endl << std::endl;
+
+    _log() << "phi_LTE(2): " << std::setprecision(12) << phi << std::endl << std::endl;
+
+    return phi;
+  }
+
+  /// \brief Change in (extensive) potential energy due to changing the occupant of one site
+  ///
+  /// - Uses the site energy cache, if enabled, so that evaluating many sites
+  ///   repeatedly for analysis, such as point defect energy maps, only
+  ///   recalculates sites near changes
+  double GrandCanonical::site_dEpot(Index mutating_site, int new_occupant) const {
+    GrandCanonicalEvent event(m_event.dN().size(), m_event.dCorr().size());
+    _update_energy(event,
+                   mutating_site,
+                   nlist().sublat_index(mutating_site),
+                   configdof().occ(mutating_site),
+                   new_occupant);
+    return event.dEpot();
+  }
+
   /// \brief Write results to files
   void GrandCanonical::write_results(Index cond_index) const {
     CASM::write_results(settings(), *this, _log());
+    write_conditions_results(cond_index);
+  }
+
+  /// \brief Write results for conditions 'cond_index', other than the results summary
+  void GrandCanonical::write_conditions_results(Index cond_index) const {
     write_conditions_json(settings(), *this, cond_index, _log());
     write_observations(settings(), *this, cond_index, _log());
     write_trajectory(settings(), *this, cond_index, _log());
     //write_pos_trajectory(settings(), *this, cond_index);
+    _log_site_energy_cache();
+  }
+
+  /// \brief Write MonteCarlo checkpoint data, and the state of the GrandCanonical method
+  ///
+  /// - Includes the MTRand of each thread for parallel sweeps, and, for the
+  ///   rejection-free method, the event rates and the selected next event, so
+  ///   that a resumed calculation continues exactly as if it had not stopped
+  void GrandCanonical::write_checkpoint(std::ostream &sout) const {
+    MonteCarlo::write_checkpoint(sout);
+    if(m_checkerboard) {
+      m_checkerboard->write_checkpoint(sout);
+    }
+    if(!m_rejection_free) {
+      return;
+    }
+    checkpoint::write(sout, m_rf_site_rate);
+    checkpoint::write(sout, m_rf_rate);
+    checkpoint::write(sout, m_rf_site);
+    checkpoint::write(sout, m_rf_cand);
+    checkpoint::write(sout, m_rf_rejections);
+  }
+
+  /// \brief Restore data written by write_checkpoint
+  ///
+  /// - Call after 'set_state' with the checkpointed ConfigDoF
+  void GrandCanonical::read_checkpoint(std::istream &sin) {
+    MonteCarlo::read_checkpoint(sin);
+    if(m_checkerboard) {
+      m_checkerboard->read_checkpoint(sin);
+    }
+    if(!m_rejection_free) {
+      return;
+    }
+    checkpoint::read(sin, m_rf_site_rate);
+    checkpoint::read(sin, m_rf_rate);
+    if(m_rf_site_rate.size() != m_site_swaps.variable_sites().size() ||
+       m_rf_rate.size() != m_rf_site_rate.size() * m_rf_max_cand) {
+      throw std::runtime_error("Error reading Monte Carlo checkpoint: number of events does not match");
+    }
+    checkpoint::read(sin, m_rf_site);
+    checkpoint::read(sin, m_rf_cand);
+    checkpoint::read(sin, m_rf_rejections);
   }
 
   /// \brief Get potential energy
@@ -422,7 +790,7 @@ namespace CASM {
   double GrandCanonical::potential_energy(const Configuration &config) const {
     //if(&config == &this->config()) { return potential_energy(); }
 
-    auto corr = correlations(config, _clexulator());
+    auto corr = correlations(config, _clexulator(), corr_threads());
     double formation_energy = _eci() * corr.data();
     auto comp_x = primclex().composition_axes().param_composition(CASM::comp_n(config));
     return formation_energy - comp_x.dot(m_condition.param_chem_pot());
@@ -435,19 +803,20 @@ namespace CASM {
                                   int current_occupant,
                                   int new_occupant,
                                   bool use_deltas,
-                                  bool all_correlations) const {
+                                  bool all_correlations,
+                                  Clexulator &clexulator) const {
 
-    // uses _clexulator(), nlist(), _configdof()
+    // uses clexulator, nlist(), _configdof()
 
     // Point the Clexulator to the right neighborhood and right ConfigDoF
-    _clexulator().set_config_occ(_configdof().occupation().begin());
-    _clexulator().set_nlist(nlist().sites(nlist().unitcell_index(mutating_site)).data());
+    clexulator.set_config_occ(_configdof().occupation().begin());
+    clexulator.set_nlist(nlist().sites(nlist().unitcell_index(mutating_site)).data());
 
     if(use_deltas) {
 
       // Calculate the change in correlations due to this event
       if(all_correlations) {
-        _clexulator().calc_delta_point_corr(sublat,
+        clexulator.calc_delta_point_corr(sublat,
                                             current_occupant,
                                             new_occupant,
                                             event.dCorr().data());
@@ -455,7 +824,7 @@ namespace CASM {
       else {
         auto begin = _eci().index().data();
         auto end = begin + _eci().index().size();
-        _clexulator().calc_restricted_delta_point_corr(sublat,
+        clexulator.calc_restricted_delta_point_corr(sublat,
                                                        current_occupant,
                                                        new_occupant,
                                                        event.dCorr().data(),
@@ -472,26 +841,26 @@ namespace CASM {
       if(all_correlations) {
 
         // Calculate before
-        _clexulator().calc_point_corr(sublat, before.data());
+        clexulator.calc_point_corr(sublat, before.data());
 
         // Apply change
         _configdof().occ(mutating_site) = new_occupant;
 
         // Calculate after
-        _clexulator().calc_point_corr(sublat, after.data());
+        clexulator.calc_point_corr(sublat, after.data());
       }
       else {
         auto begin = _eci().index().data();
         auto end = begin + _eci().index().size();
 
         // Calculate before
-        _clexulator().calc_restricted_point_corr(sublat, before.data(), begin, end);
+        clexulator.calc_restricted_point_corr(sublat, before.data(), begin, end);
 
         // Apply change
         _configdof().occ(mutating_site) = new_occupant;
 
         // Calculate after
-        _clexulator().calc_restricted_point_corr(sublat, after.data(), begin, end);
+        clexulator.calc_restricted_point_corr(sublat, after.data(), begin, end);
 
       }
 
@@ -550,7 +919,8 @@ namespace CASM {
                                       Index mutating_site,
                                       int sublat,
                                       int current_occupant,
-                                      int new_occupant) const {
+                                      int new_occupant,
+                                      Clexulator &clexulator) const {
 
     // ---- set OccMod --------------
 
@@ -567,13 +937,24 @@ namespace CASM {
     event.set_dN(new_species, 1);
 
 
-    // ---- set dcorr --------------
+    if(m_use_delta_energy) {
 
-    _set_dCorr(event, mutating_site, sublat, current_occupant, new_occupant, m_use_deltas, m_all_correlations);
+      // ---- set dformation_energy, without dcorr --------------
 
-    // ---- set dformation_energy --------------
+      clexulator.set_config_occ(_configdof().occupation().begin());
+      clexulator.set_nlist(nlist().sites(nlist().unitcell_index(mutating_site)).data());
+      event.set_dEf(clexulator.calc_delta_point_energy(sublat, current_occupant, new_occupant, m_dense_eci.data()));
+    }
+    else {
 
-    event.set_dEf(_eci() * event.dCorr().data());
+      // ---- set dcorr --------------
+
+      _set_dCorr(event, mutating_site, sublat, current_occupant, new_occupant, m_use_deltas, m_all_correlations, clexulator);
+
+      // ---- set dformation_energy --------------
+
+      event.set_dEf(_eci() * event.dCorr().data());
+    }
 
 
     // ---- set dpotential_energy --------------
@@ -582,11 +963,432 @@ namespace CASM {
 
   }
 
+  /// \brief Update event properties, using the site energy cache if enabled
+  ///
+  /// - If the change in formation energy is cached, all properties except the
+  ///   delta correlations are updated
+  ///
+  /// \returns true if the delta correlations were updated (as by _update_deltas)
+  ///
+  bool GrandCanonical::_update_energy(GrandCanonicalEvent &event,
+                                      Index mutating_site,
+                                      int sublat,
+                                      int current_occupant,
+                                      int new_occupant) const {
+
+    double dEf;
+    if(!site_energy_cache().is_enabled() ||
+       !_site_energy_cache().find(mutating_site, new_occupant, dEf)) {
+      _update_deltas(event, mutating_site, sublat, current_occupant, new_occupant, _clexulator());
+      if(site_energy_cache().is_enabled()) {
+        _site_energy_cache().insert(mutating_site, new_occupant, event.dEf());
+      }
+      return true;
+    }
+
+    event.occupational_change().set(mutating_site, sublat, new_occupant);
+
+    event.dN().setZero();
+    Index curr_species = m_site_swaps.sublat_to_mol()[sublat][current_occupant];
+    Index new_species = m_site_swaps.sublat_to_mol()[sublat][new_occupant];
+    event.set_dN(curr_species, -1);
+    event.set_dN(new_species, 1);
+
+    event.set_dEf(dEf);
+    event.set_dEpot(dEf - m_condition.exchange_chem_pot(new_species, curr_species));
+    return false;
+  }
+
+  /// \brief Number of threads to use for the low temperature expansion
+  ///
+  /// - Uses one thread if not using delta correlations, because then
+  ///   _set_dCorr temporarily changes the occupation, or in debug mode
+  Index GrandCanonical::_lte_threads() const {
+    if(!m_use_deltas || debug()) {
+      return 1;
+    }
+    return settings().lte_threads();
+  }
+
+  /// \brief Change in potential energy of each single site excitation, by
+  ///        variable site and index of the new occupant in possible_swap
+  ///
+  /// - Values found in the site energy cache are used, and the others are
+  ///   calculated in parallel, with a Clexulator per thread, and then cached
+  /// - Throws if any excitation lowers the potential energy
+  std::vector<std::vector<double> > GrandCanonical::_lte_point_dEpot() const {
+
+    const SiteExchanger &site_exch = m_site_swaps;
+    const ConfigDoF &config_dof = configdof();
+
+    // use cached values, and list the excitations that must be calculated
+    std::vector<std::vector<double> > dEpot(site_exch.variable_sites().size());
+    std::vector<std::pair<Index, Index> > todo;
+
+    for(Index exch_ind = 0; exch_ind < site_exch.variable_sites().size(); exch_ind++) {
+
+      Index mutating_site = site_exch.variable_sites()[exch_ind];
+      int sublat = site_exch.sublat()[exch_ind];
+      int current_occupant = config_dof.occ(mutating_site);
+      const auto &possible = site_exch.possible_swap()[sublat][current_occupant];
+      const auto &to_mol = site_exch.sublat_to_mol()[sublat];
+
+      dEpot[exch_ind].resize(possible.size());
+      for(Index j = 0; j < possible.size(); ++j) {
+        double dEf;
+        if(site_energy_cache().is_enabled() && _site_energy_cache().find(mutating_site, possible[j], dEf)) {
+          dEpot[exch_ind][j] = dEf - m_condition.exchange_chem_pot(to_mol[possible[j]], to_mol[current_occupant]);
+        }
+        else {
+          todo.emplace_back(exch_ind, j);
+        }
+      }
+    }
+
+    Index n_threads = _lte_threads();
+    std::vector<GrandCanonicalEvent> event(n_threads, m_event);
+    std::vector<Clexulator> clexulator(n_threads, _clexulator());
+    std::vector<double> dEf(todo.size());
+
+    parallel_for(todo.size(), n_threads, [&](Index t, Index k) {
+      Index exch_ind = todo[k].first;
+      Index mutating_site = site_exch.variable_sites()[exch_ind];
+      int sublat = site_exch.sublat()[exch_ind];
+      int current_occupant = config_dof.occ(mutating_site);
+      int new_occupant = site_exch.possible_swap()[sublat][current_occupant][todo[k].second];
+
+      _update_deltas(event[t], mutating_site, sublat, current_occupant, new_occupant, clexulator[t]);
+      dEf[k] = event[t].dEf();
+      dEpot[exch_ind][todo[k].second] = event[t].dEpot();
+    });
+
+    if(site_energy_cache().is_enabled()) {
+      for(Index k = 0; k < todo.size(); ++k) {
+        Index exch_ind = todo[k].first;
+        Index mutating_site = site_exch.variable_sites()[exch_ind];
+        int sublat = site_exch.sublat()[exch_ind];
+        int new_occupant = site_exch.possible_swap()[sublat][config_dof.occ(mutating_site)][todo[k].second];
+        _site_energy_cache().insert(mutating_site, new_occupant, dEf[k]);
+      }
+    }
+
+    for(const auto &site_dEpot : dEpot) {
+      for(double dpot_nrg : site_dEpot) {
+        if(dpot_nrg < 0.0) {
+          Log &err_log = default_err_log();
+          err_log.error<Log::standard>("Calculating low temperature expansion");
+          err_log << "  Defect lowered the potential energy. Your motif configuration "
+                  << "is not the 0K ground state.\n" << std::endl;
+          throw std::runtime_error("Error calculating low temperature expansion. Not in the ground state.");
+        }
+      }
+    }
+
+    return dEpot;
+  }
+
+  /// \brief Symmetrically distinct pairs of interacting variable sites
+  ///
+  /// - Pairs of variable sites i < j, with either site in the neighborhood of
+  ///   the unit cell containing the other, are grouped into orbits using the operations of the
+  ///   supercell factor group that leave the current configuration unchanged
+  /// - Each pair is mapped to a canonical form: the first site is mapped to the
+  ///   minimum site in its orbit, and then the second site is mapped to its
+  ///   minimum under the stabilizer of the first site
+  /// - Returns one pair per orbit, with the number of pairs in the orbit
+  std::vector<GrandCanonical::LTEPair> GrandCanonical::lte_pairs() const {
+
+    const std::vector<Index> &variable_sites = m_site_swaps.variable_sites();
+    std::vector<PermuteIterator> fg = config().factor_group();
+
+    // variable site index of each site, or -1
+    std::vector<Index> exch_index(supercell().num_sites(), -1);
+    for(Index i = 0; i < variable_sites.size(); ++i) {
+      exch_index[variable_sites[i]] = i;
+    }
+
+    // minimum site in the orbit of each variable site, and an operation mapping it there
+    std::vector<Index> orbit_min(variable_sites.size());
+    std::vector<Index> to_min(variable_sites.size());
+    std::map<Index, std::vector<Index> > stabilizer;
+    for(Index i = 0; i < variable_sites.size(); ++i) {
+      orbit_min[i] = variable_sites[i];
+      to_min[i] = -1;
+      for(Index g = 0; g < fg.size(); ++g) {
+        Index l = fg[g].permute_ind(variable_sites[i]);
+        if(l <= orbit_min[i]) {
+          orbit_min[i] = l;
+          to_min[i] = g;
+        }
+      }
+      stabilizer[orbit_min[i]];
+    }
+    for(auto &value : stabilizer) {
+      for(Index g = 0; g < fg.size(); ++g) {
+        if(fg[g].permute_ind(value.first) == value.first) {
+          value.second.push_back(g);
+        }
+      }
+    }
+
+    // canonical form of a pair, with site 'i' first
+    auto canonical = [&](Index i, Index j) {
+      Index l = fg[to_min[i]].permute_ind(variable_sites[j]);
+      Index min_l = l;
+      for(Index h : stabilizer[orbit_min[i]]) {
+        min_l = std::min(min_l, fg[h].permute_ind(l));
+      }
+      return std::make_pair(orbit_min[i], min_l);
+    };
+
+    // interacting pairs, whichever site's neighborhood includes the other
+    std::vector<std::pair<Index, Index> > site_pairs;
+    for(Index i = 0; i < variable_sites.size(); ++i) {
+      for(Index l : nlist().sites(nlist().unitcell_index(variable_sites[i]))) {
+        Index j = exch_index[l];
+        if(j >= 0 && j != i) {
+          site_pairs.push_back(std::make_pair(std::min(i, j), std::max(i, j)));
+        }
+      }
+    }
+    std::sort(site_pairs.begin(), site_pairs.end());
+    site_pairs.erase(std::unique(site_pairs.begin(), site_pairs.end()), site_pairs.end());
+
+    std::vector<LTEPair> pairs;
+    std::map<std::pair<Index, Index>, Index> pair_index;
+    for(const auto &ij : site_pairs) {
+      Index i = ij.first;
+      Index j = ij.second;
+      auto key = std::min(canonical(i, j), canonical(j, i));
+      auto res = pair_index.insert(std::make_pair(key, pairs.size()));
+      if(res.second) {
+        pairs.push_back(LTEPair {i, j, 1});
+      }
+      else {
+        pairs[res.first->second].multiplicity++;
+      }
+    }
+
+    return pairs;
+  }
+
+  /// \brief Check that the bias potential can be used with the requested method
+  ///
+  /// - The bias potential is only applied in 'check', so it requires the
+  ///   Metropolis method without parallel sweeps
+  /// - If not calculating all correlations, the order parameter may only include
+  ///   correlations with non-zero ECI, because only those are updated by events
+  void GrandCanonical::_bias_construct(const GrandCanonicalSettings &settings) {
+
+    m_bias = settings.bias_potential(_clexulator().corr_size());
+
+    if(settings.method() != Monte::METHOD::Metropolis || m_rejection_free) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"bias\" requires the Metropolis method.");
+    }
+    if(m_checkerboard) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"bias\" may not be used with \"parallel_sweep\".");
+    }
+    if(!m_all_correlations) {
+      for(const auto &w : m_bias.weights()) {
+        if(find_index(_eci().index(), w.first) == _eci().index().size()) {
+          throw std::runtime_error(
+            "Error in GrandCanonical: \"bias\" order parameter includes correlation " +
+            std::to_string(w.first) + ", which has zero ECI, so \"all_correlations\" must be sampled.");
+        }
+      }
+    }
+
+    _log().construct("Bias potential");
+    _log() << "order parameter: ";
+    for(const auto &w : m_bias.weights()) {
+      _log() << " " << w.second << "*corr(" << w.first << ")";
+    }
+    _log() << "\n" << std::endl;
+  }
+
+  /// \brief Decide whether to calculate changes in energy without delta correlations
+  ///
+  /// - The change in formation energy is calculated with
+  ///   Clexulator::calc_delta_point_energy if delta correlations are not needed:
+  ///   correlations are not sampled, only correlations with non-zero ECI are
+  ///   calculated, no bias potential is used, and not in debug mode
+  /// - Then the "corr" property is not updated by events
+  void GrandCanonical::_delta_energy_construct() {
+
+    m_use_delta_energy = m_use_deltas &&
+                         !m_all_correlations &&
+                         !m_bias.is_active() &&
+                         !debug() &&
+                         _clexulator().has_delta_point_energy();
+
+    for(auto it = samplers().cbegin(); it != samplers().cend(); ++it) {
+      if(it->first.compare(0, 5, "corr(") == 0) {
+        m_use_delta_energy = false;
+      }
+    }
+
+    if(m_use_delta_energy) {
+      m_dense_eci = Eigen::VectorXd::Zero(_clexulator().corr_size());
+      for(Index i = 0; i < _eci().index().size(); ++i) {
+        m_dense_eci(_eci().index()[i]) = _eci().value()[i];
+      }
+    }
+
+    _log() << "use_delta_energy: " << std::boolalpha << m_use_delta_energy << "\n" << std::endl;
+  }
+
+  /// \brief Construct the cache of single site energy changes
+  ///
+  /// - The change in formation energy is cached, so changing conditions does
+  ///   not invalidate the cache
+  /// - Parallel sweeps change sites without invalidating the cache, and the
+  ///   bias potential requires delta correlations for every proposed event
+  void GrandCanonical::_site_energy_cache_construct() {
+
+    if(m_checkerboard) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"site_energy_cache\" may not be used with \"parallel_sweep\".");
+    }
+    if(m_bias.is_active()) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"site_energy_cache\" may not be used with \"bias\".");
+    }
+    if(debug()) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"site_energy_cache\" may not be used in debug mode.");
+    }
+
+    Index max_occ = 0;
+    for(const auto &site : primclex().get_prim().basis) {
+      max_occ = std::max(max_occ, Index(site.site_occupant().size()));
+    }
+    _site_energy_cache() = Monte::SiteEnergyCache(supercell(), _clexulator(), max_occ);
+
+    _log().construct("Site energy cache");
+    _log() << "values: " << supercell().num_sites() * max_occ << "\n";
+    _log() << "memory (MB): " << site_energy_cache().memory() / (1024.0 * 1024.0) << "\n" << std::endl;
+  }
+
+  /// \brief Construct data structures for the rejection-free method
+  void GrandCanonical::_rf_construct() {
+
+    if(!m_use_deltas) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"rejection_free\" requires a supercell large enough to use delta correlations.");
+    }
+    if(m_checkerboard) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"rejection_free\" may not be used with \"parallel_sweep\".");
+    }
+    if(debug()) {
+      throw std::runtime_error(
+        "Error in GrandCanonical: \"rejection_free\" may not be used in debug mode.");
+    }
+
+    const auto &variable_sites = m_site_swaps.variable_sites();
+    Index volume = supercell().volume();
+
+    m_rf_max_cand = 0;
+    m_rf_uc_sites.assign(volume, std::vector<Index>());
+    for(Index i = 0; i < variable_sites.size(); ++i) {
+      for(const auto &possible : m_site_swaps.possible_swap()[m_site_swaps.sublat()[i]]) {
+        m_rf_max_cand = std::max(m_rf_max_cand, Index(possible.size()));
+      }
+      m_rf_uc_sites[nlist().unitcell_index(variable_sites[i])].push_back(i);
+    }
+
+    m_rf_affected_uc.assign(volume, std::vector<Index>());
+    for(Index uc = 0; uc < volume; ++uc) {
+      for(const auto &nuc : nlist().unitcells(uc)) {
+        m_rf_affected_uc[nuc].push_back(uc);
+      }
+    }
+
+    m_rf_site_rate.resize(variable_sites.size());
+    m_rf_rate.assign(variable_sites.size() * m_rf_max_cand, 0.0);
+
+    _log().construct("Rejection-free method");
+    _log() << "events: " << m_rf_rate.size() << "\n" << std::endl;
+  }
+
+  /// \brief Calculate the rates of all events and select the next event
+  void GrandCanonical::_rf_initialize() {
+    for(Index i = 0; i < m_site_swaps.variable_sites().size(); ++i) {
+      _rf_update_site(i);
+    }
+    _rf_select();
+  }
+
+  /// \brief Calculate the rates of all events on variable site 'i'
+  ///
+  /// - The rate of an event is the probability that a Metropolis step proposes
+  ///   and accepts it: 1/(N_site*N_cand) * min(1, exp(-beta*dEpot))
+  void GrandCanonical::_rf_update_site(Index i) {
+
+    Index mutating_site = m_site_swaps.variable_sites()[i];
+    Index sublat = m_site_swaps.sublat()[i];
+    int current_occupant = configdof().occ(mutating_site);
+    const std::vector<int> &possible_mutation = m_site_swaps.possible_swap()[sublat][current_occupant];
+
+    double norm = 1.0 / (steps_per_pass() * possible_mutation.size());
+    double beta = m_condition.beta();
+    double *rate = m_rf_rate.data() + i * m_rf_max_cand;
+    double site_rate = 0.0;
+
+    for(Index j = 0; j < possible_mutation.size(); ++j) {
+      _update_energy(m_event, mutating_site, sublat, current_occupant, possible_mutation[j]);
+      rate[j] = (m_event.dEpot() < 0.0 ? 1.0 : exp(-m_event.dEpot() * beta)) * norm;
+      site_rate += rate[j];
+    }
+    m_rf_site_rate.set(i, site_rate);
+  }
+
+  /// \brief Select the next event and the number of steps rejected before it
+  ///
+  /// - The event is selected with probability proportional to its rate
+  /// - The number of rejected steps is geometrically distributed, with the
+  ///   probability of acceptance per step equal to the total rate
+  void GrandCanonical::_rf_select() {
+
+    double total_rate = m_rf_site_rate.sum();
+    if(!(total_rate > 0.0)) {
+      m_rf_rejections = std::numeric_limits<Index>::max();
+      return;
+    }
+
+    m_rf_site = m_rf_site_rate.find(_mtrand().rand53() * total_rate);
+
+    const double *rate = m_rf_rate.data() + m_rf_site * m_rf_max_cand;
+    Index sublat = m_site_swaps.sublat()[m_rf_site];
+    int current_occupant = configdof().occ(m_site_swaps.variable_sites()[m_rf_site]);
+    Index n_cand = m_site_swaps.possible_swap()[sublat][current_occupant].size();
+    double target = _mtrand().rand53() * m_rf_site_rate.value(m_rf_site);
+    m_rf_cand = 0;
+    while(m_rf_cand < n_cand - 1 && target >= rate[m_rf_cand]) {
+      target -= rate[m_rf_cand];
+      ++m_rf_cand;
+    }
+
+    if(total_rate >= 1.0) {
+      m_rf_rejections = 0;
+      return;
+    }
+    double rejections = std::floor(std::log(1.0 - _mtrand().rand53()) / std::log1p(-total_rate));
+    if(rejections >= static_cast<double>(std::numeric_limits<Index>::max())) {
+      m_rf_rejections = std::numeric_limits<Index>::max();
+    }
+    else {
+      m_rf_rejections = static_cast<Index>(rejections);
+    }
+  }
+
   /// \brief Calculate properties given current conditions
   void GrandCanonical::_update_properties() {
 
     // initialize properties and store pointers to the data strucures
-    _vector_properties()["corr"] = correlations_vec(_configdof(), supercell(), _clexulator());
+    _vector_properties()["corr"] = correlations_vec(_configdof(), supercell(), _clexulator(), corr_threads());
     m_corr = &_vector_property("corr");
 
     _vector_properties()["comp_n"] = CASM::comp_n(_configdof(), supercell());
@@ -598,6 +1400,14 @@ namespace CASM {
     _scalar_properties()["potential_energy"] = formation_energy() - primclex().composition_axes().param_composition(comp_n()).dot(m_condition.param_chem_pot());
     m_potential_energy = &_scalar_property("potential_energy");
 
+    if(m_bias.is_active()) {
+      _scalar_properties()["order_parameter"] = m_bias.order_parameter(corr());
+      m_order_parameter = &_scalar_property("order_parameter");
+
+      _scalar_properties()["bias_energy"] = m_bias.value(*m_order_parameter);
+      m_bias_energy = &_scalar_property("bias_energy");
+    }
+
     if(debug()) {
 
       _print_correlations(corr(), "correlations", "corr", m_all_correlations);
@@ -628,6 +1438,10 @@ namespace CASM {
              << "potential_energy: " << potential_energy() << "\n" << std::endl;
     }
 
+    if(m_rejection_free) {
+      _rf_initialize();
+    }
+
   }
 
   /// \brief Generate supercell filling ConfigDoF from default configuration
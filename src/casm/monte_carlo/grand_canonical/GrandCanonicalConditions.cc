@@ -132,6 +132,18 @@ namespace CASM {
     return GrandCanonicalConditions(*this) -= RHS;
   }
 
+  ///Multiply temperature and all chemical potentials of *this by a factor
+  GrandCanonicalConditions &GrandCanonicalConditions::operator*=(double factor) {
+    m_temperature *= factor;
+    set_param_chem_pot(m_param_chem_pot * factor);
+    m_beta = 1.0 / (CASM::KB * m_temperature);
+    return *this;
+  }
+
+  GrandCanonicalConditions GrandCanonicalConditions::operator*(double factor) const {
+    return GrandCanonicalConditions(*this) *= factor;
+  }
+
   bool GrandCanonicalConditions::operator==(const GrandCanonicalConditions &RHS) const {
     if(!almost_zero(m_temperature - RHS.m_temperature, m_tolerance)) {
       return false;
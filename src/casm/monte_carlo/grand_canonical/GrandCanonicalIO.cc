@@ -1,9 +1,13 @@
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalIO.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 #include "casm/CASM_global_definitions.hh"
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
 #include "casm/monte_carlo/MonteIO_impl.hh"
+#include "casm/monte_carlo/ThermoIntegration.hh"
 
 namespace CASM {
 
@@ -94,6 +98,15 @@ namespace CASM {
     // include heat_capacity
     formatter.push_back(MonteCarloHeatCapacityFormatter<GrandCanonical>());
 
+    // include unbiased means, if using a bias potential
+    if(mc.bias().is_active()) {
+      for(auto it = mc.samplers().cbegin(); it != mc.samplers().cend(); ++it) {
+        if(it->first != "bias_energy") {
+          formatter.push_back(MonteCarloUnbiasedMeanFormatter<GrandCanonical>(it->first));
+        }
+      }
+    }
+
     // include susc_x
     for(int i = 0; i < mc.primclex().composition_axes().independent_compositions(); i++) {
       for(int j = i; j < mc.primclex().composition_axes().independent_compositions(); j++) {
@@ -140,6 +153,7 @@ namespace CASM {
   /// Output data is:
   /// - T
   /// - phi_LTE
+  /// - phi_LTE2, if 'phi_LTE2' is not null
   /// - Beta
   /// - configname
   /// - gs_potential_energy
@@ -153,7 +167,7 @@ namespace CASM {
   /// { "key0":[...], "key1":[...], ... }
   /// \endcode
   ///
-  DataFormatter<ConstMonteCarloPtr> make_lte_results_formatter(const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname) {
+  DataFormatter<ConstMonteCarloPtr> make_lte_results_formatter(const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname, const double *phi_LTE2) {
 
     DataFormatter<ConstMonteCarloPtr> formatter;
 
@@ -161,6 +175,9 @@ namespace CASM {
     formatter.push_back(ConstantValueFormatter<std::string, ConstMonteCarloPtr>("configname", configname, print_json));
     formatter.push_back(MonteCarloTFormatter<GrandCanonical>());
     formatter.push_back(GrandCanonicalLTEFormatter(phi_LTE1));
+    if(phi_LTE2) {
+      formatter.push_back(GrandCanonicalLTE2Formatter(*phi_LTE2));
+    }
     std::set<std::string> exclude;
     std::string name;
 
@@ -274,13 +291,21 @@ namespace CASM {
     return GenericDatumFormatter<double, ConstMonteCarloPtr>("phi_LTE", "phi_LTE", evaluator);
   }
 
+  /// \brief Print LTE including pair excitations
+  GenericDatumFormatter<double, ConstMonteCarloPtr> GrandCanonicalLTE2Formatter(const double &phi_LTE2) {
+    auto evaluator = [ = ](const ConstMonteCarloPtr & mc) {
+      return phi_LTE2;
+    };
+    return GenericDatumFormatter<double, ConstMonteCarloPtr>("phi_LTE2", "phi_LTE2", evaluator);
+  }
+
   /// \brief Will create new file or append to existing results file the results of the latest run
-  void write_lte_results(const MonteSettings &settings, const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname, Log &_log) {
+  void write_lte_results(const MonteSettings &settings, const GrandCanonical &mc, const double &phi_LTE1, const std::string &configname, Log &_log, const double *phi_LTE2) {
     try {
 
       fs::create_directories(settings.output_directory());
       MonteCarloDirectoryStructure dir(settings.output_directory());
-      auto formatter = make_lte_results_formatter(mc, phi_LTE1, configname);
+      auto formatter = make_lte_results_formatter(mc, phi_LTE1, configname, phi_LTE2);
 
       // write csv path results
       if(settings.write_csv()) {
@@ -324,4 +349,252 @@ namespace CASM {
     }
 
   }
+
+  namespace {
+
+    /// \brief Results summary column, using the unbiased mean if there is one
+    std::string _unbiased_column(const jsonParser &results, const std::string &name) {
+      std::string unbiased = std::string("unbiased(") + name + ")";
+      return results.contains(unbiased) ? unbiased : name;
+    }
+
+    /// \brief Compare values that have been written to and read from JSON
+    bool _same_value(double a, double b) {
+      return std::abs(a - b) <= 1e-8 * std::max(1.0, std::abs(b));
+    }
+
+    /// \brief Grand canonical free energy, per unit cell, at the first conditions along the path
+    double _free_energy_anchor(PrimClex &primclex,
+                               const GrandCanonicalSettings &settings,
+                               const MonteCarloDirectoryStructure &dir,
+                               Index cond_index,
+                               const Monte::ThermoIntegrationPoint &point,
+                               Log &_log) {
+
+      std::string type = settings.free_energy_anchor();
+      double phi;
+
+      if(type == "value") {
+        phi = settings.free_energy_anchor_value();
+      }
+      else if(type == "high_temperature") {
+        double ln_omega = 0.0;
+        const auto &prim = primclex.get_prim();
+        for(Index b = 0; b < prim.basis.size(); ++b) {
+          ln_omega += std::log(prim.basis[b].site_occupant().size());
+        }
+        phi = Monte::high_temperature_phi(point, ln_omega);
+      }
+      else {
+        if(!settings.is_motif_configname() ||
+           (settings.motif_configname() != "auto" &&
+            settings.motif_configname() != "restricted_auto")) {
+          throw std::invalid_argument("Error integrating free energy: \"anchor\": \"lte\" must use one of\n"
+                                      "  \"driver\"/\"motif\"/\"configname\": \"auto\"\n"
+                                      "  \"driver\"/\"motif\"/\"configname\": \"restricted_auto\"");
+        }
+        GrandCanonicalConditions cond;
+        from_json(cond, primclex, jsonParser(dir.conditions_json(cond_index)));
+        GrandCanonical gc(primclex, settings, _log);
+        gc.set_state(cond, settings);
+        phi = (settings.lte_order() == 2) ?
+              gc.lte2_grand_canonical_free_energy() :
+              gc.lte_grand_canonical_free_energy();
+      }
+
+      _log << "anchor: " << type << ", conditions " << cond_index
+           << ", phi: " << std::setprecision(12) << phi << "\n" << std::endl;
+      return phi;
+    }
+  }
+
+  /// \brief Integrate the grand canonical free energy along the path of conditions in the results summary
+  ///
+  /// - Reads "results.json" and, for the adaptive drive mode, "adaptive.json",
+  ///   which orders the conditions along the path
+  /// - Integrates d(Beta*phi) = <potential_energy> dBeta - Beta*<comp(x)> dparam_chem_pot(x),
+  ///   starting from the anchor given by "driver"/"free_energy", using
+  ///   unbiased means if a bias potential was used
+  /// - Writes "free_energy.json" (and "free_energy.csv", if requested) with phi,
+  ///   the grand canonical free energy per unit cell, up to the first
+  ///   conditions that were not equilibrated
+  /// - If "free_energy.json" exists, values are kept for the conditions along the
+  ///   path whose results are unchanged, and integration continues from the last
+  ///   of them, so a restarted or extended run only integrates new conditions.
+  ///   Observation files are not read.
+  ///
+  void write_free_energy(PrimClex &primclex, const GrandCanonicalSettings &settings, Log &_log) {
+
+    MonteCarloDirectoryStructure dir(settings.output_directory());
+    if(!fs::exists(dir.results_json())) {
+      throw std::runtime_error(
+        std::string("Error integrating free energy: no results at ") + dir.results_json().string() + "\n" +
+        "  Requires [\"data\"][\"storage\"][\"output_format\"] to include \"json\".");
+    }
+
+    _log.custom("Free energy integration");
+    _log << "read: " << dir.results_json() << "\n";
+    jsonParser results(dir.results_json());
+
+    Index Nparam = primclex.composition_axes().independent_compositions();
+    std::string E_col = _unbiased_column(results, "<potential_energy>");
+    std::vector<std::string> mu_col;
+    std::vector<std::string> x_col;
+    for(Index k = 0; k < Nparam; ++k) {
+      std::string var = CompositionConverter::comp_var(k);
+      mu_col.push_back(std::string("param_chem_pot(") + var + ")");
+      x_col.push_back(_unbiased_column(results, std::string("<comp(") + var + ")>"));
+    }
+
+    std::vector<std::string> col {"T", "Beta"};
+    col.insert(col.end(), mu_col.begin(), mu_col.end());
+    col.push_back(E_col);
+    col.insert(col.end(), x_col.begin(), x_col.end());
+    for(const auto &name : col) {
+      if(!results.contains(name)) {
+        throw std::runtime_error(
+          std::string("Error integrating free energy: \"") + name + "\" is not in the results summary.");
+      }
+    }
+
+    // conditions and mean properties, by condition index
+    Index N = results["T"].size();
+    std::vector<Monte::ThermoIntegrationPoint> point(N);
+    std::vector<bool> valid(N);
+    for(Index i = 0; i < N; ++i) {
+      Monte::ThermoIntegrationPoint &p = point[i];
+      valid[i] = results[E_col][i].is_number();
+      p.beta = results["Beta"][i].get<double>();
+      p.param_chem_pot.resize(Nparam);
+      p.comp.resize(Nparam);
+      for(Index k = 0; k < Nparam; ++k) {
+        p.param_chem_pot(k) = results[mu_col[k]][i].get<double>();
+        valid[i] = valid[i] && results[x_col[k]][i].is_number();
+      }
+      if(valid[i]) {
+        p.potential_energy = results[E_col][i].get<double>();
+        for(Index k = 0; k < Nparam; ++k) {
+          p.comp(k) = results[x_col[k]][i].get<double>();
+        }
+      }
+    }
+
+    // order of conditions along the path
+    std::vector<Index> order;
+    if(settings.drive_mode() == Monte::DRIVE_MODE::ADAPTIVE) {
+      std::vector<double> param;
+      if(fs::exists(dir.adaptive_json())) {
+        jsonParser adaptive(dir.adaptive_json());
+        for(Index i = 0; i < adaptive["param"].size(); ++i) {
+          param.push_back(adaptive["param"][i].get<double>());
+        }
+      }
+      for(Index i = 0; i < std::min(N, Index(param.size())); ++i) {
+        order.push_back(i);
+      }
+      std::stable_sort(order.begin(), order.end(), [&](Index a, Index b) {
+        return param[a] < param[b];
+      });
+    }
+    else {
+      for(Index i = 0; i < N; ++i) {
+        order.push_back(i);
+      }
+    }
+
+    jsonParser anchor = jsonParser::object();
+    anchor["type"] = settings.free_energy_anchor();
+    if(settings.free_energy_anchor() == "value") {
+      anchor["value"] = settings.free_energy_anchor_value();
+    }
+    else if(settings.free_energy_anchor() == "lte") {
+      anchor["order"] = settings.lte_order();
+    }
+
+    // keep existing values for unchanged results
+    std::vector<double> phi;
+    if(fs::exists(dir.free_energy_json())) {
+      jsonParser prev(dir.free_energy_json());
+      if(prev.contains("anchor") && prev["anchor"] == anchor && prev.contains("phi")) {
+        const jsonParser &prev_index = prev["conditions_index"];
+        auto same = [&](const std::string & name, Index k, double value) {
+          return prev.contains(name) && _same_value(prev[name][k].get<double>(), value);
+        };
+        while(phi.size() < order.size() && phi.size() < prev_index.size()) {
+          Index k = phi.size();
+          Index i = order[k];
+          const Monte::ThermoIntegrationPoint &p = point[i];
+          bool match = valid[i] &&
+                       prev_index[k].get<Index>() == i &&
+                       same("Beta", k, p.beta) &&
+                       same(E_col, k, p.potential_energy);
+          for(Index j = 0; j < Nparam; ++j) {
+            match = match && same(mu_col[j], k, p.param_chem_pot(j)) && same(x_col[j], k, p.comp(j));
+          }
+          if(!match) {
+            break;
+          }
+          phi.push_back(prev["phi"][k].get<double>());
+        }
+      }
+    }
+
+    Monte::ThermoIntegration integration;
+    if(phi.size()) {
+      _log << "continue from " << dir.free_energy_json() << ", "
+           << phi.size() << " of " << order.size() << " conditions\n" << std::endl;
+      integration.anchor(point[order[phi.size() - 1]], phi.back());
+    }
+
+    while(phi.size() < order.size()) {
+      Index i = order[phi.size()];
+      if(!valid[i]) {
+        _log << "conditions " << i << " are not equilibrated, stopping integration\n" << std::endl;
+        break;
+      }
+      if(integration.empty()) {
+        phi.push_back(integration.anchor(point[i], _free_energy_anchor(primclex, settings, dir, i, point[i], _log)));
+      }
+      else {
+        phi.push_back(integration.add(point[i]));
+      }
+    }
+
+    jsonParser json = jsonParser::object();
+    json["anchor"] = anchor;
+    json["conditions_index"].put_array();
+    for(const auto &name : col) {
+      json[name].put_array();
+    }
+    json["phi"].put_array();
+    for(Index k = 0; k < phi.size(); ++k) {
+      json["conditions_index"].push_back(order[k]);
+      for(const auto &name : col) {
+        json[name].push_back(results[name][order[k]]);
+      }
+      json["phi"].push_back(phi[k]);
+    }
+
+    _log << "write: " << dir.free_energy_json() << "\n";
+    json.write(dir.free_energy_json());
+
+    if(settings.write_csv()) {
+      _log << "write: " << dir.free_energy_csv() << "\n";
+      fs::ofstream sout(dir.free_energy_csv());
+      sout << "# conditions_index";
+      for(const auto &name : col) {
+        sout << " " << name;
+      }
+      sout << " phi\n";
+      sout << std::setprecision(12);
+      for(Index k = 0; k < phi.size(); ++k) {
+        sout << order[k];
+        for(const auto &name : col) {
+          sout << " " << results[name][order[k]].get<double>();
+        }
+        sout << " " << phi[k] << "\n";
+      }
+    }
+    _log << std::endl;
+  }
 }
@@ -1,6 +1,8 @@
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalSettings.hh"
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalConditions.hh"
 #include "casm/monte_carlo/grand_canonical/GrandCanonicalIO.hh"
+#include "casm/monte_carlo/Conversions.hh"
+#include "casm/monte_carlo/OccEventSpec.hh"
 #include "casm/app/AppIO.hh"
 
 namespace CASM {
@@ -33,7 +35,7 @@ namespace CASM {
 
   /// \brief Expects initial_conditions
   GrandCanonicalConditions GrandCanonicalSettings::initial_conditions() const {
-    if(drive_mode() == Monte::DRIVE_MODE::INCREMENTAL) {
+    if(drive_mode() == Monte::DRIVE_MODE::INCREMENTAL || drive_mode() == Monte::DRIVE_MODE::ADAPTIVE) {
       return _conditions("initial_conditions");
     }
     else if(drive_mode() == Monte::DRIVE_MODE::CUSTOM) {
@@ -127,6 +129,27 @@ namespace CASM {
   // --- Sampler settings ---------------------
 
   /// \brief Return true if all correlations should be sampled
+  /// \brief Return true if multi-site events are specified
+  bool GrandCanonicalSettings::is_occ_event_spec() const {
+    return _is_setting("model", "events");
+  }
+
+  /// \brief Multi-site events, from ["model"]["events"]
+  std::vector<Monte::OccEventSpec> GrandCanonicalSettings::occ_event_spec(const Monte::Conversions &convert) const {
+    std::string help = "JSON array (optional)\n"
+                       "  Occupation changes that must occur together. Ex:\n"
+                       "  [{\"name\": \"reduction\", \"sites\": [\n"
+                       "    {\"sublats\": [0], \"from\": \"Ce4\", \"to\": \"Ce3\"},\n"
+                       "    {\"sublats\": [0], \"from\": \"Ce4\", \"to\": \"Ce3\"},\n"
+                       "    {\"sublats\": [1], \"from\": \"O\", \"to\": \"Va\"}]}]\n";
+    jsonParser json = _get_setting<jsonParser>("model", "events", help);
+    std::vector<Monte::OccEventSpec> spec;
+    for(const auto &event : json) {
+      spec.push_back(event.get<Monte::OccEventSpec>(convert));
+    }
+    return spec;
+  }
+
   bool GrandCanonicalSettings::all_correlations() const {
     if(method() == Monte::METHOD::LTE1) { //hack
       return false;
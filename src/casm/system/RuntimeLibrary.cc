@@ -1,5 +1,7 @@
 #include "casm/system/RuntimeLibrary.hh"
 #include "casm/casm_io/Log.hh"
+#include "casm/system/RuntimeLibraryCache.hh"
+#include "casm/misc/parallel.hh"
 
 namespace CASM {
 
@@ -16,28 +18,77 @@ namespace CASM {
     m_so_options(so_options),
     m_handle(nullptr) {
 
+    _init(compile_msg, nullptr);
+  }
+
+  /// \brief Construct a RuntimeLibrary object, using 'cache' instead of
+  ///        compiling if the '.so' file does not exist
+  ///
+  /// - If '_filename_base.so' is a link into 'cache', the cached library is loaded
+  /// - Else, if '_filename_base.so' exists, it is loaded
+  /// - Else, '_filename_base.cc' is loaded from 'cache', and compiled into the
+  ///   cache if necessary. Only a link to the cached library, '_filename_base.so',
+  ///   is written next to the source code.
+  /// - If the cache can not be used, '_filename_base.cc' is compiled as if
+  ///   no cache were given
+  ///
+  RuntimeLibrary::RuntimeLibrary(std::string filename_base,
+                                 std::string compile_options,
+                                 std::string so_options,
+                                 std::string compile_msg,
+                                 const RuntimeLibraryCache &cache,
+                                 const Logging &logging) :
+    Logging(logging),
+    m_filename_base(filename_base),
+    m_compile_options(compile_options),
+    m_so_options(so_options),
+    m_handle(nullptr) {
+
+    _init(compile_msg, &cache);
+  }
+
+  /// \brief Load the '.so' file, compiling it or using the cache if necessary
+  void RuntimeLibrary::_init(std::string compile_msg, const RuntimeLibraryCache *cache) {
+
+    auto load = [&](const fs::path & so_path) {
+      _load(so_path.string());
+    };
+
+    // If the shared library is a link into the cache
+    if(cache != nullptr && cache->load_link(m_filename_base + ".so", load)) {
+      log().custom<Log::standard>("Using cached library", m_filename_base + ".cc");
+      log() << "cache: " << cache->dir() << "\n" << std::endl;
+      return;
+    }
+
     // If the shared library doesn't exist
     if(!fs::exists(m_filename_base + ".so")) {
 
+      // remove any link to a library that was removed from a cache
+      fs::remove(m_filename_base + ".so");
+
       // But the library source code does
       if(fs::exists(m_filename_base + ".cc")) {
 
-        // Compile it
-        log().compiling<Log::standard>(m_filename_base + ".cc");
-        log().begin_lap();
-        log() << compile_msg << std::endl;
-        try {
-          _compile();
-        }
-        catch(std::exception &e) {
-          log() << "Error compiling clexulator. To fix: \n";
-          log() << "  - Check compiler error messages.\n";
-          log() << "  - Check compiler options with 'casm settings -l'\n";
-          log() << "    - Update compiler options with 'casm settings --set-compile-options '...options...'\n";
-          log() << "    - Make sure the casm headers can be found by including '-I/path/to/casm'\n";
-          throw;
+        if(cache != nullptr && cache->enabled()) {
+          bool compiled = false;
+          auto compile = [&](const fs::path & out_base) {
+            _compile(out_base.string(), compile_msg);
+            compiled = true;
+          };
+
+          if(cache->load(m_filename_base + ".cc", m_compile_options, m_so_options, compile, load)) {
+            if(!compiled) {
+              log().custom<Log::standard>("Using cached library", m_filename_base + ".cc");
+              log() << "cache: " << cache->dir() << "\n" << std::endl;
+            }
+            return;
+          }
+          log() << "Could not use cache: " << cache->dir() << std::endl;
         }
-        log() << "compile time: " << log().lap_time() << " (s)\n" << std::endl;
+
+        // Compile it
+        _compile(m_filename_base, compile_msg);
       }
       else {
         throw std::runtime_error(
@@ -50,7 +101,7 @@ namespace CASM {
     if(fs::exists(m_filename_base + ".so")) {
 
       // Load the library with the Clexulator
-      _load();
+      _load(m_filename_base + ".so");
 
     }
     else {
@@ -67,50 +118,131 @@ namespace CASM {
     }
   }
 
+  /// \brief Compile a shared library, with messages
+  ///
+  /// Prints 'compile_msg' and the compile time, or hints for fixing the
+  /// compiler settings if compiling fails.
+  ///
+  void RuntimeLibrary::_compile(std::string out_base, std::string compile_msg) {
+    log().compiling<Log::standard>(m_filename_base + ".cc");
+    log().begin_lap();
+    log() << compile_msg << std::endl;
+    try {
+      _compile(out_base);
+    }
+    catch(std::exception &e) {
+      log() << "Error compiling clexulator. To fix: \n";
+      log() << "  - Check compiler error messages.\n";
+      log() << "  - Check compiler options with 'casm settings -l'\n";
+      log() << "    - Update compiler options with 'casm settings --set-compile-options '...options...'\n";
+      log() << "    - Make sure the casm headers can be found by including '-I/path/to/casm'\n";
+      throw;
+    }
+    log() << "compile time: " << log().lap_time() << " (s)\n" << std::endl;
+  }
+
   /// \brief Compile a shared library
   ///
-  /// \param _filename_base Base name for the source code file. For example, "/path/to/hello" looks for "/path/to/hello.cc",
-  ///        and compile "/path/to/hello.o" and "/path/to/hello.so".
+  /// \param out_base Base name for the compiled files. For example, "/path/to/hello" compiles
+  ///        "/path/to/hello.o" and "/path/to/hello.so".
   ///
   /// \result Compiles file "/path/to/hello.cc" into an object file and shared library using the options
-  ///         provided when this RuntimeLibrary object was constructed. By default, "example.o" and "example.so".
+  ///         provided when this RuntimeLibrary object was constructed.
+  ///
+  /// If the source code is sharded, the shards are compiled in parallel, using up to
+  /// default_compile_jobs() processes, into "/path/to/hello.shard_0.o", etc., which
+  /// are removed after linking.
   ///
   /// To enable runtime symbol lookup use C-style functions, i.e use extern "C" for functions you want to use
   /// via get_function.  This means no member functions or overloaded functions.
   ///
-  void RuntimeLibrary::_compile() {
+  void RuntimeLibrary::_compile(std::string out_base) {
+
+    // compile the source code, or each shard of it, into object files
+    Index n_shards = _n_shards();
+    std::vector<std::string> obj(n_shards), cmd(n_shards), out(n_shards);
+    std::vector<int> exit_code(n_shards);
+    for(Index k = 0; k < n_shards; ++k) {
+      if(n_shards == 1) {
+        obj[k] = out_base + ".o";
+        cmd[k] = m_compile_options + " -o " + obj[k] + " -c " + m_filename_base + ".cc";
+      }
+      else {
+        obj[k] = out_base + ".shard_" + std::to_string(k) + ".o";
+        cmd[k] = m_compile_options + " -DRUNTIME_LIBRARY_SHARD=" + std::to_string(k) +
+                 " -o " + obj[k] + " -c " + m_filename_base + ".cc";
+      }
+    }
+
+    Index n_jobs = std::min(default_compile_jobs().first, n_shards);
+    parallel_for(n_shards, n_jobs, [&](Index t, Index k) {
+      Popen p;
+      p.popen(cmd[k]);
+      exit_code[k] = p.exit_code();
+      out[k] = p.gets();
+    });
+
+    auto rm_shards = [&]() {
+      if(n_shards > 1) {
+        for(const auto &o : obj) {
+          fs::remove(o);
+        }
+      }
+    };
+
+    for(Index k = 0; k < n_shards; ++k) {
+      if(exit_code[k]) {
+        err_log() << "Error compiling: " << m_filename_base + ".cc" << std::endl;
+        err_log() << "Attempted: " << cmd[k] << std::endl;
+        err_log() << out[k] << std::endl;
+        rm_shards();
+        throw std::runtime_error("Can not compile " + m_filename_base + ".cc");
+      }
+    }
 
-    // compile the source code into a dynamic library
+    // link the object files into a dynamic library
     Popen p;
-    std::string cmd = m_compile_options + " -o " + m_filename_base + ".o" + " -c " + m_filename_base + ".cc";
-    p.popen(cmd);
+    std::string so_cmd = m_so_options + " -o " + out_base + ".so";
+    for(const auto &o : obj) {
+      so_cmd += " " + o;
+    }
+    p.popen(so_cmd);
+    rm_shards();
     if(p.exit_code()) {
-      err_log() << "Error compiling: " << m_filename_base + ".cc" << std::endl;
-      err_log() << "Attempted: " << cmd << std::endl;
+      err_log() << "Error compiling shared object: " << out_base + ".so" << std::endl;
+      err_log() << "Attempted: " << so_cmd << std::endl;
       err_log() << p.gets() << std::endl;
-      throw std::runtime_error("Can not compile " + m_filename_base + ".cc");
+      throw std::runtime_error("Can not compile " + out_base + ".o");
     }
+  }
 
-    cmd = m_so_options + " -o " + m_filename_base + ".so" + " " + m_filename_base + ".o";
-    p.popen(cmd);
-    if(p.exit_code()) {
-      err_log() << "Error compiling shared object: " << m_filename_base + ".so" << std::endl;
-      err_log() << "Attempted: " << cmd << std::endl;
-      err_log() << p.gets() << std::endl;
-      throw std::runtime_error("Can not compile " + m_filename_base + ".o");
+  /// \brief Number of shards to compile the source code in
+  ///
+  /// \returns N, if the source code contains a line '#define RUNTIME_LIBRARY_SHARDS N',
+  ///          else 1
+  Index RuntimeLibrary::_n_shards() const {
+    fs::ifstream file(m_filename_base + ".cc");
+    std::string prefix = "#define RUNTIME_LIBRARY_SHARDS ";
+    std::string line;
+    while(std::getline(file, line)) {
+      if(line.compare(0, prefix.size(), prefix) == 0) {
+        Index n_shards = std::stol(line.substr(prefix.size()));
+        return std::max(Index(1), n_shards);
+      }
     }
+    return 1;
   }
 
   /// \brief Load a library with a given name
   ///
-  /// \param _filename_base For "hello", this loads "hello.so"
+  /// \param so_path Path to the library, i.e. "/path/to/hello.so"
   ///
-  void RuntimeLibrary::_load() {
+  void RuntimeLibrary::_load(std::string so_path) {
 
-    m_handle = dlopen((m_filename_base + ".so").c_str(), RTLD_NOW);
+    m_handle = dlopen(so_path.c_str(), RTLD_NOW);
     if(!m_handle) {
       fprintf(stderr, "dlopen failed: %s\n", dlerror());
-      throw std::runtime_error(std::string("Cannot open library: ") + m_filename_base + ".so");
+      throw std::runtime_error(std::string("Cannot open library: ") + so_path);
     }
   }
 
@@ -383,6 +515,30 @@ namespace CASM {
     return std::make_pair(fs::path("/not/found"), "notfound");
   }
 
+  const Index RuntimeLibrary::max_default_compile_jobs;
+
+  /// \brief Return default number of shards to compile in parallel
+  ///
+  /// \returns $CASM_COMPILE_JOBS, or if it is unset or 0, the number of hardware
+  ///          threads, but no more than max_default_compile_jobs, because each
+  ///          compiler process may use a lot of memory
+  std::pair<Index, std::string> RuntimeLibrary::default_compile_jobs() {
+    auto res = _use_env(std::vector<std::string> {"CASM_COMPILE_JOBS"}, "0");
+    Index n_jobs;
+    try {
+      n_jobs = std::stol(res.first);
+    }
+    catch(std::exception &e) {
+      throw std::runtime_error(
+        "Error reading CASM_COMPILE_JOBS: '" + res.first + "'\n" +
+        "  Expected the number of shards to compile in parallel");
+    }
+    if(n_jobs <= 0) {
+      n_jobs = std::min(resolve_threads(0), max_default_compile_jobs);
+    }
+    return std::make_pair(n_jobs, res.second);
+  }
+
   std::string include_path(const fs::path &dir) {
     if(!dir.empty()) {
       return "-I" + dir.string();
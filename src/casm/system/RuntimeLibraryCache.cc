@@ -0,0 +1,423 @@
+#include "casm/system/RuntimeLibraryCache.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <boost/filesystem/fstream.hpp>
+#include "casm/system/Popen.hh"
+
+namespace CASM {
+
+  namespace {
+
+    /// \brief Holds a flock on a lock file, until destruction
+    class FileLock {
+
+    public:
+
+      /// \param path Lock file, created if necessary
+      /// \param operation LOCK_SH or LOCK_EX, optionally with LOCK_NB
+      ///
+      /// Throws if the lock file can not be opened, or if a blocking lock fails
+      FileLock(const fs::path &path, int operation) :
+        m_fd(::open(path.c_str(), O_RDWR | O_CREAT, 0666)),
+        m_locked(false) {
+
+        if(m_fd < 0) {
+          throw std::runtime_error("Could not open lock file: " + path.string());
+        }
+
+        int res;
+        while((res = ::flock(m_fd, operation)) != 0 && errno == EINTR) {}
+        m_locked = (res == 0);
+
+        if(!m_locked && !(operation & LOCK_NB)) {
+          ::close(m_fd);
+          throw std::runtime_error("Could not lock: " + path.string());
+        }
+      }
+
+      FileLock(const FileLock &) = delete;
+      FileLock &operator=(const FileLock &) = delete;
+
+      ~FileLock() {
+        if(m_locked) {
+          ::flock(m_fd, LOCK_UN);
+        }
+        ::close(m_fd);
+      }
+
+      bool locked() const {
+        return m_locked;
+      }
+
+    private:
+
+      int m_fd;
+      bool m_locked;
+    };
+
+    /// \brief 128-bit hash, as 32 hex digits
+    ///
+    /// - Two 64-bit FNV-1a hashes, one over the string and one over the
+    ///   reversed string with a different offset basis
+    std::string _hash(const std::string &str) {
+      const unsigned long long prime = 1099511628211ULL;
+      unsigned long long h1 = 14695981039346656037ULL;
+      unsigned long long h2 = h1 ^ str.size();
+      for(auto it = str.begin(); it != str.end(); ++it) {
+        h1 = (h1 ^ static_cast<unsigned char>(*it)) * prime;
+      }
+      for(auto it = str.rbegin(); it != str.rend(); ++it) {
+        h2 = (h2 ^ static_cast<unsigned char>(*it)) * prime;
+      }
+      char buf[33];
+      std::snprintf(buf, sizeof(buf), "%016llx%016llx", h1, h2);
+      return std::string(buf);
+    }
+
+    /// \brief Unique name for temporary files of this process
+    std::string _tmp_name(std::string prefix) {
+      static std::atomic<unsigned long> count(0);
+      return prefix + "." + std::to_string(::getpid()) + "." + std::to_string(count++);
+    }
+
+    /// \brief Output of '<compiler> --version', for the compiler used by 'options'
+    ///
+    /// - The compiler is the first word of 'options'
+    std::string _compiler_version(const std::string &options) {
+      std::string cxx = options.substr(0, options.find_first_of(" \t"));
+      Popen p;
+      p.popen(cxx + " --version");
+      return p.gets();
+    }
+
+    /// \brief Total size of the regular files in a directory
+    uintmax_t _dir_size(const fs::path &dir) {
+      uintmax_t size = 0;
+      for(fs::directory_iterator it(dir), end; it != end; ++it) {
+        if(fs::is_regular_file(it->path())) {
+          size += fs::file_size(it->path());
+        }
+      }
+      return size;
+    }
+
+  }
+
+  /// \brief Construct a RuntimeLibraryCache
+  ///
+  /// \param _dir Cache directory, created if necessary. If empty, the cache is disabled.
+  /// \param _max_size Maximum total size of the cached libraries, in bytes
+  ///
+  RuntimeLibraryCache::RuntimeLibraryCache(fs::path _dir, uintmax_t _max_size) :
+    m_dir(_dir),
+    m_max_size(_max_size) {}
+
+  /// \brief Construct a RuntimeLibraryCache using default_dir() and default_max_size()
+  RuntimeLibraryCache::RuntimeLibraryCache() :
+    RuntimeLibraryCache(default_dir().first, default_max_size().first) {}
+
+  /// \brief Load a library from the cache, compiling it first if necessary
+  ///
+  /// \param src Source code file, i.e. "/path/to/hello.cc"
+  /// \param compile_options Options used to compile the '.o' file
+  /// \param so_options Options used to compile the '.so' file
+  /// \param compile Called as 'compile(out_base)' on a cache miss, must compile
+  ///        'src' into 'out_base.o' and 'out_base.so'
+  /// \param load Called as 'load(so_path)' to load the cached library, while
+  ///        it is locked
+  ///
+  /// \returns false, without calling 'compile' or 'load', if the cache is disabled
+  ///          or can not be used. Errors from 'compile' and 'load' are rethrown.
+  ///
+  /// After loading, a symbolic link to the cached library is created next to
+  /// 'src' (i.e. "/path/to/hello.so"), so that later loads can use load_link
+  /// instead of calculating the key.
+  ///
+  bool RuntimeLibraryCache::load(const fs::path &src,
+                                 std::string compile_options,
+                                 std::string so_options,
+                                 std::function<void (const fs::path &out_base)> compile,
+                                 std::function<void (const fs::path &so_path)> load) const {
+
+    if(!enabled()) {
+      return false;
+    }
+
+    std::string _key;
+    std::unique_ptr<FileLock> lock;
+    try {
+      fs::create_directories(m_dir / "tmp");
+      _key = key(src, compile_options, so_options);
+      lock.reset(new FileLock(m_dir / (_key + ".lock"), LOCK_SH));
+    }
+    catch(std::exception &e) {
+      return false;
+    }
+
+    fs::path entry = m_dir / _key;
+    fs::path so_path = entry / (src.stem().string() + ".so");
+
+    // if already cached, mark as recently used and load
+    if(fs::exists(so_path)) {
+      boost::system::error_code ec;
+      fs::last_write_time(entry, std::time(nullptr), ec);
+      load(so_path);
+    }
+    else {
+      lock.reset();
+      lock.reset(new FileLock(m_dir / (_key + ".lock"), LOCK_EX));
+
+      // check again, another process may have compiled it while unlocked
+      if(!fs::exists(so_path)) {
+        fs::path tmp = m_dir / "tmp" / _tmp_name(_key);
+        fs::remove_all(tmp);
+        fs::create_directories(tmp);
+        try {
+          compile(tmp / src.stem());
+        }
+        catch(std::exception &e) {
+          fs::remove_all(tmp);
+          throw;
+        }
+
+        boost::system::error_code ec;
+        fs::rename(tmp, entry, ec);
+        if(ec) {
+          fs::remove_all(tmp);
+          if(!fs::exists(so_path)) {
+            throw std::runtime_error("Could not add library to cache: " + entry.string());
+          }
+        }
+      }
+      load(so_path);
+    }
+    lock.reset();
+
+    // a missing link only means the key is calculated again next time
+    fs::path link = src.parent_path() / so_path.filename();
+    boost::system::error_code ec;
+    fs::remove(link, ec);
+    fs::create_symlink(fs::absolute(so_path), link, ec);
+
+    try {
+      evict(_key);
+    }
+    catch(std::exception &e) {
+      // a failed eviction leaves the cache larger, but usable
+    }
+
+    return true;
+  }
+
+  /// \brief Load a library through a link created by 'load'
+  ///
+  /// \param link Symbolic link to a cached library, i.e. "/path/to/hello.so"
+  /// \param load Called as 'load(so_path)' to load the cached library, while
+  ///        it is locked
+  ///
+  /// \returns false, without calling 'load', if the cache is disabled, if 'link'
+  ///          is not a link into the cache, or if the cached library has been
+  ///          removed, in which case 'link' is removed too. Errors from 'load'
+  ///          are rethrown.
+  ///
+  bool RuntimeLibraryCache::load_link(const fs::path &link,
+                                      std::function<void (const fs::path &so_path)> load) const {
+
+    if(!enabled() || !fs::is_symlink(link)) {
+      return false;
+    }
+
+    fs::path so_path = fs::read_symlink(link);
+    fs::path entry = so_path.parent_path();
+    if(entry.parent_path() != fs::absolute(m_dir)) {
+      return false;
+    }
+
+    std::unique_ptr<FileLock> lock;
+    try {
+      lock.reset(new FileLock(m_dir / (entry.filename().string() + ".lock"), LOCK_SH));
+    }
+    catch(std::exception &e) {
+      return false;
+    }
+
+    boost::system::error_code ec;
+    if(!fs::exists(so_path)) {
+      fs::remove(link, ec);
+      return false;
+    }
+
+    // mark as recently used and load
+    fs::last_write_time(entry, std::time(nullptr), ec);
+    load(so_path);
+    return true;
+  }
+
+  /// \brief Cache key for 'src' compiled with 'compile_options' and 'so_options'
+  ///
+  /// - Hashes the source code after preprocessing, so that changes to included
+  ///   headers are detected, along with the compile options, shared library
+  ///   options, and the '--version' output of the compilers they use
+  /// - Line markers are not included, so the key does not depend on the
+  ///   location of 'src'
+  /// - Throws std::runtime_error if preprocessing fails
+  ///
+  std::string RuntimeLibraryCache::key(const fs::path &src,
+                                       std::string compile_options,
+                                       std::string so_options) const {
+
+    fs::create_directories(m_dir / "tmp");
+    fs::path ii = m_dir / "tmp" / (_tmp_name(src.stem().string()) + ".ii");
+
+    Popen p;
+    p.popen(compile_options + " -E -P -o " + ii.string() + " " + src.string());
+    if(p.exit_code() || !fs::exists(ii)) {
+      fs::remove(ii);
+      throw std::runtime_error("Could not preprocess " + src.string());
+    }
+
+    std::string str;
+    {
+      fs::ifstream file(ii, std::ios::binary);
+      str.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    fs::remove(ii);
+
+    str.push_back('\0');
+    str += compile_options;
+    str.push_back('\0');
+    str += so_options;
+    str.push_back('\0');
+    str += _compiler_version(compile_options);
+    str.push_back('\0');
+    str += _compiler_version(so_options);
+
+    return _hash(str);
+  }
+
+  /// \brief Remove least recently used entries until the cache is no larger than max_size()
+  ///
+  /// \param keep Key of an entry that should not be removed
+  ///
+  /// - Entries that are locked by another process are not removed
+  ///
+  void RuntimeLibraryCache::evict(std::string keep) const {
+
+    if(!enabled() || !fs::exists(m_dir)) {
+      return;
+    }
+
+    FileLock cache_lock(m_dir / "cache.lock", LOCK_EX);
+
+    struct Entry {
+      std::time_t time;
+      uintmax_t size;
+      fs::path path;
+    };
+
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+    for(fs::directory_iterator it(m_dir), end; it != end; ++it) {
+      if(!fs::is_directory(it->path()) || it->path().filename() == "tmp") {
+        continue;
+      }
+      Entry e {fs::last_write_time(it->path()), _dir_size(it->path()), it->path()};
+      total += e.size;
+      entries.push_back(e);
+    }
+
+    if(total <= m_max_size) {
+      return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry & A, const Entry & B) {
+      return A.time < B.time;
+    });
+
+    for(const auto &e : entries) {
+      if(total <= m_max_size) {
+        break;
+      }
+      std::string _key = e.path.filename().string();
+      if(_key == keep) {
+        continue;
+      }
+      FileLock lock(m_dir / (_key + ".lock"), LOCK_EX | LOCK_NB);
+      if(!lock.locked()) {
+        continue;
+      }
+      fs::remove_all(e.path);
+      total -= e.size;
+    }
+  }
+
+  /// \brief Return default cache directory and specifying variable
+  ///
+  /// \returns In order of preference: $CASM_CLEXULATOR_CACHE, or
+  ///          $XDG_CACHE_HOME/casm/clexulator, or $HOME/.cache/casm/clexulator.
+  ///          If CASM_CLEXULATOR_CACHE is "none" or empty, returns an empty path,
+  ///          which disables the cache.
+  std::pair<fs::path, std::string> RuntimeLibraryCache::default_dir() {
+    char *_env;
+
+    // if CASM_CLEXULATOR_CACHE exists
+    _env = std::getenv("CASM_CLEXULATOR_CACHE");
+    if(_env != nullptr) {
+      std::string val(_env);
+      if(val.empty() || val == "none") {
+        return std::make_pair(fs::path(), "CASM_CLEXULATOR_CACHE");
+      }
+      return std::make_pair(fs::path(val), "CASM_CLEXULATOR_CACHE");
+    }
+
+    // if XDG_CACHE_HOME exists
+    _env = std::getenv("XDG_CACHE_HOME");
+    if(_env != nullptr && std::string(_env).size()) {
+      return std::make_pair(fs::path(_env) / "casm" / "clexulator", "XDG_CACHE_HOME");
+    }
+
+    // if HOME exists
+    _env = std::getenv("HOME");
+    if(_env != nullptr && std::string(_env).size()) {
+      return std::make_pair(fs::path(_env) / ".cache" / "casm" / "clexulator", "HOME");
+    }
+
+    // else
+    return std::make_pair(fs::path(), "notfound");
+  }
+
+  /// \brief Return default maximum cache size, in bytes, and specifying variable
+  ///
+  /// \returns $CASM_CLEXULATOR_CACHE_SIZE MiB, or 1024 MiB
+  std::pair<uintmax_t, std::string> RuntimeLibraryCache::default_max_size() {
+    const uintmax_t MiB = 1024 * 1024;
+
+    // if CASM_CLEXULATOR_CACHE_SIZE exists
+    char *_env = std::getenv("CASM_CLEXULATOR_CACHE_SIZE");
+    if(_env != nullptr) {
+      try {
+        return std::make_pair(std::stoull(_env) * MiB, "CASM_CLEXULATOR_CACHE_SIZE");
+      }
+      catch(std::exception &e) {
+        throw std::runtime_error(
+          std::string("Error reading CASM_CLEXULATOR_CACHE_SIZE: '") + _env + "'\n" +
+          "  Expected the maximum cache size in MiB");
+      }
+    }
+
+    // else
+    return std::make_pair(1024 * MiB, "default");
+  }
+
+}
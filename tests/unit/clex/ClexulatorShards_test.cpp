@@ -0,0 +1,136 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+///   print_clexulator, with the basis functions split into shards that are
+///   compiled in parallel by RuntimeLibrary
+
+/// What is being used to test it:
+#include <boost/filesystem.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+#include "casm/clex/PrimClex.hh"
+#include "casm/clusterography/Orbitree.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ClexulatorShardsTest)
+
+BOOST_AUTO_TEST_CASE(CompareToUnsharded) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+  fs::path bspecs_dest = primclex.dir().bspecs("default");
+  fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+  // for autotools
+  primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+  primclex.settings().commit();
+
+  CommandArgs args("casm bset -uf", &primclex, primclex.dir().root_dir(), Logging::null());
+  BOOST_REQUIRE(!casm_api(args));
+
+  const ProjectSettings &set = primclex.settings();
+  ClexDescription desc = set.default_clex();
+  Clexulator unsharded = primclex.clexulator(desc);
+
+  // print the same basis functions, split into shards of a few orbits
+  const Structure &prim = primclex.get_prim();
+  SiteOrbitree tree = primclex.orbitree(desc);
+
+  PrimNeighborList nlist(
+    set.nlist_weight_matrix(),
+    set.nlist_sublat_indices().begin(),
+    set.nlist_sublat_indices().end());
+  std::set<UnitCellCoord> nbors;
+  neighborhood(std::inserter(nbors, nbors.begin()), tree, prim, primclex.crystallography_tol());
+  nlist.expand(nbors.begin(), nbors.end());
+
+  fs::path shard_dir = primclex.dir().root_dir() / "clexulator_shards";
+  fs::create_directories(shard_dir);
+  fs::path shard_src = shard_dir / (set.clexulator() + ".cc");
+  fs::remove(shard_dir / (set.clexulator() + ".so"));
+  fs::ofstream outfile(shard_src);
+  print_clexulator(prim, tree, nlist, set.clexulator(), outfile, primclex.crystallography_tol(), true, 1 << 12);
+  outfile.close();
+
+  Index n_shards = 1;
+  fs::ifstream infile(shard_src);
+  std::string prefix = "#define RUNTIME_LIBRARY_SHARDS ";
+  std::string line;
+  while(std::getline(infile, line)) {
+    if(line.compare(0, prefix.size(), prefix) == 0) {
+      n_shards = std::stol(line.substr(prefix.size()));
+    }
+  }
+  BOOST_REQUIRE(n_shards > 2);
+
+  Clexulator sharded(set.clexulator(), shard_dir, nlist, logging, set.compile_options(), set.so_options());
+
+  BOOST_REQUIRE_EQUAL(sharded.corr_size(), unsharded.corr_size());
+  BOOST_REQUIRE_EQUAL(sharded.nlist_size(), unsharded.nlist_size());
+  BOOST_CHECK(sharded.has_delta_point_energy());
+
+  // random occupation of a neighbor list that does not wrap around
+  std::vector<int> sublat_indices(nlist.sublat_indices().begin(), nlist.sublat_indices().end());
+  const auto &basis = prim.basis;
+  long N = sharded.nlist_size();
+  std::vector<long> nl(N);
+  std::vector<int> occ(N);
+  for(long k = 0; k < N; ++k) {
+    nl[k] = k;
+    int n_occ = basis[sublat_indices[k % sublat_indices.size()]].site_occupant().size();
+    occ[k] = (k * 7 + 3) % n_occ;
+  }
+
+  Index N_corr = sharded.corr_size();
+  std::vector<double> expected(N_corr), result(N_corr), eci(N_corr);
+  for(Index i = 0; i < N_corr; ++i) {
+    eci[i] = (i % 3 == 0) ? 0.0 : 0.01 * (i + 1);
+  }
+
+  for(Clexulator *clex : {
+        &unsharded, &sharded
+      }) {
+    clex->set_config_occ(occ.data());
+    clex->set_nlist(nl.data());
+  }
+
+  unsharded.calc_global_corr_contribution(expected.data());
+  sharded.calc_global_corr_contribution(result.data());
+  for(Index i = 0; i < N_corr; ++i) {
+    BOOST_CHECK_SMALL(result[i] - expected[i], 1e-12);
+  }
+
+  for(Index n = 0; n < sublat_indices.size(); ++n) {
+    int b = sublat_indices[n];
+
+    unsharded.calc_point_corr(b, expected.data());
+    sharded.calc_point_corr(b, result.data());
+    for(Index i = 0; i < N_corr; ++i) {
+      BOOST_CHECK_SMALL(result[i] - expected[i], 1e-12);
+    }
+
+    int n_occ = basis[b].site_occupant().size();
+    for(int occ_f = 0; occ_f < n_occ; ++occ_f) {
+      int occ_i = occ[n];
+      if(occ_f == occ_i) {
+        continue;
+      }
+      BOOST_CHECK_SMALL(
+        sharded.calc_delta_point_energy(b, occ_i, occ_f, eci.data()) -
+        unsharded.calc_delta_point_energy(b, occ_i, occ_f, eci.data()),
+        1e-10);
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
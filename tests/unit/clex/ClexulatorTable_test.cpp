@@ -0,0 +1,374 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ClexulatorTable.hh"
+
+/// Dependencies
+#include "casm/app/casm_functions.hh"
+#include "casm/clex/PrimClex.hh"
+
+/// What is being used to test it:
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <boost/filesystem.hpp>
+#include "Common.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// \brief Use the basis set of the Monte Carlo tests, and write it with 'casm bset -uf'
+  void make_bset(PrimClex &primclex) {
+    fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+    fs::path bspecs_dest = primclex.dir().bspecs("default");
+    fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+    // for autotools
+    primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+    primclex.settings().commit();
+
+    CommandArgs args("casm bset -uf", &primclex, primclex.dir().root_dir(), Logging::null());
+    BOOST_REQUIRE(!casm_api(args));
+  }
+
+  /// \brief Benchmarks only run if $CASM_BENCHMARK is set, so 'make check' skips them
+  bool run_benchmark() {
+    const char *value = std::getenv("CASM_BENCHMARK");
+    if(value == nullptr || std::string(value).empty()) {
+      BOOST_TEST_MESSAGE("  skipped, set CASM_BENCHMARK to run");
+      return false;
+    }
+    return true;
+  }
+
+  /// \brief Seconds to call 'f' 'n' times
+  template<typename F>
+  double time(Index n, F f) {
+    auto begin = std::chrono::steady_clock::now();
+    for(Index i = 0; i < n; ++i) {
+      f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - begin).count();
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(ClexulatorTableTest)
+
+BOOST_AUTO_TEST_CASE(CompareToCompiled) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  make_bset(primclex);
+
+  const ProjectSettings &set = primclex.settings();
+  ClexDescription desc = set.default_clex();
+  fs::path table_path = primclex.dir().clexulator_table(set.name(), desc.bset);
+  BOOST_REQUIRE(fs::exists(table_path));
+
+  Clexulator compiled = primclex.clexulator(desc);
+  Clexulator table = make_table_clexulator(set.name() + "_Clexulator", table_path, primclex.nlist());
+
+  BOOST_REQUIRE_EQUAL(table.corr_size(), compiled.corr_size());
+  BOOST_REQUIRE_EQUAL(table.nlist_size(), compiled.nlist_size());
+  BOOST_CHECK(table.neighborhood() == compiled.neighborhood());
+  BOOST_CHECK(table.weight_matrix() == compiled.weight_matrix());
+  BOOST_CHECK(table.has_delta_point_energy());
+
+  // random occupation of a neighbor list that does not wrap around
+  std::vector<int> sublat_indices(primclex.nlist().sublat_indices().begin(),
+                                  primclex.nlist().sublat_indices().end());
+  const auto &basis = primclex.get_prim().basis;
+  long N = table.nlist_size();
+  std::vector<long> nlist(N);
+  std::vector<int> occ(N);
+  for(long k = 0; k < N; ++k) {
+    nlist[k] = k;
+    int n_occ = basis[sublat_indices[k % sublat_indices.size()]].site_occupant().size();
+    occ[k] = (k * 7 + 3) % n_occ;
+  }
+
+  Index N_corr = table.corr_size();
+  std::vector<double> expected(N_corr), result(N_corr), eci(N_corr);
+  for(Index i = 0; i < N_corr; ++i) {
+    eci[i] = (i % 3 == 0) ? 0.0 : 0.01 * (i + 1);
+  }
+
+  for(Clexulator *clex : {
+        &compiled, &table
+      }) {
+    clex->set_config_occ(occ.data());
+    clex->set_nlist(nlist.data());
+  }
+
+  compiled.calc_global_corr_contribution(expected.data());
+  table.calc_global_corr_contribution(result.data());
+  for(Index i = 0; i < N_corr; ++i) {
+    BOOST_CHECK_SMALL(result[i] - expected[i], 1e-5);
+  }
+
+  // batched sum over unit cells, with neighbor lists that overlap
+  Index n_cells = 150;
+  std::vector<int> batch_occ(N + n_cells * sublat_indices.size());
+  for(Index l = 0; l < batch_occ.size(); ++l) {
+    int n_occ = basis[sublat_indices[l % sublat_indices.size()]].site_occupant().size();
+    batch_occ[l] = (l * 5 + l / 3) % n_occ;
+  }
+  std::vector<const long int *> nlist_ptrs(n_cells);
+  std::vector<long> batch_nlist(N * n_cells);
+  for(Index c = 0; c < n_cells; ++c) {
+    for(long k = 0; k < N; ++k) {
+      batch_nlist[c * N + k] = k + c * sublat_indices.size();
+    }
+    nlist_ptrs[c] = batch_nlist.data() + c * N;
+  }
+  std::vector<double> tcorr(N_corr);
+  for(Clexulator *clex : {
+        &compiled, &table
+      }) {
+    clex->set_config_occ(batch_occ.data());
+    std::fill(expected.begin(), expected.end(), 0.0);
+    for(Index c = 0; c < n_cells; ++c) {
+      clex->set_nlist(nlist_ptrs[c]);
+      clex->calc_global_corr_contribution(tcorr.data());
+      for(Index i = 0; i < N_corr; ++i) {
+        expected[i] += tcorr[i];
+      }
+    }
+    clex->calc_global_corr_sum(nlist_ptrs.data(), n_cells, result.data());
+    for(Index i = 0; i < N_corr; ++i) {
+      BOOST_CHECK_SMALL(result[i] - expected[i], 1e-8);
+    }
+    clex->set_config_occ(occ.data());
+    clex->set_nlist(nlist.data());
+  }
+
+  for(Index nl = 0; nl < sublat_indices.size(); ++nl) {
+    int b = sublat_indices[nl];
+
+    compiled.calc_point_corr(b, expected.data());
+    table.calc_point_corr(b, result.data());
+    for(Index i = 0; i < N_corr; ++i) {
+      BOOST_CHECK_SMALL(result[i] - expected[i], 1e-5);
+    }
+
+    int occ_i = occ[nl];
+    int occ_f = (occ_i + 1) % basis[b].site_occupant().size();
+    compiled.calc_delta_point_corr(b, occ_i, occ_f, expected.data());
+    table.calc_delta_point_corr(b, occ_i, occ_f, result.data());
+    for(Index i = 0; i < N_corr; ++i) {
+      BOOST_CHECK_SMALL(result[i] - expected[i], 1e-5);
+    }
+
+    BOOST_CHECK_SMALL(
+      table.calc_delta_point_energy(b, occ_i, occ_f, eci.data()) -
+      compiled.calc_delta_point_energy(b, occ_i, occ_f, eci.data()), 1e-5);
+  }
+
+  // use the table backend via PrimClex
+  BOOST_CHECK(!primclex.settings().set_clexulator_backend("interpreted"));
+  BOOST_CHECK(primclex.settings().set_clexulator_backend("table"));
+  primclex.settings().commit();
+  primclex.refresh(true, false, false, false, true);
+  BOOST_CHECK(primclex.has_clexulator(desc));
+  BOOST_CHECK_EQUAL(primclex.clexulator(desc).corr_size(), N_corr);
+
+  primclex.settings().set_clexulator_backend("compiled");
+  primclex.settings().commit();
+
+  // reading tables with out of range indices throws
+  jsonParser json(table_path);
+  ClexulatorTable checked;
+  BOOST_CHECK_NO_THROW(from_json(checked, json));
+  BOOST_REQUIRE(checked.orbit.nlist.size() > 0);
+
+  auto check_throws = [&](std::function<void (ClexulatorTable &)> corrupt) {
+    ClexulatorTable corrupted = checked;
+    corrupt(corrupted);
+    jsonParser corrupted_json;
+    to_json(corrupted, corrupted_json);
+    ClexulatorTable result;
+    BOOST_CHECK_THROW(from_json(result, corrupted_json), std::runtime_error);
+  };
+  check_throws([](ClexulatorTable & t) {
+    t.orbit.nlist[0] = t.nlist_size;
+  });
+  check_throws([](ClexulatorTable & t) {
+    t.orbit.func.back() = t.occ_func.size() - t.max_occ + 1;
+  });
+  check_throws([](ClexulatorTable & t) {
+    t.orbit.term_begin[1] = t.orbit.coeff.size() + 1;
+  });
+  check_throws([](ClexulatorTable & t) {
+    t.orbit.factor_begin[1] = t.orbit.nlist.size() + 1;
+  });
+  check_throws([](ClexulatorTable & t) {
+    t.orbit.site_end[0] = t.orbit.factor_begin[1] + 1;
+  });
+}
+
+/// Time the table backend against the compiled Clexulator for the same basis set
+///
+/// - Skipped unless $CASM_BENCHMARK is set. To run only the benchmarks:
+///   CASM_BENCHMARK=1 casm_unit_clex --run_test=ClexulatorTableTest/*Benchmark --log_level=message
+BOOST_AUTO_TEST_CASE(Benchmark) {
+
+  if(!run_benchmark()) {
+    return;
+  }
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  make_bset(primclex);
+
+  const ProjectSettings &set = primclex.settings();
+  ClexDescription desc = set.default_clex();
+  fs::path table_path = primclex.dir().clexulator_table(set.name(), desc.bset);
+  Clexulator compiled = primclex.clexulator(desc);
+  Clexulator table = make_table_clexulator(set.name() + "_Clexulator", table_path, primclex.nlist());
+
+  // occupation of a neighbor list that does not wrap around
+  std::vector<int> sublat_indices(primclex.nlist().sublat_indices().begin(),
+                                  primclex.nlist().sublat_indices().end());
+  const auto &basis = primclex.get_prim().basis;
+  long N = table.nlist_size();
+  std::vector<long> nlist(N);
+  std::vector<int> occ(N);
+  for(long k = 0; k < N; ++k) {
+    nlist[k] = k;
+    int n_occ = basis[sublat_indices[k % sublat_indices.size()]].site_occupant().size();
+    occ[k] = (k * 7 + 3) % n_occ;
+  }
+
+  Index N_corr = table.corr_size();
+  std::vector<double> corr(N_corr), eci(N_corr);
+  for(Index i = 0; i < N_corr; ++i) {
+    eci[i] = (i % 3 == 0) ? 0.0 : 0.01 * (i + 1);
+  }
+
+  int b = sublat_indices[0];
+  int occ_f = (occ[0] + 1) % basis[b].site_occupant().size();
+  Index n = 10000;
+
+  BOOST_TEST_MESSAGE("Clexulator backends, " << N_corr << " basis functions, "
+                     << n << " evaluations (s):");
+  BOOST_TEST_MESSAGE("  backend  global_corr  point_corr  delta_point_energy");
+  for(auto backend : std::vector<std::pair<std::string, Clexulator *> > {
+        {"compiled", &compiled}, {"table", &table}
+      }) {
+    Clexulator &clex = *backend.second;
+    clex.set_config_occ(occ.data());
+    clex.set_nlist(nlist.data());
+
+    double sum = 0.0;
+    double t_global = time(n, [&]() {
+      clex.calc_global_corr_contribution(corr.data());
+      sum += corr[N_corr - 1];
+    });
+    double t_point = time(n, [&]() {
+      clex.calc_point_corr(b, corr.data());
+      sum += corr[N_corr - 1];
+    });
+    double t_delta = time(n, [&]() {
+      sum += clex.calc_delta_point_energy(b, occ[0], occ_f, eci.data());
+    });
+    BOOST_CHECK(std::isfinite(sum));
+
+    BOOST_TEST_MESSAGE("  " << backend.first << "  " << t_global << "  " << t_point << "  " << t_delta);
+  }
+}
+
+/// Time the batched calc_global_corr_sum against one calc_global_corr_contribution
+/// call per unit cell, for the same occupation and both backends
+///
+/// - Skipped unless $CASM_BENCHMARK is set
+BOOST_AUTO_TEST_CASE(BatchedBenchmark) {
+
+  if(!run_benchmark()) {
+    return;
+  }
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  make_bset(primclex);
+
+  const ProjectSettings &set = primclex.settings();
+  ClexDescription desc = set.default_clex();
+  fs::path table_path = primclex.dir().clexulator_table(set.name(), desc.bset);
+  Clexulator compiled = primclex.clexulator(desc);
+  Clexulator table = make_table_clexulator(set.name() + "_Clexulator", table_path, primclex.nlist());
+
+  // neighbor lists of 'n_cells' unit cells, offset by one unit cell each
+  std::vector<int> sublat_indices(primclex.nlist().sublat_indices().begin(),
+                                  primclex.nlist().sublat_indices().end());
+  const auto &basis = primclex.get_prim().basis;
+  long N = table.nlist_size();
+  Index n_cells = 4096;
+  std::vector<int> occ(N + n_cells * sublat_indices.size());
+  for(Index l = 0; l < occ.size(); ++l) {
+    int n_occ = basis[sublat_indices[l % sublat_indices.size()]].site_occupant().size();
+    occ[l] = (l * 5 + l / 3) % n_occ;
+  }
+  std::vector<const long int *> nlist_ptrs(n_cells);
+  std::vector<long> nlist(N * n_cells);
+  for(Index c = 0; c < n_cells; ++c) {
+    for(long k = 0; k < N; ++k) {
+      nlist[c * N + k] = k + c * sublat_indices.size();
+    }
+    nlist_ptrs[c] = nlist.data() + c * N;
+  }
+
+  Index N_corr = table.corr_size();
+  std::vector<double> corr(N_corr), tcorr(N_corr);
+  Index n = 20;
+
+  BOOST_TEST_MESSAGE("Global correlations, " << N_corr << " basis functions, "
+                     << n << " sums over " << n_cells << " unit cells (s):");
+  BOOST_TEST_MESSAGE("  backend  per_cell  batched  speedup");
+  for(auto backend : std::vector<std::pair<std::string, Clexulator *> > {
+        {"compiled", &compiled}, {"table", &table}
+      }) {
+    Clexulator &clex = *backend.second;
+    clex.set_config_occ(occ.data());
+
+    double sum = 0.0;
+    double t_cell = time(n, [&]() {
+      std::fill(corr.begin(), corr.end(), 0.0);
+      for(Index c = 0; c < n_cells; ++c) {
+        clex.set_nlist(nlist_ptrs[c]);
+        clex.calc_global_corr_contribution(tcorr.data());
+        for(Index i = 0; i < N_corr; ++i) {
+          corr[i] += tcorr[i];
+        }
+      }
+      sum += corr[N_corr - 1];
+    });
+    double t_batch = time(n, [&]() {
+      clex.calc_global_corr_sum(nlist_ptrs.data(), n_cells, corr.data());
+      sum += corr[N_corr - 1];
+    });
+    BOOST_CHECK(std::isfinite(sum));
+
+    BOOST_TEST_MESSAGE("  " << backend.first << "  " << t_cell << "  " << t_batch << "  " << t_cell / t_batch);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,33 +7,47 @@
 /// Dependencies
 
 /// What is being used to test it:
+#include <sstream>
+#include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 using namespace CASM;
 
 BOOST_AUTO_TEST_SUITE(ClexulatorTest)
 
-BOOST_AUTO_TEST_CASE(MakeClexulatorTest) {
-  namespace fs = boost::filesystem;
+namespace {
 
-  std::string compile_opt = RuntimeLibrary::default_cxx().first + " " + RuntimeLibrary::default_cxxflags().first + " -Iinclude";
-  std::string so_opt = RuntimeLibrary::default_cxx().first + " " + RuntimeLibrary::default_soflags().first;
+  std::string compile_options() {
+    std::string compile_opt = RuntimeLibrary::default_cxx().first + " " + RuntimeLibrary::default_cxxflags().first + " -Iinclude";
+    if(!RuntimeLibrary::default_boost_includedir().first.empty()) {
+      compile_opt += " " + include_path(RuntimeLibrary::default_boost_includedir().first);
+    }
+    return compile_opt;
+  }
 
-  if(!RuntimeLibrary::default_boost_includedir().first.empty()) {
-    compile_opt += " " + include_path(RuntimeLibrary::default_boost_includedir().first);
+  std::string so_options() {
+    std::string so_opt = RuntimeLibrary::default_cxx().first + " " + RuntimeLibrary::default_soflags().first;
+    if(!RuntimeLibrary::default_boost_libdir().first.empty()) {
+      so_opt += " " + link_path(RuntimeLibrary::default_boost_libdir().first);
+    }
+    return so_opt;
   }
 
-  if(!RuntimeLibrary::default_boost_libdir().first.empty()) {
-    so_opt += " " + link_path(RuntimeLibrary::default_boost_libdir().first);
+  PrimNeighborList make_nlist() {
+    std::vector<int> sublat_indices = {0};
+    PrimNeighborList::Matrix3Type W;
+    W.row(0) << 2, 1, 1;
+    W.row(1) << 1, 2, 1;
+    W.row(2) << 1, 1, 2;
+    return PrimNeighborList(W, sublat_indices.begin(), sublat_indices.end());
   }
 
-  std::vector<int> sublat_indices = {0};
-  PrimNeighborList::Matrix3Type W;
-  W.row(0) << 2, 1, 1;
-  W.row(1) << 1, 2, 1;
-  W.row(2) << 1, 1, 2;
+}
+
+BOOST_AUTO_TEST_CASE(MakeClexulatorTest) {
 
-  PrimNeighborList nlist(W, sublat_indices.begin(), sublat_indices.end());
+  PrimNeighborList nlist = make_nlist();
 
   Log dumblog = null_log();
 
@@ -41,11 +55,113 @@ BOOST_AUTO_TEST_CASE(MakeClexulatorTest) {
                         "tests/unit/clex",
                         nlist,
                         dumblog,
-                        compile_opt,
-                        so_opt);
+                        compile_options(),
+                        so_options());
 
   BOOST_CHECK_EQUAL(clexulator.corr_size(), 75);
 
+  // printed without calc_delta_point_energy
+  BOOST_CHECK(!clexulator.has_delta_point_energy());
+  double eci = 0.0;
+  BOOST_CHECK_THROW(clexulator.calc_delta_point_energy(0, 0, 1, &eci), std::runtime_error);
+
+  // pair swap, with sites 'a' and 'b' in each other's neighborhood, matches
+  // changing the occupation of one site at a time
+  long N = clexulator.nlist_size();
+  std::vector<long> nlist_a(N), nlist_b(N);
+  for(long k = 0; k < N; ++k) {
+    nlist_a[k] = k;
+    nlist_b[k] = 2 * N - 1 - k;
+  }
+  nlist_a[1] = nlist_b[0];
+  nlist_b[1] = nlist_a[0];
+
+  std::vector<int> occ(2 * N);
+  for(long i = 0; i < occ.size(); ++i) {
+    occ[i] = (i * 7 + 3) % 5 < 2 ? 1 : 0;
+  }
+  occ[nlist_a[0]] = 0;
+  occ[nlist_b[0]] = 1;
+  std::vector<int> occ_init(occ);
+
+  ClexSwapSite a {nlist_a[0], 0, 0, 1, nlist_a.data(), nlist_a.data() + N};
+  ClexSwapSite b {nlist_b[0], 0, 1, 0, nlist_b.data(), nlist_b.data() + N};
+
+  std::vector<double> expected(clexulator.corr_size());
+  std::vector<double> before(clexulator.corr_size());
+  std::vector<double> after(clexulator.corr_size());
+
+  for(bool use_deltas : {
+        true, false
+      }) {
+    std::fill(expected.begin(), expected.end(), 0.0);
+    clexulator.set_config_occ(occ.data());
+    for(const ClexSwapSite &site : {
+          a, b
+        }) {
+      clexulator.set_nlist(site.nlist_begin);
+      if(use_deltas) {
+        std::fill(before.begin(), before.end(), 0.0);
+        clexulator.calc_delta_point_corr(site.b, site.occ_i, site.occ_f, after.data());
+      }
+      else {
+        clexulator.calc_point_corr(site.b, before.data());
+        occ[site.l] = site.occ_f;
+        clexulator.calc_point_corr(site.b, after.data());
+      }
+      occ[site.l] = site.occ_f;
+      for(long i = 0; i < expected.size(); ++i) {
+        expected[i] += after[i] - before[i];
+      }
+    }
+    occ = occ_init;
+
+    clexulator.calc_delta_swap_corr(occ.data(), a, b, use_deltas, after.data());
+    BOOST_CHECK(occ == occ_init);
+    for(long i = 0; i < expected.size(); ++i) {
+      BOOST_CHECK_SMALL(after[i] - expected[i], 1e-10);
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(ABIVersionTest) {
+  namespace fs = boost::filesystem;
+
+  // a copy of test_Clexulator, as if compiled against another version of
+  // Clexulator_impl::Base
+  std::string src;
+  {
+    fs::ifstream sin(fs::path("tests/unit/clex/test_Clexulator.cc"));
+    std::stringstream ss;
+    ss << sin.rdbuf();
+    src = ss.str();
+  }
+  boost::replace_all(src, "test_Clexulator", "old_Clexulator");
+  boost::replace_all(src,
+                     "return CASM::Clexulator_impl::abi_version;",
+                     "return CASM::Clexulator_impl::abi_version - 1;");
+
+  fs::path dir = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(dir);
+  {
+    fs::ofstream sout(dir / "old_Clexulator.cc");
+    sout << src;
+  }
+
+  PrimNeighborList nlist = make_nlist();
+  Log dumblog = null_log();
+
+  std::string what;
+  try {
+    Clexulator clexulator("old_Clexulator", dir, nlist, dumblog, compile_options(), so_options());
+  }
+  catch(std::runtime_error &e) {
+    what = e.what();
+  }
+  BOOST_CHECK(what.find("casm bset -uf") != std::string::npos);
+
+  fs::remove_all(dir);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigDoF.hh"
+
+/// What is being used to test it:
+#include <boost/filesystem.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+#include "casm/clex/Configuration.hh"
+#include "casm/clex/NeighborList.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ConfigDoFTest)
+
+BOOST_AUTO_TEST_CASE(CorrelationsThreads) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+  fs::path bspecs_dest = primclex.dir().bspecs("default");
+  fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+  // for autotools
+  primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+  primclex.settings().commit();
+
+  CommandArgs args("casm bset -u", &primclex, primclex.dir().root_dir(), Logging::null());
+  BOOST_REQUIRE(!casm_api(args));
+
+  Clexulator clexulator = primclex.clexulator(primclex.settings().default_clex());
+
+  // more unit cells than fit in one block, and not a multiple of the block size
+  Eigen::Matrix3i T;
+  T << 11, 0, 0,
+  0, 11, 0,
+  0, 0, 9;
+  Supercell scel(&primclex, T);
+  BOOST_REQUIRE(scel.volume() > 1024);
+
+  // deterministic, disordered occupation
+  ConfigDoF configdof(scel.num_sites());
+  const auto &basis = primclex.get_prim().basis;
+  Index volume = scel.volume();
+  for(Index l = 0; l < scel.num_sites(); ++l) {
+    int n_occ = basis[l / volume].site_occupant().size();
+    configdof.occ(l) = (l * 7 + l / 5) % n_occ;
+  }
+
+  // the original serial sum over unit cells
+  Eigen::VectorXd expected = Eigen::VectorXd::Zero(clexulator.corr_size());
+  Eigen::VectorXd tcorr = Eigen::VectorXd::Zero(clexulator.corr_size());
+  clexulator.set_config_occ(configdof.occupation().begin());
+  for(Index v = 0; v < volume; ++v) {
+    clexulator.set_nlist(scel.nlist().sites(v).data());
+    clexulator.calc_global_corr_contribution(tcorr.data());
+    expected += tcorr;
+  }
+  expected /= (double) volume;
+
+  Eigen::VectorXd serial = correlations_vec(configdof, scel, clexulator, 1);
+  for(Index i = 0; i < expected.size(); ++i) {
+    BOOST_CHECK_SMALL(serial(i) - expected(i), 1e-12);
+  }
+
+  // identical, not just close, for any number of threads
+  for(Index n_threads : {2, 3, 4, 7, 64, 0}) {
+    Eigen::VectorXd result = correlations_vec(configdof, scel, clexulator, n_threads);
+    BOOST_CHECK(result == serial);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
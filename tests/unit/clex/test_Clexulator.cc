@@ -24,6 +24,9 @@
 /// \brief Returns a Clexulator_impl::Base* owning a test_Clexulator
 extern "C" CASM::Clexulator_impl::Base *make_test_Clexulator();
 
+/// \brief Returns the Clexulator_impl::abi_version test_Clexulator was compiled with
+extern "C" int abi_version_test_Clexulator();
+
 namespace CASM {
 
   class test_Clexulator : public Clexulator_impl::Base {
@@ -1948,5 +1951,10 @@ extern "C" {
     return new CASM::test_Clexulator();
   }
 
+  /// \brief Returns the Clexulator_impl::abi_version test_Clexulator was compiled with
+  int abi_version_test_Clexulator() {
+    return CASM::Clexulator_impl::abi_version;
+  }
+
 }
 
@@ -0,0 +1,105 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/BiasPotential.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include "casm/casm_io/jsonParser.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(BiasPotentialTest)
+
+BOOST_AUTO_TEST_CASE(Potentials) {
+
+  std::vector<std::pair<Index, double> > weights = {{1, 1.0}, {3, -0.5}};
+
+  Monte::BiasPotential harmonic(weights, Monte::BiasPotential::TYPE::HARMONIC, 2.0, 0.25);
+  BOOST_CHECK(harmonic.is_active());
+  BOOST_CHECK(!Monte::BiasPotential().is_active());
+
+  Eigen::VectorXd corr(4);
+  corr << 1.0, 0.5, 7.0, 0.2;
+  BOOST_CHECK_CLOSE(harmonic.order_parameter(corr), 0.4, 1e-10);
+  BOOST_CHECK_CLOSE(harmonic.value(0.75), 0.25, 1e-10);
+
+  // dq from extensive dCorr, and the change in bias energy of the supercell
+  Eigen::VectorXd dCorr(4);
+  dCorr << 3.0, 2.0, -1.0, 4.0;
+  BOOST_CHECK_SMALL(harmonic.delta_order_parameter(dCorr, 10.0), 1e-12);
+  dCorr(1) = 3.0;
+  BOOST_CHECK_CLOSE(harmonic.delta_order_parameter(dCorr, 10.0), 0.1, 1e-10);
+  BOOST_CHECK_CLOSE(harmonic.delta(0.25, 0.1, 10.0), 10.0 * 0.5 * 2.0 * 0.01, 1e-10);
+
+  Monte::BiasPotential linear(weights, Monte::BiasPotential::TYPE::LINEAR, -3.0);
+  BOOST_CHECK_CLOSE(linear.value(2.0), -6.0, 1e-10);
+
+  Monte::BiasPotential table(weights, {0.0, 1.0, 2.0}, {1.0, 3.0, 2.0});
+  BOOST_CHECK_EQUAL(table.value(-1.0), 1.0);
+  BOOST_CHECK_CLOSE(table.value(0.5), 2.0, 1e-10);
+  BOOST_CHECK_CLOSE(table.value(1.5), 2.5, 1e-10);
+  BOOST_CHECK_EQUAL(table.value(5.0), 2.0);
+
+  BOOST_CHECK_THROW(Monte::BiasPotential(weights, {0.0, 1.0}, {1.0}), std::runtime_error);
+  BOOST_CHECK_THROW(Monte::BiasPotential(weights, {1.0, 0.0}, {1.0, 2.0}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(FromJSON) {
+
+  jsonParser json = jsonParser::parse(std::string(
+                                        "{\"order_parameter\": {\"corr\": {\"1\": 1.0, \"2\": -1.0}},"
+                                        " \"potential\": {\"type\": \"harmonic\", \"center\": 0.5, \"spring\": 4.0}}"));
+
+  auto bias = jsonConstructor<Monte::BiasPotential>::from_json(json, 3);
+  BOOST_CHECK_EQUAL(bias.weights().size(), 2);
+  BOOST_CHECK_CLOSE(bias.value(1.0), 0.5, 1e-10);
+
+  BOOST_CHECK_THROW(jsonConstructor<Monte::BiasPotential>::from_json(json, 2), std::runtime_error);
+
+  json["potential"]["type"] = "cubic";
+  BOOST_CHECK_THROW(jsonConstructor<Monte::BiasPotential>::from_json(json, 3), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Reweighting) {
+
+  // N independent spins, q = fraction of up spins, with a linear bias that
+  // favors up spins; reweighting should recover <q> = 0.5
+  Index N = 10;
+  double beta = 1.0;
+  std::vector<std::pair<Index, double> > weights = {{0, 1.0}};
+  Monte::BiasPotential bias(weights, Monte::BiasPotential::TYPE::LINEAR, -0.5);
+
+  MTRand mtrand(MTRand::uint32(0));
+  std::vector<int> spin(N, 0);
+  double q = 0.0;
+  Index n_samples = 20000;
+  Eigen::VectorXd obs(n_samples);
+  Eigen::VectorXd bias_energy(n_samples);
+
+  for(Index s = 0; s < n_samples; ++s) {
+    for(Index step = 0; step < N; ++step) {
+      Index i = mtrand.randInt(N - 1);
+      Eigen::VectorXd dCorr(1);
+      dCorr(0) = spin[i] ? -1.0 : 1.0;
+      double dq = bias.delta_order_parameter(dCorr, N);
+      double dE = bias.delta(q, dq, N);
+      if(dE < 0.0 || mtrand.rand53() < std::exp(-beta * dE)) {
+        spin[i] = 1 - spin[i];
+        q += dq;
+      }
+    }
+    obs(s) = q;
+    bias_energy(s) = bias.value(q);
+  }
+
+  BOOST_CHECK(obs.mean() > 0.55);
+  BOOST_CHECK_SMALL(Monte::reweighted_mean(obs, bias_energy, beta, N) - 0.5, 0.02);
+
+  Eigen::VectorXd w = Monte::reweighting_weights(bias_energy, beta, N);
+  BOOST_CHECK_CLOSE(w.sum(), 1.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
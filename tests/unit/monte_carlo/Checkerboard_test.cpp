@@ -0,0 +1,149 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/Checkerboard.hh"
+
+/// What is being used to test it:
+#include <set>
+#include <boost/filesystem.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+#include "casm/clex/NeighborList.hh"
+#include "casm/monte_carlo/SiteExchanger.hh"
+#include "casm/monte_carlo/canonical/Canonical.hh"
+#include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(CheckerboardTest)
+
+namespace {
+
+  /// Check that parallel sweeps keep valid occupations, and properties that match
+  /// a full recalculation for the final configuration
+  template<typename RunType>
+  void check_sweeps(PrimClex &primclex, const fs::path &settings_path, Index n_sweeps) {
+
+    Log &log = null_log();
+    typename RunType::SettingsType settings(primclex, settings_path);
+    auto conditions = settings.initial_conditions();
+
+    RunType mc(primclex, settings, log);
+    BOOST_REQUIRE(mc.is_parallel_sweep());
+    ConfigDoF init_configdof = mc.set_state(conditions, settings).first;
+
+    for(Index i = 0; i < n_sweeps; ++i) {
+      mc.parallel_sweep();
+    }
+
+    const auto &occ = mc.configdof().occupation();
+    auto max_occ = mc.supercell().max_allowed_occupation();
+    for(Index l = 0; l < occ.size(); ++l) {
+      BOOST_CHECK(occ[l] >= 0 && occ[l] <= max_occ[l]);
+    }
+    BOOST_CHECK(occ != init_configdof.occupation());
+
+    // recalculate from scratch
+    RunType ref_mc(primclex, settings, log);
+    ref_mc.set_state(conditions, mc.configdof());
+
+    BOOST_CHECK_SMALL(mc.formation_energy() - ref_mc.formation_energy(), 1e-8);
+    BOOST_CHECK_SMALL(mc.potential_energy() - ref_mc.potential_energy(), 1e-8);
+    BOOST_CHECK_SMALL((mc.corr() - ref_mc.corr()).norm(), 1e-8);
+    BOOST_CHECK_SMALL(mc.potential_energy() - mc.potential_energy(mc.config()), 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Test0) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  fs::path eci_src = "tests/unit/monte_carlo/eci_0.json";
+  fs::path eci_dest = primclex.dir().eci("formation_energy", "default", "default", "default", "default");
+  fs::copy_file(eci_src, eci_dest, fs::copy_option::overwrite_if_exists);
+
+  fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+  fs::path bspecs_dest = primclex.dir().bspecs("default");
+  fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+  // for autotools
+  primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+  primclex.settings().commit();
+
+  CommandArgs args("casm bset -u", &primclex, primclex.dir().root_dir(), Logging::null());
+  BOOST_REQUIRE(!casm_api(args));
+
+  fs::path mc_dir = primclex.dir().root_dir() / "mc_checkerboard";
+  fs::create_directory(mc_dir);
+
+  // a supercell large enough to use delta correlations
+  jsonParser gc_json;
+  gc_json.read(fs::path("tests/unit/monte_carlo/metropolis_grand_canonical_0.json"));
+  gc_json["supercell"] = std::vector<std::vector<int> > {{8, 0, 0}, {0, 8, 0}, {0, 0, 6}};
+  gc_json["driver"]["motif"]["configname"] = "default";
+  gc_json["driver"]["initial_conditions"]["param_chem_pot"]["a"] = -1.0;
+  gc_json["driver"]["parallel_sweep"] = 4;
+  fs::path gc_settings_path = mc_dir / "grand_canonical.json";
+  gc_json.write(gc_settings_path);
+
+  // groups: each variable site is in exactly one group, and the neighborhood
+  // of each site includes no other site of its group
+  {
+    GrandCanonicalSettings settings(primclex, gc_settings_path);
+    GrandCanonical mc(primclex, settings, null_log());
+    mc.set_state(settings.initial_conditions(), settings);
+
+    const SuperNeighborList &nlist = mc.nlist();
+    SiteExchanger site_swaps(mc.supercell());
+    MTRand mtrand(1234);
+    Monte::Checkerboard checkerboard(
+      nlist, mc.supercell().volume(), site_swaps.variable_sites(), 2, mtrand);
+
+    BOOST_CHECK(checkerboard.n_colors() > 1);
+
+    std::vector<Index> group_of(mc.configdof().size(), checkerboard.size());
+    Index n_sites = 0;
+    for(Index g = 0; g < checkerboard.size(); ++g) {
+      for(Index l : checkerboard.group(g)) {
+        BOOST_CHECK_EQUAL(group_of[l], checkerboard.size());
+        group_of[l] = g;
+        ++n_sites;
+      }
+    }
+    BOOST_CHECK_EQUAL(n_sites, site_swaps.variable_sites().size());
+
+    for(Index g = 0; g < checkerboard.size(); ++g) {
+      for(Index l : checkerboard.group(g)) {
+        for(Index n : nlist.sites(nlist.unitcell_index(l))) {
+          BOOST_CHECK(n == l || group_of[n] != g);
+        }
+      }
+    }
+  }
+
+  // grand canonical sweeps
+  check_sweeps<GrandCanonical>(primclex, gc_settings_path, 20);
+
+  // canonical sweeps
+  jsonParser c_json = gc_json;
+  c_json["ensemble"] = "canonical";
+  for(std::string cond : {
+        "initial_conditions", "final_conditions", "incremental_conditions"
+      }) {
+    c_json["driver"][cond].erase("param_chem_pot");
+    c_json["driver"][cond]["comp"]["a"] = (cond == "incremental_conditions") ? 0.0 : 0.3;
+  }
+  fs::path c_settings_path = mc_dir / "canonical.json";
+  c_json.write(c_settings_path);
+  check_sweeps<Monte::Canonical>(primclex, c_settings_path, 20);
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+///   Clexulator::calc_delta_point_energy, as generated by 'casm bset -uf'
+
+/// What is being used to test it:
+#include <boost/filesystem.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+#include "casm/clex/ECIContainer.hh"
+#include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(DeltaPointEnergyTest)
+
+BOOST_AUTO_TEST_CASE(CompareToDeltaCorr) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  fs::path eci_src = "tests/unit/monte_carlo/eci_0.json";
+  fs::path eci_dest = primclex.dir().eci("formation_energy", "default", "default", "default", "default");
+  fs::copy_file(eci_src, eci_dest, fs::copy_option::overwrite_if_exists);
+
+  fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+  fs::path bspecs_dest = primclex.dir().bspecs("default");
+  fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+  // for autotools
+  primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+  primclex.settings().commit();
+
+  auto check = [&](std::string str) {
+    CommandArgs args(str, &primclex, primclex.dir().root_dir(), Logging::null());
+    return !casm_api(args);
+  };
+
+  BOOST_REQUIRE(check(R"(casm bset -uf)"));
+
+  ClexDescription desc = primclex.settings().default_clex();
+  Clexulator clexulator = primclex.clexulator(desc);
+  BOOST_REQUIRE(clexulator.has_delta_point_energy());
+
+  const ECIContainer &eci = primclex.eci(desc);
+  Index N_corr = clexulator.corr_size();
+  std::vector<double> dense_eci(N_corr, 0.0);
+  for(Index i = 0; i < eci.index().size(); ++i) {
+    dense_eci[eci.index()[i]] = eci.value()[i];
+  }
+
+  // every change of occupant, on every sublattice, for several occupations of
+  // a neighbor list that does not wrap around
+  std::vector<int> sublat_indices(primclex.nlist().sublat_indices().begin(),
+                                  primclex.nlist().sublat_indices().end());
+  const auto &basis = primclex.get_prim().basis;
+  long N = clexulator.nlist_size();
+  std::vector<long> nlist(N);
+  std::vector<int> occ(N);
+  std::vector<double> dcorr(N_corr);
+  for(long k = 0; k < N; ++k) {
+    nlist[k] = k;
+  }
+  clexulator.set_nlist(nlist.data());
+
+  for(Index round = 0; round < 5; ++round) {
+    for(long k = 0; k < N; ++k) {
+      int n_occ = basis[sublat_indices[k % sublat_indices.size()]].site_occupant().size();
+      occ[k] = (k * (2 * round + 7) + round + 3) % n_occ;
+    }
+    clexulator.set_config_occ(occ.data());
+
+    for(Index nl = 0; nl < sublat_indices.size(); ++nl) {
+      int b = sublat_indices[nl];
+      int n_occ = basis[b].site_occupant().size();
+      for(int occ_f = 0; occ_f < n_occ; ++occ_f) {
+        int occ_i = occ[nl];
+        if(occ_f == occ_i) {
+          continue;
+        }
+        clexulator.calc_delta_point_corr(b, occ_i, occ_f, dcorr.data());
+        double expected = 0.0;
+        for(Index i = 0; i < N_corr; ++i) {
+          expected += dense_eci[i] * dcorr[i];
+        }
+        BOOST_CHECK_SMALL(
+          clexulator.calc_delta_point_energy(b, occ_i, occ_f, dense_eci.data()) - expected,
+          1e-10);
+      }
+    }
+  }
+
+  // the same, through GrandCanonical with and without the fused path
+  fs::path mc_dir = primclex.dir().root_dir() / "mc_delta_point_energy";
+  fs::create_directory(mc_dir);
+
+  jsonParser json;
+  json.read(fs::path("tests/unit/monte_carlo/metropolis_grand_canonical_0.json"));
+  json["supercell"] = std::vector<std::vector<int> > {{8, 0, 0}, {0, 8, 0}, {0, 0, 6}};
+  json["driver"]["motif"]["configname"] = "default";
+  json["driver"]["initial_conditions"]["param_chem_pot"]["a"] = -1.0;
+  fs::path ref_settings_dest = mc_dir / "metropolis_grand_canonical_corr.json";
+  json.write(ref_settings_dest);
+
+  // without correlation sampling, the fused path is used
+  jsonParser &measurements = json["data"]["measurements"];
+  jsonParser fused_measurements = jsonParser::array();
+  for(auto it = measurements.begin(); it != measurements.end(); ++it) {
+    if((*it)["quantity"].get<std::string>() != "all_correlations") {
+      fused_measurements.push_back(*it);
+    }
+  }
+  measurements = fused_measurements;
+  fs::path settings_dest = mc_dir / "metropolis_grand_canonical_fused.json";
+  json.write(settings_dest);
+
+  Log &log = null_log();
+  GrandCanonicalSettings settings(primclex, settings_dest);
+  GrandCanonicalSettings ref_settings(primclex, ref_settings_dest);
+  GrandCanonical mc(primclex, settings, log);
+  GrandCanonical ref_mc(primclex, ref_settings, log);
+  BOOST_REQUIRE(mc.use_delta_energy());
+  BOOST_REQUIRE(!ref_mc.use_delta_energy());
+
+  ConfigDoF configdof = mc.set_state(settings.initial_conditions(), settings).first;
+  ref_mc.set_state(settings.initial_conditions(), configdof);
+
+  Index n_accept = 0;
+  for(Index step = 0; step < 2000; ++step) {
+    const auto &event = mc.propose();
+    const auto &mod = event.occupational_change();
+    BOOST_CHECK_SMALL(event.dEpot() - ref_mc.site_dEpot(mod.site_index(), mod.to_value()), 1e-8);
+    if(mc.check(event)) {
+      mc.accept(event);
+      ref_mc.set_configdof(mc.configdof());
+      ++n_accept;
+    }
+    else {
+      mc.reject(event);
+    }
+  }
+  BOOST_CHECK(n_accept > 0);
+  BOOST_CHECK_SMALL(mc.formation_energy() - ref_mc.formation_energy(), 1e-8);
+  BOOST_CHECK_SMALL(mc.potential_energy() - ref_mc.potential_energy(), 1e-8);
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,129 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <limits>
+#include <set>
+#include <boost/filesystem.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(GrandCanonicalLTETest)
+
+BOOST_AUTO_TEST_CASE(PointECI) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  // only the point ECI are non-zero, so excitations on different sites do not interact
+  jsonParser eci_json;
+  eci_json.read(fs::path("tests/unit/monte_carlo/eci_0.json"));
+  jsonParser &cluster_functions = eci_json["cluster_functions"];
+  for(auto it = cluster_functions.begin(); it != cluster_functions.end(); ++it) {
+    if((*it)["prototype"]["sites"].size() != 1 && it->contains("eci")) {
+      it->erase("eci");
+    }
+  }
+  eci_json.write(primclex.dir().eci("formation_energy", "default", "default", "default", "default"));
+
+  fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+  fs::path bspecs_dest = primclex.dir().bspecs("default");
+  fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+  // for autotools
+  primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+  primclex.settings().commit();
+
+  auto check = [&](std::string str) {
+    CommandArgs args(str, &primclex, primclex.dir().root_dir(), Logging::null());
+    return !casm_api(args);
+  };
+
+  BOOST_REQUIRE(check(R"(casm bset -u)"));
+
+  fs::path mc_dir = primclex.dir().root_dir() / "mc_lte";
+  fs::create_directory(mc_dir);
+
+  jsonParser json;
+  json.read(fs::path("tests/unit/monte_carlo/metropolis_grand_canonical_0.json"));
+  json["supercell"] = std::vector<std::vector<int> > {{6, 0, 0}, {0, 6, 0}, {0, 0, 4}};
+  json["driver"]["motif"]["configname"] = "default";
+  json["driver"]["initial_conditions"]["param_chem_pot"]["a"] = -10.0;
+  fs::path settings_dest = mc_dir / "metropolis_grand_canonical_lte.json";
+  json.write(settings_dest);
+
+  Log &log = null_log();
+  GrandCanonicalSettings settings(primclex, settings_dest);
+  GrandCanonical mc(primclex, settings, log);
+  GrandCanonicalConditions conditions = settings.initial_conditions();
+  mc.set_state(conditions, settings);
+
+  // variable sites, and the lowest excitation energy
+  const auto &basis = primclex.get_prim().basis;
+  Index volume = mc.supercell().volume();
+  std::vector<bool> is_variable(mc.configdof().size());
+  double min_dEpot = std::numeric_limits<double>::max();
+  Index n_excitations = 0;
+  for(Index l = 0; l < mc.configdof().size(); ++l) {
+    int n_occ = basis[l / volume].site_occupant().size();
+    is_variable[l] = (n_occ > 1);
+    for(int occ = 0; occ < n_occ; ++occ) {
+      if(n_occ > 1 && occ != mc.configdof().occ(l)) {
+        min_dEpot = std::min(min_dEpot, mc.site_dEpot(l, occ));
+        ++n_excitations;
+      }
+    }
+  }
+  BOOST_REQUIRE(n_excitations > 0);
+  BOOST_REQUIRE_MESSAGE(min_dEpot > 0.0, "motif is not the ground state");
+
+  // pair multiplicities sum to the number of interacting pairs of variable sites
+  const SuperNeighborList &nlist = mc.nlist();
+  std::set<std::pair<Index, Index> > interacting;
+  for(Index l = 0; l < mc.configdof().size(); ++l) {
+    if(!is_variable[l]) {
+      continue;
+    }
+    for(Index m : nlist.sites(nlist.unitcell_index(l))) {
+      if(m != l && is_variable[m]) {
+        interacting.insert(std::make_pair(std::min(l, m), std::max(l, m)));
+      }
+    }
+  }
+
+  std::vector<GrandCanonical::LTEPair> pairs = mc.lte_pairs();
+  Index n_pairs = 0;
+  for(const auto &pair : pairs) {
+    BOOST_CHECK(pair.i < pair.j);
+    BOOST_CHECK(pair.multiplicity > 0);
+    n_pairs += pair.multiplicity;
+  }
+  BOOST_CHECK_EQUAL(n_pairs, interacting.size());
+  BOOST_CHECK(pairs.size() < interacting.size());
+
+  // at a temperature where the sum of single site excitations, SUM_i(x_i), is
+  // at most 1e-4, phi_LTE2 and phi_LTE1 agree to O(SUM_i(x_i))
+  double beta = std::log(n_excitations / 1e-4) / min_dEpot;
+  conditions.set_temperature(1.0 / (KB * beta));
+  mc.set_conditions(conditions);
+
+  double phi1 = mc.lte_grand_canonical_free_energy();
+  double phi2 = mc.lte2_grand_canonical_free_energy();
+  double Epot = mc.potential_energy();
+  BOOST_CHECK(Epot - phi1 > 0.0);
+  BOOST_CHECK_CLOSE(Epot - phi2, Epot - phi1, 0.1);
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -53,6 +53,48 @@ BOOST_AUTO_TEST_CASE(Test0) {
 
   BOOST_CHECK(check(std::string("casm monte -s ") + settings_dest.string()));
 
+  // single site energy changes and properties are the same with and without
+  // the site energy cache, as events are accepted
+  jsonParser json;
+  json.read(settings_src);
+  json["driver"]["site_energy_cache"] = true;
+  fs::path cache_settings_dest = mc_dir / "metropolis_grand_canonical_cache.json";
+  json.write(cache_settings_dest);
+
+  Log &log = null_log();
+  GrandCanonicalSettings settings(primclex, settings_dest);
+  GrandCanonicalSettings cache_settings(primclex, cache_settings_dest);
+  GrandCanonical mc(primclex, settings, log);
+  GrandCanonical cache_mc(primclex, cache_settings, log);
+  BOOST_CHECK(!mc.site_energy_cache().is_enabled());
+  BOOST_REQUIRE(cache_mc.site_energy_cache().is_enabled());
+
+  ConfigDoF configdof = mc.set_state(settings.initial_conditions(), settings).first;
+  cache_mc.set_state(settings.initial_conditions(), configdof);
+
+  const auto &basis = primclex.get_prim().basis;
+  Index volume = cache_mc.supercell().volume();
+  for(Index round = 0; round < 10; ++round) {
+    for(Index step = 0; step < 100; ++step) {
+      const auto &event = cache_mc.propose();
+      if(cache_mc.check(event)) {
+        cache_mc.accept(event);
+      }
+    }
+    mc.set_configdof(cache_mc.configdof());
+    BOOST_CHECK_SMALL(cache_mc.formation_energy() - mc.formation_energy(), 1e-8);
+    BOOST_CHECK_SMALL((cache_mc.comp_n() - mc.comp_n()).norm(), 1e-8);
+
+    for(Index l = 0; l < cache_mc.configdof().size(); ++l) {
+      for(int occ = 0; occ < basis[l / volume].site_occupant().size(); ++occ) {
+        if(basis[l / volume].site_occupant().size() > 1 && occ != cache_mc.configdof().occ(l)) {
+          BOOST_CHECK_SMALL(cache_mc.site_dEpot(l, occ) - mc.site_dEpot(l, occ), 1e-8);
+        }
+      }
+    }
+  }
+  BOOST_CHECK(cache_mc.site_energy_cache().hits() > 0);
+
 }
 
 BOOST_AUTO_TEST_SUITE_END()
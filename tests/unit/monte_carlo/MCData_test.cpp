@@ -0,0 +1,150 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/MCData.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(MCDataTest)
+
+BOOST_AUTO_TEST_CASE(MeanAndSquaredNorm) {
+
+  MCData data;
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for(Index i = 0; i < 1000; ++i) {
+    data.push_back(-3.0 + dist(gen));
+  }
+
+  for(MCData::size_type start : {0, 1, 17, 500, 998}) {
+    auto obs = data.observations().segment(start, data.size() - start);
+    MCDataConvergence conv(data, start, 0.95);
+    BOOST_CHECK_CLOSE(conv.mean(), obs.mean(), 1e-8);
+    BOOST_CHECK_CLOSE(conv.squared_norm(), obs.squaredNorm(), 1e-8);
+  }
+
+  data.clear();
+  BOOST_CHECK_EQUAL(data.size(), 0);
+  data.push_back(1.0);
+  data.push_back(1.0);
+  MCDataConvergence conv(data, 0, 0.95);
+  BOOST_CHECK_EQUAL(conv.mean(), 1.0);
+  BOOST_CHECK_EQUAL(conv.calculated_precision(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(SharedStore) {
+
+  // columns of a shared MCDataStore give the same results as separate MCData
+  MCDataStore store(3, 10);
+  std::vector<MCData> single(3);
+  std::vector<MCData> view;
+  for(Index c = 0; c < 3; ++c) {
+    view.emplace_back(store, c);
+  }
+
+  std::mt19937 gen(0);
+  std::normal_distribution<double> dist(0.0, 1.0);
+  Eigen::Vector3d row;
+  for(Index i = 0; i < 1000; ++i) {
+    row << dist(gen), 5.0 + dist(gen), -2.0 * i;
+    store.push_back(row.data());
+    for(Index c = 0; c < 3; ++c) {
+      single[c].push_back(row(c));
+    }
+  }
+  BOOST_CHECK_THROW(view[0].push_back(1.0), std::runtime_error);
+  BOOST_CHECK_EQUAL(store.block_levels(), 10);
+
+  // copies of a view own a copy of its observations
+  MCData copy = view[2];
+  MCDataConvergence copy_conv(copy, 100, 0.95);
+
+  for(Index c = 0; c < 3; ++c) {
+    BOOST_CHECK_EQUAL(view[c].size(), 1000);
+    BOOST_CHECK(view[c].observations() == single[c].observations());
+    MCDataConvergence a(view[c], 100, 0.95);
+    MCDataConvergence b(single[c], 100, 0.95);
+    BOOST_CHECK_EQUAL(a.mean(), b.mean());
+    BOOST_CHECK_EQUAL(a.calculated_precision(), b.calculated_precision());
+  }
+
+  BOOST_CHECK(copy.observations() == view[2].observations());
+  MCDataConvergence view_conv(view[2], 100, 0.95);
+  BOOST_CHECK_EQUAL(copy_conv.mean(), view_conv.mean());
+  BOOST_CHECK_EQUAL(copy_conv.calculated_precision(), view_conv.calculated_precision());
+
+  view[1].clear();
+  BOOST_CHECK_EQUAL(store.size(), 0);
+  BOOST_CHECK_EQUAL(view[0].size(), 0);
+  BOOST_CHECK_EQUAL(copy.size(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(BlockGrowth) {
+
+  // blocking statistics do not depend on the reserved space, or on earlier
+  // observations that were cleared
+  MCDataStore reserved(2, 1000);
+  MCDataStore grown(2, 1);
+  std::mt19937 gen(0);
+  std::normal_distribution<double> dist(0.0, 1.0);
+  std::vector<double> sample(2);
+  for(Index i = 0; i < 700; ++i) {
+    sample[0] = dist(gen);
+    sample[1] = 3.0 * dist(gen);
+    grown.push_back(sample.data());
+  }
+  grown.clear();
+  BOOST_CHECK_EQUAL(grown.block_levels(), 1);
+
+  for(Index i = 0; i < 300; ++i) {
+    sample[0] = dist(gen);
+    sample[1] = 3.0 * dist(gen);
+    reserved.push_back(sample.data());
+    grown.push_back(sample.data());
+  }
+  BOOST_CHECK_EQUAL(reserved.block_levels(), 9);
+  BOOST_CHECK_EQUAL(grown.block_levels(), 9);
+
+  for(Index k = 0; k < reserved.block_levels(); ++k) {
+    for(MCDataStore::size_type j = 0; j <= (reserved.size() >> k); ++j) {
+      for(Index c = 0; c < 2; ++c) {
+        BOOST_CHECK_EQUAL(grown.block_sum(k, j, c), reserved.block_sum(k, j, c));
+        BOOST_CHECK_EQUAL(grown.block_sqsum(k, j, c), reserved.block_sqsum(k, j, c));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CorrelatedPrecision) {
+
+  // AR(1) process: x[i] = phi*x[i-1] + e[i], with Var(e) = 1, for which
+  // Var(<x>) ~ 1 / ((1-phi)^2 * N)
+  double phi = 0.9;
+  MCData data;
+  std::mt19937 gen(0);
+  std::normal_distribution<double> dist(0.0, 1.0);
+  double x = 0.0;
+  MCData::size_type start = 1000;
+  MCData::size_type N = 1 << 18;
+  for(MCData::size_type i = 0; i < start + N; ++i) {
+    x = phi * x + dist(gen);
+    data.push_back(10.0 + x);
+  }
+
+  double conf = 0.95;
+  double z_alpha = 1.959964;
+  double expected = z_alpha * sqrt(1.0 / ((1.0 - phi) * (1.0 - phi) * N));
+
+  MCDataConvergence conv(data, start, conf);
+  BOOST_CHECK_CLOSE(conv.calculated_precision(), expected, 20.0);
+  BOOST_CHECK(conv.is_converged(2.0 * expected));
+  BOOST_CHECK(!conv.is_converged(0.5 * expected));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
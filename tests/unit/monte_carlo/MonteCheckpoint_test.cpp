@@ -0,0 +1,157 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/MonteCheckpoint.hh"
+
+/// What is being used to test it:
+#include <sstream>
+#include <boost/filesystem.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+#include "casm/monte_carlo/canonical/Canonical.hh"
+#include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(MonteCheckpointTest)
+
+namespace {
+
+  /// Perform 'n_steps' steps, as MonteDriver does
+  template<typename RunType>
+  void run_steps(RunType &mc, Index n_steps) {
+    Index step = 0;
+    while(step < n_steps) {
+      if(mc.is_rejection_free()) {
+        bool accepted;
+        step += mc.rejection_free_step(n_steps - step, accepted);
+      }
+      else if(mc.is_parallel_sweep()) {
+        mc.parallel_sweep();
+        step += mc.steps_per_pass();
+      }
+      else {
+        const auto &event = mc.propose();
+        if(mc.check(event)) {
+          mc.accept(event);
+        }
+        else {
+          mc.reject(event);
+        }
+        ++step;
+      }
+    }
+  }
+
+  /// Check that stopping and resuming from a checkpoint, as MonteDriver does,
+  /// gives exactly the same result as an uninterrupted run
+  template<typename RunType>
+  void check_resume(PrimClex &primclex, const fs::path &settings_path) {
+
+    Log &log = null_log();
+    typename RunType::SettingsType settings(primclex, settings_path);
+    auto conditions = settings.initial_conditions();
+
+    RunType mc(primclex, settings, log);
+    mc.set_state(conditions, settings);
+    run_steps(mc, 2000);
+
+    std::stringstream ss;
+    mc.write_checkpoint(ss);
+    ConfigDoF configdof = mc.configdof();
+
+    run_steps(mc, 5000);
+
+    RunType resumed(primclex, settings, log);
+    resumed.set_state(conditions, configdof);
+    resumed.read_checkpoint(ss);
+
+    run_steps(resumed, 5000);
+
+    BOOST_CHECK(resumed.configdof().occupation() == mc.configdof().occupation());
+    for(const auto &prop : mc.scalar_properties()) {
+      BOOST_CHECK_EQUAL(resumed.scalar_property(prop.first), prop.second);
+    }
+    for(const auto &prop : mc.vector_properties()) {
+      BOOST_CHECK(resumed.vector_property(prop.first) == prop.second);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ResumeTest) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  fs::path eci_src = "tests/unit/monte_carlo/eci_0.json";
+  fs::path eci_dest = primclex.dir().eci("formation_energy", "default", "default", "default", "default");
+  fs::copy_file(eci_src, eci_dest, fs::copy_option::overwrite_if_exists);
+
+  fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+  fs::path bspecs_dest = primclex.dir().bspecs("default");
+  fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+  // for autotools
+  primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+  primclex.settings().commit();
+
+  auto check = [&](std::string str) {
+    CommandArgs args(str, &primclex, primclex.dir().root_dir(), Logging::null());
+    return !casm_api(args);
+  };
+
+  BOOST_CHECK(check(R"(casm bset -u)"));
+
+  fs::path mc_dir = primclex.dir().root_dir() / "mc_checkpoint";
+  fs::create_directory(mc_dir);
+
+  // a supercell large enough to use delta correlations
+  jsonParser gc_json;
+  gc_json.read(fs::path("tests/unit/monte_carlo/metropolis_grand_canonical_0.json"));
+  gc_json["supercell"] = std::vector<std::vector<int> > {{8, 0, 0}, {0, 8, 0}, {0, 0, 6}};
+  gc_json["driver"]["motif"]["configname"] = "default";
+  gc_json["driver"]["initial_conditions"]["param_chem_pot"]["a"] = -1.0;
+
+  auto write = [&](const jsonParser & json, std::string name) {
+    fs::path path = mc_dir / name;
+    json.write(path);
+    return path;
+  };
+
+  // grand canonical: Metropolis, rejection-free, and parallel sweeps
+  check_resume<GrandCanonical>(primclex, write(gc_json, "grand_canonical.json"));
+
+  jsonParser json = gc_json;
+  json["driver"]["rejection_free"] = true;
+  check_resume<GrandCanonical>(primclex, write(json, "grand_canonical_rf.json"));
+
+  json = gc_json;
+  json["driver"]["parallel_sweep"] = 2;
+  check_resume<GrandCanonical>(primclex, write(json, "grand_canonical_sweep.json"));
+
+  // canonical: Metropolis and kinetic Monte Carlo
+  jsonParser c_json = gc_json;
+  c_json["ensemble"] = "canonical";
+  for(std::string cond : {
+        "initial_conditions", "final_conditions", "incremental_conditions"
+      }) {
+    c_json["driver"][cond].erase("param_chem_pot");
+    c_json["driver"][cond]["comp"]["a"] = (cond == "incremental_conditions") ? 0.0 : 0.3;
+  }
+  check_resume<Monte::Canonical>(primclex, write(c_json, "canonical.json"));
+
+  json = c_json;
+  json["method"] = "kmc";
+  json["kmc"]["hop_cutoff"] = 3.3;
+  json["kmc"]["kra"]["O"] = 0.5;
+  check_resume<Monte::Canonical>(primclex, write(json, "canonical_kmc.json"));
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
+#include "casm/monte_carlo/grand_canonical/GrandCanonicalIO.hh"
+#include "casm/monte_carlo/MonteIO.hh"
+#include "casm/monte_carlo/MonteDriver.hh"
+
+/// What is being used to test it:
+#include <sstream>
+#include "casm/monte_carlo/MonteCheckpoint.hh"
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(MonteDriverTest)
+
+namespace {
+
+  std::string read_file(const fs::path &path) {
+    fs::ifstream sin(path);
+    std::stringstream ss;
+    ss << sin.rdbuf();
+    return ss.str();
+  }
+
+  /// Copy the test ECI and basis set specs, and generate the Clexulator
+  void make_clex(PrimClex &primclex) {
+    fs::path eci_src = "tests/unit/monte_carlo/eci_0.json";
+    fs::path eci_dest = primclex.dir().eci("formation_energy", "default", "default", "default", "default");
+    fs::copy_file(eci_src, eci_dest, fs::copy_option::overwrite_if_exists);
+
+    fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+    fs::path bspecs_dest = primclex.dir().bspecs("default");
+    fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+    // for autotools
+    primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+    primclex.settings().commit();
+
+    CommandArgs args("casm bset -u", &primclex, primclex.dir().root_dir(), Logging::null());
+    BOOST_REQUIRE(!casm_api(args));
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentTest) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+  make_clex(primclex);
+
+  // independent runs of 4 conditions, with a fixed number of passes and a seed
+  jsonParser json;
+  json.read(fs::path("tests/unit/monte_carlo/metropolis_grand_canonical_0.json"));
+  json["data"].erase("min_pass");
+  json["data"]["N_pass"] = 200;
+  for(auto &measurement : json["data"]["measurements"]) {
+    measurement.erase("precision");
+  }
+  json["driver"]["seed"] = 1234;
+  json["driver"]["site_energy_cache"] = true;
+  json["driver"]["initial_conditions"]["param_chem_pot"]["a"] = -1.0;
+  json["driver"]["final_conditions"]["param_chem_pot"]["a"] = -0.7;
+
+  // run sequentially, and with 2 threads, returning the log
+  auto run = [&](Index threads) {
+    fs::path mc_dir = primclex.dir().root_dir() / ("mc_driver_" + std::to_string(threads));
+    fs::remove_all(mc_dir);
+    fs::create_directory(mc_dir);
+    json["driver"]["threads"] = threads;
+    json.write(mc_dir / "monte_settings.json");
+
+    OStringStreamLog log;
+    GrandCanonicalSettings settings(primclex, mc_dir / "monte_settings.json");
+    MonteDriver<GrandCanonical> driver(primclex, settings, log, log);
+    driver.run();
+    return log.ss().str();
+  };
+
+  std::string sequential_log = run(1);
+  std::string concurrent_log = run(2);
+
+  BOOST_CHECK(sequential_log.find("Concurrent calculations") == std::string::npos);
+  BOOST_CHECK(concurrent_log.find("Concurrent calculations") != std::string::npos);
+
+  // ensemble specific output is written by both
+  auto count = [](const std::string &str, const std::string &substr) {
+    Index n = 0;
+    for(auto pos = str.find(substr); pos != std::string::npos; pos = str.find(substr, pos + 1)) {
+      ++n;
+    }
+    return n;
+  };
+  BOOST_CHECK_EQUAL(count(sequential_log, "hit rate: "), 4);
+  BOOST_CHECK_EQUAL(count(concurrent_log, "hit rate: "), 4);
+
+  MonteCarloDirectoryStructure seq(primclex.dir().root_dir() / "mc_driver_1");
+  MonteCarloDirectoryStructure con(primclex.dir().root_dir() / "mc_driver_2");
+
+  BOOST_CHECK(jsonParser(seq.results_json()) == jsonParser(con.results_json()));
+  BOOST_CHECK_EQUAL(read_file(seq.results_csv()), read_file(con.results_csv()));
+  BOOST_CHECK_EQUAL(jsonParser(seq.results_json())["<potential_energy>"].size(), 4);
+
+  for(Index i = 0; i < 4; ++i) {
+    BOOST_CHECK(jsonParser(seq.conditions_json(i)) == jsonParser(con.conditions_json(i)));
+    BOOST_CHECK(jsonParser(seq.final_state_json(i)) == jsonParser(con.final_state_json(i)));
+    BOOST_CHECK(fs::exists(fs::path(con.observations_json(i).string() + ".gz")));
+    BOOST_CHECK(!fs::exists(con.checkpoint_bin(i)));
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(DependentResumeTest) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+  make_clex(primclex);
+
+  // dependent runs of 2 conditions, with first run equilibration
+  jsonParser json;
+  json.read(fs::path("tests/unit/monte_carlo/metropolis_grand_canonical_0.json"));
+  json["data"].erase("min_pass");
+  json["data"]["N_pass"] = 100;
+  json["data"]["equilibration_passes_first_run"] = 100;
+  for(auto &measurement : json["data"]["measurements"]) {
+    measurement.erase("precision");
+  }
+  json["driver"]["dependent_runs"] = true;
+  json["driver"]["seed"] = 1234;
+  json["driver"]["initial_conditions"]["param_chem_pot"]["a"] = -1.0;
+  json["driver"]["final_conditions"]["param_chem_pot"]["a"] = -0.9;
+
+  fs::path mc_dir = primclex.dir().root_dir() / "mc_driver_dependent_resume";
+  fs::remove_all(mc_dir);
+  fs::create_directory(mc_dir);
+  json.write(mc_dir / "monte_settings.json");
+
+  GrandCanonicalSettings settings(primclex, mc_dir / "monte_settings.json");
+  MonteCarloDirectoryStructure dir(mc_dir);
+
+  // a checkpoint for conditions 0, as if stopped before the first pass
+  {
+    GrandCanonical mc(primclex, settings, null_log());
+    mc.set_state(settings.initial_conditions(), settings);
+
+    fs::create_directories(dir.conditions_dir(0));
+    fs::ofstream sout(dir.checkpoint_bin(0), std::ios::out | std::ios::binary);
+    checkpoint::write(sout, std::string("CASMCHK2"));
+    checkpoint::write(sout, Index(0));
+    checkpoint::write(sout, MonteCounter::size_type(0));
+    checkpoint::write(sout, MonteCounter::size_type(0));
+    checkpoint::write(sout, MonteCounter::size_type(0));
+    checkpoint::write(sout, mc.configdof().occupation());
+    mc.write_checkpoint(sout);
+    checkpoint::write(sout, Index(0));
+  }
+
+  OStringStreamLog log;
+  MonteDriver<GrandCanonical> driver(primclex, settings, log, log);
+  driver.run();
+
+  // resumed without the first run state or equilibration
+  std::string str = log.ss().str();
+  BOOST_CHECK(str.find("Resume from checkpoint") != std::string::npos);
+  BOOST_CHECK(str.find("Equilibration passes") == std::string::npos);
+  BOOST_CHECK(!fs::exists(dir.initial_state_firstruneq_json(0)));
+
+  BOOST_CHECK_EQUAL(jsonParser(dir.results_json())["<potential_energy>"].size(), 2);
+  for(Index i = 0; i < 2; ++i) {
+    BOOST_CHECK(fs::exists(dir.final_state_json(i)));
+    BOOST_CHECK(!fs::exists(dir.checkpoint_bin(i)));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/MonteTrajectory.hh"
+
+/// What is being used to test it:
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(MonteTrajectoryTest)
+
+BOOST_AUTO_TEST_CASE(WriteRead) {
+
+  fs::path dir = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(dir);
+  fs::path file = dir / "trajectory.bin";
+
+  Index n_sites = 1000;
+  Index n_samples = 250;
+  Index keyframe_period = 16;
+
+  // random walk of occupations, with a few sites changed per sample
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<Index> site(0, n_sites - 1);
+  std::uniform_int_distribution<int> occ(0, 2);
+  std::vector<Array<int> > expected;
+  Array<int> occupation(n_sites, 0);
+  {
+    MonteTrajectoryWriter writer(file, n_sites, keyframe_period);
+    for(Index i = 0; i < n_samples; ++i) {
+      for(Index j = 0; j < 5; ++j) {
+        occupation[site(gen)] = occ(gen);
+      }
+      writer.write(i, 2 * i, occupation);
+      expected.push_back(occupation);
+    }
+    BOOST_CHECK_EQUAL(writer.size(), n_samples);
+  }
+
+  // much smaller than storing every snapshot
+  BOOST_CHECK(fs::file_size(file) < n_samples * n_sites / 4);
+
+  MonteTrajectoryReader reader(file);
+  BOOST_CHECK_EQUAL(reader.size(), n_samples);
+  BOOST_CHECK_EQUAL(reader.n_sites(), n_sites);
+  BOOST_CHECK_EQUAL(reader.keyframe_period(), keyframe_period);
+
+  // sequential
+  Index i = 0;
+  while(reader.next()) {
+    BOOST_CHECK_EQUAL(reader.sample(), i);
+    BOOST_CHECK_EQUAL(reader.pass(i), i);
+    BOOST_CHECK_EQUAL(reader.step(i), 2 * i);
+    BOOST_CHECK(reader.occupation() == expected[i]);
+    ++i;
+  }
+  BOOST_CHECK_EQUAL(i, n_samples);
+
+  // random access
+  for(Index i : {200, 3, 17, 16, 15, 249, 0, 100, 101}) {
+    reader.seek(i);
+    BOOST_CHECK(reader.occupation() == expected[i]);
+  }
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(ResumeFromCheckpoint) {
+
+  fs::path dir = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(dir);
+  fs::path file = dir / "trajectory.bin";
+
+  Index n_sites = 100;
+  Index keyframe_period = 8;
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<Index> site(0, n_sites - 1);
+  std::uniform_int_distribution<int> occ(0, 2);
+  auto step = [&](Array<int> &occupation) {
+    for(Index j = 0; j < 3; ++j) {
+      occupation[site(gen)] = occ(gen);
+    }
+  };
+
+  std::vector<Array<int> > expected;
+  Array<int> occupation(n_sites, 0);
+  std::stringstream checkpoint;
+  {
+    MonteTrajectoryWriter writer(file, n_sites, keyframe_period);
+    for(Index i = 0; i < 21; ++i) {
+      step(occupation);
+      writer.write(i, 0, occupation);
+      expected.push_back(occupation);
+    }
+    writer.write_checkpoint(checkpoint);
+
+    // samples after the checkpoint, as if the run stopped before the next one
+    Array<int> lost(occupation);
+    for(Index i = 21; i < 30; ++i) {
+      step(lost);
+      writer.write(i, 0, lost);
+    }
+  }
+
+  {
+    MonteTrajectoryWriter writer(checkpoint);
+    BOOST_CHECK_EQUAL(writer.size(), 21);
+    for(Index i = 21; i < 40; ++i) {
+      step(occupation);
+      writer.write(i, 0, occupation);
+      expected.push_back(occupation);
+    }
+  }
+
+  MonteTrajectoryReader reader(file);
+  BOOST_CHECK_EQUAL(reader.size(), 40);
+  Index i = 0;
+  while(reader.next()) {
+    BOOST_CHECK_EQUAL(reader.pass(i), i);
+    BOOST_CHECK(reader.occupation() == expected[i]);
+    ++i;
+  }
+
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
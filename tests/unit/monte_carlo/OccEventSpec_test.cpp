@@ -0,0 +1,101 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/OccEventSpec.hh"
+
+/// What is being used to test it:
+#include <boost/filesystem.hpp>
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "casm/monte_carlo/Conversions.hh"
+#include "casm/monte_carlo/OccCandidate.hh"
+#include "casm/monte_carlo/OccLocation.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(OccEventSpecTest)
+
+BOOST_AUTO_TEST_CASE(ZrO_PairEvent) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  Eigen::Matrix3i T;
+  T << 3, 0, 0,
+  0, 3, 0,
+  0, 0, 3;
+  Supercell scel(&primclex, T);
+  Monte::Conversions convert(scel);
+  Monte::OccCandidateList cand_list(convert);
+
+  Index O = convert.species_index("O");
+  Index Va = convert.species_index("Va");
+
+  // all asym that may be O or Va
+  std::vector<Index> O_asym;
+  for(Index asym = 0; asym < convert.asym_size(); ++asym) {
+    if(convert.occ_size(asym) > 1 &&
+       convert.species_allowed(asym, O) &&
+       convert.species_allowed(asym, Va)) {
+      O_asym.push_back(asym);
+    }
+  }
+  BOOST_REQUIRE(O_asym.size());
+
+  // O, O -> Va, Va, and the reverse
+  Monte::OccFlipSpec flip(O_asym, O, Va);
+  Monte::OccEventProposer proposer(convert, cand_list, {Monte::OccEventSpec("pair", {flip, flip})});
+  BOOST_CHECK_EQUAL(proposer.size(), 2);
+
+  Configuration config(scel);
+  config.init_occupation();
+  Monte::OccLocation occ_loc(convert, cand_list);
+  occ_loc.initialize(config);
+
+  auto count = [&](Index species) {
+    Index n = 0;
+    for(const auto &asym : O_asym) {
+      n += occ_loc.cand_size(cand_list.index(asym, species));
+    }
+    return n;
+  };
+
+  MTRand mtrand(MTRand::uint32(0));
+  Monte::OccEvent e;
+  Index n_proposed = 0;
+  for(Index step = 0; step < 100000; ++step) {
+
+    double ratio = proposer.propose(e, occ_loc, mtrand);
+    if(ratio == 0.0) {
+      BOOST_CHECK_EQUAL(e.occ_transform.size(), 0);
+      continue;
+    }
+    ++n_proposed;
+
+    BOOST_REQUIRE_EQUAL(e.occ_transform.size(), 2);
+    BOOST_CHECK(e.occ_transform[0].l != e.occ_transform[1].l);
+    for(const auto &occ : e.occ_transform) {
+      BOOST_CHECK_EQUAL(occ_loc.mol(occ.mol_id).species_index, occ.from_species);
+      BOOST_CHECK_EQUAL(config.occ(occ.l), convert.occ_index(occ.asym, occ.from_species));
+    }
+
+    // ratio of the number of ordered pairs before and after
+    Index from = e.occ_transform[0].from_species;
+    Index to = e.occ_transform[0].to_species;
+    double n_from = count(from);
+    double n_to = count(to) + 2;
+    BOOST_CHECK_CLOSE(ratio, (n_from * (n_from - 1.0)) / (n_to * (n_to - 1.0)), 1e-10);
+
+    occ_loc.apply(e, config.configdof());
+  }
+  BOOST_CHECK(n_proposed > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
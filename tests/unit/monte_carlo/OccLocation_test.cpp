@@ -146,6 +146,40 @@ BOOST_AUTO_TEST_CASE(ZrO_DiluteConfig) {
   test::ZrOProj proj;
   run_case(proj, dilute_config, mtrand);
 }
+
+BOOST_AUTO_TEST_CASE(ZrO_NoSwap) {
+
+  MTRand mtrand;
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  Eigen::Matrix3i T;
+  T << 3, 0, 0,
+  0, 3, 0,
+  0, 0, 3;
+  Supercell scel(&primclex, T);
+  Monte::Conversions convert(scel);
+
+  // every variable site has the same occupant, so no canonical swap is possible
+  Configuration config(scel);
+  config.init_occupation();
+
+  Monte::OccCandidateList cand_list(convert);
+  Monte::OccLocation occ_loc(convert, cand_list);
+  occ_loc.initialize(config);
+
+  Monte::OccEvent e;
+  BOOST_CHECK_THROW(occ_loc.propose_canonical(e, cand_list.canonical_swap(), mtrand), std::runtime_error);
+
+  std::vector<Monte::OccSwap> canonical_swap(cand_list.canonical_swap());
+  BOOST_CHECK_THROW(occ_loc.propose_canonical(e, canonical_swap, mtrand), std::runtime_error);
+  BOOST_CHECK_THROW(occ_loc.propose_canonical(e, std::vector<Monte::OccSwap>(), mtrand), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_CASE(FCCTernary_RandomConfig) {
 
   MTRand mtrand;
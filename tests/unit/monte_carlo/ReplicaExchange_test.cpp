@@ -0,0 +1,203 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/grand_canonical/GrandCanonical.hh"
+#include "casm/monte_carlo/grand_canonical/GrandCanonicalIO.hh"
+#include "casm/monte_carlo/MonteIO.hh"
+#include "casm/monte_carlo/ReplicaExchangeDriver.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <boost/filesystem.hpp>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+#include "Common.hh"
+#include "casm/app/casm_functions.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// Probability of energy E = 0, 1, ..., N for N independent spins, with E = number of up spins
+  std::vector<double> spin_probability(Index N, double beta) {
+    std::vector<double> p(N + 1);
+    double sum = 0.0;
+    for(Index E = 0; E <= N; ++E) {
+      p[E] = std::exp(std::lgamma(N + 1.0) - std::lgamma(E + 1.0) - std::lgamma(N - E + 1.0) - beta * E);
+      sum += p[E];
+    }
+    for(auto &x : p) {
+      x /= sum;
+    }
+    return p;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ReplicaExchangeTest)
+
+BOOST_AUTO_TEST_CASE(ExchangeProbability) {
+
+  BOOST_CHECK_EQUAL(replica_exchange_probability(1.0, 2.0, 0.0, 1.0, 0.0, 1.0), 1.0);
+  BOOST_CHECK_CLOSE(replica_exchange_probability(2.0, 1.0, 0.0, 1.0, 0.0, 1.0), std::exp(-1.0), 1e-12);
+
+  // different potentials: D = beta_i*(omega_ij - omega_ii) + beta_j*(omega_ji - omega_jj)
+  BOOST_CHECK_CLOSE(replica_exchange_probability(1.0, 0.5, -1.0, 0.5, 2.0, -1.0), std::exp(-3.0), 1e-12);
+
+  // detailed balance: P(x_i, x_j) * A(x_i, x_j -> x_j, x_i) == P(x_j, x_i) * A(x_j, x_i -> x_i, x_j)
+  MTRand mtrand(12345);
+  for(Index n = 0; n < 100; ++n) {
+    double beta_i = 0.1 + 2.0 * mtrand.rand53();
+    double beta_j = 0.1 + 2.0 * mtrand.rand53();
+    double omega_ii = mtrand.rand53(), omega_ij = mtrand.rand53();
+    double omega_ji = mtrand.rand53(), omega_jj = mtrand.rand53();
+
+    double forward = std::exp(-beta_i * omega_ii - beta_j * omega_jj) *
+                     replica_exchange_probability(beta_i, beta_j, omega_ii, omega_ij, omega_ji, omega_jj);
+    double reverse = std::exp(-beta_i * omega_ij - beta_j * omega_ji) *
+                     replica_exchange_probability(beta_i, beta_j, omega_ij, omega_ii, omega_jj, omega_ji);
+    BOOST_CHECK_CLOSE(forward, reverse, 1e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DetailedBalance) {
+
+  // a ladder of replicas of 3 independent spins, E = number of up spins, as in
+  // ReplicaExchangeDriver with conditions that differ only in temperature
+  Index N = 3;
+  std::vector<double> beta {0.25, 0.5, 1.0, 2.0};
+  Index R = beta.size();
+  std::vector<std::vector<int> > spin(R, std::vector<int>(N, 0));
+  std::vector<double> E(R, 0.0);
+
+  std::vector<std::vector<double> > count(R, std::vector<double>(N + 1, 0.0));
+  std::vector<double> n_attempt(R, 0.0), n_accept(R, 0.0);
+
+  MTRand mtrand(42);
+  Index n_rounds = 400000;
+  for(Index round = 0; round < n_rounds; ++round) {
+
+    // one Metropolis spin flip per replica
+    for(Index r = 0; r < R; ++r) {
+      Index s = mtrand.randInt(N - 1);
+      double dE = spin[r][s] ? -1.0 : 1.0;
+      if(dE < 0.0 || mtrand.rand53() < std::exp(-beta[r] * dE)) {
+        spin[r][s] = 1 - spin[r][s];
+        E[r] += dE;
+      }
+    }
+
+    // exchanges between neighbors, alternating parity
+    for(Index i = round % 2; i + 1 < R; i += 2) {
+      Index j = i + 1;
+      double prob = replica_exchange_probability(beta[i], beta[j], E[i], E[j], E[i], E[j]);
+      n_attempt[i] += 1.0;
+      if(mtrand.rand53() < prob) {
+        std::swap(spin[i], spin[j]);
+        std::swap(E[i], E[j]);
+        n_accept[i] += 1.0;
+      }
+    }
+
+    for(Index r = 0; r < R; ++r) {
+      count[r][Index(E[r])] += 1.0;
+    }
+  }
+
+  // each replica samples its own Boltzmann distribution
+  for(Index r = 0; r < R; ++r) {
+    auto p = spin_probability(N, beta[r]);
+    for(Index e = 0; e <= N; ++e) {
+      BOOST_CHECK_SMALL(count[r][e] / n_rounds - p[e], 0.01);
+    }
+  }
+
+  // and, because replica states are independent at equilibrium, the exchange
+  // acceptance rate is the average acceptance probability
+  for(Index i = 0; i + 1 < R; ++i) {
+    auto p_i = spin_probability(N, beta[i]);
+    auto p_j = spin_probability(N, beta[i + 1]);
+    double expected = 0.0;
+    for(Index e_i = 0; e_i <= N; ++e_i) {
+      for(Index e_j = 0; e_j <= N; ++e_j) {
+        expected += p_i[e_i] * p_j[e_j] *
+                    replica_exchange_probability(beta[i], beta[i + 1], e_i, e_j, e_i, e_j);
+      }
+    }
+    BOOST_CHECK_SMALL(n_accept[i] / n_attempt[i] - expected, 0.01);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Driver) {
+
+  test::ZrOProj proj;
+  proj.check_init();
+  proj.check_composition();
+
+  Logging logging = Logging::null();
+  PrimClex primclex(proj.dir, logging);
+
+  fs::path eci_src = "tests/unit/monte_carlo/eci_0.json";
+  fs::path eci_dest = primclex.dir().eci("formation_energy", "default", "default", "default", "default");
+  fs::copy_file(eci_src, eci_dest, fs::copy_option::overwrite_if_exists);
+
+  fs::path bspecs_src = "tests/unit/monte_carlo/bspecs_0.json";
+  fs::path bspecs_dest = primclex.dir().bspecs("default");
+  fs::copy_file(bspecs_src, bspecs_dest, fs::copy_option::overwrite_if_exists);
+
+  // for autotools
+  primclex.settings().set_casm_libdir(fs::current_path() / ".libs");
+  primclex.settings().commit();
+
+  CommandArgs args("casm bset -u", &primclex, primclex.dir().root_dir(), Logging::null());
+  BOOST_REQUIRE(!casm_api(args));
+
+  // a ladder of 4 temperatures, 3 replicas run at once
+  jsonParser json;
+  json.read(fs::path("tests/unit/monte_carlo/metropolis_grand_canonical_0.json"));
+  json["method"] = "ReplicaExchange";
+  json["data"].erase("min_pass");
+  json["data"]["N_pass"] = 100;
+  for(auto &measurement : json["data"]["measurements"]) {
+    measurement.erase("precision");
+  }
+  json["driver"]["seed"] = 1234;
+  json["driver"]["threads"] = 3;
+  json["driver"]["swap_period"] = 2;
+  json["driver"]["mode"] = "custom";
+  json["driver"]["custom_conditions"].put_array();
+  for(double T : {
+        300.0, 600.0, 900.0, 1200.0
+      }) {
+    jsonParser cond = json["driver"]["initial_conditions"];
+    cond["param_chem_pot"]["a"] = -1.0;
+    cond["temperature"] = T;
+    json["driver"]["custom_conditions"].push_back(cond);
+  }
+
+  fs::path mc_dir = primclex.dir().root_dir() / "mc_replica_exchange";
+  fs::remove_all(mc_dir);
+  fs::create_directory(mc_dir);
+  json.write(mc_dir / "monte_settings.json");
+
+  GrandCanonicalSettings settings(primclex, mc_dir / "monte_settings.json");
+  ReplicaExchangeDriver<GrandCanonical> driver(primclex, settings, null_log(), null_log());
+  driver.run();
+
+  // exchanges are attempted between each pair, every other swap period
+  Index n_pairs = 3;
+  for(Index i = 0; i < n_pairs; ++i) {
+    BOOST_CHECK_GE(driver.exchanges_attempted()[i], 24);
+    BOOST_CHECK_LE(driver.exchanges_accepted()[i], driver.exchanges_attempted()[i]);
+  }
+
+  MonteCarloDirectoryStructure dir(mc_dir);
+  BOOST_CHECK_EQUAL(jsonParser(dir.results_json())["<potential_energy>"].size(), 4);
+  for(Index i = 0; i < 4; ++i) {
+    BOOST_CHECK(fs::exists(dir.final_state_json(i)));
+    BOOST_CHECK(fs::exists(dir.conditions_json(i)));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,69 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/SumTree.hh"
+
+/// What is being used to test it:
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(SumTreeTest)
+
+BOOST_AUTO_TEST_CASE(Test0) {
+
+  Monte::SumTree tree(5);
+  BOOST_CHECK_EQUAL(tree.size(), 5);
+  BOOST_CHECK_EQUAL(tree.sum(), 0.0);
+
+  tree.set(0, 1.0);
+  tree.set(2, 2.0);
+  tree.set(4, 3.0);
+  BOOST_CHECK_EQUAL(tree.sum(), 6.0);
+  BOOST_CHECK_EQUAL(tree.value(2), 2.0);
+
+  BOOST_CHECK_EQUAL(tree.find(0.0), 0);
+  BOOST_CHECK_EQUAL(tree.find(0.5), 0);
+  BOOST_CHECK_EQUAL(tree.find(1.0), 2);
+  BOOST_CHECK_EQUAL(tree.find(2.5), 2);
+  BOOST_CHECK_EQUAL(tree.find(3.0), 4);
+  BOOST_CHECK_EQUAL(tree.find(5.9), 4);
+
+  // round-off: target >= sum() returns the last non-zero value
+  BOOST_CHECK_EQUAL(tree.find(6.0), 4);
+
+  tree.set(4, 0.0);
+  BOOST_CHECK_EQUAL(tree.sum(), 3.0);
+  BOOST_CHECK_EQUAL(tree.find(3.0), 2);
+
+  // single value
+  Monte::SumTree one(1);
+  one.set(0, 0.25);
+  BOOST_CHECK_EQUAL(one.sum(), 0.25);
+  BOOST_CHECK_EQUAL(one.find(0.1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Test1) {
+
+  // compare sampling frequencies with values
+  MTRand mtrand(MTRand::uint32(0));
+  Index N = 13;
+  Monte::SumTree tree(N);
+  for(Index i = 0; i < N; ++i) {
+    tree.set(i, (i % 3) * 1.0);
+  }
+
+  std::vector<double> count(N, 0.0);
+  Index n_samples = 100000;
+  for(Index s = 0; s < n_samples; ++s) {
+    count[tree.find(mtrand.rand53() * tree.sum())] += 1.0;
+  }
+
+  for(Index i = 0; i < N; ++i) {
+    double expected = tree.value(i) / tree.sum();
+    BOOST_CHECK_SMALL(count[i] / n_samples - expected, 0.01);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/ThermoIntegration.hh"
+
+/// What is being used to test it:
+#include <cmath>
+
+using namespace CASM;
+
+namespace {
+
+  /// Single site lattice gas, with potential energy (e - mu)*x, x = 0 or 1
+  struct LatticeGas {
+
+    double e;
+
+    Monte::ThermoIntegrationPoint point(double beta, double mu) const {
+      Eigen::VectorXd _mu(1);
+      _mu(0) = mu;
+      Eigen::VectorXd x(1);
+      x(0) = 1.0 / (1.0 + std::exp(beta * (e - mu)));
+      return Monte::ThermoIntegrationPoint(beta, _mu, (e - mu) * x(0), x);
+    }
+
+    double phi(double beta, double mu) const {
+      return -std::log(1.0 + std::exp(-beta * (e - mu))) / beta;
+    }
+  };
+}
+
+BOOST_AUTO_TEST_SUITE(ThermoIntegrationTest)
+
+BOOST_AUTO_TEST_CASE(Test0) {
+
+  LatticeGas gas {0.1};
+  Monte::ThermoIntegration integration;
+  BOOST_CHECK(integration.empty());
+
+  // anchor at high temperature, cool down, then change the chemical potential
+  double beta = 0.1;
+  double mu = 0.0;
+  auto p = gas.point(beta, mu);
+  BOOST_CHECK_CLOSE(Monte::high_temperature_phi(p, std::log(2.0)), gas.phi(beta, mu), 1.0);
+
+  integration.anchor(p, gas.phi(beta, mu));
+  BOOST_CHECK_EQUAL(integration.size(), 1);
+  BOOST_CHECK_CLOSE(integration.phi(), gas.phi(beta, mu), 1e-10);
+
+  for(int i = 0; i < 1000; ++i) {
+    beta += 0.04;
+    integration.add(gas.point(beta, mu));
+  }
+  BOOST_CHECK_CLOSE(integration.phi(), gas.phi(beta, mu), 0.01);
+
+  for(int i = 0; i < 1000; ++i) {
+    mu += 0.0002;
+    integration.add(gas.point(beta, mu));
+  }
+  BOOST_CHECK_EQUAL(integration.size(), 2001);
+  BOOST_CHECK_CLOSE(integration.phi(), gas.phi(beta, mu), 0.01);
+
+  // continuing from the last point gives the same result as not stopping
+  Monte::ThermoIntegration resumed;
+  resumed.anchor(integration.last(), integration.phi());
+  auto next = gas.point(beta + 0.01, mu + 0.001);
+  BOOST_CHECK_CLOSE(resumed.add(next), integration.add(next), 1e-10);
+
+  // no change in conditions, no change in beta*phi
+  BOOST_CHECK_SMALL(Monte::integrate_beta_phi(next, next), 1e-14);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
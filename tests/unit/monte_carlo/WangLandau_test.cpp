@@ -0,0 +1,99 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/WangLandau.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace {
+
+  /// Run a Wang-Landau window for N independent spins, with E = number of up spins
+  void run_spins(Monte::WangLandau &wl, Index N, MTRand &mtrand) {
+    std::vector<int> spin(N, 0);
+    double E = 0.0;
+    while(!wl.is_converged()) {
+      for(Index step = 0; step < 100 * N; ++step) {
+        Index i = mtrand.randInt(N - 1);
+        double new_E = E + (spin[i] ? -1.0 : 1.0);
+        if(wl.accept(E, new_E, mtrand.rand53())) {
+          spin[i] = 1 - spin[i];
+          E = new_E;
+        }
+        wl.update(E);
+      }
+      wl.check_flat();
+    }
+  }
+
+  double ln_binomial(Index n, Index k) {
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(WangLandauTest)
+
+BOOST_AUTO_TEST_CASE(Bins) {
+
+  Monte::WangLandau wl(-0.5, 1.0, 2, 5);
+  BOOST_CHECK_EQUAL(wl.bin(0.0), 0);
+  BOOST_CHECK_EQUAL(wl.bin(2.4), 2);
+  BOOST_CHECK_EQUAL(wl.bin(-0.6), -1);
+  BOOST_CHECK_EQUAL(wl.energy(3), 3.0);
+  BOOST_CHECK(!wl.contains(1));
+  BOOST_CHECK(wl.contains(4));
+  BOOST_CHECK(!wl.contains(5));
+
+  // outside the window, only moves toward it are accepted
+  BOOST_CHECK(wl.accept(0.0, 1.0, 0.99));
+  BOOST_CHECK(!wl.accept(1.0, 0.0, 0.0));
+  BOOST_CHECK(!wl.accept(7.0, 8.0, 0.0));
+
+  // inside the window, moves out are rejected
+  BOOST_CHECK(!wl.accept(2.0, 1.0, 0.0));
+  BOOST_CHECK(wl.accept(2.0, 3.0, 0.99));
+
+  wl.update(2.0);
+  BOOST_CHECK_EQUAL(wl.ln_g(2), 1.0);
+  BOOST_CHECK_EQUAL(wl.histogram(2), 1);
+  BOOST_CHECK(wl.visited(2));
+  BOOST_CHECK(!wl.visited(3));
+  BOOST_CHECK_EQUAL(wl.steps(), 1);
+
+  // g(2) > g(3), so moving up is always accepted, and down is not
+  BOOST_CHECK(wl.accept(3.0, 2.0, 0.5) == (0.5 < std::exp(-1.0)));
+}
+
+BOOST_AUTO_TEST_CASE(IndependentSpins) {
+
+  // g(E) = binomial(N, E), calculated in two overlapping windows
+  Index N = 20;
+  Monte::WangLandauParams params;
+  params.ln_f_final = 1e-5;
+
+  std::vector<Monte::WangLandau> windows;
+  windows.emplace_back(-0.5, 1.0, 0, 13, params);
+  windows.emplace_back(-0.5, 1.0, 8, N + 1, params);
+
+  MTRand mtrand(MTRand::uint32(0));
+  for(auto &wl : windows) {
+    run_spins(wl, N, mtrand);
+    BOOST_CHECK(wl.is_one_over_t());
+    BOOST_CHECK(wl.iterations() > 0);
+  }
+
+  auto ln_g = Monte::stitch(windows);
+  BOOST_CHECK_EQUAL(ln_g.size(), N + 1);
+  BOOST_CHECK_EQUAL(ln_g.begin()->first, 0);
+  for(const auto &val : ln_g) {
+    double expected = ln_binomial(N, val.first);
+    BOOST_CHECK_SMALL(val.second - ln_g[0] - expected, 0.1);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 
 /// What is being tested:
 #include "casm/system/RuntimeLibrary.hh"
+#include "casm/system/RuntimeLibraryCache.hh"
 
 /// Dependencies
 #include "casm/casm_io/Log.hh"
@@ -68,4 +69,134 @@ BOOST_AUTO_TEST_CASE(FunctionTest) {
 
 }
 
+BOOST_AUTO_TEST_CASE(ShardTest) {
+
+  std::string cc_filename_base = "tests/unit/system/runtime_lib_shards";
+  fs::path cc_filename {cc_filename_base + ".cc"};
+
+  // each shard defines one function, and all are defined without RUNTIME_LIBRARY_SHARD
+  fs::ofstream file(cc_filename);
+  file << "#define RUNTIME_LIBRARY_SHARDS 3\n"
+       "#ifdef RUNTIME_LIBRARY_SHARD\n"
+       "#define RUNTIME_LIBRARY_SHARD_ENABLED(k) (RUNTIME_LIBRARY_SHARD == k)\n"
+       "#else\n"
+       "#define RUNTIME_LIBRARY_SHARD_ENABLED(k) 1\n"
+       "#endif\n"
+       "int one();\n"
+       "int two();\n"
+       "#if RUNTIME_LIBRARY_SHARD_ENABLED(0)\n"
+       "extern \"C\" int three() {\n"
+       "   return one() + two();\n"
+       "}\n"
+       "#endif\n"
+       "#if RUNTIME_LIBRARY_SHARD_ENABLED(1)\n"
+       "int one() {\n"
+       "   return 1;\n"
+       "}\n"
+       "#endif\n"
+       "#if RUNTIME_LIBRARY_SHARD_ENABLED(2)\n"
+       "int two() {\n"
+       "   return 2;\n"
+       "}\n"
+       "#endif\n";
+  file.close();
+
+  std::string compile_opt = RuntimeLibrary::default_cxx().first + " " +
+                            RuntimeLibrary::default_cxxflags().first;
+  std::string so_opt = RuntimeLibrary::default_cxx().first + " " +
+                       RuntimeLibrary::default_soflags().first + " " +
+                       link_path(RuntimeLibrary::default_boost_libdir().first.string());
+
+  RuntimeLibrary lib(
+    cc_filename_base,
+    compile_opt,
+    so_opt,
+    "Compiling RuntimeLibrary test code",
+    Logging::null());
+
+  BOOST_CHECK_EQUAL(3, lib.get_function<int()>("three")());
+  BOOST_CHECK(!fs::exists(cc_filename_base + ".shard_0.o"));
+
+  lib.rm();
+}
+
+BOOST_AUTO_TEST_CASE(CacheTest) {
+
+  fs::path test_dir {"tests/unit/system/runtime_lib_cache_test"};
+  fs::remove_all(test_dir);
+  fs::path cache_dir = test_dir / "cache";
+
+  std::string compile_opt = RuntimeLibrary::default_cxx().first + " " +
+                            RuntimeLibrary::default_cxxflags().first;
+  std::string so_opt = RuntimeLibrary::default_cxx().first + " " +
+                       RuntimeLibrary::default_soflags().first + " " +
+                       link_path(RuntimeLibrary::default_boost_libdir().first.string());
+
+  // write source code, differing only by location, to two 'projects'
+  auto write = [&](fs::path dir, int value) {
+    fs::create_directories(dir);
+    fs::ofstream file(dir / "runtime_lib.cc");
+    file << "extern \"C\" int value() {\n"
+         "   return " << value << ";\n"
+         "}\n";
+    return (dir / "runtime_lib").string();
+  };
+  std::string base_a = write(test_dir / "a", 42);
+  std::string base_b = write(test_dir / "b", 42);
+  std::string base_c = write(test_dir / "c", 43);
+
+  auto n_entries = [&]() {
+    Index count = 0;
+    for(fs::directory_iterator it(cache_dir), end; it != end; ++it) {
+      if(fs::is_directory(it->path()) && it->path().filename() != "tmp") {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  RuntimeLibraryCache cache(cache_dir, 1024 * 1024 * 1024);
+  BOOST_CHECK(cache.enabled());
+  BOOST_CHECK_EQUAL(cache.key(base_a + ".cc", compile_opt, so_opt),
+                    cache.key(base_b + ".cc", compile_opt, so_opt));
+  BOOST_CHECK(cache.key(base_a + ".cc", compile_opt, so_opt) !=
+              cache.key(base_c + ".cc", compile_opt, so_opt));
+  BOOST_CHECK(cache.key(base_a + ".cc", compile_opt, so_opt) !=
+              cache.key(base_a + ".cc", compile_opt + " -DNDEBUG", so_opt));
+
+  {
+    RuntimeLibrary lib_a(base_a, compile_opt, so_opt, "Compiling RuntimeLibrary test code", cache, Logging::null());
+    BOOST_CHECK_EQUAL(lib_a.get_function<int()>("value")(), 42);
+    BOOST_CHECK(fs::is_symlink(base_a + ".so"));
+    BOOST_CHECK_EQUAL(n_entries(), 1);
+
+    // the same source code in another location is loaded from the cache
+    RuntimeLibrary lib_b(base_b, compile_opt, so_opt, "Compiling RuntimeLibrary test code", cache, Logging::null());
+    BOOST_CHECK_EQUAL(lib_b.get_function<int()>("value")(), 42);
+    BOOST_CHECK(fs::is_symlink(base_b + ".so"));
+    BOOST_CHECK(fs::equivalent(base_a + ".so", base_b + ".so"));
+    BOOST_CHECK_EQUAL(n_entries(), 1);
+
+    // loading through the link does not preprocess, so does not use the compiler
+    RuntimeLibrary lib_a2(base_a, "not-a-compiler", so_opt, "Compiling RuntimeLibrary test code", cache, Logging::null());
+    BOOST_CHECK_EQUAL(lib_a2.get_function<int()>("value")(), 42);
+  }
+
+  // with a cache that holds only one library, the least recently used is evicted
+  RuntimeLibraryCache small_cache(cache_dir, 1);
+  RuntimeLibrary lib_c(base_c, compile_opt, so_opt, "Compiling RuntimeLibrary test code", small_cache, Logging::null());
+  BOOST_CHECK_EQUAL(lib_c.get_function<int()>("value")(), 43);
+  BOOST_CHECK_EQUAL(n_entries(), 1);
+  BOOST_CHECK(fs::exists(cache_dir / cache.key(base_c + ".cc", compile_opt, so_opt)));
+
+  // a disabled cache compiles next to the source code, replacing the link to
+  // the evicted library
+  BOOST_CHECK(fs::is_symlink(base_a + ".so") && !fs::exists(base_a + ".so"));
+  RuntimeLibrary lib_d(base_a, compile_opt, so_opt, "Compiling RuntimeLibrary test code", RuntimeLibraryCache("", 0), Logging::null());
+  BOOST_CHECK_EQUAL(lib_d.get_function<int()>("value")(), 42);
+  BOOST_CHECK(fs::exists(base_a + ".so") && !fs::is_symlink(base_a + ".so"));
+
+  fs::remove_all(test_dir);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
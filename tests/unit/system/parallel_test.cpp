@@ -0,0 +1,89 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/misc/parallel.hh"
+
+/// What is being used to test it:
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(parallelTest)
+
+BOOST_AUTO_TEST_CASE(ResolveThreads) {
+  BOOST_CHECK(resolve_threads(0) >= 1);
+  BOOST_CHECK_EQUAL(resolve_threads(3), 3);
+}
+
+BOOST_AUTO_TEST_CASE(EveryIndexOnce) {
+
+  for(Index n : {0, 1, 5, 1000}) {
+    for(Index n_threads : {1, 2, 3, 8, 2000}) {
+      std::vector<std::atomic<int> > count(n);
+      for(auto &c : count) {
+        c = 0;
+      }
+      std::vector<Index> thread(n, -1);
+      parallel_for(n, n_threads, [&](Index t, Index i) {
+        ++count[i];
+        thread[i] = t;
+      });
+
+      for(Index i = 0; i < n; ++i) {
+        BOOST_CHECK_EQUAL(count[i], 1);
+        BOOST_CHECK(thread[i] >= 0 && thread[i] < std::max(Index(1), n_threads));
+      }
+
+      // contiguous chunks, in order
+      for(Index i = 1; i < n; ++i) {
+        BOOST_CHECK(thread[i - 1] <= thread[i]);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RethrowsWorkerExceptions) {
+
+  // an exception in a worker thread is rethrown, after all threads finish
+  std::vector<std::atomic<int> > count(100);
+  for(auto &c : count) {
+    c = 0;
+  }
+  BOOST_CHECK_THROW(
+    parallel_for(100, 4, [&](Index t, Index i) {
+    ++count[i];
+    if(i == 90) {
+      throw std::runtime_error("worker");
+    }
+  }),
+  std::runtime_error);
+
+  // other threads ran their chunks to completion
+  for(Index i = 0; i < 75; ++i) {
+    BOOST_CHECK_EQUAL(count[i], 1);
+  }
+
+  // the first exception, by thread, is rethrown
+  try {
+    parallel_for(100, 4, [&](Index t, Index i) {
+      if(i == 10) {
+        throw std::runtime_error("first");
+      }
+      if(i == 60) {
+        throw std::logic_error("second");
+      }
+    });
+    BOOST_ERROR("expected an exception");
+  }
+  catch(const std::runtime_error &e) {
+    BOOST_CHECK_EQUAL(std::string(e.what()), "first");
+  }
+  catch(...) {
+    BOOST_ERROR("rethrew the wrong exception");
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()